@@ -277,6 +277,8 @@ std::string OptionsParser::APIyaml(const buffers::resources::Settings* currentCo
   int inherit_negatives = compilerSettings.has_inherit_negatives() ? compilerSettings.inherit_negatives() : 0;
   bool inherit_objects = compilerSettings.has_inherit_objects() ? compilerSettings.inherit_objects() : 0;
   bool automatic_semicolons = compilerSettings.has_automatic_semicolons() ? compilerSettings.automatic_semicolons() : 0;
+  int resource_codec = compilerSettings.has_resource_codec() ? compilerSettings.resource_codec() : 0;
+  bool shard_codegen = compilerSettings.has_shard_codegen() ? compilerSettings.shard_codegen() : 0;
 
   std::string yaml;
   yaml += "%e-yaml\n";
@@ -295,6 +297,8 @@ std::string OptionsParser::APIyaml(const buffers::resources::Settings* currentCo
   yaml += "inherit-increment-from: " + std::to_string(inherit_increment) + "\n";
   yaml += "inherit-objects: " + std::string(inherit_objects ? "true" : "false") + "\n";
   yaml += "automatic-semicolons: " + std::string(automatic_semicolons ? "true" : "false") + "\n";
+  yaml += "resource-codec: " + std::to_string(resource_codec) + "\n";
+  yaml += "shard-codegen: " + std::string(shard_codegen ? "true" : "false") + "\n";
   yaml += " \n";
   yaml += "target-audio: " + audio + "\n";
   yaml += "target-windowing: " + platform + "\n";
@@ -62,6 +62,8 @@ using namespace std;
 #include "settings-parse/crawler.h"
 
 #include "components/components.h"
+#include "components/resource_codec.h"
+#include "components/resource_toc.h"
 
 #include "general/bettersystem.h"
 #include "event_reader/event_parser.h"
@@ -109,7 +111,7 @@ inline void write_desktop_entry(const std::filesystem::path& fname, const GameDa
 }
 
 inline void write_exe_info(const std::filesystem::path& codegen_directory, const GameData &game) {
-  std::ofstream wto;
+  codegen_ofstream wto;
   const buffers::resources::General &gameSet = game.settings.general();
   const string &gloss_version = game.settings.info().version();
 
@@ -148,6 +150,7 @@ inline void write_exe_info(const std::filesystem::path& codegen_directory, const
 static int write_res_helper(FILE* gameModule, int& resourceblock_start, const GameData &game) {
   // Start by setting off our location with a DWord of NULLs
   fwrite("\0\0\0",1,4,gameModule);
+  resource_toc::clear();
 
   idpr("Adding Sprites",90);
 
@@ -168,8 +171,13 @@ static int write_res_helper(FILE* gameModule, int& resourceblock_start, const Ga
 
   current_language->module_write_paths(game, gameModule);
 
-  // Tell where the resources start
-  fwrite("\0\0\0\0res0",8,1,gameModule);
+  // Index the sections so the game can find them without reading in order
+  int toc_start = ftell(gameModule);
+  resource_toc::write(gameModule);
+
+  // Tell where the index and resources start
+  fwrite(&toc_start,4,1,gameModule);
+  fwrite("res1",4,1,gameModule);
   fwrite(&resourceblock_start,4,1,gameModule);
 
   // Close the game module; we're done adding resources
@@ -196,7 +204,7 @@ DLLEXPORT void ide_handles_game_launch() { run_game = false; }
 static bool redirect_make = true;
 DLLEXPORT void log_make_to_console() { redirect_make = false; }
 
-template<typename T> void write_resource_meta(ofstream &wto, const char *kind, vector<T> resources, bool gen_names = true) {
+template<typename T> void write_resource_meta(ostream &wto, const char *kind, vector<T> resources, bool gen_names = true) {
   int max = 0;
   stringstream swb;  // switch body
   wto << "namespace enigma_user {\n"
@@ -207,6 +215,7 @@ template<typename T> void write_resource_meta(ofstream &wto, const char *kind, v
     swb << "      case " << res.id() << ": return \""  << res.name << "\";\n";
   }
   wto << "  };\n\n";
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD\n";
   if (gen_names) {
     wto << "  string " << kind << "_get_name(int i) {\n"
            "    switch (i) {\n";
@@ -214,12 +223,15 @@ template<typename T> void write_resource_meta(ofstream &wto, const char *kind, v
     wto << "    }\n"
            "  }\n";
   }
+  wto << "#endif\n";
   wto << "}\n";
-  wto << "namespace enigma { size_t " << kind << "_idmax = " << max << "; }\n\n";
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD\n";
+  wto << "namespace enigma { size_t " << kind << "_idmax = " << max << "; }\n";
+  wto << "#endif\n\n";
 }   
  
 void wite_asset_enum(const std::filesystem::path& fName) {
-  std::ofstream wto;
+  codegen_ofstream wto;
   wto.open(fName.u8string().c_str());
   
   wto<< "#ifndef ASSET_ENUM_H\n#define ASSET_ENUM_H\n\n";
@@ -481,7 +493,7 @@ int lang_CPP::compile(const GameData &game, const char* exe_filename, int mode)
 
   //Export resources to each file.
 
-  ofstream wto;
+  codegen_ofstream wto;
   idpr("Outputting Resources in Various Places...",10);
 
   // FIRST FILE
@@ -498,17 +510,7 @@ int lang_CPP::compile(const GameData &game, const char* exe_filename, int mode)
     write_desktop_entry(gameFname, game);
 
   edbg << "Writing modes and settings" << flushl;
-  wto.open((codegen_directory/"Preprocessor_Environment_Editable/GAME_SETTINGS.h").u8string().c_str(),ios_base::out);
-  wto << license;
-  wto << "#define ASSUMEZERO 0\n";
-  wto << "#define PRIMBUFFER 0\n";
-  wto << "#define PRIMDEPTH2 6\n";
-  wto << "#define AUTOLOCALS 0\n";
-  wto << "#define MODE3DVARS 0\n";
-  wto << "#define GM_COMPATIBILITY_VERSION " << setting::compliance_mode << "\n";
-  wto << "void ABORT_ON_ALL_ERRORS() { " << (false?"game_end();":"") << " }\n";
-  wto << '\n';
-  wto.close();
+  write_game_settings();
 
   wto.open((codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_modesenabled.h").u8string().c_str(),ios_base::out);
   wto << license;
@@ -541,10 +543,13 @@ int lang_CPP::compile(const GameData &game, const char* exe_filename, int mode)
   wto.open((codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_resourcenames.h").u8string().c_str(),ios_base::out);
   wto << license;
 
+  // Generated game sources see this file too; definitions are left to SHELLmain.
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD\n";
   wto << "namespace enigma {\n";
   std::string res_in = (compilerInfo.exe_vars["RESOURCES_IN"] != "") ? "RESOURCES_IN" : "RESOURCES";
   wto << "const char *resource_file_path=\"" << compilerInfo.exe_vars[res_in] << "\";\n";
   wto << "}\n";
+  wto << "#endif\n";
 
   write_resource_meta(wto,     "object", game.objects);
   write_resource_meta(wto,     "sprite", game.sprites);
@@ -561,6 +566,7 @@ int lang_CPP::compile(const GameData &game, const char* exe_filename, int mode)
   wite_asset_enum(codegen_directory/"AssetEnum.h");
   
   wto << "#include \"AssetEnum.h\"\n";
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD\n";
   wto << "namespace enigma {\n\n";
   wto << "std::map<enigma_user::AssetType, std::map<std::string, int>> assetMap = {\n";
   
@@ -583,6 +589,7 @@ int lang_CPP::compile(const GameData &game, const char* exe_filename, int mode)
   
   wto << "\n};\n";
   wto << "\n\n}\n";
+  wto << "#endif\n";
   wto.close();
 
 
@@ -725,6 +732,7 @@ int lang_CPP::compile(const GameData &game, const char* exe_filename, int mode)
   make += "NETWORKING=\""  + extensions::targetAPI.networkSys + "\" ";
   make += "PLATFORM=\"" + extensions::targetAPI.windowSys + "\" ";
   make += "TARGET-PLATFORM=\"" + compilerInfo.target_platform + "\" ";
+  make += "RESOURCE_CODEC=\"" + string(resource_codec::make_name(resource_codec::chosen())) + "\" ";
 
   for (const auto& key : compilerInfo.make_vars) {
     if (key.second != "")
@@ -28,10 +28,13 @@
 
 #include <map>
 #include <string>
+#include <fstream>
 using namespace std;
 
 #include "parser/object_storage.h"
 #include "compile_organization.h"
+#include "compile_common.h"
+#include "settings.h"
 
 namespace used_funcs
 {
@@ -42,6 +45,46 @@ namespace used_funcs
     object_set_sprite = 0;
   }
 }
+void codegen_ofstream::open(const std::filesystem::path &fname, std::ios_base::openmode) {
+  close();
+  fname_ = fname;
+  str(string());
+  clear();
+}
+
+bool codegen_ofstream::close() {
+  if (fname_.empty()) return false;
+  const string content = str();
+  const std::filesystem::path fname = fname_;
+  fname_.clear();
+
+  std::error_code ec;
+  if (std::filesystem::file_size(fname, ec) == content.length() && !ec) {
+    ifstream in(fname, ios_base::in | ios_base::binary);
+    string old(content.length(), '\0');
+    if (in.read(&old[0], old.length()) && old == content)
+      return false;
+  }
+  ofstream out(fname, ios_base::out | ios_base::binary);
+  out << content;
+  return true;
+}
+
+void write_game_settings() {
+  codegen_ofstream wto(codegen_directory/"Preprocessor_Environment_Editable/GAME_SETTINGS.h");
+  wto << license;
+  wto << "#define ASSUMEZERO 0\n";
+  wto << "#define PRIMBUFFER 0\n";
+  wto << "#define PRIMDEPTH2 6\n";
+  wto << "#define AUTOLOCALS 0\n";
+  wto << "#define MODE3DVARS 0\n";
+  wto << "#define GM_COMPATIBILITY_VERSION " << setting::compliance_mode << "\n";
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD\n";
+  wto << "void ABORT_ON_ALL_ERRORS() { }\n";
+  wto << "#endif\n";
+  wto << '\n';
+}
+
 map<string, ParsedScript*> scr_lookup;
 
 map<string, vector<ParsedScript*> > tline_lookup;
@@ -31,6 +31,8 @@
 
 #include <map>
 #include <vector>
+#include <sstream>
+#include <filesystem>
 #include "compile_organization.h"
 #include "parser/object_storage.h"
 
@@ -51,6 +53,32 @@ namespace used_funcs
 
 extern const char* license;
 
+// Writes GAME_SETTINGS.h from the current settings. Both a settings change and
+// a compile write it, so they share this to keep the file's text identical.
+void write_game_settings();
+
+// Drop-in for ofstream when writing codegen. Output is buffered and only hits
+// the disk on close() if it differs from what the file already holds, so make
+// sees unchanged generated sources as up to date and skips rebuilding them.
+class codegen_ofstream: public std::ostringstream {
+ public:
+  codegen_ofstream() {}
+  explicit codegen_ofstream(const std::filesystem::path &fname,
+                            std::ios_base::openmode = std::ios_base::out) {
+    open(fname);
+  }
+  ~codegen_ofstream() { close(); }
+
+  void open(const std::filesystem::path &fname,
+            std::ios_base::openmode = std::ios_base::out);
+  bool is_open() const { return !fname_.empty(); }
+  // Returns whether the file had to be (re)written.
+  bool close();
+
+ private:
+  std::filesystem::path fname_;
+};
+
 
 inline string tdefault(string t) {
   return (t != "" ? t : "var");
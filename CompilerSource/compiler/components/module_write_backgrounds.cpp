@@ -39,6 +39,8 @@ using namespace std;
 
 #include "backend/ideprint.h"
 #include "languages/lang_CPP.h"
+#include "resource_codec.h"
+#include "resource_toc.h"
 
 inline void writei(int x, FILE *f) {
   fwrite(&x,4,1,f);
@@ -49,6 +51,8 @@ int lang_CPP::module_write_backgrounds(const GameData &game, FILE *gameModule)
   // Now we're going to add backgrounds
   edbg << game.backgrounds.size() << " Adding Backgrounds to Game Module: " << flushl;
 
+  const long section_start = ftell(gameModule);
+
   //Magic Number
   fwrite("BKG ",4,1,gameModule);
 
@@ -62,8 +66,12 @@ int lang_CPP::module_write_backgrounds(const GameData &game, FILE *gameModule)
       back_maxid = game.backgrounds[i].id();
   fwrite(&back_maxid,4,1,gameModule);
 
+  const int codec = resource_codec::chosen();
+  vector<unsigned char> blob;
+
   for (int i = 0; i < back_count; i++)
   {
+    const long record_start = ftell(gameModule);
     writei(game.backgrounds[i].id(), gameModule);  // id
     writei(game.backgrounds[i].image_data.width,  gameModule);  // width
     writei(game.backgrounds[i].image_data.height, gameModule);  // height
@@ -79,10 +87,16 @@ int lang_CPP::module_write_backgrounds(const GameData &game, FILE *gameModule)
     writei(game.backgrounds[i]->horizontal_spacing(), gameModule);
     writei(game.backgrounds[i]->vertical_spacing(),   gameModule);
 
-    const int sz = game.backgrounds[i].image_data.pixels.size();
-    writei(sz, gameModule); // size
-    fwrite(game.backgrounds[i].image_data.pixels.data(), 1, sz, gameModule); // data
+    const auto &image = game.backgrounds[i].image_data;
+    if (!resource_codec::encode(codec, image.pixels.data(), image.pixels.size(), image.width * image.height * 4, blob))
+      user << "Background `" << game.backgrounds[i].name << "' is corrupt; it will fail to load." << flushl;
+    writei(blob.size(), gameModule); // size
+    fwrite(blob.data(), 1, blob.size(), gameModule); // data
+
+    resource_toc::add("BKG ", game.backgrounds[i].id(), record_start, ftell(gameModule) - record_start,
+                      codec << resource_toc::toc_codec_shift);
   }
+  resource_toc::add("BKG ", -1, section_start, ftell(gameModule) - section_start);
 
   edbg << "Done writing backgrounds." << flushl;
   return 0;
@@ -35,6 +35,7 @@ using namespace std;
 
 #include "rectpacker/rectpack.h"
 #include "languages/lang_CPP.h"
+#include "resource_toc.h"
 
 inline void writei(int x, FILE *f) {
   fwrite(&x,4,1,f);
@@ -87,6 +88,8 @@ int lang_CPP::module_write_fonts(const GameData &game, FILE *gameModule)
   // Now we're going to add backgrounds
   edbg << game.fonts.size() << " Adding Fonts to Game Module: " << flushl;
 
+  const long section_start = ftell(gameModule);
+
   //Magic Number
   fwrite("FNT ",4,1,gameModule);
 
@@ -186,6 +189,8 @@ int lang_CPP::module_write_fonts(const GameData &game, FILE *gameModule)
     delete[] boxes;
   }
 
+  resource_toc::add("FNT ", -1, section_start, ftell(gameModule) - section_start);
+
   edbg << "Done writing fonts." << flushl;
   return 0;
 }
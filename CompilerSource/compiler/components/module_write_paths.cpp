@@ -43,6 +43,7 @@ using namespace std;
 #include "backend/ideprint.h"
 
 #include "languages/lang_CPP.h"
+#include "resource_toc.h"
 
 inline void writei(int x, FILE *f) {
   fwrite(&x,4,1,f);
@@ -53,6 +54,8 @@ int lang_CPP::module_write_paths(const GameData &game, FILE *gameModule)
   // Now we're going to add paths
   edbg << "Adding " << game.paths.size() << " Paths to Game Module: " << flushl;
 
+  const long section_start = ftell(gameModule);
+
   //Magic Number
   fwrite("PTH ",4,1,gameModule);
 
@@ -87,6 +90,8 @@ int lang_CPP::module_write_paths(const GameData &game, FILE *gameModule)
     }
   }
 
+  resource_toc::add("PTH ", -1, section_start, ftell(gameModule) - section_start);
+
   edbg << "Done writing paths." << flushl;
   return 0;
 }
@@ -40,6 +40,7 @@ using namespace std;
 
 #include "backend/ideprint.h"
 #include "languages/lang_CPP.h"
+#include "resource_toc.h"
 
 inline void writei(int x, FILE *f) {
   fwrite(&x,4,1,f);
@@ -54,6 +55,8 @@ int lang_CPP::module_write_sounds(const GameData &game, FILE *gameModule)
     fflush(stdout);
   }
 
+  const long section_start = ftell(gameModule);
+
   //Magic number
   fwrite("SND ",4,1,gameModule);
 
@@ -80,6 +83,8 @@ int lang_CPP::module_write_sounds(const GameData &game, FILE *gameModule)
     fwrite(game.sounds[i].audio.data(), 1, sndsz, gameModule); // Data
   }
 
+  resource_toc::add("SND ", -1, section_start, ftell(gameModule) - section_start);
+
   edbg << "Done writing sounds." << flushl;
   return 0;
 }
@@ -40,6 +40,8 @@ using namespace std;
 #include "compiler/compile_common.h"
 
 #include "backend/ideprint.h"
+#include "resource_codec.h"
+#include "resource_toc.h"
 
 inline void writei(int x, FILE *f) {
   fwrite(&x,4,1,f);
@@ -51,6 +53,8 @@ int lang_CPP::module_write_sprites(const GameData &game, FILE *gameModule)
   // Now we're going to add sprites
   edbg << game.sprites.size() << " Adding Sprites to Game Module: " << flushl;
 
+  const long section_start = ftell(gameModule);
+
   //Magic Number
   fwrite("SPR ",4,1,gameModule);
 
@@ -64,8 +68,12 @@ int lang_CPP::module_write_sprites(const GameData &game, FILE *gameModule)
       sprite_maxid = game.sprites[i].id();
   fwrite(&sprite_maxid,4,1,gameModule);
 
+  const int codec = resource_codec::chosen();
+  vector<unsigned char> blob;
+
   for (int i = 0; i < sprite_count; i++)
   {
+    const long record_start = ftell(gameModule);
     writei(game.sprites[i].id(), gameModule); //id
 
     // Track how many subImages we're copying
@@ -105,13 +113,21 @@ int lang_CPP::module_write_sprites(const GameData &game, FILE *gameModule)
     for (int ii = 0;ii < subCount; ii++)
     {
       //strans = game.sprites[i].image_data[ii].transColor, fwrite(&idttrans,4,1,exe); //Transparent color
+      const auto &pixels = game.sprites[i].image_data[ii].pixels;
+      if (!resource_codec::encode(codec, pixels.data(), pixels.size(), swidth * sheight * 4, blob))
+        user << "Subimage " << ii << " of sprite `" << game.sprites[i].name << "' is corrupt; it will fail to load." << flushl;
       writei(swidth * sheight * 4, gameModule); // size when unpacked
-      writei(game.sprites[i].image_data[ii].pixels.size(), gameModule);  // size
-      fwrite(game.sprites[i].image_data[ii].pixels.data(), 1,
-             game.sprites[i].image_data[ii].pixels.size(), gameModule);  // data
+      writei(blob.size(), gameModule);  // size
+      fwrite(blob.data(), 1, blob.size(), gameModule);  // data
       writei(0,gameModule);
     }
+
+    // Sprites the user asked not to preload are decoded on first use
+    const bool deferred = game.sprites[i]->has_preload() && !game.sprites[i]->preload();
+    resource_toc::add("SPR ", game.sprites[i].id(), record_start, ftell(gameModule) - record_start,
+                      (deferred ? resource_toc::toc_deferred : 0) | codec << resource_toc::toc_codec_shift);
   }
+  resource_toc::add("SPR ", -1, section_start, ftell(gameModule) - section_start);
 
   edbg << "Done writing sprites." << flushl;
   return 0;
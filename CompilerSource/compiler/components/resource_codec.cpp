@@ -0,0 +1,91 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "resource_codec.h"
+#include "settings.h"
+#include "backend/ideprint.h"
+
+#include <zlib.h>
+#ifdef ENIGMA_HAVE_LZ4
+#  include <lz4hc.h>
+#endif
+#ifdef ENIGMA_HAVE_ZSTD
+#  include <zstd.h>
+#endif
+
+namespace resource_codec
+{
+  int chosen() {
+    switch (setting::resource_codec) {
+      #ifdef ENIGMA_HAVE_LZ4
+      case lz4: return lz4;
+      #endif
+      #ifdef ENIGMA_HAVE_ZSTD
+      case zstd: return zstd;
+      #endif
+      case zlib: return zlib;
+      default:
+        static bool warned = false;
+        if (!warned)
+          user << "This compiler was built without " << make_name(setting::resource_codec)
+               << " support; compressing resources with zlib instead." << flushl;
+        warned = true;
+        return zlib;
+    }
+  }
+
+  const char *make_name(int codec) {
+    switch (codec) {
+      case zlib: return "zlib";
+      case lz4:  return "lz4";
+      case zstd: return "zstd";
+      default:   return "unknown";
+    }
+  }
+
+  bool encode(int codec, const unsigned char *zdata, size_t zsize, size_t unpacked, std::vector<unsigned char> &out) {
+    out.assign(zdata, zdata + zsize);
+    if (codec == zlib) return true;
+
+    std::vector<unsigned char> raw(unpacked);
+    uLongf rawsize = unpacked;
+    if (uncompress(raw.data(), &rawsize, zdata, zsize) != Z_OK || rawsize != unpacked)
+      return false;
+
+    #ifdef ENIGMA_HAVE_LZ4
+    if (codec == lz4) {
+      std::vector<unsigned char> packed(LZ4_compressBound(unpacked));
+      const int size = LZ4_compress_HC((const char*) raw.data(), (char*) packed.data(), unpacked, packed.size(), LZ4HC_CLEVEL_MAX);
+      if (size <= 0) return false;
+      packed.resize(size);
+      out.swap(packed);
+      return true;
+    }
+    #endif
+    #ifdef ENIGMA_HAVE_ZSTD
+    if (codec == zstd) {
+      std::vector<unsigned char> packed(ZSTD_compressBound(unpacked));
+      const size_t size = ZSTD_compress(packed.data(), packed.size(), raw.data(), unpacked, 19);
+      if (ZSTD_isError(size)) return false;
+      packed.resize(size);
+      out.swap(packed);
+      return true;
+    }
+    #endif
+    return false;
+  }
+}
@@ -0,0 +1,46 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_RESOURCE_CODEC_H
+#define ENIGMA_RESOURCE_CODEC_H
+
+#include <stddef.h>
+#include <vector>
+
+// Compression for the sprite and background pixels in the resource block. The
+// IDE hands us images already deflated with zlib; other codecs re-encode them.
+// The numbering matches the game's Universal_System/codecs.h.
+namespace resource_codec
+{
+  enum {
+    zlib = 0,
+    lz4  = 1,
+    zstd = 2
+  };
+
+  // The codec the game settings ask for, or zlib if this build of the
+  // compiler can't write it.
+  int chosen();
+  // Its name as the game's Makefile knows it (RESOURCE_CODEC).
+  const char *make_name(int codec);
+
+  // Re-encodes a zlib blob that inflates to `unpacked` bytes. If the blob
+  // can't be inflated, `out` gets it unchanged and this returns false.
+  bool encode(int codec, const unsigned char *zdata, size_t zsize, size_t unpacked, std::vector<unsigned char> &out);
+}
+
+#endif
@@ -0,0 +1,59 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "resource_toc.h"
+
+#include <string.h>
+#include <vector>
+
+namespace resource_toc
+{
+  namespace {
+    struct entry {
+      char type[4];
+      int id, offset, size, flags;
+    };
+    std::vector<entry> entries;
+  }
+
+  void clear() {
+    entries.clear();
+  }
+
+  void add(const char type[4], int id, long offset, long size, int flags) {
+    entry e;
+    memcpy(e.type, type, 4);
+    e.id = id;
+    e.offset = offset;
+    e.size = size;
+    e.flags = flags;
+    entries.push_back(e);
+  }
+
+  void write(FILE *gameModule) {
+    fwrite("TOC ",4,1,gameModule);
+    int count = entries.size();
+    fwrite(&count,4,1,gameModule);
+    for (const entry &e : entries) {
+      fwrite(e.type,4,1,gameModule);
+      fwrite(&e.id,4,1,gameModule);
+      fwrite(&e.offset,4,1,gameModule);
+      fwrite(&e.size,4,1,gameModule);
+      fwrite(&e.flags,4,1,gameModule);
+    }
+  }
+}
@@ -0,0 +1,42 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_RESOURCE_TOC_H
+#define ENIGMA_RESOURCE_TOC_H
+
+#include <stdio.h>
+
+// Table of contents for the resource block. The module writers note where each
+// section and asset record landed as they write it, and write_res_helper
+// appends the table after the last section so the game can find any record
+// without reading the ones before it. Offsets are from the start of the file.
+//
+// On disk: "TOC ", the entry count, then five ints per entry (type, id, offset,
+// size, flags). Section entries have an ID of -1.
+namespace resource_toc
+{
+  enum {
+    toc_deferred = 1,    // Decode the asset the first time the game uses it.
+    toc_codec_shift = 8  // Bits 8-15 hold the codec of the record's blobs.
+  };
+
+  void clear();
+  void add(const char type[4], int id, long offset, long size, int flags = 0);
+  void write(FILE *gameModule);
+}
+
+#endif
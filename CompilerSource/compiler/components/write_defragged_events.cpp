@@ -42,7 +42,7 @@ using namespace std;
 int lang_CPP::compile_writeDefraggedEvents(
     const GameData &game, const std::set<EventGroupKey> &used_events,
     const ParsedObjectVec &parsed_objects) {
-  ofstream wto((codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_evparent.h").u8string().c_str());
+  codegen_ofstream wto((codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_evparent.h").u8string().c_str());
   wto << license;
 
   //Write timeline/moment names. Timelines are like scripts, but we don't have to worry about arguments or return types.
@@ -84,6 +84,10 @@ int lang_CPP::compile_writeDefraggedEvents(
     if (event.HasDefaultCode()) {
       wto << " {" << endl << "  " << event.DefaultCode() << endl
           << (e_is_void ? "    }" : "      return 0;\n    }") << endl;
+      // Lets the engine tell objects that kept the default apart from those
+      // that replaced it (eg, to cull default draws by their sprite's box).
+      if (event.HasReplaceableDefaultCode())
+        wto << "    virtual bool myevent_" << fname << "_is_default() { return true; }" << endl;
     } else {
       wto << (e_is_void ? " { } // No default " : " { return 0; } // No default ")
           << event.HumanName() << " code." << endl;
@@ -127,6 +131,12 @@ int lang_CPP::compile_writeDefraggedEvents(
   wto << "namespace enigma" << endl << "{" << endl;
 
   // Start by defining storage locations for our event lists to iterate.
+  // Generated object sources only link instances into them, so everything
+  // past their declarations is left to SHELLmain.
+  wto << "#ifdef ENIGMA_CODEGEN_SHARD" << endl;
+  for (const auto &event : used_events)
+    wto << "  extern event_iter *event_" << event.FunctionName() << ";" << endl;
+  wto << "#else" << endl;
   for (const auto &event : used_events)
     wto << "  event_iter *event_" << event.FunctionName() << ";" << endl;
 
@@ -195,7 +205,7 @@ int lang_CPP::compile_writeDefraggedEvents(
           wto << base_indent << "if (myevent_" << fname + "_supercheck())\n";
         }
       }
-      wto <<   base_indent << "  for (instance_event_iterator = event_" << fname << "->next; instance_event_iterator != NULL; instance_event_iterator = instance_event_iterator->next) {\n";
+      wto <<   base_indent << "  for (instance_event_iterator = event_" << fname << "->next; instance_event_iterator != NULL; instance_event_iterator = instance_event_iterator->next_after_code()) {\n";
       if (callsubcheck) {
         wto << base_indent << "    if (((enigma::event_parent*)(instance_event_iterator->inst))->myevent_" << fname << "_subcheck()) {\n";
       }
@@ -227,10 +237,10 @@ int lang_CPP::compile_writeDefraggedEvents(
     wto << "    if (keyboard_check_pressed(vk_f1)) show_info();" << endl;
   if (game.settings.shortcuts().let_f9_screenshot())
     wto << "    if (keyboard_check_pressed(vk_f9)) {}" << endl;   //TODO: Screenshot function
-  if (game.settings.shortcuts().let_f5_save_f6_load())  //TODO: uncomment after game save and load fucntions implemented
+  if (game.settings.shortcuts().let_f5_save_f6_load())
   {
-    wto << "    //if (keyboard_check_pressed(vk_f5)) game_save('_save" << game.settings.general().game_id() << ".sav');" << endl;
-    wto << "    //if (keyboard_check_pressed(vk_f6)) game_load('_save" << game.settings.general().game_id() << ".sav');" << endl;
+    wto << "    if (keyboard_check_pressed(vk_f5)) game_save(\"_save" << game.settings.general().game_id() << ".sav\");" << endl;
+    wto << "    if (keyboard_check_pressed(vk_f6)) game_load(\"_save" << game.settings.general().game_id() << ".sav\");" << endl;
   }
   // Handle room switching/game restart.
   wto << "    enigma::dispose_destroyed_instances();" << endl;
@@ -239,6 +249,7 @@ int lang_CPP::compile_writeDefraggedEvents(
   wto << "    " << endl;
   wto << "    return 0;" << endl;
   wto << "  } // event function" << endl;
+  wto << "#endif" << endl;
 
   // Done, end the namespace
   wto << "} // namespace enigma" << endl;
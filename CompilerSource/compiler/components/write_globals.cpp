@@ -61,24 +61,35 @@ static string esc(const string &str) {
 int lang_CPP::compile_writeGlobals(const GameData &game,
                                    const ParsedScope* global,
                                    const DotLocalMap &dot_accessed_locals) {
-  ofstream wto;
+  codegen_ofstream wto;
   wto.open((codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_globals.h").u8string().c_str(),ios_base::out);
   wto << license;
 
+  // Generated game sources include this file as well; they get declarations
+  // only, and SHELLmain keeps the one definition of everything.
   global_script_argument_count=16; //write all 16 arguments
   if (global_script_argument_count) {
     wto << "// Script arguments\n";
+    wto << "#ifdef ENIGMA_CODEGEN_SHARD\n";
+    wto << "extern variant argument0";
+    for (int i = 1; i < global_script_argument_count; i++)
+      wto << ", argument" << i;
+    wto << ";\n";
+    wto << "#else\n";
     wto << "variant argument0 = 0";
     for (int i = 1; i < global_script_argument_count; i++)
       wto << ", argument" << i << " = 0";
-    wto << ";\n\n";
+    wto << ";\n";
+    wto << "#endif\n\n";
   }
 
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD" << endl;
   wto << "namespace enigma_user { " << endl;
   //wto << "  string working_directory = \"\";" << endl; // moved over to PFmain.h
   wto << "  unsigned int game_id = " << game.settings.general().game_id() << ";"
       << endl;
-  wto << "}" << endl <<endl;
+  wto << "}" << endl;
+  wto << "#endif" << endl << endl;
 
   wto << "namespace enigma_user {" << endl;
   for (size_t i = 0; i < game.constants.size(); i++) {
@@ -92,6 +103,7 @@ int lang_CPP::compile_writeGlobals(const GameData &game,
   const auto &wsets = game.settings.windowing();
   const auto &gameInfo = game.gameInfo;
 
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD" << endl;
   wto << "//Default variable type: \"undefined\" or \"real\"" << endl;
   wto << "const int variant::default_type = "
       << (csets.treat_uninitialized_vars_as_zero()
@@ -123,9 +135,15 @@ int lang_CPP::compile_writeGlobals(const GameData &game,
   wto << "  bool gameInfoStayOnTop = " << gameInfo.stay_on_top() << ";" << endl;
   wto << "  bool gameInfoPauseGame = " << gameInfo.pause_game() << ";" << endl;
   wto << "}" << endl;
+  wto << "#endif" << endl << endl;
 
+  wto << "#ifdef ENIGMA_CODEGEN_SHARD" << endl;
+  for (parsed_object::cglobit i = global->globals.begin(); i != global->globals.end(); i++)
+    wto << "extern " << i->second.type << " " << i->second.prefix << i->first << i->second.suffix << ";" << endl;
+  wto << "#else" << endl;
   for (parsed_object::cglobit i = global->globals.begin(); i != global->globals.end(); i++)
     wto << i->second.type << " " << i->second.prefix << i->first << i->second.suffix << ";" << endl;
+  wto << "#endif" << endl;
   //This part needs written into a global object_parent class instance elsewhere.
   //for (globit i = global->dots.begin(); i != global->globals.end(); i++)
   //  wto << i->second->type << " " << i->second->prefixes << i->second->name << i->second->suffixes << ";" << endl;
@@ -135,7 +153,28 @@ int lang_CPP::compile_writeGlobals(const GameData &game,
   for (decciter i = dot_accessed_locals.begin(); i != dot_accessed_locals.end(); i++) // Dots are vars that are accessed as something.varname.
     wto << "    " << i->second.type << " " << i->second.prefix << i->first << i->second.suffix << ";" << endl;
 
-  wto << "    ENIGMA_global_structure(const int _x, const int _y): object_locals(_x,_y) {}" << endl << "  };" << endl << "  object_basic *ENIGMA_global_instance = new ENIGMA_global_structure(global,global);" << endl << "}";
+  wto << "    ENIGMA_global_structure(const int _x, const int _y): object_locals(_x,_y) {}" << endl;
+  // The global instance is only a home for global.* variables, so those are all it saves.
+  wto << "    void $snapshot(snapshot_io &enigma_snapshot_io) {" << endl;
+  for (decciter i = dot_accessed_locals.begin(); i != dot_accessed_locals.end(); i++)
+    if (i->second.prefix.find('*') == string::npos)
+      wto << "      enigma_snapshot_io(" << i->first << ");" << endl;
+  wto << "    }" << endl;
+  wto << "  };" << endl;
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD" << endl;
+  wto << "  object_basic *ENIGMA_global_instance = new ENIGMA_global_structure(global,global);" << endl << endl;
+
+  // Everything game_save keeps that isn't in an instance or a registered section.
+  wto << "  void snapshot_globals(snapshot_io &enigma_snapshot_io) {" << endl;
+  wto << "    enigma_snapshot_io(enigma_user::score);" << endl;
+  wto << "    enigma_snapshot_io(enigma_user::health);" << endl;
+  wto << "    enigma_snapshot_io(enigma_user::lives);" << endl;
+  for (parsed_object::cglobit i = global->globals.begin(); i != global->globals.end(); i++)
+    if (i->second.prefix.find('*') == string::npos)
+      wto << "    enigma_snapshot_io(::" << i->first << ");" << endl;
+  wto << "    ENIGMA_global_instance->$snapshot(enigma_snapshot_io);" << endl;
+  wto << "  }" << endl;
+  wto << "#endif" << endl << "}";
   wto << endl;
   wto.close();
   return 0;
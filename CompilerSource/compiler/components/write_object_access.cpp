@@ -68,16 +68,24 @@ string REFERENCE_POSTFIX(string ref) {
 struct usedtype { int uc; dectrip original; usedtype(): uc(0) {} }; // uc is the use count, then after polling, the dummy number.
 int lang_CPP::compile_writeObjAccess(const ParsedObjectVec &parsed_objects, const DotLocalMap &dot_accessed_locals, const ParsedScope *global, bool treatUninitAs0)
 {
-  ofstream wto;
+  codegen_ofstream wto;
   wto.open((codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_objectaccess.h").u8string().c_str(),ios_base::out);
   wto << license;
   wto << "// Depending on how many times your game accesses variables via OBJECT.varname, this file may be empty." << endl << endl;
   wto << "namespace enigma" << endl << "{" << endl;
 
+  // Generated game sources only need to be able to call the accessors.
+  wto << "#ifdef ENIGMA_CODEGEN_SHARD" << endl;
+  wto << "  object_locals *glaccess(int x);" << endl;
+  wto << "  var &map_var(std::map<string, var> **vmap, string str);" << endl;
+  for (auto dait = dot_accessed_locals.begin(); dait != dot_accessed_locals.end(); dait++)
+    wto << "  " << dait->second.type << " " << dait->second.prefix << REFERENCE_POSTFIX(dait->second.suffix) << " &varaccess_" << dait->first << "(int x);" << endl;
+  wto << "#else" << endl;
+
   wto <<
   "  object_locals ldummy;" << endl <<
   "  object_locals *glaccess(int x)" << endl <<
-  "  {" << endl << "    object_locals* ri = (object_locals*)fetch_instance_by_int(x);" << endl << "    return ri ? ri : &ldummy;" << endl << "  }" << endl << endl;
+  "  {" << endl << "    object_locals* ri = (object_locals*)fetch_instance_by_int(x);" << endl << "    note_instance_changed(ri);" << endl << "    return ri ? ri : &ldummy;" << endl << "  }" << endl << endl;
 
   wto <<
   "  var &map_var(std::map<string, var> **vmap, string str)" << endl <<
@@ -141,6 +149,7 @@ int lang_CPP::compile_writeObjAccess(const ParsedObjectVec &parsed_objects, cons
     wto << "    return dummy_" << usedtypes[dait->second.type + " " + dait->second.prefix + dait->second.suffix].uc << ";" << endl;
     wto << "  }" << endl;
   }
+  wto << "#endif" << endl;
   wto << "} // namespace enigma" << endl;
   wto.close();
   return 0;
@@ -30,6 +30,8 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <filesystem>
+#include <set>
 #include <vector>
 
 using namespace std;
@@ -83,6 +85,13 @@ static inline void declare_extension_casts(std::ostream &wto,
     const ParsedExtensionVec &parsed_extensions) {
   // Write extension cast methods; these are a temporary fix until the new instance system is in place.
   wto << "  namespace extension_cast {\n";
+  wto << "#ifdef ENIGMA_CODEGEN_SHARD\n";
+  for (unsigned i = 0; i < parsed_extensions.size(); i++) {
+    if (!parsed_extensions[i].implements.empty()) {
+      wto << "    " << parsed_extensions[i].implements << " *as_" << parsed_extensions[i].implements << "(object_basic* x);\n";
+    }
+  }
+  wto << "#else\n";
   for (unsigned i = 0; i < parsed_extensions.size(); i++) {
     if (!parsed_extensions[i].implements.empty()) {
       wto << "    " << parsed_extensions[i].implements << " *as_" << parsed_extensions[i].implements << "(object_basic* x) {\n";
@@ -90,12 +99,12 @@ static inline void declare_extension_casts(std::ostream &wto,
       wto << "    }\n";
     }
   }
+  wto << "#endif\n";
   wto << "  }\n";
 }
 
 static inline void declare_object_locals_class(std::ostream &wto,
     const ParsedExtensionVec &parsed_extensions) {
-  wto << "  extern std::map<int,object_basic*> instance_deactivated_list;\n";
   wto << "  extern objectstruct** objectdata;\n\n";
 
   wto << "  struct object_locals: event_parent";
@@ -112,7 +121,16 @@ static inline void declare_object_locals_class(std::ostream &wto,
   wto << "    #include \"Preprocessor_Environment_Editable/IDE_EDIT_inherited_locals.h\"\n\n";
   wto << "    std::map<string, var> *vmap;\n";
   wto << "    object_locals() {vmap = NULL;}\n";
-  wto << "    object_locals(unsigned _x, int _y): event_parent(_x,_y) {vmap = NULL;}\n";
+  wto << "    object_locals(unsigned _x, int _y): event_parent(_x,_y) {vmap = NULL;}\n\n";
+  wto << "    void $snapshot(snapshot_io &enigma_snapshot_io) {\n";
+  wto << "      event_parent::$snapshot(enigma_snapshot_io);\n";
+  for (unsigned i = 0; i < parsed_extensions.size(); i++) {
+    if (!parsed_extensions[i].implements.empty()) {
+      wto << "      snapshot_extension(enigma_snapshot_io, static_cast<"
+          << parsed_extensions[i].implements << "&>(*this));\n";
+    }
+  }
+  wto << "    }\n";
   wto << "  };\n";
 }
 
@@ -212,9 +230,12 @@ static inline bool parent_declares(parsed_object *parent, const deciter decl) {
   return false;
 }
 
-static void write_object_locals(language_adapter *lang, std::ostream &wto,
-                                const ParsedScope *global,
-                                parsed_object *object) {
+// Declares the locals this object adds to its parent's, and returns them so
+// the rest of the class can refer to the same list.
+static vector<deciter> write_object_locals(language_adapter *lang, std::ostream &wto,
+                                           const ParsedScope *global,
+                                           parsed_object *object) {
+  vector<deciter> declared;
   wto << "    // Local variables\n    ";
   for (const ParsedEvent &pev : object->all_events) {
     string addls = pev.ev_id.LocalDeclarations();
@@ -245,8 +266,10 @@ static void write_object_locals(language_adapter *lang, std::ostream &wto,
     if (writeit) {
       wto << tdefault(ii->second.type) << " " << ii->second.prefix << ii->first
           << ii->second.suffix << ";\n    ";
+      declared.push_back(ii);
     }
   }
+  return declared;
 }
 
 static inline void write_object_scripts(std::ostream &wto, parsed_object *object, const CompileState &state) {
@@ -351,6 +374,9 @@ static void write_object_events(std::ostream &wto, parsed_object *object) {
       if (pev.ev_id.HasSubCheck()) {
         wto << "    inline bool myevent_" << evname << "_subcheck();\n";
       }
+      if (!pev.code.empty() && pev.ev_id.HasReplaceableDefaultCode()) {
+        wto << "    bool myevent_" << evname << "_is_default() { return false; }\n";
+      }
     }
   }
 }
@@ -578,21 +604,15 @@ static void write_object_destructor(std::ostream &wto, parsed_object *object) {
 
   if (!object->parent) {
     wto << "      delete vmap;\n";
-    wto << "      enigma::winstance_list_iterator_delete(ENOBJ_ITER_me);\n";
-    for (parsed_object *obj = object; obj; obj = obj->parent) {
-      wto << "      delete ENOBJ_ITER_myobj" << obj->id << ";\n";
-    }
-  } else {
-    wto << "      delete ENOBJ_ITER_myobj" << object->id << ";\n";
   }
+  // Our instance, object and event list nodes were tombstoned when we were
+  // unlinked; the instance system reclaims them in dispose_destroyed_instances.
   for (const ParsedEventGroup &group : object->registered_events) {
     const EventGroupKey &event = group.event_key;
     if (object->InheritsAny(event)) continue;
     if (event.HasIteratorDeleteCode()) {
       if (!iscomment(event.IteratorDeleteCode()))
         wto << "      " << event.IteratorDeleteCode() << ";\n";
-    } else {
-      wto << "      delete ENOBJ_ITER_myevent_" << event.FunctionName() << ";\n";
     }
   }
   wto << "    }\n";
@@ -601,6 +621,23 @@ static void write_object_destructor(std::ostream &wto, parsed_object *object) {
   wto << "    virtual bool can_cast(int obj) const;\n";
 }
 
+// Saves/restores the locals declared in this class on top of the parent's; see
+// Universal_System/snapshot.h. Pointers are left alone.
+static void write_object_snapshot(std::ostream &wto, parsed_object *object,
+                                  const vector<deciter> &locals) {
+  wto << "    \n    void $snapshot(enigma::snapshot_io &enigma_snapshot_io)\n    {\n";
+  if (object->parent) {
+    wto << "      OBJ_" << object->parent->name << "::$snapshot(enigma_snapshot_io);\n";
+  } else {
+    wto << "      object_locals::$snapshot(enigma_snapshot_io);\n";
+  }
+  for (const deciter &local : locals) {
+    if (local->second.prefix.find('*') != string::npos) continue;
+    wto << "      enigma_snapshot_io(" << local->first << ");\n";
+  }
+  wto << "    }\n";
+}
+
 static void write_object_class_body(parsed_object* object, language_adapter *lang, std::ostream &wto, const GameData &game, const CompileState &state) {
   wto << "  \n  struct OBJ_" << object->name;
   if (object->parent) {
@@ -610,7 +647,8 @@ static void write_object_class_body(parsed_object* object, language_adapter *lan
   }
   wto << "\n  {\n";
 
-  write_object_locals(lang, wto, &state.global_object, object);
+  const vector<deciter> locals =
+      write_object_locals(lang, wto, &state.global_object, object);
   write_object_scripts(wto, object, state);
   write_object_timelines(wto, game, object, state.timeline_lookup);
   write_object_events(wto, object);
@@ -620,6 +658,7 @@ static void write_object_class_body(parsed_object* object, language_adapter *lan
   write_object_unlink(wto, object);
   write_object_constructors(wto, object);
   write_object_destructor(wto, object);
+  write_object_snapshot(wto, object, locals);
 
   wto << "  };\n";
 }
@@ -674,11 +713,12 @@ static inline void write_object_data_structs(std::ostream &wto,
 // -----------------------------------------------------------------------------
 static inline void write_object_declarations(
     lang_CPP* lcpp, const GameData &game, const CompileState &state) {
-  ofstream wto;
+  codegen_ofstream wto;
   wto.open(codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_objectdeclarations.h",ios_base::out);
   wto << license;
   wto << "#include \"Universal_System/Object_Tiers/collisions_object.h\"\n";
-  wto << "#include \"Universal_System/Object_Tiers/object.h\"\n\n";
+  wto << "#include \"Universal_System/Object_Tiers/object.h\"\n";
+  wto << "#include \"Universal_System/snapshot.h\"\n\n";
   wto << "#include <map>";
 
   declare_scripts(wto, game, state);
@@ -696,44 +736,111 @@ static inline void write_object_declarations(
   write_object_class_bodies(lcpp, wto, game, state);
   wto << "}\n\n";
 
+  wto << "#ifndef ENIGMA_CODEGEN_SHARD\n";
   wto << "namespace enigma {\n";
   write_object_data_structs(wto, state.parsed_objects);
   wto << "}\n";
+  wto << "#endif\n";
   wto.close();
 }
 
-static inline void write_script_implementations(ofstream& wto, const GameData &game, const CompileState &state, int mode);
-static inline void write_timeline_implementations(ofstream& wto, const GameData &game, const CompileState &state);
-static inline void write_event_bodies(ofstream& wto, const GameData &game, int mode, const ParsedObjectVec &parsed_objects, const ScriptLookupMap &script_lookup, const TimelineLookupMap &timeline_lookup);
-static inline void write_global_script_array(ofstream &wto, const GameData &game, const CompileState &state);
-static inline void write_basic_constructor(ofstream &wto);
+static inline void write_script_implementations(std::ostream &wto, const GameData &game, const CompileState &state, int mode, size_t first, size_t last);
+static inline void write_timeline_implementations(std::ostream &wto, const TimelineLookupMap::value_type &tline);
+static inline void write_event_bodies(std::ostream &wto, const GameData &game, int mode, const parsed_object *obj, const ScriptLookupMap &script_lookup, const TimelineLookupMap &timeline_lookup);
+static inline void write_global_script_array(std::ostream &wto, const GameData &game, const CompileState &state);
+static inline void write_basic_constructor(std::ostream &wto);
 
-// [ CODEGEN FILE ] ------------------------------------------------------------
+// Scripts are small and plentiful, so they are grouped to keep the number of
+// translation units (each of which has to parse SHELLmain.h) in check.
+static const size_t scripts_per_shard = 32;
+
+// Helpers for the parsed code, which uses them in place of the ^^ operator.
+static inline void write_log_xor_helpers(std::ostream &wto) {
+  wto << endl << "#define log_xor || log_xor_helper() ||" << endl;
+  wto << "struct log_xor_helper { bool value; };" << endl;
+  wto << "template<typename LEFT> log_xor_helper operator ||(const LEFT &left, const log_xor_helper &xorh) { log_xor_helper nxor; nxor.value = (bool)left; return nxor; }" << endl;
+  wto << "template<typename RIGHT> bool operator ||(const log_xor_helper &xorh, const RIGHT &right) { return xorh.value ^ (bool)right; }" << endl << endl;
+}
+
+// The one include of every generated game source: SHELLmain.h with the
+// codegen headers reduced to declarations, plus helpers for the parsed code.
+static inline void write_shard_header() {
+  codegen_ofstream wto(codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_shard.h");
+  wto << license;
+  wto << "#define INCLUDED_FROM_SHELLMAIN 1\n";
+  wto << "#define ENIGMA_CODEGEN_SHARD 1\n\n";
+  wto << "#include \"SHELLmain.h\"\n";
+  write_log_xor_helpers(wto);
+}
+
+// [ CODEGEN FILES ] -----------------------------------------------------------
 // Object functionality: implements event routines and scripts declared earlier.
+// With setting::shard_codegen, every object, script group and timeline gets its
+// own source under Shards/, which is only rewritten when its text changes; make
+// then rebuilds just the edited resources, in parallel. Each of those sources
+// sees the game's Definitions, so that is opt-in. Otherwise all of it goes to
+// IDE_EDIT_objectfunctionality.h, compiled once as part of SHELLmain. Either way
+// SHELLmain keeps the script table and the universal constructor.
 // -----------------------------------------------------------------------------
 static inline void write_object_functionality(
     const GameData &game, const CompileState &state, int mode) {
-  vector<unsigned> parent_undefined;
-  ofstream wto((codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_objectfunctionality.h").u8string().c_str(),ios_base::out);
+  const std::filesystem::path shard_dir =
+      codegen_directory/"Preprocessor_Environment_Editable/Shards";
+  std::filesystem::create_directories(shard_dir);
 
+  codegen_ofstream wto(codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_objectfunctionality.h");
   wto << license;
-  wto << endl << "#define log_xor || log_xor_helper() ||" << endl;
-  wto << "struct log_xor_helper { bool value; };" << endl;
-  wto << "template<typename LEFT> log_xor_helper operator ||(const LEFT &left, const log_xor_helper &xorh) { log_xor_helper nxor; nxor.value = (bool)left; return nxor; }" << endl;
-  wto << "template<typename RIGHT> bool operator ||(const log_xor_helper &xorh, const RIGHT &right) { return xorh.value ^ (bool)right; }" << endl << endl;
 
-  write_script_implementations(wto, game, state, mode);
-  write_timeline_implementations(wto, game, state);
-  write_event_bodies(wto, game, mode, state.parsed_objects, state.script_lookup, state.timeline_lookup);
+  set<string> shards;
+  if (setting::shard_codegen) {
+    write_shard_header();
+    auto open_shard = [&](codegen_ofstream &shard, const string &name) {
+      shards.insert(name + ".cpp");
+      shard.open(shard_dir/(name + ".cpp"));
+      shard << license;
+      shard << "#include \"Preprocessor_Environment_Editable/IDE_EDIT_shard.h\"\n\n";
+    };
+
+    for (size_t first = 0; first < game.scripts.size(); first += scripts_per_shard) {
+      codegen_ofstream shard;
+      open_shard(shard, "SCR_" + std::to_string(first / scripts_per_shard));
+      write_script_implementations(shard, game, state, mode, first,
+          std::min(first + scripts_per_shard, game.scripts.size()));
+    }
+    for (const auto &tline : state.timeline_lookup) {
+      codegen_ofstream shard;
+      open_shard(shard, "TLINE_" + tline.first);
+      write_timeline_implementations(shard, tline);
+    }
+    for (const auto *obj : state.parsed_objects) {
+      codegen_ofstream shard;
+      open_shard(shard, "OBJ_" + obj->name);
+      write_event_bodies(shard, game, mode, obj, state.script_lookup, state.timeline_lookup);
+    }
+  } else {
+    write_log_xor_helpers(wto);
+    write_script_implementations(wto, game, state, mode, 0, game.scripts.size());
+    for (const auto &tline : state.timeline_lookup)
+      write_timeline_implementations(wto, tline);
+    for (const auto *obj : state.parsed_objects)
+      write_event_bodies(wto, game, mode, obj, state.script_lookup, state.timeline_lookup);
+  }
+
+  // Whatever else is in there belongs to a resource that has since been
+  // removed or renamed, or to a sharded build, and would otherwise still be
+  // picked up by make.
+  for (const auto &entry : std::filesystem::directory_iterator(shard_dir)) {
+    if (entry.path().extension() == ".cpp" && !shards.count(entry.path().filename().u8string()))
+      std::filesystem::remove(entry.path());
+  }
+
   write_global_script_array(wto, game, state);
   write_basic_constructor(wto);
-
-  wto.close();
 }
 
-static inline void write_script_implementations(ofstream& wto, const GameData &game, const CompileState &state, int mode) {
+static inline void write_script_implementations(std::ostream &wto, const GameData &game, const CompileState &state, int mode, size_t first, size_t last) {
   // Export globalized scripts
-  for (size_t i = 0; i < game.scripts.size(); i++) {
+  for (size_t i = first; i < last; i++) {
     ParsedScript* scr = state.script_lookup.at(game.scripts[i].name);
     const char* comma = "";
     wto << "variant _SCR_" << game.scripts[i].name << "(";
@@ -765,61 +872,56 @@ static inline void write_script_implementations(ofstream& wto, const GameData &g
   }
 }
 
-static inline void write_timeline_implementations(ofstream& wto, const GameData &game, const CompileState &state) {
+static inline void write_timeline_implementations(std::ostream &wto, const TimelineLookupMap::value_type &tline) {
   // Export globalized timelines.
   // TODO: Is there such a thing as a localized timeline?
-  (void) game;  // XXX: why the hell is this needed for everything but timelines?
-  for (const auto &tline : state.timeline_lookup) {\
-    for (const auto &moment : tline.second.moments) {
-      wto << "void TLINE_" << tline.first << "_MOMENT_" << moment.step << "() {\n";
-      ParsedCode& upev = moment.script->global_code
-          ? *moment.script->global_code : moment.script->code;
-
-      string override_code, override_synt;
-      if (upev.code.compare(0, 12, "with((self))") == 0) {
-        override_code = upev.code.substr(12);
-        override_synt = upev.synt.substr(12);
-      }
-      print_to_file(
-          override_code.empty() ? upev.code : override_code,
-          override_synt.empty() ? upev.synt : override_synt,
-          upev.strc,
-          upev.strs,
-          2, wto);
-      wto << "\n}\n\n";
+  for (const auto &moment : tline.second.moments) {
+    wto << "void TLINE_" << tline.first << "_MOMENT_" << moment.step << "() {\n";
+    ParsedCode& upev = moment.script->global_code
+        ? *moment.script->global_code : moment.script->code;
+
+    string override_code, override_synt;
+    if (upev.code.compare(0, 12, "with((self))") == 0) {
+      override_code = upev.code.substr(12);
+      override_synt = upev.synt.substr(12);
     }
+    print_to_file(
+        override_code.empty() ? upev.code : override_code,
+        override_synt.empty() ? upev.synt : override_synt,
+        upev.strc,
+        upev.strs,
+        2, wto);
+    wto << "\n}\n\n";
   }
 }
 
-static void write_event_func(ofstream& wto, const ParsedEvent &event, string objname, string evname, int mode);
-static void write_object_event_funcs(ofstream& wto, const parsed_object *const object, int mode);
-static void write_object_script_funcs(ofstream& wto, const parsed_object *const t, const ScriptLookupMap &script_lookup);
-static void write_object_timeline_funcs(ofstream& wto, const GameData &game, const parsed_object *const t, const TimelineLookupMap &timeline_lookup);
-static void write_can_cast_func(ofstream& wto, const parsed_object *const pobj);
+static void write_event_func(std::ostream &wto, const ParsedEvent &event, string objname, string evname, int mode);
+static void write_object_event_funcs(std::ostream &wto, const parsed_object *const object, int mode);
+static void write_object_script_funcs(std::ostream &wto, const parsed_object *const t, const ScriptLookupMap &script_lookup);
+static void write_object_timeline_funcs(std::ostream &wto, const GameData &game, const parsed_object *const t, const TimelineLookupMap &timeline_lookup);
+static void write_can_cast_func(std::ostream &wto, const parsed_object *const pobj);
 
 static void write_event_bodies(
-    ofstream& wto, const GameData &game, int mode,
-    const ParsedObjectVec &parsed_objects, const ScriptLookupMap &script_lookup,
+    std::ostream &wto, const GameData &game, int mode,
+    const parsed_object *obj, const ScriptLookupMap &script_lookup,
     const TimelineLookupMap &timeline_lookup) {
-  for (const auto *obj : parsed_objects) {
-    // Write infrastructure to trigger grouped events (stacked/dispatched)
-    implement_event_groups(wto, obj);
+  // Write infrastructure to trigger grouped events (stacked/dispatched)
+  implement_event_groups(wto, obj);
 
-    // Write the user-defined event implementations.
-    write_object_event_funcs(wto, obj, mode);
+  // Write the user-defined event implementations.
+  write_object_event_funcs(wto, obj, mode);
 
-    // Write local object copies of scripts
-    write_object_script_funcs(wto, obj, script_lookup);
+  // Write local object copies of scripts
+  write_object_script_funcs(wto, obj, script_lookup);
 
-    // Write local object copies of timelines
-    write_object_timeline_funcs(wto, game, obj, timeline_lookup);
+  // Write local object copies of timelines
+  write_object_timeline_funcs(wto, game, obj, timeline_lookup);
 
-    //Write the required "can_cast()" function.
-    write_can_cast_func(wto, obj);
-  }
+  //Write the required "can_cast()" function.
+  write_can_cast_func(wto, obj);
 }
 
-static void write_object_event_funcs(ofstream& wto, const parsed_object *const object, int mode) {
+static void write_object_event_funcs(std::ostream &wto, const parsed_object *const object, int mode) {
   for (const ParsedEvent &event : object->all_events) {
     string evname = event.ev_id.TrueFunctionName();
 
@@ -858,7 +960,7 @@ static void write_object_event_funcs(ofstream& wto, const parsed_object *const o
   }
 }
 
-static void write_event_func(ofstream& wto, const ParsedEvent &event, string objname, string evname, int mode) {
+static void write_event_func(std::ostream &wto, const ParsedEvent &event, string objname, string evname, int mode) {
   std::string evfuncname = "myevent_" + evname;
   wto << "variant enigma::OBJ_" << objname << "::" << evfuncname << "()\n{\n";
   if (mode == emode_debug) {
@@ -874,7 +976,7 @@ static void write_event_func(ofstream& wto, const ParsedEvent &event, string obj
   wto << "\n  return 0;\n}\n\n";
 }
 
-static inline void write_object_script_funcs(ofstream& wto, const parsed_object *const t, const ScriptLookupMap &script_lookup) {
+static inline void write_object_script_funcs(std::ostream &wto, const parsed_object *const t, const ScriptLookupMap &script_lookup) {
   for (parsed_object::const_funcit it = t->funcs.begin(); it != t->funcs.end(); ++it) { // For each function called by this object
     auto subscr = script_lookup.find(it->first); // Check if it's a script
     if (subscr != script_lookup.end() // If we've got ourselves a script
@@ -894,8 +996,8 @@ static inline void write_object_script_funcs(ofstream& wto, const parsed_object
   }
 }
 
-static inline void write_known_timelines(ofstream& wto, const GameData &game, const parsed_object *const t, const TimelineLookupMap &timeline_lookup);
-static inline void write_object_timeline_funcs(ofstream& wto, const GameData &game, const parsed_object *const t, const TimelineLookupMap &timeline_lookup) {
+static inline void write_known_timelines(std::ostream &wto, const GameData &game, const parsed_object *const t, const TimelineLookupMap &timeline_lookup);
+static inline void write_object_timeline_funcs(std::ostream &wto, const GameData &game, const parsed_object *const t, const TimelineLookupMap &timeline_lookup) {
   bool hasKnownTlines = false;
   for (parsed_object::const_tlineit it = t->tlines.begin(); it != t->tlines.end(); ++it) { //For each timeline potentially set by this object
     auto timit = timeline_lookup.find(it->first); //Check if it's a timeline
@@ -919,7 +1021,7 @@ static inline void write_object_timeline_funcs(ofstream& wto, const GameData &ga
   }
 }
 
-static inline void write_known_timelines(ofstream& wto, const GameData &game, const parsed_object *const t, const TimelineLookupMap &timeline_lookup) {
+static inline void write_known_timelines(std::ostream &wto, const GameData &game, const parsed_object *const t, const TimelineLookupMap &timeline_lookup) {
   (void) game;  // XXX: why the hell is this needed for everything but timelines?
   wto << "void enigma::OBJ_" << t->name << "::timeline_call_moment_script(int timeline_index, int moment_index) {\n";
   wto << "  switch (timeline_index) {\n";
@@ -946,7 +1048,7 @@ static inline void write_known_timelines(ofstream& wto, const GameData &game, co
   wto << "}\n\n";
 }
 
-static inline void write_can_cast_func(ofstream& wto, const parsed_object *const pobj) {
+static inline void write_can_cast_func(std::ostream &wto, const parsed_object *const pobj) {
   wto << "bool enigma::OBJ_" << pobj->name << "::can_cast(int obj) const {\n";
   bool written = false;
   wto << "  return ";
@@ -959,7 +1061,7 @@ static inline void write_can_cast_func(ofstream& wto, const parsed_object *const
   wto << ";\n" << "}\n\n";
 }
 
-static inline void write_global_script_array(ofstream &wto, const GameData &game, const CompileState &state) {
+static inline void write_global_script_array(std::ostream &wto, const GameData &game, const CompileState &state) {
   wto << "namespace enigma\n{\n"
   "  std::vector<callable_script> callable_scripts = {\n";
   int scr_count = 0;
@@ -977,7 +1079,7 @@ static inline void write_global_script_array(ofstream &wto, const GameData &game
   wto << "  };\n  \n";
 }
 
-static inline void write_basic_constructor(ofstream &wto) {
+static inline void write_basic_constructor(std::ostream &wto) {
   wto <<
       "  void constructor(object_basic* instance_b) {\n"
       "    //This is the universal create event code\n"
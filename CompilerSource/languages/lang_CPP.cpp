@@ -71,6 +71,7 @@ void lang_CPP::load_extension_locals() {
 
 #include "settings-parse/parse_ide_settings.h"
 #include "settings-parse/crawler.h"
+#include "compiler/compile_common.h"
 
 #include <System/builtins.h>
 
@@ -88,8 +89,11 @@ syntax_error *lang_CPP::definitionsModified(const char* wscode, const char* targ
   main_context = new jdi::context();
   
   cout << "Dumping whiteSpace definitions..." << endl;
-  FILE *of = wscode ? fopen((codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_whitespace.h").u8string().c_str(),"wb") : NULL;
-  if (of) fputs(wscode,of), fclose(of);
+  if (wscode) {
+    // Left alone when unchanged, so a rebuild doesn't recompile everything that includes it
+    codegen_ofstream wto(codegen_directory/"Preprocessor_Environment_Editable/IDE_EDIT_whitespace.h");
+    wto << wscode;
+  }
   
   cout << "Opening ENIGMA for parse..." << endl;
   
@@ -170,8 +174,6 @@ syntax_error *lang_CPP::definitionsModified(const char* wscode, const char* targ
   return &ide_passback_error;
 }
 
-#include "compiler/compile_common.h"
-
 int lang_CPP::load_shared_locals() {
   cout << "Finding parent..."; fflush(stdout);
 
@@ -47,7 +47,7 @@ using namespace std;
 inline string fc(const char* fn);
 static void reset_ide_editables()
 {
-  ofstream wto;
+  codegen_ofstream wto;
   string f2comp = fc((codegen_directory/"API_Switchboard.h").u8string().c_str());
   string f2write = license;
     string inc = "/include.h\"\n";
@@ -83,16 +83,7 @@ static void reset_ide_editables()
     wto << "/***************\nEnd optional libs\n ***************/\n";
   wto.close();
 
-  wto.open((codegen_directory/"Preprocessor_Environment_Editable/GAME_SETTINGS.h").c_str(),ios_base::out);
-    wto << license;
-    wto << "#define ASSUMEZERO 0\n";
-    wto << "#define PRIMBUFFER 0\n";
-    wto << "#define PRIMDEPTH2 6\n";
-    wto << "#define AUTOLOCALS 0\n";
-    wto << "#define MODE3DVARS 0\n";
-    wto << "void ABORT_ON_ALL_ERRORS() { }\n";
-    wto << '\n';
-  wto.close();
+  write_game_settings();
 }
 
 //#include "backend/ideprint.h"
@@ -137,6 +128,8 @@ void parse_ide_settings(const char* eyaml)
       setting::compliance_mode = setting::COMPL_STANDARD;
   }
   setting::automatic_semicolons   = settree.get("automatic-semicolons").toBool();
+  setting::resource_codec         = settree.get("resource-codec").toInt();
+  setting::shard_codegen          = settree.get("shard-codegen").toBool();
   setting::keyword_blacklist = settree.get("keyword-blacklist").toString();
 
   // Path to enigma sources
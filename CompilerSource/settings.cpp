@@ -50,6 +50,8 @@ namespace setting
   bool literal_autocast = 0; // Determines how literals are treated.                 0 = enigma::variant,   1 = C++ scalars
   bool inherit_objects = 0;  // Determines whether objects should automatically inherit locals and events from their parents
   bool automatic_semicolons = 0; // Determines whether semicolons should automatically be added or if the user wants strict syntax
+  int resource_codec = 0;        // How sprite and background pixels are compressed in the game.  0 = zlib, 1 = LZ4, 2 = zstd
+  bool shard_codegen = 0;        // Whether objects, scripts and timelines compile as separate sources; Definitions are then seen by each of them
   COMPLIANCE_LVL compliance_mode = COMPL_STANDARD;
   std::string keyword_blacklist = "";
 }
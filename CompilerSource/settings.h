@@ -73,6 +73,8 @@ namespace setting
   extern bool literal_autocast; // Determines how literals are treated.                 0 = enigma::variant,   1 = C++ scalars
   extern bool inherit_objects;  // Determines whether objects should automatically inherit locals and events from their parents
   extern bool automatic_semicolons; // Determines whether semicolons should automatically be added or if the user wants strict syntax
+  extern int resource_codec;        // How sprite and background pixels are compressed in the game.  0 = zlib, 1 = LZ4, 2 = zstd
+  extern bool shard_codegen;        // Whether objects, scripts and timelines compile as separate sources; Definitions are then seen by each of them
   extern COMPLIANCE_LVL compliance_mode; // How to resolve differences between GM versions.
   extern std::string keyword_blacklist; //Words to blacklist from user scripts, separated by commas.
 }
@@ -190,13 +190,8 @@ double distance_to_object(int object)
         if (inst2->sprite_index == -1 && (inst2->mask_index == -1))
             continue;
 
-        const enigma::BoundingBox &box2 = inst2->$bbox_relative();
-        const double x2 = inst2->x, y2 = inst2->y,
-                     xscale2 = inst2->image_xscale, yscale2 = inst2->image_yscale,
-                     ia2 = inst2->image_angle;
-        int left2, top2, right2, bottom2;
-
-        get_border(&left2, &right2, &top2, &bottom2, box2.left(), box2.top(), box2.right(), box2.bottom(), x2, y2, xscale2, yscale2, ia2);
+        const enigma::world_bbox &wb2 = inst2->$bbox_world();
+        const int left2 = wb2.left, top2 = wb2.top, right2 = wb2.right, bottom2 = wb2.bottom;
 
         const int right  = min(right1, right2),   left = max(left1, left2),
                   bottom = min(bottom1, bottom2), top  = max(top1, top2);
@@ -276,13 +271,8 @@ double move_contact_object(int object, double angle, double max_dist, bool solid
             continue;
         if (inst2->id == inst1->id || (solid_only && !inst2->solid))
             continue;
-        const enigma::BoundingBox &box2 = inst2->$bbox_relative();
-        const double x2 = inst2->x, y2 = inst2->y,
-                     xscale2 = inst2->image_xscale, yscale2 = inst2->image_yscale,
-                     ia2 = inst2->image_angle;
-        int left2, top2, right2, bottom2;
-
-        get_border(&left2, &right2, &top2, &bottom2, box2.left(), box2.top(), box2.right(), box2.bottom(), x2, y2, xscale2, yscale2, ia2);
+        const enigma::world_bbox &wb2 = inst2->$bbox_world();
+        const int left2 = wb2.left, top2 = wb2.top, right2 = wb2.right, bottom2 = wb2.bottom;
 
         if (right2 >= left1 && bottom2 >= top1 && left2 <= right1 && top2 <= bottom1)
         {
@@ -396,13 +386,8 @@ double move_outside_object(int object, double angle, double max_dist, bool solid
                 continue;
             if (inst2->sprite_index == -1 && (inst2->mask_index == -1))
                 continue;
-            const enigma::BoundingBox &box2 = inst2->$bbox_relative();
-            const double x2 = inst2->x, y2 = inst2->y,
-                         xscale2 = inst2->image_xscale, yscale2 = inst2->image_yscale,
-                         ia2 = inst2->image_angle;
-            int left2, top2, right2, bottom2;
-
-            get_border(&left2, &right2, &top2, &bottom2, box2.left(), box2.top(), box2.right(), box2.bottom(), x2, y2, xscale2, yscale2, ia2);
+            const enigma::world_bbox &wb2 = inst2->$bbox_world();
+            const int left2 = wb2.left, top2 = wb2.top, right2 = wb2.right, bottom2 = wb2.bottom;
 
             if (!(right2 >= left1 && bottom2 >= top1 && left2 <= right1 && top2 <= bottom1))
                 continue;
@@ -510,13 +495,8 @@ bool move_bounce_object(int object, bool adv, bool solid_only)
             continue;
         if (inst2->sprite_index == -1 && (inst2->mask_index == -1))
             continue;
-        const enigma::BoundingBox &box2 = inst2->$bbox_relative();
-        const double x2 = inst2->x, y2 = inst2->y,
-                     xscale2 = inst2->image_xscale, yscale2 = inst2->image_yscale,
-                     ia2 = inst2->image_angle;
-        int left2, top2, right2, bottom2;
-
-        get_border(&left2, &right2, &top2, &bottom2, box2.left(), box2.top(), box2.right(), box2.bottom(), x2, y2, xscale2, yscale2, ia2);
+        const enigma::world_bbox &wb2 = inst2->$bbox_world();
+        const int left2 = wb2.left, top2 = wb2.top, right2 = wb2.right, bottom2 = wb2.bottom;
 
         if (right2 >= left1 && bottom2 >= top1 && left2 <= right1 && top2 <= bottom1)
             return false;
@@ -756,13 +736,8 @@ void instance_deactivate_region(int rleft, int rtop, int rwidth, int rheight, bo
         if (inst->sprite_index == -1 && (inst->mask_index == -1)) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
-        const double x = inst->x, y = inst->y,
-        xscale = inst->image_xscale, yscale = inst->image_yscale,
-        ia = inst->image_angle;
-
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (left <= (rleft+rwidth) && rleft <= right && top <= (rtop+rheight) && rtop <= bottom) {
             if (inside) {
@@ -779,7 +754,7 @@ void instance_deactivate_region(int rleft, int rtop, int rwidth, int rheight, bo
 }
 
 void instance_activate_region(int rleft, int rtop, int rwidth, int rheight, bool inside) {
-    std::map<int,enigma::object_basic*>::iterator iter = enigma::instance_deactivated_list.begin();
+    enigma::instance_deactivated_list_iterator iter = enigma::instance_deactivated_list.begin();
     while (iter != enigma::instance_deactivated_list.end()) {
 
         enigma::object_collisions* const inst = (enigma::object_collisions*) iter->second;
@@ -789,13 +764,8 @@ void instance_activate_region(int rleft, int rtop, int rwidth, int rheight, bool
             continue;
         }
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
-        const double x = inst->x, y = inst->y,
-        xscale = inst->image_xscale, yscale = inst->image_yscale,
-        ia = inst->image_angle;
-
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         bool removed = false;
         if (left <= (rleft+rwidth) && rleft <= right && top <= (rtop+rheight) && rtop <= bottom) {
@@ -883,7 +853,7 @@ void instance_deactivate_circle(int x, int y, int r, bool inside, bool notme)
 
 void instance_activate_circle(int x, int y, int r, bool inside)
 {
-    std::map<int,enigma::object_basic*>::iterator iter = enigma::instance_deactivated_list.begin();
+    enigma::instance_deactivated_list_iterator iter = enigma::instance_deactivated_list.begin();
     while (iter != enigma::instance_deactivated_list.end()) {
         enigma::object_collisions* const inst = (enigma::object_collisions*) iter->second;
 
@@ -940,12 +910,8 @@ void position_change(cs_scalar x1, cs_scalar y1, int obj, bool perf)
         if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
-        const double x = inst->x, y = inst->y,
-                     xscale = inst->image_xscale, yscale = inst->image_yscale,
-                     ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (x1 >= left && x1 <= right && y1 >= top && y1 <= bottom)
             enigma::instance_change_inst(obj, perf, inst);
@@ -23,6 +23,7 @@
 #include "Universal_System/Object_Tiers/collisions_object.h"
 #include "Universal_System/Instances/instance_system.h" //iter
 #include "Universal_System/Instances/instance.h"
+#include "Collision_Systems/General/collisions_broadphase.h"
 
 #include "BBOXutil.h"
 #include "BBOXimpl.h"
@@ -63,6 +64,18 @@ static inline double min(double x, double y) { return x<y? x : y; }
 static inline int max(int x, int y) { return x>y? x : y; }
 static inline double max(double x, double y) { return x>y? x : y; }
 
+namespace enigma
+{
+    bool collision_bounds(const object_collisions *inst, int &left, int &top, int &right, int &bottom)
+    {
+        if (inst->sprite_index == -1 && inst->mask_index == -1)
+            return false;
+        const world_bbox &box = inst->$bbox_world();
+        left = box.left; top = box.top; right = box.right; bottom = box.bottom;
+        return true;
+    }
+}
+
 enigma::object_collisions* const collide_inst_inst(int object, bool solid_only, bool notme, double x, double y)
 {
     enigma::object_collisions* const inst1 = ((enigma::object_collisions*)enigma::instance_event_iterator->inst);
@@ -79,9 +92,9 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
 
     get_border(&left1, &right1, &top1, &bottom1, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale1, yscale1, ia1);
 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, left1, top1, right1, bottom1); it; ++it)
     {
-        enigma::object_collisions* const inst2 = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst2 = *it;
         if (notme && inst2->id == inst1->id)
             continue;
         if (solid_only && !inst2->solid)
@@ -89,12 +102,8 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
         if (inst2->sprite_index == -1 && inst2->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box2 = inst2->$bbox_relative();
-        const double x2 = inst2->x, y2 = inst2->y,
-                     xscale2 = inst2->image_xscale, yscale2 = inst2->image_yscale,
-                     ia2 = inst2->image_angle;
-        int left2, top2, right2, bottom2;
-        get_border(&left2, &right2, &top2, &bottom2, box2.left(), box2.top(), box2.right(), box2.bottom(), x2, y2, xscale2, yscale2, ia2);
+        const enigma::world_bbox &wb2 = inst2->$bbox_world();
+        const int left2 = wb2.left, top2 = wb2.top, right2 = wb2.right, bottom2 = wb2.bottom;
 
         if (left1 <= right2 && left2 <= right1 && top1 <= bottom2 && top2 <= bottom1)
             return inst2;
@@ -115,9 +124,9 @@ enigma::object_collisions* const collide_inst_rect(int object, bool solid_only,
         y1 = y3;
     }
 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x2, y2); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
             continue;
         if (solid_only && !inst->solid)
@@ -125,12 +134,8 @@ enigma::object_collisions* const collide_inst_rect(int object, bool solid_only,
          if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
-        const double x = inst->x, y = inst->y,
-                     xscale = inst->image_xscale, yscale = inst->image_yscale,
-                     ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (left <= x2 && x1 <= right && top <= y2 && y1 <= bottom)
             return inst;
@@ -144,9 +149,9 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
     if (x1 == x2 && y1 == y2)
         return collide_inst_point(object, solid_only, notme, x1, y1);
 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, min(x1, x2), min(y1, y2), max(x1, x2), max(y1, y2)); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
             continue;
         if (solid_only && !inst->solid)
@@ -154,12 +159,8 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
         if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
-        const double x = inst->x, y = inst->y,
-                     xscale = inst->image_xscale, yscale = inst->image_yscale,
-                     ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         double minX = max(min(x1,x2),left);
         double maxX = min(max(x1,x2),right);
@@ -202,9 +203,9 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
 
 enigma::object_collisions* const collide_inst_point(int object, bool solid_only, bool notme, int x1, int y1)
 {
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x1, y1); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
             continue;
         if (solid_only && !inst->solid)
@@ -212,12 +213,8 @@ enigma::object_collisions* const collide_inst_point(int object, bool solid_only,
         if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
-        const double x = inst->x, y = inst->y,
-                     xscale = inst->image_xscale, yscale = inst->image_yscale,
-                     ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (x1 >= left && x1 <= right && y1 >= top && y1 <= bottom)
             return inst;
@@ -249,9 +246,9 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
     if (fzero(rx) || fzero(ry))
         return 0;
 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, int(x1 - rx) - 1, int(y1 - ry) - 1, int(x1 + rx) + 1, int(y1 + ry) + 1); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
             continue;
         if (solid_only && !inst->solid)
@@ -259,12 +256,8 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
         if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
-        const double x = inst->x, y = inst->y,
-                     xscale = inst->image_xscale, yscale = inst->image_yscale,
-                     ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         const bool intersects = line_ellipse_intersects(rx, ry, left-x1, top-y1, bottom-y1) ||
                                  line_ellipse_intersects(rx, ry, right-x1, top-y1, bottom-y1) ||
@@ -281,20 +274,16 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
 
 void destroy_inst_point(int object, bool solid_only, int x1, int y1)
 {
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x1, y1); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (solid_only && !inst->solid)
             continue;
         if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
-        const double x = inst->x, y = inst->y,
-                     xscale = inst->image_xscale, yscale = inst->image_yscale,
-                     ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (x1 >= left && x1 <= right && y1 >= top && y1 <= bottom)
             enigma_user::instance_destroy(inst->id);
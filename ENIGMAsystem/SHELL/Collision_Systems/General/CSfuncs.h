@@ -82,4 +82,19 @@ void instance_deactivate_circle(int x, int y, int r, bool inside = true, bool no
 void instance_activate_circle(int x, int y, int r, bool inside = true);
 var instance_get_mtv(int object);
 
+enum {
+  broadphase_linear,  // Every query walks all instances of the object it's given.
+  broadphase_grid     // Queries only visit instances bucketed near them; see collisions_broadphase.h.
+};
+
+// The grid is updated as instances move, including by assigning x/y in the
+// middle of a step: every instance whose code ran, or that was reached into with
+// with() or dot access, has its box re-read before the next query. Enabling the
+// grid or calling collision_broadphase_refresh() files every instance where it
+// currently stands; a refresh is only needed after engine code outside events
+// moves instances.
+void collision_set_broadphase(int mode, int cell_size = 64);
+int collision_get_broadphase();
+void collision_broadphase_refresh();
+
 }
@@ -0,0 +1,327 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+
+#include "collisions_broadphase.h"
+#include "CSfuncs.h"
+#include "Universal_System/Instances/callbacks_events.h"
+#include "Universal_System/roomsystem.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace enigma
+{
+    namespace
+    {
+        // An instance as the grid has it filed.
+        struct broadphase_entry
+        {
+            object_collisions *inst;  // NULL once the instance is found gone.
+            unsigned id;
+            int left, top, right, bottom;
+            bool bounded;  // Whether it had anything to collide with.
+            bool spread;   // Too big for cells; filed in `unindexed` instead.
+        };
+
+        // Entries spanning more cells than this skip the grid and are checked by every query.
+        const int max_cells_per_entry = 64;
+
+        int mode = enigma_user::broadphase_linear;
+        int cell_size = 64;
+        bool callback_registered = false, stale = true;
+        unsigned long synced_links = 0;
+        int synced_maxid = 0;
+
+        std::vector<broadphase_entry> entries;  // Sorted by ID.
+        size_t gone_entries = 0;
+        std::vector<unsigned> unindexed;        // Spread entries.
+        std::unordered_map<long long, std::vector<unsigned> > cells;
+        std::vector<unsigned> visited;
+        unsigned query_number = 0;
+        std::vector<unsigned> changed;          // IDs reported through instance_changed_hook.
+
+        inline int cell_of(int v) { return v >= 0 ? v / cell_size : -((-v - 1) / cell_size) - 1; }
+        inline long long cell_key(int cx, int cy) { return ((long long)cx << 32) ^ (unsigned)cy; }
+
+        void file_entry(unsigned i)
+        {
+            broadphase_entry &e = entries[i];
+            e.spread = false;
+            if (!e.bounded) return;
+            const int cl = cell_of(e.left), cr = cell_of(e.right), ct = cell_of(e.top), cb = cell_of(e.bottom);
+            if ((long long)(cr - cl + 1) * (cb - ct + 1) > max_cells_per_entry) {
+                e.spread = true;
+                unindexed.push_back(i);
+                return;
+            }
+            for (int cy = ct; cy <= cb; ++cy)
+                for (int cx = cl; cx <= cr; ++cx)
+                    cells[cell_key(cx, cy)].push_back(i);
+        }
+
+        // Order within a cell doesn't matter; queries sort what they find.
+        void remove_index(std::vector<unsigned> &v, unsigned i)
+        {
+            auto it = std::find(v.begin(), v.end(), i);
+            if (it == v.end()) return;
+            *it = v.back();
+            v.pop_back();
+        }
+
+        void unfile_entry(unsigned i)
+        {
+            const broadphase_entry &e = entries[i];
+            if (!e.bounded) return;
+            if (e.spread) {
+                remove_index(unindexed, i);
+                return;
+            }
+            const int cl = cell_of(e.left), cr = cell_of(e.right), ct = cell_of(e.top), cb = cell_of(e.bottom);
+            for (int cy = ct; cy <= cb; ++cy)
+                for (int cx = cl; cx <= cr; ++cx) {
+                    auto c = cells.find(cell_key(cx, cy));
+                    if (c != cells.end()) remove_index(c->second, i);
+                }
+        }
+
+        void add_entry(object_collisions *inst)
+        {
+            broadphase_entry e = broadphase_entry();
+            e.inst = inst;
+            e.id = inst->id;
+            e.bounded = collision_bounds(inst, e.left, e.top, e.right, e.bottom);
+            entries.push_back(e);
+            visited.push_back(query_number);
+            file_entry(entries.size() - 1);
+        }
+
+        void forget_entry(unsigned i)
+        {
+            unfile_entry(i);
+            entries[i].inst = NULL;
+            entries[i].bounded = false;
+            ++gone_entries;
+        }
+
+        int find_entry(unsigned id)
+        {
+            auto it = std::lower_bound(entries.begin(), entries.end(), id,
+                [](const broadphase_entry &e, unsigned id) { return e.id < id; });
+            return it != entries.end() && it->id == id ? int(it - entries.begin()) : -1;
+        }
+
+        // Files every live instance where it stands.
+        void sync()
+        {
+            entries.clear();
+            unindexed.clear();
+            changed.clear();
+            gone_entries = 0;
+            for (auto &c : cells)
+                c.second.clear();
+            visited.clear();
+
+            for (iterator it = instance_list_first(); it; ++it)
+                add_entry((object_collisions*)*it);
+
+            // Drop cells nobody has used in a while so a scrolling game doesn't grow the table forever.
+            size_t live_cells = 0;
+            for (auto &c : cells)
+                live_cells += !c.second.empty();
+            if (cells.size() > 2 * live_cells + 1024) {
+                for (auto c = cells.begin(); c != cells.end(); )
+                    if (c->second.empty()) c = cells.erase(c); else ++c;
+            }
+
+            synced_links = instance_link_count;
+            synced_maxid = maxid;
+            stale = false;
+        }
+
+        // Re-reads the box of an instance that was reported changed and moves its
+        // entry to the cells it covers now. The box comes from the instance's
+        // bbox cache, so an instance that didn't actually move costs a compare.
+        void refile(unsigned id)
+        {
+            const int i = find_entry(id);
+            if (i < 0) return;
+            broadphase_entry &e = entries[i];
+            if (!e.inst) return;
+            inst_iter *node = instance_list.get(id);
+            if (!node || node->inst != e.inst) {
+                forget_entry(i);
+                return;
+            }
+
+            int left, top, right, bottom;
+            const bool bounded = collision_bounds(e.inst, left, top, right, bottom);
+            if (bounded == e.bounded && (!bounded ||
+                (left == e.left && top == e.top && right == e.right && bottom == e.bottom)))
+                return;
+            unfile_entry(i);
+            e.bounded = bounded;
+            e.left = left; e.top = top; e.right = right; e.bottom = bottom;
+            file_entry(i);
+        }
+
+        // Brings the grid up to date before a query: files instances created
+        // since the last update and refiles the ones reported changed. Only IDs
+        // past the old maxid can be new; anything else relinked (activation,
+        // room instances reusing their IDs) forces a full sync, as does a table
+        // that has come to be mostly destroyed instances.
+        void update()
+        {
+            if (stale) {
+                sync();
+                return;
+            }
+            if (instance_link_count != synced_links) {
+                unsigned long added = 0;
+                for (int id = synced_maxid; id < maxid; ++id)
+                {
+                    inst_iter *node = instance_list.get(id);
+                    if (!node) continue;
+                    add_entry((object_collisions*)node->inst);
+                    ++added;
+                }
+                synced_maxid = maxid;
+                if (synced_links + added != instance_link_count) {
+                    sync();
+                    return;
+                }
+                synced_links = instance_link_count;
+            }
+
+            for (unsigned id : changed)
+                refile(id);
+            changed.clear();
+
+            if (gone_entries > 1024 && gone_entries * 2 > entries.size())
+                sync();
+        }
+
+        void note_changed(object_basic *inst)
+        {
+            changed.push_back(inst->id);
+        }
+
+        // Keeps the change list from piling up in steps that make no queries.
+        void update_before_collisions()
+        {
+            if (mode == enigma_user::broadphase_grid)
+                update();
+        }
+    }
+
+    collision_candidates::collision_candidates(int object, int left, int top, int right, int bottom): pos(0), indexed(false)
+    {
+        if (mode != enigma_user::broadphase_grid || (object < 0 && object != enigma_user::all) || object >= 100000) {
+            linear = fetch_inst_iter_by_int(object);
+            return;
+        }
+        indexed = true;
+        // The instance asking may have moved since anything last reported it.
+        if (instance_event_iterator)
+            note_instance_changed(instance_event_iterator->inst);
+        update();
+
+        if (!++query_number) {
+            std::fill(visited.begin(), visited.end(), 0);
+            query_number = 1;
+        }
+
+        std::vector<unsigned> gone;
+        const auto consider = [&](unsigned i)
+        {
+            if (visited[i] == query_number) return;
+            visited[i] = query_number;
+            const broadphase_entry &e = entries[i];
+            if (e.left > right || e.right < left || e.top > bottom || e.bottom < top)
+                return;
+            // Destroyed or deactivated instances have left the ID table; a node
+            // pointing at someone else means the ID came back with a new instance.
+            inst_iter *node = instance_list.get(e.id);
+            if (!node || node->inst != e.inst) {
+                gone.push_back(i);
+                return;
+            }
+            if (object != enigma_user::all && e.inst->object_index != object && !e.inst->can_cast(object))
+                return;
+            found.push_back(e.inst);
+        };
+
+        const int cl = cell_of(left), cr = cell_of(right), ct = cell_of(top), cb = cell_of(bottom);
+        if ((long long)(cr - cl + 1) * (cb - ct + 1) > (long long)cells.size()) {
+            // The query covers more cells than exist; walk the table instead of the area.
+            for (const auto &c : cells)
+                for (unsigned i : c.second)
+                    consider(i);
+        } else {
+            for (int cy = ct; cy <= cb; ++cy)
+                for (int cx = cl; cx <= cr; ++cx) {
+                    auto c = cells.find(cell_key(cx, cy));
+                    if (c == cells.end()) continue;
+                    for (unsigned i : c->second)
+                        consider(i);
+                }
+        }
+        for (unsigned i : unindexed)
+            consider(i);
+        for (unsigned i : gone)
+            forget_entry(i);
+
+        // Keep the linear path's answer when several instances collide.
+        std::sort(found.begin(), found.end(), [](const object_collisions *a, const object_collisions *b) { return a->id < b->id; });
+    }
+}
+
+namespace enigma_user
+{
+
+void collision_set_broadphase(int mode, int cell_size)
+{
+    if (mode != broadphase_linear && mode != broadphase_grid)
+        return;
+    if (cell_size > 0 && cell_size != enigma::cell_size) {
+        enigma::cell_size = cell_size;
+        enigma::cells.clear();
+        enigma::entries.clear();
+        enigma::stale = true;
+    }
+    if (mode != enigma::mode) {
+        enigma::mode = mode;
+        enigma::stale = true;
+    }
+    enigma::instance_changed_hook = mode == broadphase_grid ? enigma::note_changed : NULL;
+    if (mode == broadphase_grid && !enigma::callback_registered) {
+        enigma::register_callback_before_collision_event(enigma::update_before_collisions);
+        enigma::callback_registered = true;
+    }
+}
+
+int collision_get_broadphase()
+{
+    return enigma::mode;
+}
+
+void collision_broadphase_refresh()
+{
+    enigma::stale = true;
+}
+
+}
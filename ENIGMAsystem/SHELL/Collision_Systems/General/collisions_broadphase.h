@@ -0,0 +1,65 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+// -------------------------------------------------------------------------------------------
+// Broad phase for the collide_inst_* queries. By default a query walks every instance of the
+// object it asks about; with the grid enabled, instances are bucketed into uniform cells and
+// a query only visits the ones whose cells it overlaps.
+// -------------------------------------------------------------------------------------------
+
+#ifndef COLLISION_BROADPHASE_H
+#define COLLISION_BROADPHASE_H
+
+#include "Universal_System/Object_Tiers/collisions_object.h"
+#include "Universal_System/Instances/instance_system.h"
+
+#include <vector>
+
+namespace enigma
+{
+    // Implemented by each collision system: the world-space box the instance
+    // currently occupies, or false if it has nothing to collide with.
+    bool collision_bounds(const object_collisions *inst, int &left, int &top, int &right, int &bottom);
+
+    // Visits the instances of `object` that may touch the given box, as a drop-in
+    // for iterating fetch_inst_iter_by_int(object). In linear mode (and for
+    // self/other/instance ID lookups) that's exactly what it does. In grid mode it
+    // visits, in ID order, the instances whose boxes overlap the query; callers
+    // still do their own exact tests. The grid follows instances incrementally:
+    // anything user code may have touched is reported through
+    // instance_changed_hook and refiled before the next query.
+    class collision_candidates
+    {
+        iterator linear;
+        std::vector<object_collisions*> found;
+        size_t pos;
+        bool indexed;
+
+      public:
+        collision_candidates(int object, int left, int top, int right, int bottom);
+
+        operator bool() { return indexed ? pos < found.size() : bool(linear); }
+        object_collisions *operator*() { return indexed ? found[pos] : (object_collisions*)*linear; }
+        collision_candidates &operator++() {
+            if (indexed) ++pos;
+            else ++linear;
+            return *this;
+        }
+    };
+}
+
+#endif // COLLISION_BROADPHASE_H
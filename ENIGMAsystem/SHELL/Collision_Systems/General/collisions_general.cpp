@@ -25,28 +25,23 @@ namespace enigma
         //                  is merged
         if (inst->polygon_index != -1)
         {
-            // Using parameterized points if sent
-            double x1, y1;
+            enigma::BoundingBox box;
             if (x == -1 && y == -1)
             {
-                x1 = inst->x;
-                y1 = inst->y;
+                // At the instance's own position, the cached polygon already knows its box
+                box = get_polygon_world(inst).box;
             } else {
-                x1 = x;
-                y1 = y;
+                // Using parameterized points, so transform a fresh copy
+                enigma::Polygon &poly = enigma::polygons.get(inst->polygon_index);
+                std::vector<glm::vec2> points = poly.getOffsetPoints();
+                glm::vec2 pivot(0, 0);
+                enigma::transformPoints(points, 
+                                        x, y, 
+                                        inst->polygon_angle, pivot,
+                                        inst->polygon_xscale, inst->polygon_yscale);
+                box = enigma::computeBBOXFromPoints(points);
             }
 
-            // Fetching transformed points
-            enigma::Polygon poly = enigma::polygons.get(inst->polygon_index);
-            std::vector<glm::vec2> points = poly.getOffsetPoints();
-            glm::vec2 pivot(0, 0);
-            enigma::transformPoints(points, 
-                                    x1, y1, 
-                                    inst->polygon_angle, pivot,
-                                    inst->polygon_xscale, inst->polygon_yscale);
-            
-            // Computing bbox
-            enigma::BoundingBox box = enigma::computeBBOXFromPoints(points);
             left = box.left();
             top = box.top();
             right = box.right();
@@ -55,11 +50,40 @@ namespace enigma
         // If the polygon is not availble, the bbox is computed from the polygon
         else if (inst->sprite_index != -1)
         {
-            const enigma::BoundingBox &box = inst->$bbox_relative();
-            const double x = inst->x, y = inst->y,
-                            xscale = inst->image_xscale, yscale = inst->image_yscale,
-                            ia = inst->image_angle;
-            get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+            const enigma::world_bbox &box = inst->$bbox_world();
+            left = box.left;
+            top = box.top;
+            right = box.right;
+            bottom = box.bottom;
         }
     }
+
+    const polygon_world_cache &get_polygon_world(const enigma::object_collisions* inst)
+    {
+        if (!inst->$polygon_cache)
+            inst->$polygon_cache = std::make_shared<polygon_world_cache>();
+        polygon_world_cache &c = *inst->$polygon_cache;
+
+        // Polygons can have their points or offset changed after creation; the revision covers both
+        enigma::Polygon &poly = enigma::polygons.get(inst->polygon_index);
+        const unsigned revision = poly.getRevision();
+        if (c.valid && c.polygon_index == inst->polygon_index && c.revision == revision &&
+            c.x == inst->x && c.y == inst->y && c.angle == inst->polygon_angle &&
+            c.xscale == inst->polygon_xscale && c.yscale == inst->polygon_yscale)
+            return c;
+
+        c.valid = true;
+        c.polygon_index = inst->polygon_index;
+        c.revision = revision;
+        c.x = inst->x;
+        c.y = inst->y;
+        c.angle = inst->polygon_angle;
+        c.xscale = inst->polygon_xscale;
+        c.yscale = inst->polygon_yscale;
+
+        c.points = poly.getOffsetPoints();
+        enigma::transformPoints(c.points, c.x, c.y, c.angle, glm::vec2(0, 0), c.xscale, c.yscale);
+        c.box = enigma::computeBBOXFromPoints(c.points);
+        return c;
+    }
 }
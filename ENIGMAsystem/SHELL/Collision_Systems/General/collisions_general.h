@@ -68,5 +68,18 @@ static inline double point_direction(cs_scalar x1, cs_scalar y1,cs_scalar x2, cs
 namespace enigma
 {
     void get_bbox_border(int &left, int &top, int &right, int &bottom, const enigma::object_collisions* inst, double x = -1, double y = -1);
+
+    // An instance's polygon in room coordinates, along with everything it was
+    // built from so it's only rebuilt when the instance or the polygon changes.
+    struct polygon_world_cache
+    {
+        bool valid = false;
+        int polygon_index;
+        unsigned revision;
+        double x, y, angle, xscale, yscale;
+        std::vector<glm::vec2> points;
+        BoundingBox box;
+    };
+    const polygon_world_cache &get_polygon_world(const enigma::object_collisions* inst);
 }
 #endif // ~COLLISION_GENERAL_H
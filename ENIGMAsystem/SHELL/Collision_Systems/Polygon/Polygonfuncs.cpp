@@ -550,7 +550,7 @@ namespace enigma_user
     void instance_activate_region(int rleft, int rtop, int rwidth, int rheight, bool inside) 
     {
         // Iterating over the instances
-        std::map<int,enigma::object_basic*>::iterator iter = enigma::instance_deactivated_list.begin();
+        enigma::instance_deactivated_list_iterator iter = enigma::instance_deactivated_list.begin();
         while (iter != enigma::instance_deactivated_list.end()) 
         {
             enigma::object_collisions* const inst = (enigma::object_collisions*) iter->second;
@@ -648,7 +648,7 @@ namespace enigma_user
     void instance_activate_circle(int x, int y, int r, bool inside)
     {
         // Iterating over the instances
-        std::map<int,enigma::object_basic*>::iterator iter = enigma::instance_deactivated_list.begin();
+        enigma::instance_deactivated_list_iterator iter = enigma::instance_deactivated_list.begin();
         while (iter != enigma::instance_deactivated_list.end()) 
         {
             enigma::object_collisions* const inst = (enigma::object_collisions*)iter->second;
@@ -29,12 +29,24 @@
 #include "Universal_System/Resources/polygon.h"
 #include "Universal_System/Resources/polygon_internal.h"
 #include "../General/collisions_general.h"
+#include "../General/collisions_broadphase.h"
 
 #include "Polygonimpl.h"
 #include "polygon_collision_util.h"
 #include <cmath>
 #include <utility>
 
+namespace enigma
+{
+    bool collision_bounds(const object_collisions *inst, int &left, int &top, int &right, int &bottom)
+    {
+        if (inst->sprite_index == -1 && inst->mask_index == -1 && inst->polygon_index == -1)
+            return false;
+        get_bbox_border(left, top, right, bottom, inst);
+        return true;
+    }
+}
+
 enigma::object_collisions* const collide_inst_inst(int object, bool solid_only, bool notme, double x, double y)
 {
     // Obtain the first Object
@@ -50,10 +62,10 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
     enigma::get_bbox_border(left1, top1, right1, bottom1, inst1, x, y);
 
     // Iterating over instances in the room to detect collision
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, left1, top1, right1, bottom1); it; ++it)
     {
         // Selecting the instance
-        enigma::object_collisions* const inst2 = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst2 = *it;
 
         // Initial Checks
         if (notme && inst2->id == inst1->id)
@@ -140,10 +152,10 @@ enigma::object_collisions* const collide_inst_rect(int object, bool solid_only,
 
     // Iterating over instances to find any object that is colliding with
     // this rectangle
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x2, y2); it; ++it)
     {
         // Getting the instance
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
 
         // Preliminary checks for collision
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
@@ -195,10 +207,10 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
         return collide_inst_point(object, solid_only, prec, notme, x1, y1);
 
     // Iterating over instances 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, min(x1, x2), min(y1, y2), max(x1, x2), max(y1, y2)); it; ++it)
     {
         // Retrieving the instance
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
 
         // Preliminary checks
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
@@ -286,10 +298,10 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
 enigma::object_collisions* const collide_inst_point(int object, bool solid_only, bool prec, bool notme, int x1, int y1)
 {
     // Iterating over the instances to detect collision
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x1, y1); it; ++it)
     {
         // Retrieving the instance
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
 
         // Doing some Preliminary Checks
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
@@ -350,10 +362,10 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
         return 0;
 
     // Iterate over the instances for the collision check
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, int(x1 - rx) - 1, int(y1 - ry) - 1, int(x1 + rx) + 1, int(y1 + ry) + 1); it; ++it)
     {
         // Retrieving the instance
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
 
         // Preliminary checks
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
@@ -408,10 +420,10 @@ std::vector<enigma::object_collisions*> get_colliding_bbox_instances(int x1, int
     std::vector<enigma::object_collisions*> instances;
 
     // Iterating over instances
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x1, y1); it; ++it)
     {
         // Preliminary checks before collisions
-        enigma::object_collisions* const inst = (enigma::object_collisions*) *it;
+        enigma::object_collisions* const inst = *it;
         if (solid_only && !inst->solid)
             continue;
 
@@ -25,8 +25,10 @@
 #include "Universal_System/Instances/instance_system.h" //iter
 #include "Universal_System/Instances/instance.h"
 #include "Universal_System/math_consts.h"
+#include "Collision_Systems/General/collisions_broadphase.h"
 
 #include "PRECimpl.h"
+#include "PRECmask.h"
 #include <cmath>
 #include <utility>
 
@@ -62,43 +64,115 @@ static inline void get_border(int *leftv, int *rightv, int *topv, int *bottomv,
 template<typename T> static inline T min(T x, T y) { return x<y? x : y; }
 template<typename T> static inline T max(T x, T y) { return x>y? x : y; }
 
+namespace enigma
+{
+    bool collision_bounds(const object_collisions *inst, int &left, int &top, int &right, int &bottom)
+    {
+        if (inst->sprite_index == -1 && inst->mask_index == -1)
+            return false;
+        const world_bbox &box = inst->$bbox_world();
+        left = box.left; top = box.top; right = box.right; bottom = box.bottom;
+        return true;
+    }
+}
+
+namespace
+{
+    // Where an instance's collision mask sits in the room. Room pixel (col, row) samples mask pixel
+    //   (floor((bx*cos - by*sin)/xscale) + xoffset, floor((bx*sin + by*cos)/yscale) + yoffset),
+    // with (bx, by) = (floor(col - x), floor(row - y)). Flooring (rather than truncating toward zero)
+    // keeps the mask left of and above the origin from folding onto its column and row.
+    struct placed_mask
+    {
+        const enigma::collision_mask *mask;
+        double x, y, xscale, yscale, cosa, sina;
+        int xoffset, yoffset;
+        bool aligned;          // Unrotated at unit scale, so mask pixels are room pixels shifted by...
+        int shift_x, shift_y;  // ...this much: mask (px, py) is room (px + shift_x, py + shift_y).
+
+        placed_mask(const enigma::collision_mask *mask, double x, double y, double xscale, double yscale, double angle, int xoffset, int yoffset):
+            mask(mask), x(x), y(y), xscale(xscale), yscale(yscale), xoffset(xoffset), yoffset(yoffset)
+        {
+            // Quarter turns get exact factors, so an unrotated mask maps one pixel to one pixel.
+            double a = fmod(angle, 360.0);
+            if (a < 0) a += 360.0;
+            if (a == 0)        { cosa = 1;  sina = 0; }
+            else if (a == 90)  { cosa = 0;  sina = 1; }
+            else if (a == 180) { cosa = -1; sina = 0; }
+            else if (a == 270) { cosa = 0;  sina = -1; }
+            else {
+                const double arad = a*M_PI/180.0;
+                cosa = cos(arad);
+                sina = sin(arad);
+            }
+            aligned = cosa == 1 && xscale == 1 && yscale == 1;
+            shift_x = int(ceil(x)) - xoffset;
+            shift_y = int(ceil(y)) - yoffset;
+        }
+
+        bool empty() const { return xscale == 0 || yscale == 0; }
+
+        bool test(int col, int row) const
+        {
+            if (aligned)
+                return mask->test(col - shift_x, row - shift_y);
+            const double bx = floor(col - x), by = floor(row - y);
+            return mask->test(int(floor((bx*cosa - by*sina)/xscale)) + xoffset,
+                              int(floor((bx*sina + by*cosa)/yscale)) + yoffset);
+        }
+
+        // For aligned masks: the room mask (col..col+63, row), with col in bit 0.
+        uint64_t span(int col, int row) const
+        {
+            const int py = row - shift_y;
+            return py >= 0 && py < mask->height ? mask->span(py, col - shift_x) : 0;
+        }
+    };
+
+    // Clears the bits of a span starting at col that fall past right.
+    inline uint64_t clip_span(uint64_t bits, int col, int right) {
+        return right - col < 63 ? bits & ((uint64_t(2) << (right - col)) - 1) : bits;
+    }
+}
+
 static bool precise_collision_single(int intersection_left, int intersection_right, int intersection_top, int intersection_bottom,
                                 double x1, double y1,
                                 double xscale1, double yscale1,
                                 double ia1,
-                                unsigned char* pixels1,
-                                int w1, int h1,
+                                const enigma::collision_mask* mask1,
                                 int xoffset1, int yoffset1)
 {
+    const placed_mask m1(mask1, x1, y1, xscale1, yscale1, ia1, xoffset1, yoffset1);
+    if (m1.empty()) {
+        return false;
+    }
 
-    if (xscale1 != 0.0 && yscale1 != 0.0) {
-
-        const double pi_half = M_PI/2.0;
-
-        const double arad1 = ia1*M_PI/180.0;
-
-        const double cosa1 = cos(-arad1);
-        const double sina1 = sin(-arad1);
-        const double cosa90_1 = cos(-arad1 + pi_half);
-        const double sina90_1 = sin(-arad1 + pi_half);
-
-        for (int rowindex = intersection_top; rowindex <= intersection_bottom; rowindex++)
+    if (m1.aligned) {
+        // Clip to the mask and test its rows 64 bits at a time.
+        const int left = max(intersection_left, m1.shift_x),
+                  right = min(intersection_right, m1.shift_x + mask1->width - 1),
+                  top = max(intersection_top, m1.shift_y),
+                  bottom = min(intersection_bottom, m1.shift_y + mask1->height - 1);
+        for (int rowindex = top; rowindex <= bottom; rowindex++)
         {
-            for(int colindex = intersection_left; colindex <= intersection_right; colindex++)
+            for (int colindex = left; colindex <= right; colindex += 64)
             {
-
-                //Test for single image.
-                const int bx1 = (colindex - x1);
-                const int by1 = (rowindex - y1);
-                const int px1 = (int)((bx1*cosa1 + by1*sina1)/xscale1 + xoffset1);
-                const int py1 = (int)((bx1*cosa90_1 + by1*sina90_1)/yscale1 + yoffset1);
-                const bool p1 = px1 >= 0 && py1 >= 0 && px1 < w1 && py1 < h1 && pixels1[py1*w1 + px1] != 0;
-
-                if (p1) {
+                if (clip_span(m1.span(colindex, rowindex), colindex, right)) {
                     return true;
                 }
             }
         }
+        return false;
+    }
+
+    for (int rowindex = intersection_top; rowindex <= intersection_bottom; rowindex++)
+    {
+        for(int colindex = intersection_left; colindex <= intersection_right; colindex++)
+        {
+            if (m1.test(colindex, rowindex)) {
+                return true;
+            }
+        }
     }
     return false;
 }
@@ -107,53 +181,42 @@ static bool precise_collision_pair(int intersection_left, int intersection_right
                                 double x1, double y1, double x2, double y2,
                                 double xscale1, double yscale1, double xscale2, double yscale2,
                                 double ia1, double ia2,
-                                unsigned char* pixels1, unsigned char* pixels2,
-                                int w1, int h1, int w2, int h2,
+                                const enigma::collision_mask* mask1, const enigma::collision_mask* mask2,
                                 int xoffset1, int yoffset1, int xoffset2, int yoffset2)
 {
+    const placed_mask m1(mask1, x1, y1, xscale1, yscale1, ia1, xoffset1, yoffset1),
+                      m2(mask2, x2, y2, xscale2, yscale2, ia2, xoffset2, yoffset2);
+    if (m1.empty() || m2.empty()) {
+        return false;
+    }
 
-    if (xscale1 != 0.0 && yscale1 != 0.0 && xscale2 != 0.0 && yscale2 != 0.0) {
-
-        const double pi_half = M_PI/2.0;
-
-        const double arad1 = ia1*M_PI/180.0;
-        const double arad2 = ia2*M_PI/180.0;
-
-        const double cosa1 = cos(-arad1);
-        const double sina1 = sin(-arad1);
-        const double cosa90_1 = cos(-arad1 + pi_half);
-        const double sina90_1 = sin(-arad1 + pi_half);
-
-        const double cosa2 = cos(-arad2);
-        const double sina2 = sin(-arad2);
-        const double cosa90_2 = cos(-arad2 + pi_half);
-        const double sina90_2 = sin(-arad2 + pi_half);
-
-        for (int rowindex = intersection_top; rowindex <= intersection_bottom; rowindex++)
+    if (m1.aligned && m2.aligned) {
+        // Clip to where both masks are, then AND their rows 64 bits at a time.
+        const int left = max(intersection_left, max(m1.shift_x, m2.shift_x)),
+                  right = min(intersection_right, min(m1.shift_x + mask1->width, m2.shift_x + mask2->width) - 1),
+                  top = max(intersection_top, max(m1.shift_y, m2.shift_y)),
+                  bottom = min(intersection_bottom, min(m1.shift_y + mask1->height, m2.shift_y + mask2->height) - 1);
+        for (int rowindex = top; rowindex <= bottom; rowindex++)
         {
-            for(int colindex = intersection_left; colindex <= intersection_right; colindex++)
+            for (int colindex = left; colindex <= right; colindex += 64)
             {
-
-                //Test for first image.
-                const int bx1 = (colindex - x1);
-                const int by1 = (rowindex - y1);
-                const int px1 = (int)((bx1*cosa1 + by1*sina1)/xscale1 + xoffset1);
-                const int py1 = (int)((bx1*cosa90_1 + by1*sina90_1)/yscale1 + yoffset1);
-                const bool p1 = px1 >= 0 && py1 >= 0 && px1 < w1 && py1 < h1 && pixels1[py1*w1 + px1] != 0;
-
-                //Test for second image.
-                const int bx2 = (colindex - x2);
-                const int by2 = (rowindex - y2);
-                const int px2 = (int)((bx2*cosa2 + by2*sina2)/xscale2 + xoffset2);
-                const int py2 = (int)((bx2*cosa90_2 + by2*sina90_2)/yscale2 + yoffset2);
-                const bool p2 = px2 >= 0 && py2 >= 0 && px2 < w2 && py2 < h2 && pixels2[py2*w2 + px2] != 0;
-
-                //Final test.
-                if (p1 && p2) {
+                if (clip_span(m1.span(colindex, rowindex) & m2.span(colindex, rowindex), colindex, right)) {
                     return true;
                 }
             }
         }
+        return false;
+    }
+
+    // Rotated or scaled: map each pixel into both masks.
+    for (int rowindex = intersection_top; rowindex <= intersection_bottom; rowindex++)
+    {
+        for(int colindex = intersection_left; colindex <= intersection_right; colindex++)
+        {
+            if (m1.test(colindex, rowindex) && m2.test(colindex, rowindex)) {
+                return true;
+            }
+        }
     }
     return false;
 }
@@ -163,66 +226,44 @@ static bool precise_collision_line(int intersection_left, int intersection_right
                                 double x1, double y1,
                                 double xscale1, double yscale1,
                                 double ia1,
-                                unsigned char* pixels1,
-                                int w1, int h1,
+                                const enigma::collision_mask* mask1,
                                 int xoffset1, int yoffset1,
                                 int lx1, int ly1, int lx2, int ly2)
 {
-    if (xscale1 != 0.0 && yscale1 != 0.0) {
-
-        const double pi_half = M_PI/2.0;
-
-        const double arad1 = ia1*M_PI/180.0;
-
-        const double cosa1 = cos(-arad1);
-        const double sina1 = sin(-arad1);
-        const double cosa90_1 = cos(-arad1 + pi_half);
-        const double sina90_1 = sin(-arad1 + pi_half);
+    const placed_mask m1(mask1, x1, y1, xscale1, yscale1, ia1, xoffset1, yoffset1);
+    if (m1.empty()) {
+        return false;
+    }
 
-        if (lx1 != lx2 && abs(lx1-lx2) >= abs(ly1-ly2)) { // The slope is defined and in [-1;1].
-            const int minX = max(min(lx1, lx2), intersection_left),
-                       maxX = min(max(lx1, lx2), intersection_right);
+    if (lx1 != lx2 && abs(lx1-lx2) >= abs(ly1-ly2)) { // The slope is defined and in [-1;1].
+        const int minX = max(min(lx1, lx2), intersection_left),
+                   maxX = min(max(lx1, lx2), intersection_right);
 
-            const double denom = lx2 - lx1;
-            for (int gx = minX; gx <= maxX; gx++)
-            {
-                int gy = (int)round((gx - lx1)*(ly2-ly1)/denom + ly1);
-                if (gy < intersection_top || gy > intersection_bottom) {
-                    continue;
-                }
-                // Test for single image.
-                const int bx1 = (gx - x1);
-                const int by1 = (gy - y1);
-                const int px1 = (int)((bx1*cosa1 + by1*sina1)/xscale1 + xoffset1);
-                const int py1 = (int)((bx1*cosa90_1 + by1*sina90_1)/yscale1 + yoffset1);
-                const bool p1 = px1 >= 0 && py1 >= 0 && px1 < w1 && py1 < h1 && pixels1[py1*w1 + px1] != 0;
-
-                if (p1) {
-                    return true;
-                }
+        const double denom = lx2 - lx1;
+        for (int gx = minX; gx <= maxX; gx++)
+        {
+            int gy = (int)round((gx - lx1)*(ly2-ly1)/denom + ly1);
+            if (gy < intersection_top || gy > intersection_bottom) {
+                continue;
+            }
+            if (m1.test(gx, gy)) {
+                return true;
             }
         }
-        else { // ly1 != ly2.
-            const int minY = max(min(ly1, ly2), intersection_top),
-                       maxY = min(max(ly1, ly2), intersection_bottom);
+    }
+    else { // ly1 != ly2.
+        const int minY = max(min(ly1, ly2), intersection_top),
+                   maxY = min(max(ly1, ly2), intersection_bottom);
 
-            const double denom = ly2 - ly1;
-            for (int gy = minY; gy <= maxY; gy++)
-            {
-                int gx = (int)round((gy - ly1)*(lx2-lx1)/denom + lx1);
-                if (gx < intersection_left || gx > intersection_right) {
-                    continue;
-                }
-                // Test for single image.
-                const int bx1 = (gx - x1);
-                const int by1 = (gy - y1);
-                const int px1 = (int)((bx1*cosa1 + by1*sina1)/xscale1 + xoffset1);
-                const int py1 = (int)((bx1*cosa90_1 + by1*sina90_1)/yscale1 + yoffset1);
-                const bool p1 = px1 >= 0 && py1 >= 0 && px1 < w1 && py1 < h1 && pixels1[py1*w1 + px1] != 0;
-
-                if (p1) {
-                    return true;
-                }
+        const double denom = ly2 - ly1;
+        for (int gy = minY; gy <= maxY; gy++)
+        {
+            int gx = (int)round((gy - ly1)*(lx2-lx1)/denom + lx1);
+            if (gx < intersection_left || gx > intersection_right) {
+                continue;
+            }
+            if (m1.test(gx, gy)) {
+                return true;
             }
         }
     }
@@ -234,43 +275,27 @@ static bool precise_collision_ellipse(int intersection_left, int intersection_ri
                                 double x1, double y1,
                                 double xscale1, double yscale1,
                                 double ia1,
-                                unsigned char* pixels1,
-                                int w1, int h1,
+                                const enigma::collision_mask* mask1,
                                 int xoffset1, int yoffset1,
                                 int ex, int ey, int rx, int ry)
 {
+    const placed_mask m1(mask1, x1, y1, xscale1, yscale1, ia1, xoffset1, yoffset1);
+    if (m1.empty()) {
+        return false;
+    }
 
-    if (xscale1 != 0.0 && yscale1 != 0.0) {
-
-        const double pi_half = M_PI/2.0;
-
-        const double arad1 = ia1*M_PI/180.0;
-
-        const double cosa1 = cos(-arad1);
-        const double sina1 = sin(-arad1);
-        const double cosa90_1 = cos(-arad1 + pi_half);
-        const double sina90_1 = sin(-arad1 + pi_half);
-
-        const double rx_2 = rx*rx, ry_2 = ry*ry;
+    const double rx_2 = rx*rx, ry_2 = ry*ry;
 
-        for (int rowindex = intersection_top; rowindex <= intersection_bottom; rowindex++)
+    for (int rowindex = intersection_top; rowindex <= intersection_bottom; rowindex++)
+    {
+        for(int colindex = intersection_left; colindex <= intersection_right; colindex++)
         {
-            for(int colindex = intersection_left; colindex <= intersection_right; colindex++)
-            {
-                const double px = colindex - ex;
-                const double py = rowindex - ey;
-                if (px*px/rx_2 + py*py/ry_2 > 1.0) continue;
-
-                // Test for single image.
-                const int bx1 = (colindex - x1);
-                const int by1 = (rowindex - y1);
-                const int px1 = (int)((bx1*cosa1 + by1*sina1)/xscale1 + xoffset1);
-                const int py1 = (int)((bx1*cosa90_1 + by1*sina90_1)/yscale1 + yoffset1);
-                const bool p1 = px1 >= 0 && py1 >= 0 && px1 < w1 && py1 < h1 && pixels1[py1*w1 + px1] != 0;
-
-                if (p1) {
-                    return true;
-                }
+            const double px = colindex - ex;
+            const double py = rowindex - ey;
+            if (px*px/rx_2 + py*py/ry_2 > 1.0) continue;
+
+            if (m1.test(colindex, rowindex)) {
+                return true;
             }
         }
     }
@@ -293,9 +318,9 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
 
     get_border(&left1, &right1, &top1, &bottom1, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale1, yscale1, ia1);
 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, left1, top1, right1, bottom1); it; ++it)
     {
-        enigma::object_collisions* const inst2 = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst2 = *it;
         if (notme && inst2->id == inst1->id)
             continue;
         if (solid_only && !inst2->solid)
@@ -303,12 +328,11 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
         if (inst2->sprite_index == -1 && inst2->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box2 = inst2->$bbox_relative();
         const double x2 = inst2->x, y2 = inst2->y,
                      xscale2 = inst2->image_xscale, yscale2 = inst2->image_yscale,
                      ia2 = inst2->image_angle;
-        int left2, top2, right2, bottom2;
-        get_border(&left2, &right2, &top2, &bottom2, box2.left(), box2.top(), box2.right(), box2.bottom(), x2, y2, xscale2, yscale2, ia2);
+        const enigma::world_bbox &wb2 = inst2->$bbox_world();
+        const int left2 = wb2.left, top2 = wb2.top, right2 = wb2.right, bottom2 = wb2.bottom;
 
         if (left1 <= right2 && left2 <= right1 && top1 <= bottom2 && top2 <= bottom1) {
 
@@ -322,10 +346,10 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
             const int usi1 = ((int) inst1->image_index) % sprite1.SubimageCount();
             const int usi2 = ((int) inst2->image_index) % sprite2.SubimageCount();
 
-            unsigned char* pixels1 = (unsigned char*) (sprite1.GetSubimage(usi1).collisionData);
-            unsigned char* pixels2 = (unsigned char*) (sprite2.GetSubimage(usi2).collisionData);
+            const enigma::collision_mask* mask1 = (const enigma::collision_mask*) (sprite1.GetSubimage(usi1).collisionData);
+            const enigma::collision_mask* mask2 = (const enigma::collision_mask*) (sprite2.GetSubimage(usi2).collisionData);
 
-            if (pixels1 == 0 && pixels2 == 0) { //bbox vs. bbox.
+            if (mask1 == 0 && mask2 == 0) { //bbox vs. bbox.
                 return inst2;
             }
             else {
@@ -335,24 +359,18 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
                 const int ins_top = max(top1, top2);
                 const int ins_bottom = min(bottom1, bottom2);
 
-                const int w1 = sprite1.width;
-                const int h1 = sprite1.height;
-                const int w2 = sprite2.width;
-                const int h2 = sprite2.height;
-
                 const double xoffset1 = sprite1.xoffset;
                 const double yoffset1 = sprite1.yoffset;
                 const double xoffset2 = sprite2.xoffset;
                 const double yoffset2 = sprite2.yoffset;
 
-                if (pixels1 != 0 && pixels2 == 0) { //precise vs. bbox.
+                if (mask1 != 0 && mask2 == 0) { //precise vs. bbox.
                     const bool coll_result = precise_collision_single(
                         ins_left, ins_right, ins_top, ins_bottom,
                         x, y,
                         xscale1, yscale1,
                         ia1,
-                        pixels1,
-                        w1, h1,
+                        mask1,
                         xoffset1, yoffset1
                       );
 
@@ -360,14 +378,13 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
                         return inst2;
                     }
                 }
-                else if (pixels1 == 0 && pixels2 != 0) { //bbox vs. precise.
+                else if (mask1 == 0 && mask2 != 0) { //bbox vs. precise.
                     const bool coll_result = precise_collision_single(
                         ins_left, ins_right, ins_top, ins_bottom,
                         x2, y2,
                         xscale2, yscale2,
                         ia2,
-                        pixels2,
-                        w2, h2,
+                        mask2,
                         xoffset2, yoffset2
                     );
 
@@ -381,8 +398,7 @@ enigma::object_collisions* const collide_inst_inst(int object, bool solid_only,
                         x, y, x2, y2,
                         xscale1, yscale1, xscale2, yscale2,
                         ia1, ia2,
-                        pixels1, pixels2,
-                        w1, h1, w2, h2,
+                        mask1, mask2,
                         xoffset1, yoffset1, xoffset2, yoffset2
                     );
 
@@ -404,9 +420,9 @@ enigma::object_collisions* const collide_inst_rect(int object, bool solid_only,
     if (y1 > y2)
         std::swap(y1, y2);
 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x2, y2); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
             continue;
         if (solid_only && !inst->solid)
@@ -414,12 +430,11 @@ enigma::object_collisions* const collide_inst_rect(int object, bool solid_only,
          if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
         const double x = inst->x, y = inst->y,
                      xscale = inst->image_xscale, yscale = inst->image_yscale,
                      ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (left <= x2 && x1 <= right && top <= y2 && y1 <= bottom) {
 
@@ -434,9 +449,9 @@ enigma::object_collisions* const collide_inst_rect(int object, bool solid_only,
 
             const int usi = ((int) inst->image_index) % sprite.SubimageCount();
 
-            unsigned char* pixels = (unsigned char*) (sprite.GetSubimage(usi).collisionData);
+            const enigma::collision_mask* mask = (const enigma::collision_mask*) (sprite.GetSubimage(usi).collisionData);
 
-            if (pixels == 0) { //bbox.
+            if (mask == 0) { //bbox.
                 return inst;
             }
             else { //precise.
@@ -448,9 +463,6 @@ enigma::object_collisions* const collide_inst_rect(int object, bool solid_only,
 
                 //Check per pixel.
 
-                const int w = sprite.width;
-                const int h = sprite.height;
-
                 const double xoffset = sprite.xoffset;
                 const double yoffset = sprite.yoffset;
 
@@ -459,8 +471,7 @@ enigma::object_collisions* const collide_inst_rect(int object, bool solid_only,
                     x, y,
                     xscale, yscale,
                     ia,
-                    pixels,
-                    w, h,
+                    mask,
                     xoffset, yoffset
                 );
 
@@ -479,9 +490,9 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
     if (x1 == x2 && y1 == y2)
         return collide_inst_point(object, solid_only, prec, notme, x1, y1);
 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, min(x1, x2), min(y1, y2), max(x1, x2), max(y1, y2)); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
             continue;
         if (solid_only && !inst->solid)
@@ -489,12 +500,11 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
         if (inst->sprite_index == -1 && inst->mask_index == -1) // No sprite/mask then no collision.
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
         const double x = inst->x, y = inst->y,
                      xscale = inst->image_xscale, yscale = inst->image_yscale,
                      ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         double minX = max(min(x1,x2),left);
         double maxX = min(max(x1,x2),right);
@@ -540,9 +550,9 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
 
                 const int usi = ((int) inst->image_index) % sprite.SubimageCount();
 
-                unsigned char* pixels = (unsigned char*) (sprite.GetSubimage(usi).collisionData);
+                const enigma::collision_mask* mask = (const enigma::collision_mask*) (sprite.GetSubimage(usi).collisionData);
 
-                if (pixels == NULL) { // Bounding box.
+                if (mask == NULL) { // Bounding box.
                     return inst;
                 }
                 else { // Precise.
@@ -554,9 +564,6 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
 
                     // Check per pixel.
 
-                    const int w = sprite.width;
-                    const int h = sprite.height;
-
                     const double xoffset = sprite.xoffset;
                     const double yoffset = sprite.yoffset;
 
@@ -566,8 +573,7 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
                         x, y,
                         xscale, yscale,
                         ia,
-                        pixels,
-                        w, h,
+                        mask,
                         xoffset, yoffset,
                         x1, y1, x2, y2
                     );
@@ -584,9 +590,9 @@ enigma::object_collisions* const collide_inst_line(int object, bool solid_only,
 
 enigma::object_collisions* const collide_inst_point(int object, bool solid_only, bool prec, bool notme, int x1, int y1)
 {
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x1, y1); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
             continue;
         if (solid_only && !inst->solid)
@@ -594,12 +600,11 @@ enigma::object_collisions* const collide_inst_point(int object, bool solid_only,
         if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
         const double x = inst->x, y = inst->y,
                      xscale = inst->image_xscale, yscale = inst->image_yscale,
                      ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (x1 >= left && x1 <= right && y1 >= top && y1 <= bottom) {
 
@@ -614,9 +619,9 @@ enigma::object_collisions* const collide_inst_point(int object, bool solid_only,
 
             const int usi = ((int) inst->image_index) % sprite.SubimageCount();
 
-            unsigned char* pixels = (unsigned char*) (sprite.GetSubimage(usi).collisionData);
+            const enigma::collision_mask* mask = (const enigma::collision_mask*) (sprite.GetSubimage(usi).collisionData);
 
-            if (pixels == 0) { //bbox.
+            if (mask == 0) { //bbox.
                 return inst;
             }
             else { //precise.
@@ -628,9 +633,6 @@ enigma::object_collisions* const collide_inst_point(int object, bool solid_only,
 
                 //Check per pixel.
 
-                const int w = sprite.width;
-                const int h = sprite.height;
-
                 const double xoffset = sprite.xoffset;
                 const double yoffset = sprite.yoffset;
 
@@ -639,8 +641,7 @@ enigma::object_collisions* const collide_inst_point(int object, bool solid_only,
                     x, y,
                     xscale, yscale,
                     ia,
-                    pixels,
-                    w, h,
+                    mask,
                     xoffset, yoffset
                 );
 
@@ -677,9 +678,9 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
     if (rx == 0 || ry == 0)
         return 0;
 
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, int(x1 - rx) - 1, int(y1 - ry) - 1, int(x1 + rx) + 1, int(y1 + ry) + 1); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (notme && inst->id == enigma::instance_event_iterator->inst->id)
             continue;
         if (solid_only && !inst->solid)
@@ -687,12 +688,11 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
         if (inst->sprite_index == -1 && inst->mask_index == -1) // No sprite/mask then no collision.
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
         const double x = inst->x, y = inst->y,
                      xscale = inst->image_xscale, yscale = inst->image_yscale,
                      ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         const bool intersects = line_ellipse_intersects(rx, ry, left-x1, top-y1, bottom-y1) ||
                                  line_ellipse_intersects(rx, ry, right-x1, top-y1, bottom-y1) ||
@@ -712,9 +712,9 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
 
             const int usi = ((int) inst->image_index) % sprite.SubimageCount();
 
-            unsigned char* pixels = (unsigned char*) (sprite.GetSubimage(usi).collisionData);
+            const enigma::collision_mask* mask = (const enigma::collision_mask*) (sprite.GetSubimage(usi).collisionData);
 
-            if (pixels == 0) { // Bounding Box.
+            if (mask == 0) { // Bounding Box.
                 return inst;
             }
             else { // Precise.
@@ -726,9 +726,6 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
 
                 // Check per pixel.
 
-                const int w = sprite.width;
-                const int h = sprite.height;
-
                 const double xoffset = sprite.xoffset;
                 const double yoffset = sprite.yoffset;
 
@@ -737,8 +734,7 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
                     x, y,
                     xscale, yscale,
                     ia,
-                    pixels,
-                    w, h,
+                    mask,
                     xoffset, yoffset,
                     x1, y1, rx, ry
                 );
@@ -754,20 +750,19 @@ enigma::object_collisions* const collide_inst_ellipse(int object, bool solid_onl
 
 void destroy_inst_point(int object, bool solid_only, int x1, int y1)
 {
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(object); it; ++it)
+    for (enigma::collision_candidates it(object, x1, y1, x1, y1); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (solid_only && !inst->solid)
             continue;
         if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
         const double x = inst->x, y = inst->y,
                      xscale = inst->image_xscale, yscale = inst->image_yscale,
                      ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (x1 >= left && x1 <= right && y1 >= top && y1 <= bottom) {
 
@@ -777,9 +772,9 @@ void destroy_inst_point(int object, bool solid_only, int x1, int y1)
 
             const int usi = ((int) inst->image_index) % sprite.SubimageCount();
 
-            unsigned char* pixels = (unsigned char*) (sprite.GetSubimage(usi).collisionData);
+            const enigma::collision_mask* mask = (const enigma::collision_mask*) (sprite.GetSubimage(usi).collisionData);
 
-            if (pixels == 0) { //bbox.
+            if (mask == 0) { //bbox.
                 enigma_user::instance_destroy(inst->id);
             }
             else { //precise.
@@ -791,9 +786,6 @@ void destroy_inst_point(int object, bool solid_only, int x1, int y1)
 
                 //Check per pixel.
 
-                const int w = sprite.width;
-                const int h = sprite.height;
-
                 const double xoffset = sprite.xoffset;
                 const double yoffset = sprite.yoffset;
 
@@ -802,8 +794,7 @@ void destroy_inst_point(int object, bool solid_only, int x1, int y1)
                     x, y,
                     xscale, yscale,
                     ia,
-                    pixels,
-                    w, h,
+                    mask,
                     xoffset, yoffset
                 );
 
@@ -817,18 +808,17 @@ void destroy_inst_point(int object, bool solid_only, int x1, int y1)
 
 void change_inst_point(int obj, bool perf, int x1, int y1)
 {
-    for (enigma::iterator it = enigma::fetch_inst_iter_by_int(enigma_user::all); it; ++it)
+    for (enigma::collision_candidates it(enigma_user::all, x1, y1, x1, y1); it; ++it)
     {
-        enigma::object_collisions* const inst = (enigma::object_collisions*)*it;
+        enigma::object_collisions* const inst = *it;
         if (inst->sprite_index == -1 && inst->mask_index == -1) //no sprite/mask then no collision
             continue;
 
-        const enigma::BoundingBox &box = inst->$bbox_relative();
         const double x = inst->x, y = inst->y,
                      xscale = inst->image_xscale, yscale = inst->image_yscale,
                      ia = inst->image_angle;
-        int left, top, right, bottom;
-        get_border(&left, &right, &top, &bottom, box.left(), box.top(), box.right(), box.bottom(), x, y, xscale, yscale, ia);
+        const enigma::world_bbox &wb = inst->$bbox_world();
+        const int left = wb.left, top = wb.top, right = wb.right, bottom = wb.bottom;
 
         if (x1 >= left && x1 <= right && y1 >= top && y1 <= bottom) {
 
@@ -838,9 +828,9 @@ void change_inst_point(int obj, bool perf, int x1, int y1)
 
             const int usi = ((int) inst->image_index) % sprite.SubimageCount();
 
-            unsigned char* pixels = (unsigned char*) (sprite.GetSubimage(usi).collisionData);
+            const enigma::collision_mask* mask = (const enigma::collision_mask*) (sprite.GetSubimage(usi).collisionData);
 
-            if (pixels == 0) { //bbox.
+            if (mask == 0) { //bbox.
                 enigma::instance_change_inst(obj, perf, inst);
             }
             else { //precise.
@@ -852,9 +842,6 @@ void change_inst_point(int obj, bool perf, int x1, int y1)
 
                 //Check per pixel.
 
-                const int w = sprite.width;
-                const int h = sprite.height;
-
                 const double xoffset = sprite.xoffset;
                 const double yoffset = sprite.yoffset;
 
@@ -863,8 +850,7 @@ void change_inst_point(int obj, bool perf, int x1, int y1)
                     x, y,
                     xscale, yscale,
                     ia,
-                    pixels,
-                    w, h,
+                    mask,
                     xoffset, yoffset
                 );
 
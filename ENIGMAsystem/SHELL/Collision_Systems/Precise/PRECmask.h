@@ -0,0 +1,56 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_PRECMASK_H
+#define ENIGMA_PRECMASK_H
+
+#include <vector>
+#include <stdint.h>
+
+namespace enigma
+{
+  // A subimage's collision mask, one bit per pixel. Each row is padded to a whole
+  // number of 64-bit words; pixel x of a row is bit (x & 63) of word (x >> 6), and
+  // the padding bits are always clear, so a row can be tested 64 pixels at a time.
+  struct collision_mask
+  {
+    int width, height, words;  // `words` is the number of words per row.
+    std::vector<uint64_t> bits;
+
+    collision_mask(int w, int h): width(w), height(h), words((w + 63) >> 6), bits(size_t(words) * h, 0) {}
+
+    const uint64_t *row(int y) const { return &bits[size_t(y) * words]; }
+    void set(int x, int y) { bits[size_t(y) * words + (x >> 6)] |= uint64_t(1) << (x & 63); }
+    bool test(int x, int y) const {
+      return x >= 0 && y >= 0 && x < width && y < height && (row(y)[x >> 6] >> (x & 63) & 1);
+    }
+
+    // The 64 pixels of row y starting at pixel x, with pixel x in bit 0. Pixels
+    // off either end of the row read as clear. Assumes 0 <= y < height.
+    uint64_t span(int y, int x) const {
+      if (x >= width || x <= -64) return 0;
+      const uint64_t *r = row(y);
+      if (x < 0) return r[0] << -x;
+      const int w = x >> 6, b = x & 63;
+      uint64_t v = r[w] >> b;
+      if (b && w + 1 < words) v |= r[w + 1] << (64 - b);
+      return v;
+    }
+  };
+}
+
+#endif // ENIGMA_PRECMASK_H
@@ -18,6 +18,7 @@
 #include "Collision_Systems/collision_mandatory.h"
 #include "Universal_System/nlpo2.h"
 #include "Universal_System/Resources/sprites_internal.h"
+#include "PRECmask.h"
 
 #include <iostream>
 
@@ -37,14 +38,17 @@ namespace enigma
     {
       case ct_precise:
         {
+          // A pixel is solid if its alpha is nonzero.
           const unsigned int w = spr.width, h = spr.height;
-          unsigned char* colldata = new unsigned char[w*h];
+          collision_mask* colldata = new collision_mask(w, h);
 
           for (unsigned int rowindex = 0; rowindex < h; rowindex++)
           {
+            const unsigned char* alpha = data + 4*rowindex*w + 3;
+            uint64_t* row = &colldata->bits[size_t(rowindex)*colldata->words];
             for(unsigned int colindex = 0; colindex < w; colindex++)
             {
-              colldata[rowindex*w + colindex] = (data[4*(rowindex*w + colindex) + 3] != 0) ? 1 : 0; // If alpha != 0 then 1 else 0.
+              row[colindex >> 6] |= uint64_t(alpha[4*colindex] != 0) << (colindex & 63);
             }
           }
 
@@ -55,7 +59,7 @@ namespace enigma
         {
           // Create ellipse inside bbox.
           const unsigned int w = spr.width, h = spr.height;
-          unsigned char* colldata = new unsigned char[w*h](); // Initialize all elements to 0.
+          collision_mask* colldata = new collision_mask(w, h); // All bits start clear.
           const BoundingBox bbox = spr.bbox;
 
           const unsigned int a = max(bbox.right()-bbox.left(), bbox.bottom()-bbox.top())/2, // Major radius.
@@ -75,7 +79,7 @@ namespace enigma
             {
               const int xcp = x-xc, ycp = y-yc; // Center to point.
               const bool is_inside_ellipse = b_2*xcp*xcp + a_2*ycp*ycp <= a_2b_2;
-              colldata[y*w + x] = (is_inside_ellipse ? 1 : 0); // If point inside ellipse, 1, else 0.
+              if (is_inside_ellipse) colldata->set(x, y); // Set the bits inside the ellipse.
             }
           }
 
@@ -85,7 +89,7 @@ namespace enigma
         {
           // Create diamond inside bbox.
           const unsigned int w = spr.width, h = spr.height;
-          unsigned char* colldata = new unsigned char[w*h](); // Initialize all elements to 0.
+          collision_mask* colldata = new collision_mask(w, h); // All bits start clear.
           const BoundingBox bbox = spr.bbox;
 
           // Diamond corners.
@@ -113,7 +117,7 @@ namespace enigma
                                               cp(xlb, -ylb, xlp, -ylp) >= 0 &&
                                               cp(xrt, -yrt, xrp, -yrp) >= 0 &&
                                               cp(xrb, -yrb, xrp, -yrp) <= 0;
-              colldata[y*w + x] = (is_inside_diamond ? 1 : 0); // If point inside diamond, 1, else 0.
+              if (is_inside_diamond) colldata->set(x, y); // Set the bits inside the diamond.
             }
           }
 
@@ -124,7 +128,7 @@ namespace enigma
         {
           // Create circle fitting inside bbox.
           const unsigned int w = spr.width, h = spr.height;
-          unsigned char* colldata = new unsigned char[w*h](); // Initialize all elements to 0.
+          collision_mask* colldata = new collision_mask(w, h); // All bits start clear.
           const BoundingBox bbox = spr.bbox;
 
           const unsigned int r = min(bbox.right()-bbox.left(), bbox.bottom()-bbox.top())/2; // Radius.
@@ -143,7 +147,7 @@ namespace enigma
             {
               const int xcp = x-xc, ycp = y-yc; // Center to point.
               const bool is_inside_circle = xcp*xcp + ycp*ycp <= r_2;
-              colldata[y*w + x] = (is_inside_circle ? 1 : 0); // If point inside circle, 1, else 0.
+              if (is_inside_circle) colldata->set(x, y); // Set the bits inside the circle.
             }
           }
 
@@ -156,7 +160,7 @@ namespace enigma
   void free_collision_mask(void* mask)
   {
     if (mask != 0) {
-      delete[] (unsigned char*)mask;
+      delete (collision_mask*)mask;
     }
   }
 };
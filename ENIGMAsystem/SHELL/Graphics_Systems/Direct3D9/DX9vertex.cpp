@@ -210,6 +210,7 @@ void vertex_color(int buffer, int color, double alpha) {
 
 void vertex_submit_offset(int buffer, int primitive, unsigned offset, unsigned start, unsigned count) {
   draw_state_flush();
+  enigma::vertices_submitted += count;
 
   const auto& vertexBuffer = enigma::vertexBuffers[buffer];
 
@@ -228,6 +229,7 @@ void vertex_submit_offset(int buffer, int primitive, unsigned offset, unsigned s
 
 void index_submit_range(int buffer, int vertex, int primitive, unsigned start, unsigned count) {
   draw_state_flush();
+  enigma::vertices_submitted += count;
 
   const auto& vertexBuffer = enigma::vertexBuffers[vertex];
 
@@ -30,7 +30,10 @@
 #include "Universal_System/Resources/sprites.h"
 
 #include <cmath>
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <stdint.h>
 
 using namespace std;
@@ -50,6 +53,7 @@ namespace enigma {
 }
 
 using namespace enigma;
+using namespace enigma_user;
 /*const int fa_left = 0;
 const int fa_center = 1;
 const int fa_right = 2;
@@ -62,7 +66,7 @@ unsigned valign = enigma_user::fa_top; //default alignment
 
 const string unicodeAnds = "\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x1F\x0F\x0F\x0F\x0F\x0F\x0F\x0F\x0F\x07\x07\x07\x07\x03\x03\x01";
 
-static uint32_t getUnicodeCharacter(const string str, size_t& pos) {
+static uint32_t getUnicodeCharacter(const string& str, size_t& pos) {
   uint32_t character = 0;
   if (str[pos] & 0x80) {
     character = (str[pos] & unicodeAnds[(str[pos] >> 1) & 0x1F]);
@@ -97,7 +101,7 @@ unsigned draw_get_valign(){
 
 namespace enigma {
   inline float get_space_width(const SpriteFont& fnt) {
-    fontglyph g = findGlyph(fnt, ' ');
+    const fontglyph& g = findGlyph(fnt, ' ');
     // Use the width of the space glyph when available,
     // else use the backup.
     // FIXME: Find out why the width is not available on Linux.
@@ -122,7 +126,7 @@ double string_char_width(variant vstr)
   if (character == ' ') {
     return get_space_width(fnt);
   }
-  fontglyph g = findGlyph(fnt, character);
+  const fontglyph& g = findGlyph(fnt, character);
   if (g.empty()) {
     return get_space_width(fnt);
   } else {
@@ -141,7 +145,7 @@ unsigned int string_width(variant vstr)
     if (character == '\r' or character == '\n') {
       tlen = 0;
     } else {
-      fontglyph g = findGlyph(fnt, character);
+      const fontglyph& g = findGlyph(fnt, character);
       if (character == ' ' or g.empty()) {
         tlen += slen;
       } else {
@@ -174,7 +178,7 @@ unsigned int string_width_ext(variant vstr, gs_scalar sep, gs_scalar w) //here s
   {
     uint32_t character = getUnicodeCharacter(str, i);
 
-    fontglyph g = findGlyph(fnt, character);
+    const fontglyph& g = findGlyph(fnt, character);
     if (character == ' ' or g.empty()) {
         if (width >= w && w!=-1) {
           (width>maxwidth ? maxwidth=width, width = 0 : width = 0);
@@ -201,7 +205,7 @@ unsigned int string_height_ext(variant vstr, gs_scalar sep, gs_scalar w)
     if (character == '\r' or character == '\n') {
       width = 0, height +=  (sep+2 ? fnt.height : sep);
     } else {
-      fontglyph g = findGlyph(fnt, character);
+      const fontglyph& g = findGlyph(fnt, character);
       if (character == ' ' or g.empty()) {
         width += slen;
       }
@@ -244,7 +248,7 @@ unsigned int string_width_line(variant vstr, int line)
       cl += 1;
       len = 0;
     } else {
-      fontglyph g = findGlyph(fnt, character);
+      const fontglyph& g = findGlyph(fnt, character);
       if (character == ' ' or g.empty())
         len += slen;
       else {
@@ -270,7 +274,7 @@ unsigned int string_width_ext_line(variant vstr, gs_scalar w, int line)
     } else if (character == '\n') {
       if (cl == line) return ceil(width); else width = 0, cl +=1;
     } else {
-      fontglyph g = findGlyph(fnt, character);
+      const fontglyph& g = findGlyph(fnt, character);
       if ((character == ' ' or g.empty()) && w != -1) {
         width += slen, tw = 0;
         for (size_t c = i+1; c < str.length(); c++)
@@ -278,7 +282,7 @@ unsigned int string_width_ext_line(variant vstr, gs_scalar w, int line)
           uint32_t ct = getUnicodeCharacter(str, c);
           if (ct == ' ' or ct == '\r' or ct == '\n')
             break;
-          fontglyph gt = findGlyph(fnt, ct);
+          const fontglyph& gt = findGlyph(fnt, ct);
           tw += (!gt.empty() ? g.xs : slen);
         }
         if (width+tw >= w){
@@ -311,7 +315,7 @@ unsigned int string_width_ext_line_count(variant vstr, gs_scalar w)
     } else if (character == '\n') {
       width = 0, cl +=1;
     } else {
-      fontglyph g = findGlyph(fnt, character);
+      const fontglyph& g = findGlyph(fnt, character);
       if ((character == ' ' or g.empty()) && w != -1){
         width += slen, tw = 0;
         for (size_t c = i+1; c < str.length(); c++)
@@ -319,7 +323,7 @@ unsigned int string_width_ext_line_count(variant vstr, gs_scalar w)
           uint32_t ct = getUnicodeCharacter(str, c);
           if (ct == ' ' or ct == '\r' or ct == '\n')
             break;
-          fontglyph gt = findGlyph(fnt, ct);
+          const fontglyph& gt = findGlyph(fnt, ct);
           tw += (!gt.empty() ? g.xs : slen);
         }
         if (width+tw >= w)
@@ -334,15 +338,46 @@ unsigned int string_width_ext_line_count(variant vstr, gs_scalar w)
 
 }
 
-////////////////////////////////////////////////////
+namespace {
+
+// One glyph of a laid-out string, relative to the point the string is drawn at.
+struct text_quad {
+  gs_scalar x, y, x2, y2;
+  float tx, ty, tx2, ty2;
+};
+
+// The glyph quads of a string in some font, alignment and wrapping. revision
+// is the font's revision when the quads were built; sep and w only count for
+// draw_text_ext.
+struct text_layout {
+  size_t hash;
+  int font;
+  string text;
+  bool ext;
+  gs_scalar sep, w;
+  unsigned halign, valign;
+  unsigned revision;
+  int texture;
+  vector<text_quad> quads;
+
+  bool matches(int fnt, const string& str, bool e, gs_scalar s, gs_scalar wd) const {
+    return font == fnt && ext == e && (!e || (sep == s && w == wd)) &&
+           halign == ::halign && valign == ::valign && text == str;
+  }
+};
 
-namespace enigma_user
-{
+// Layouts of the most recently drawn strings, most recent first. Text that
+// stays the same from frame to frame (HUDs, labels, menus) is only laid out
+// once, and drawing it is a copy of its quads.
+const size_t text_layout_cache_size = 256;
+std::list<text_layout> text_layouts;
+std::unordered_multimap<size_t, std::list<text_layout>::iterator> text_layout_index;
 
-void draw_text(gs_scalar x, gs_scalar y, variant vstr)
+}
+
+static void layout_text(const SpriteFont& fnt, const string& str, vector<text_quad>& quads)
 {
-  string str = toString(vstr);
-  const SpriteFont& fnt = sprite_fonts[currentfont];
+  const gs_scalar x = 0, y = 0;
   gs_scalar yy = valign == fa_top ? y+fnt.yoffset : valign == fa_middle ? y +fnt.yoffset - string_height(str)/2 : y + fnt.yoffset - string_height(str);
   float slen = get_space_width(fnt);
   if (halign == fa_left){
@@ -356,16 +391,11 @@ void draw_text(gs_scalar x, gs_scalar y, variant vstr)
         } else if (character == '\n') {
           xx = x, yy += fnt.height;
         } else {
-          fontglyph g = findGlyph(fnt, character);
+          const fontglyph& g = findGlyph(fnt, character);
           if (character == ' ' or g.empty()) {
             xx += slen;
           } else {
-            draw_primitive_begin_texture(pr_trianglestrip, fnt.texture);
-            draw_vertex_texture(xx + g.x,  yy + g.y, g.tx, g.ty);
-            draw_vertex_texture(xx + g.x2, yy + g.y, g.tx2, g.ty);
-            draw_vertex_texture(xx + g.x,  yy + g.y2, g.tx,  g.ty2);
-            draw_vertex_texture(xx + g.x2, yy + g.y2, g.tx2, g.ty2);
-            draw_primitive_end();
+            quads.push_back(text_quad{xx + g.x, yy + g.y, xx + g.x2, yy + g.y2, g.tx, g.ty, g.tx2, g.ty2});
             xx += gs_scalar(g.xs);
           }
         }
@@ -383,16 +413,11 @@ void draw_text(gs_scalar x, gs_scalar y, variant vstr)
           line +=1, yy += fnt.height;
           xx = halign == fa_center ? x-gs_scalar(string_width_line(str,line)/2) : x-gs_scalar(string_width_line(str,line));
         } else {
-          fontglyph g = findGlyph(fnt, character);
+          const fontglyph& g = findGlyph(fnt, character);
           if (character == ' ' or g.empty()) {
             xx += slen;
           } else {
-            draw_primitive_begin_texture(pr_trianglestrip, fnt.texture);
-            draw_vertex_texture(xx + g.x,  yy + g.y, g.tx, g.ty);
-            draw_vertex_texture(xx + g.x2, yy + g.y, g.tx2, g.ty);
-            draw_vertex_texture(xx + g.x,  yy + g.y2, g.tx,  g.ty2);
-            draw_vertex_texture(xx + g.x2, yy + g.y2, g.tx2, g.ty2);
-            draw_primitive_end();
+            quads.push_back(text_quad{xx + g.x, yy + g.y, xx + g.x2, yy + g.y2, g.tx, g.ty, g.tx2, g.ty2});
             xx += gs_scalar(g.xs);
           }
         }
@@ -400,6 +425,146 @@ void draw_text(gs_scalar x, gs_scalar y, variant vstr)
   }
 }
 
+static void layout_text_ext(const SpriteFont& fnt, const string& str, gs_scalar sep, gs_scalar w, vector<text_quad>& quads)
+{
+  const gs_scalar x = 0, y = 0;
+  gs_scalar yy = valign == fa_top ? y+fnt.yoffset : valign == fa_middle ? y + fnt.yoffset - string_height_ext(str,sep,w)/2 : y + fnt.yoffset - string_height_ext(str,sep,w);
+  float slen = get_space_width(fnt);
+  if (halign == fa_left){
+    gs_scalar xx = x, width = 0, tw = 0;
+    for (size_t i = 0; i < str.length(); i++)
+    {
+      uint32_t character = getUnicodeCharacter(str, i);
+      if (character == '\r') {
+        xx = x, yy += (sep+2 ? fnt.height : sep), i += str[i+1] == '\n';
+      } else if (character == '\n') {
+            xx = x, yy += (sep+2 ? fnt.height : sep);
+      } else {
+        fontglyph g = findGlyph(fnt, character);
+        if (character == ' ' or g.empty()) {
+          xx += slen, width = xx-x;
+          tw = 0;
+          for (size_t c = i+1; c < str.length(); c++)
+          {
+            character = getUnicodeCharacter(str, c);
+            if (character == ' ' or character == '\r' or character == '\n')
+              break;
+            g = findGlyph(fnt, character);
+            tw += (!g.empty()?g.xs:slen);
+          }
+          if (width+tw >= w && w != -1)
+          xx = x, yy += (sep==-1 ? fnt.height : sep), width = 0, tw = 0;
+        } else {
+          quads.push_back(text_quad{xx + g.x, yy + g.y, xx + g.x2, yy + g.y2, g.tx, g.ty, g.tx2, g.ty2});
+          xx += gs_scalar(g.xs);
+        }
+      }
+    }
+  } else {
+    gs_scalar xx = halign == fa_center ? x-gs_scalar(string_width_ext_line(str,w,0)/2) : x-gs_scalar(string_width_ext_line(str,w,0)), line = 0, width = 0, tw = 0;
+    for (size_t i = 0; i < str.length(); i++)
+    {
+      uint32_t character = getUnicodeCharacter(str, i);
+      if (character == '\r') {
+        line += 1, xx = halign == fa_center ? x-gs_scalar(string_width_ext_line(str,w,line)/2) : x-gs_scalar(string_width_ext_line(str,w,line)), yy += (sep+2 ? fnt.height : sep), i += str[i+1] == '\n', width = 0;
+      } else if (character == '\n') {
+        line += 1, xx = halign == fa_center ? x-gs_scalar(string_width_ext_line(str,w,line)/2) : x-gs_scalar(string_width_ext_line(str,w,line)), yy += (sep+2 ? fnt.height : sep), width = 0;
+      } else {
+        fontglyph g = findGlyph(fnt, character);
+        if (character == ' ' or g.empty()) {
+          xx += slen, width += slen, tw = 0;
+          for (size_t c = i+1; c < str.length(); c++)
+          {
+            character = getUnicodeCharacter(str, c);
+            if (character == ' ' or character == '\r' or character == '\n')
+              break;
+            g = findGlyph(fnt, character);
+            tw += (!g.empty() ? g.xs : slen);
+          }
+
+          if (width+tw >= w && w != -1)
+            line += 1, xx = halign == fa_center ? x-gs_scalar(string_width_ext_line(str,w,line)/2) : x-gs_scalar(string_width_ext_line(str,w,line)), yy += (sep==-1 ? fnt.height : sep), width = 0, tw = 0;
+        } else {
+          quads.push_back(text_quad{xx + g.x, yy + g.y, xx + g.x2, yy + g.y2, g.tx, g.ty, g.tx2, g.ty2});
+          xx += gs_scalar(g.xs);
+          width += g.xs;
+        }
+      }
+    }
+  }
+}
+
+static void build_text_layout(const SpriteFont& fnt, text_layout& layout) {
+  layout.quads.clear();
+  if (layout.ext) layout_text_ext(fnt, layout.text, layout.sep, layout.w, layout.quads);
+  else layout_text(fnt, layout.text, layout.quads);
+  layout.revision = fnt.revision;
+  layout.texture = fnt.texture;
+}
+
+static const text_layout& get_text_layout(const string& str, bool ext, gs_scalar sep, gs_scalar w) {
+  const int font = currentfont;
+  const SpriteFont& fnt = sprite_fonts[font];
+  const size_t hash = std::hash<string>()(str) ^ (size_t(font) * 0x9E3779B1u + (halign << 2) + valign + (ext << 4));
+
+  auto found = text_layout_index.equal_range(hash);
+  for (auto it = found.first; it != found.second; ++it) {
+    text_layout& layout = *it->second;
+    if (!layout.matches(font, str, ext, sep, w)) continue;
+    text_layouts.splice(text_layouts.begin(), text_layouts, it->second);
+    if (layout.revision != fnt.revision || layout.texture != fnt.texture)
+      build_text_layout(fnt, layout);
+    return layout;
+  }
+
+  if (text_layouts.size() >= text_layout_cache_size) {
+    const text_layout& oldest = text_layouts.back();
+    auto stale = text_layout_index.equal_range(oldest.hash);
+    for (auto it = stale.first; it != stale.second; ++it) {
+      if (&*it->second == &oldest) {
+        text_layout_index.erase(it);
+        break;
+      }
+    }
+    text_layouts.pop_back();
+  }
+
+  text_layouts.push_front(text_layout{hash, font, str, ext, sep, w, halign, valign, 0, -1, {}});
+  text_layout_index.emplace(hash, text_layouts.begin());
+  text_layout& layout = text_layouts.front();
+  build_text_layout(fnt, layout);
+  return layout;
+}
+
+// All the glyphs go out as one triangle list, rather than a strip apiece.
+static void draw_text_layout(gs_scalar x, gs_scalar y, const text_layout& layout) {
+  if (layout.quads.empty()) return;
+  draw_primitive_begin_texture(pr_trianglelist, layout.texture);
+  for (const text_quad& q : layout.quads) {
+    draw_vertex_texture(x + q.x,  y + q.y,  q.tx,  q.ty);
+    draw_vertex_texture(x + q.x2, y + q.y,  q.tx2, q.ty);
+    draw_vertex_texture(x + q.x,  y + q.y2, q.tx,  q.ty2);
+    draw_vertex_texture(x + q.x,  y + q.y2, q.tx,  q.ty2);
+    draw_vertex_texture(x + q.x2, y + q.y,  q.tx2, q.ty);
+    draw_vertex_texture(x + q.x2, y + q.y2, q.tx2, q.ty2);
+  }
+  draw_primitive_end();
+}
+
+////////////////////////////////////////////////////
+
+namespace enigma_user
+{
+
+void draw_text(gs_scalar x, gs_scalar y, variant vstr)
+{
+  draw_text_layout(x, y, get_text_layout(toString(vstr), false, -1, -1));
+}
+
+void draw_text_ext(gs_scalar x, gs_scalar y, variant vstr, gs_scalar sep, gs_scalar w)
+{
+  draw_text_layout(x, y, get_text_layout(toString(vstr), true, sep, w));
+}
 
 void draw_text_sprite(gs_scalar x, gs_scalar y, variant vstr, int sep, int lineWidth, int sprite, int firstChar, int scale)
 {
@@ -484,7 +649,7 @@ void draw_text_skewed(gs_scalar x, gs_scalar y, variant vstr, gs_scalar top, gs_
       } else if (character == '\n') {
         xx = x, yy += fnt.height;
       } else {
-        fontglyph g = findGlyph(fnt, character);
+        const fontglyph& g = findGlyph(fnt, character);
         if (character == ' ' or g.empty()) {
           xx += slen;
         } else {
@@ -511,7 +676,7 @@ void draw_text_skewed(gs_scalar x, gs_scalar y, variant vstr, gs_scalar top, gs_
         line +=1, yy += fnt.height;
         xx = halign == fa_center ? x-gs_scalar(string_width_line(str,line)/2) : x-gs_scalar(string_width_line(str,line));
       } else {
-        fontglyph g = findGlyph(fnt, character);
+        const fontglyph& g = findGlyph(fnt, character);
         if (character == ' ' or g.empty()) {
           xx += slen;
         } else {
@@ -528,87 +693,6 @@ void draw_text_skewed(gs_scalar x, gs_scalar y, variant vstr, gs_scalar top, gs_
   }
 }
 
-void draw_text_ext(gs_scalar x, gs_scalar y, variant vstr, gs_scalar sep, gs_scalar w)
-{
-  string str = toString(vstr);
-  const SpriteFont& fnt = sprite_fonts[currentfont];
-
-  gs_scalar yy = valign == fa_top ? y+fnt.yoffset : valign == fa_middle ? y + fnt.yoffset - string_height_ext(str,sep,w)/2 : y + fnt.yoffset - string_height_ext(str,sep,w);
-  float slen = get_space_width(fnt);
-  if (halign == fa_left){
-    gs_scalar xx = x, width = 0, tw = 0;
-    for (size_t i = 0; i < str.length(); i++)
-    {
-      uint32_t character = getUnicodeCharacter(str, i);
-      if (character == '\r') {
-        xx = x, yy += (sep+2 ? fnt.height : sep), i += str[i+1] == '\n';
-      } else if (character == '\n') {
-            xx = x, yy += (sep+2 ? fnt.height : sep);
-      } else {
-        fontglyph g = findGlyph(fnt, character);
-        if (character == ' ' or g.empty()) {
-          xx += slen, width = xx-x;
-          tw = 0;
-          for (size_t c = i+1; c < str.length(); c++)
-          {
-            character = getUnicodeCharacter(str, c);
-            if (character == ' ' or character == '\r' or character == '\n')
-              break;
-            g = findGlyph(fnt, character);
-            tw += (!g.empty()?g.xs:slen);
-          }
-          if (width+tw >= w && w != -1)
-          xx = x, yy += (sep==-1 ? fnt.height : sep), width = 0, tw = 0;
-        } else {
-          draw_primitive_begin_texture(pr_trianglestrip, fnt.texture);
-          draw_vertex_texture(xx + g.x,  yy + g.y, g.tx, g.ty);
-          draw_vertex_texture(xx + g.x2, yy + g.y, g.tx2, g.ty);
-          draw_vertex_texture(xx + g.x,  yy + g.y2, g.tx,  g.ty2);
-          draw_vertex_texture(xx + g.x2, yy + g.y2, g.tx2, g.ty2);
-          draw_primitive_end();
-          xx += gs_scalar(g.xs);
-        }
-      }
-    }
-  } else {
-    gs_scalar xx = halign == fa_center ? x-gs_scalar(string_width_ext_line(str,w,0)/2) : x-gs_scalar(string_width_ext_line(str,w,0)), line = 0, width = 0, tw = 0;
-    for (size_t i = 0; i < str.length(); i++)
-    {
-      uint32_t character = getUnicodeCharacter(str, i);
-      if (character == '\r') {
-        line += 1, xx = halign == fa_center ? x-gs_scalar(string_width_ext_line(str,w,line)/2) : x-gs_scalar(string_width_ext_line(str,w,line)), yy += (sep+2 ? fnt.height : sep), i += str[i+1] == '\n', width = 0;
-      } else if (character == '\n') {
-        line += 1, xx = halign == fa_center ? x-gs_scalar(string_width_ext_line(str,w,line)/2) : x-gs_scalar(string_width_ext_line(str,w,line)), yy += (sep+2 ? fnt.height : sep), width = 0;
-      } else {
-        fontglyph g = findGlyph(fnt, character);
-        if (character == ' ' or g.empty()) {
-          xx += slen, width += slen, tw = 0;
-          for (size_t c = i+1; c < str.length(); c++)
-          {
-            character = getUnicodeCharacter(str, c);
-            if (character == ' ' or character == '\r' or character == '\n')
-              break;
-            g = findGlyph(fnt, character);
-            tw += (!g.empty() ? g.xs : slen);
-          }
-
-          if (width+tw >= w && w != -1)
-            line += 1, xx = halign == fa_center ? x-gs_scalar(string_width_ext_line(str,w,line)/2) : x-gs_scalar(string_width_ext_line(str,w,line)), yy += (sep==-1 ? fnt.height : sep), width = 0, tw = 0;
-        } else {
-          draw_primitive_begin_texture(pr_trianglestrip, fnt.texture);
-          draw_vertex_texture(xx + g.x,  yy + g.y, g.tx, g.ty);
-          draw_vertex_texture(xx + g.x2, yy + g.y, g.tx2, g.ty);
-          draw_vertex_texture(xx + g.x,  yy + g.y2, g.tx,  g.ty2);
-          draw_vertex_texture(xx + g.x2, yy + g.y2, g.tx2, g.ty2);
-          draw_primitive_end();
-          xx += gs_scalar(g.xs);
-          width += g.xs;
-        }
-      }
-    }
-  }
-}
-
 void draw_text_transformed(gs_scalar x, gs_scalar y, variant vstr, gs_scalar xscale, gs_scalar yscale, double rot)
 {
   string str = toString(vstr);
@@ -639,7 +723,7 @@ void draw_text_transformed(gs_scalar x, gs_scalar y, variant vstr, gs_scalar xsc
         } else if (character == '\n') {
           lines += 1, xx = tmpx + lines * shi, yy = tmpy + lines * chi;
         } else {
-          fontglyph g = findGlyph(fnt, character);
+          const fontglyph& g = findGlyph(fnt, character);
           if (character == ' ' or g.empty()) {
             xx += sw,
             yy -= sh;
@@ -683,7 +767,7 @@ void draw_text_transformed(gs_scalar x, gs_scalar y, variant vstr, gs_scalar xsc
           else
             xx = tmpx-tmpsize * cvx + lines * shi, yy = tmpy+tmpsize * svx + lines * chi;
         } else {
-          fontglyph g = findGlyph(fnt, character);
+          const fontglyph& g = findGlyph(fnt, character);
           if (character == ' ' or g.empty()) {
               xx += sw,
             yy -= sh;
@@ -874,7 +958,7 @@ void draw_text_transformed_color(gs_scalar x, gs_scalar y, variant vstr, gs_scal
         } else if (character == '\n') {
           lines += 1, width = 0, xx = tmpx + lines * shi, yy = tmpy + lines * chi, tmpsize = string_width_line(str,lines);
         } else {
-          fontglyph g = findGlyph(fnt, character);
+          const fontglyph& g = findGlyph(fnt, character);
           if (character == ' ' or g.empty()) {
             xx += sw, yy -= sh,
             width += sw;
@@ -923,7 +1007,7 @@ void draw_text_transformed_color(gs_scalar x, gs_scalar y, variant vstr, gs_scal
           else
             xx = tmpx-tmpsize * cvx + lines * shi, yy = tmpy+tmpsize * svx + lines * chi;
         } else {
-          fontglyph g = findGlyph(fnt, character);
+          const fontglyph& g = findGlyph(fnt, character);
           if (character == ' ' or g.empty()) {
             xx += sw, yy -= sh,
             width += sw;
@@ -1116,7 +1200,7 @@ void draw_text_color(gs_scalar x, gs_scalar y,variant vstr,int c1,int c2,int c3,
           line += 1;
           sw = (gs_scalar)string_width_line(str, line);
         } else {
-          fontglyph g = findGlyph(fnt, character);
+          const fontglyph& g = findGlyph(fnt, character);
           if (character == ' ' or g.empty()) {
             xx += slen;
           } else {
@@ -1149,7 +1233,7 @@ void draw_text_color(gs_scalar x, gs_scalar y,variant vstr,int c1,int c2,int c3,
           yy += fnt.height, line += 1, sw = (gs_scalar)string_width_line(str, line),
           xx = halign == fa_center ? x-sw/2 : x-sw, tmpx = xx;
         } else {
-          fontglyph g = findGlyph(fnt, character);
+          const fontglyph& g = findGlyph(fnt, character);
           if (character == ' ' or g.empty()) {
             xx += slen;
           } else {
@@ -31,6 +31,7 @@
 #include "Universal_System/image_formats.h"
 #include "Universal_System/Resources/backgrounds.h"
 #include "Universal_System/Object_Tiers/graphics_object.h"
+#include "Universal_System/Object_Tiers/object.h"
 #include "Universal_System/depth_draw.h"
 #include "Universal_System/Instances/instance_system.h"
 #include "Universal_System/roomsystem.h"
@@ -40,6 +41,7 @@
 #include "Graphics_Systems/graphics_mandatory.h"
 
 #include <string>
+#include <cmath>
 #include <cstdio>
 #include <limits>
 
@@ -81,6 +83,53 @@ RawImage create_from_screen_helper(int x, int y, int w, int h, bool removeback,
 //These are used to reset the screen viewport for surfaces
 gs_scalar viewport_x, viewport_y, viewport_w, viewport_h;
 
+//View culling; see draw_set_view_culling
+bool view_culling = false;
+int instances_culled = 0, instances_drawn = 0;
+
+//The part of the room the view being drawn can show, when culling against it
+struct {
+  bool active = false;
+  gs_scalar left, top, right, bottom;
+} cull_area;
+
+void set_cull_area(gs_scalar x, gs_scalar y, gs_scalar w, gs_scalar h, gs_scalar angle) {
+  // a perspective projection shows more than its ortho rectangle
+  cull_area.active = view_culling && !(enigma::d3dMode && enigma::d3dPerspective);
+  if (!cull_area.active) return;
+  if (std::fmod(angle, 360) != 0) {
+    // the view turns about its center, so take the circle it sweeps
+    const gs_scalar r = std::sqrt(w*w + h*h) / 2;
+    x += w/2 - r, y += h/2 - r, w = h = 2*r;
+  }
+  cull_area.left = x, cull_area.top = y;
+  cull_area.right = x + w, cull_area.bottom = y + h;
+}
+
+// Whether culling may skip the instance's draw: its object allows culling and
+// its sprite, where the default Draw event would put it, is out of the view.
+// Instances with no sprite are always drawn.
+bool cull_instance(enigma::object_graphics* inst) {
+  if (!cull_area.active) return false;
+  const int mode = enigma_user::object_get_draw_culling(inst->object_index);
+  if (!mode || (mode < 0 && !inst->myevent_draw_is_default())) return false;
+  if (!enigma_user::sprite_exists(inst->sprite_index)) return false;
+
+  const enigma::Sprite& spr = enigma::sprites.get(inst->sprite_index);
+  gs_scalar left = -spr.xoffset * inst->image_xscale, right = (spr.width - spr.xoffset) * inst->image_xscale,
+            top = -spr.yoffset * inst->image_yscale, bottom = (spr.height - spr.yoffset) * inst->image_yscale;
+  if (left > right) std::swap(left, right);
+  if (top > bottom) std::swap(top, bottom);
+  if (std::fmod(inst->image_angle, 360) != 0) {
+    // rotation is about the origin; bound the sprite by the circle it sweeps
+    const gs_scalar rx = std::max(-left, right), ry = std::max(-top, bottom),
+                    r = std::sqrt(rx*rx + ry*ry);
+    left = top = -r, right = bottom = r;
+  }
+  return inst->x + right < cull_area.left || inst->x + left > cull_area.right ||
+         inst->y + bottom < cull_area.top || inst->y + top > cull_area.bottom;
+}
+
 } // namespace anonymous
 
 namespace enigma {
@@ -146,9 +195,6 @@ static inline void draw_insts()
     if (inst_depth != NULL) {
       drawing_depths[(*it).second.first].draw_events->unlink(inst_depth->depth.myiter);
       inst_iter* mynewiter = drawing_depths[(*it).second.second].draw_events->add_inst(inst_depth->depth.myiter->inst);
-      if (instance_event_iterator == inst_depth->depth.myiter) {
-        instance_event_iterator = inst_depth->depth.myiter->prev;
-      }
       inst_depth->depth.myiter = mynewiter;
     }
   }
@@ -173,15 +219,24 @@ static inline int draw_tiles()
     if (dit->second.tiles.size())
     {
       for (auto &t : tile_layer_metadata[dit->second.tiles[0].depth]) {
+        if (cull_area.active && (t[5] < cull_area.left || t[3] > cull_area.right ||
+                                 t[6] < cull_area.top || t[4] > cull_area.bottom))
+          continue;
         enigma_user::index_submit_range(enigma::tile_index_buffer, enigma::tile_vertex_buffer, enigma_user::pr_trianglelist, t[0], t[1], t[2]);
       }
     }
     enigma::inst_iter* push_it = enigma::instance_event_iterator;
     //loop instances
-    for (enigma::instance_event_iterator = dit->second.draw_events->next; enigma::instance_event_iterator != NULL; enigma::instance_event_iterator = enigma::instance_event_iterator->next) {
+    for (enigma::instance_event_iterator = dit->second.draw_events->next; enigma::instance_event_iterator != NULL; enigma::instance_event_iterator = enigma::instance_event_iterator->next_after_code()) {
       enigma::object_graphics* inst = ((object_graphics*)enigma::instance_event_iterator->inst);
-      if (inst->myevent_draw_subcheck())
-        inst->myevent_draw();
+      if (inst->myevent_draw_subcheck()) {
+        if (cull_instance(inst)) {
+          instances_culled++;
+        } else {
+          instances_drawn++;
+          inst->myevent_draw();
+        }
+      }
       if (enigma::room_switching_id != -1)
         return 1;
     }
@@ -230,7 +285,7 @@ static inline void draw_gui()
   {
     enigma::inst_iter* push_it = enigma::instance_event_iterator;
     //loop instances
-    for (enigma::instance_event_iterator = dit->second.draw_events->next; enigma::instance_event_iterator != NULL; enigma::instance_event_iterator = enigma::instance_event_iterator->next) {
+    for (enigma::instance_event_iterator = dit->second.draw_events->next; enigma::instance_event_iterator != NULL; enigma::instance_event_iterator = enigma::instance_event_iterator->next_after_code()) {
       enigma::object_graphics* inst = ((object_graphics*)enigma::instance_event_iterator->inst);
       if (inst->myevent_drawgui_subcheck())
         inst->myevent_drawgui();
@@ -337,12 +392,14 @@ void screen_refresh() {
 void screen_redraw()
 {
   enigma::scene_begin();
+  instances_culled = instances_drawn = 0;
 
   if (!view_enabled)
   {
     screen_set_viewport(0, 0, window_get_region_width(), window_get_region_height());
 
     clear_view(0, 0, window_get_region_width(), window_get_region_height(), 0, background_showcolor);
+    set_cull_area(0, 0, window_get_region_width(), window_get_region_height(), 0);
     draw_back();
     draw_insts();
     draw_tiles();
@@ -375,6 +432,7 @@ void screen_redraw()
       screen_set_viewport(view_xport[vc], view_yport[vc], view_wport[vc], view_hport[vc]);
 
       clear_view(view_xview[vc], view_yview[vc], view_wview[vc], view_hview[vc], view_angle[vc], background_showcolor && draw_backs);
+      set_cull_area(view_xview[vc], view_yview[vc], view_wview[vc], view_hview[vc], view_angle[vc]);
 
       if (draw_backs)
         draw_back();
@@ -391,6 +449,7 @@ void screen_redraw()
 
   // normal draw events over, do an implicit flush
   draw_batch_flush(batch_flush_deferred);
+  cull_area.active = false;
 
   // Now process the sub event of draw called draw gui
   // It is for drawing GUI elements without view scaling and transformation
@@ -428,6 +487,25 @@ void screen_redraw()
   screen_refresh();
 }
 
+void draw_set_view_culling(bool enable) {
+  if (view_culling == enable) return;
+  view_culling = enable;
+  enigma::tile_chunk_size = enable ? 512 : 0;
+  enigma::delete_tiles();
+}
+
+bool draw_get_view_culling() {
+  return view_culling;
+}
+
+int draw_get_instances_culled() {
+  return instances_culled;
+}
+
+int draw_get_instances_drawn() {
+  return instances_drawn;
+}
+
 int screen_save(string filename) { //Assumes native integers are little endian
   draw_batch_flush(batch_flush_deferred);
 
@@ -46,6 +46,18 @@ namespace enigma_user {
   void screen_set_viewport(gs_scalar x, gs_scalar y, gs_scalar width, gs_scalar height);
   void screen_reset_viewport();
 
+  // With view culling on, screen_redraw skips tile batches and instance draws
+  // that fall outside the view being drawn. An instance is a candidate when
+  // its object allows it (object_set_draw_culling); by default only objects
+  // without a Draw event of their own are, as their sprite is all they draw.
+  // Culling is off in perspective 3D. Tiles are batched by 512px chunks while
+  // it's on.
+  void draw_set_view_culling(bool enable);
+  bool draw_get_view_culling();
+  // Instance draws skipped and run by the last screen_redraw, over all views.
+  int draw_get_instances_culled();
+  int draw_get_instances_drawn();
+
   unsigned int display_get_gui_width();
   unsigned int display_get_gui_height();
   void display_set_gui_size(unsigned int width, unsigned int height);
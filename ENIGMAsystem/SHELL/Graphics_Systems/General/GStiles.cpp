@@ -34,6 +34,7 @@
 #undef INCLUDED_FROM_SHELLMAIN
 
 #include <algorithm>
+#include <cmath>
 
 namespace {
 
@@ -46,8 +47,10 @@ namespace enigma
     int tile_vertex_buffer = -1, tile_index_buffer = -1;
     //Tile vector holds several values, like number of vertices to render, texture to use and so on
     //The structure is like this [render batch][batch info]
-    //batch info - 0 = texture to use, 1 = vertices to render,
+    //batch info - 0 = texture to use, 1 = first index, 2 = indices to render,
+    //3-6 = left, top, right and bottom of the batch's tiles in the room
     std::map<int,std::vector<std::vector<int> > > tile_layer_metadata;
+    int tile_chunk_size = 0;
 
     static void draw_tile(int &ind, int index, int vertex, const tile& t)
     {
@@ -84,6 +87,16 @@ namespace enigma
       ind += 4;
     }
 
+    // The room area a tile covers, rounded out to whole pixels.
+    static void tile_bounds(const tile& t, int &left, int &top, int &right, int &bottom)
+    {
+      const gs_scalar x2 = t.roomX + t.width*t.xscale, y2 = t.roomY + t.height*t.yscale;
+      left = std::floor(std::min<gs_scalar>(t.roomX, x2));
+      top = std::floor(std::min<gs_scalar>(t.roomY, y2));
+      right = std::ceil(std::max<gs_scalar>(t.roomX, x2));
+      bottom = std::ceil(std::max<gs_scalar>(t.roomY, y2));
+    }
+
     void load_tiles()
     {
         if (!tiles_are_dirty) return;
@@ -109,34 +122,63 @@ namespace enigma
         else
             enigma_user::index_clear(tile_index_buffer);
 
+        // Short indices only reach 16384 tiles; big rooms need full ints.
+        size_t tile_count = 0;
+        for (enigma::diter dit = drawing_depths.rbegin(); dit != drawing_depths.rend(); dit++)
+            tile_count += dit->second.tiles.size();
+
         enigma_user::vertex_begin(tile_vertex_buffer, vertexFormat);
-        enigma_user::index_begin(tile_index_buffer, enigma_user::index_type_ushort);
+        enigma_user::index_begin(tile_index_buffer, tile_count * 4 > 65536 ? enigma_user::index_type_uint : enigma_user::index_type_ushort);
 
         int vertex_ind = 0, index_start = 0;
         for (enigma::diter dit = drawing_depths.rbegin(); dit != drawing_depths.rend(); dit++) {
             auto& dtiles = dit->second.tiles;
-            if (dtiles.size())
+            if (dtiles.empty()) continue;
+            const auto layer_depth = dit->first;
+
+            // With chunking on, a layer's tiles are grouped by the chunk their
+            // top-left corner falls in, keeping their order within a chunk, and
+            // no batch spans two chunks; so a view can skip whole batches.
+            std::vector<size_t> order(dtiles.size());
+            std::vector<long long> chunks(dtiles.size(), 0);
+            for (size_t i = 0; i < dtiles.size(); ++i) {
+                order[i] = i;
+                if (tile_chunk_size > 0) {
+                    int left, top, right, bottom;
+                    tile_bounds(dtiles[i], left, top, right, bottom);
+                    const long long cx = std::floor(left / double(tile_chunk_size)),
+                                    cy = std::floor(top / double(tile_chunk_size));
+                    chunks[i] = cy * 0x100000000LL + cx;
+                }
+            }
+            if (tile_chunk_size > 0) {
+                std::stable_sort(order.begin(), order.end(),
+                                 [&](size_t a, size_t b) { return chunks[a] < chunks[b]; });
+            }
+
+            std::vector<std::vector<int> >& batches = tile_layer_metadata[layer_depth];
+            for (size_t n = 0; n < order.size(); ++n)
             {
-                const auto layer_depth = dit->first;
-                for (std::vector<tile>::size_type i = 0; i != dtiles.size(); ++i)
-                {
-                    const tile& t = dtiles[i];
-                    const enigma::Background& bck2d = enigma::backgrounds.get(t.bckid);
-                    
-                    // if this is the first tile, go ahead and start a batch
-                    if (i == 0)
-                        tile_layer_metadata[layer_depth].push_back({bck2d.textureID, index_start, 0});
-                    std::vector<int>& batch = tile_layer_metadata[layer_depth].back();
-                    draw_tile(vertex_ind, tile_index_buffer, tile_vertex_buffer, t);
-                    // if this tile has the same texture as the batch, then just increase
-                    // the index count, otherwise, start a new batch that includes this tile
-                    if (batch[0] == bck2d.textureID) {
-                        batch[2] += 6;
-                    } else {
-                        tile_layer_metadata[layer_depth].push_back({bck2d.textureID, index_start, 6});
-                    }
-                    index_start += 6;
+                const tile& t = dtiles[order[n]];
+                if (!enigma_user::background_exists(t.bckid)) continue;
+                const enigma::Background& bck2d = enigma::backgrounds.get(t.bckid);
+                int left, top, right, bottom;
+                tile_bounds(t, left, top, right, bottom);
+
+                // start a new batch when the texture or the chunk changes,
+                // otherwise just grow the current one
+                if (batches.empty() || batches.back()[0] != bck2d.textureID ||
+                    (n && chunks[order[n]] != chunks[order[n - 1]])) {
+                    batches.push_back({bck2d.textureID, index_start, 0, left, top, right, bottom});
                 }
+                std::vector<int>& batch = batches.back();
+                draw_tile(vertex_ind, tile_index_buffer, tile_vertex_buffer, t);
+                batch[2] += 6;
+                batch[3] = std::min(batch[3], left);
+                batch[4] = std::min(batch[4], top);
+                batch[5] = std::max(batch[5], right);
+                batch[6] = std::max(batch[6], bottom);
+                index_start += 6;
             }
         }
 
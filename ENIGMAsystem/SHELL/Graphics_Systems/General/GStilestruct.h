@@ -31,6 +31,10 @@ namespace enigma
 {
     extern int tile_vertex_buffer, tile_index_buffer;
     extern std::map<int,std::vector<std::vector<int> > > tile_layer_metadata;
+    // Side of the square room chunks tile batches are split by so views can
+    // cull them; 0 batches each layer as a whole. Call delete_tiles() after
+    // changing it.
+    extern int tile_chunk_size;
 
     void draw_tile();
     void delete_tiles();
@@ -54,6 +54,7 @@ namespace enigma {
 vector<std::unique_ptr<VertexFormat>> vertexFormats;
 vector<std::unique_ptr<VertexBuffer>> vertexBuffers;
 vector<std::unique_ptr<IndexBuffer>> indexBuffers;
+unsigned long long vertices_submitted = 0;
 
 } // namespace enigma
 
@@ -334,6 +335,10 @@ void vertex_submit_offset(int buffer, int primitive, int texture, unsigned offse
   vertex_submit_offset(buffer, primitive, offset, start, count);
 }
 
+unsigned long long vertex_get_submitted() {
+  return enigma::vertices_submitted;
+}
+
 int index_create_buffer() {
   int id = enigma::indexBuffers.size();
   enigma::indexBuffers.push_back(std::make_unique<enigma::IndexBuffer>());
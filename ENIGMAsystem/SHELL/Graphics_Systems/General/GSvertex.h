@@ -98,6 +98,8 @@ void vertex_submit_range(int buffer, int primitive, unsigned start, unsigned cou
 void vertex_submit_range(int buffer, int primitive, int texture, unsigned start, unsigned count);
 void vertex_submit_offset(int buffer, int primitive, unsigned offset, unsigned start, unsigned count);
 void vertex_submit_offset(int buffer, int primitive, int texture, unsigned offset, unsigned start, unsigned count);
+// total number of vertices submitted for drawing since the game started
+unsigned long long vertex_get_submitted();
 
 enum {
   index_type_ushort,
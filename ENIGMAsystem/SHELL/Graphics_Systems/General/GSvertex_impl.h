@@ -175,6 +175,10 @@ extern vector<std::unique_ptr<VertexFormat>> vertexFormats;
 extern vector<std::unique_ptr<VertexBuffer>> vertexBuffers;
 extern vector<std::unique_ptr<IndexBuffer>> indexBuffers;
 
+// running total of vertices drawn by vertex_submit_offset and index_submit_range
+// every backend adds to it, including None, so drawing can be measured headless
+extern unsigned long long vertices_submitted;
+
 }
 
 #endif
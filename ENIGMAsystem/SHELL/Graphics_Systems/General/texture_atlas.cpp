@@ -205,6 +205,7 @@ namespace enigma {
             enigma::graphics_delete_texture(fnt->texture);
           }
           fnt->texture = enigma::texture_atlas_array[ta].texture;
+          fnt->index_glyphs();
         } break;
         default: break; //We do nothing for the rest
       }
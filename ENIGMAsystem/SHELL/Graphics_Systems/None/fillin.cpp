@@ -20,6 +20,7 @@
 #include "Graphics_Systems/General/GStextures.h"
 #include "Graphics_Systems/General/GStiles.h"
 #include "Graphics_Systems/General/GSvertex.h"
+#include "Graphics_Systems/General/GSvertex_impl.h"
 #include "Graphics_Systems/General/GSsurface.h"
 #include "Graphics_Systems/General/GSstdraw.h"
 #include "Graphics_Systems/General/GSsprite.h"
@@ -85,9 +86,15 @@ namespace enigma_user
 
 	void vertex_argb(int buffer, unsigned argb) {}
 	void vertex_color(int buffer, int color, double alpha) {}
-	void vertex_submit_offset(int buffer, int primitive, unsigned offset, unsigned vertex_start, unsigned vertex_count) {}
-	void index_submit_range(int buffer, int vertex, int primitive, unsigned start, unsigned count) {}
-
+	// Nothing is drawn, but the vertices are still counted so drawing code can be benchmarked headless.
+	void vertex_submit_offset(int buffer, int primitive, unsigned offset, unsigned vertex_start, unsigned vertex_count) {
+		enigma::vertices_submitted += vertex_count;
+	}
+	void index_submit_range(int buffer, int vertex, int primitive, unsigned start, unsigned count) {
+		enigma::vertices_submitted += count;
+	}
+
+	void texture_set_stage(int stage, int texid){}
 	void texture_set_priority(int texid, double prio){}
 	bool texture_mipmapping_supported(){return false;}
 	bool texture_anisotropy_supported(){return false;}
@@ -60,6 +60,10 @@ size_t file_bin_position(int fileid);
 void file_bin_seek(int fileid, size_t pos);
 void file_bin_write_byte(int fileid, unsigned char byte);
 int file_bin_read_byte(int fileid);
+size_t file_bin_read_buffer(int fileid, int buffer, unsigned offset, size_t size);
+size_t file_bin_write_buffer(int fileid, int buffer, unsigned offset, size_t size);
+std::string file_bin_read_string(int fileid, size_t size);
+void file_bin_write_string(int fileid, const std::string& str);
 
 } //namespace enigma_user
 
@@ -18,91 +18,10 @@
 
 #define INCLUDED_FROM_SHELLMAIN 1
 
-// Simple Universal libraries
-///////////////////////////////
-
-#include "Universal_System/image_formats.h"
-#include "Universal_System/var4.h"
-#include "Universal_System/var_array.h"
-#include "Universal_System/dynamic_args.h"
-
-#ifdef DEBUG_MODE
-#include "Universal_System/debugscope.h"
-#endif
-
-#include "Universal_System/mathnc.h"
-#include "Universal_System/random.h"
-#include "Universal_System/estring.h"
-#include "Universal_System/buffers.h"
-#include "Platforms/General/fileio.h"
-#include "Universal_System/terminal_io.h"
-
-#include "Universal_System/Resources/backgrounds.h"
-#include "Universal_System/Resources/sprites.h"
-#include "Universal_System/Resources/fonts.h"
-#include "Universal_System/Resources/polygon.h"
-
-#include "Universal_System/Instances/callbacks_events.h"
-
-#include "GameSettings.h"
-#include "Preprocessor_Environment_Editable/LIBINCLUDE.h"
-#include "Preprocessor_Environment_Editable/GAME_SETTINGS.h"
-
-#include "Universal_System/Object_Tiers/collisions_object.h"
-
-#include "Collision_Systems/collision_mandatory.h"
-#include "Graphics_Systems/graphics_mandatory.h"
-#include "Widget_Systems/widgets_mandatory.h"
-#include "Platforms/platforms_mandatory.h"
-
-#include "API_Switchboard.h"
-
-#include "Universal_System/reflexive_types.h"
-
-#include "Universal_System/GAME_GLOBALS.h" // TODO: Do away with this sloppy infestation permanently!
-#include "Universal_System/ENIGMA_GLOBALS.h"
-
-#include "libEGMstd.h"
-
-#include "Universal_System/switch_stuff.h"
-#include "Platforms/General/PFmain.h"
-
-extern int amain();
-
-#include "Universal_System/Object_Tiers/object.h"
-#include "Universal_System/Instances/instance.h"
-#include "Universal_System/roomsystem.h"
-
-#include "Universal_System/globalupdate.h"
-
-#include "Universal_System/Instances/instance_system_frontend.h"
-
-#include "Universal_System/Resources/resource_data.h"
-#include "Universal_System/highscore_functions.h"
-
-#include "Universal_System/move_functions.h"
-#include "Universal_System/actions.h"
-#include "Universal_System/lives.h"
-#include "Universal_System/Resources/asset_index.h"
-
-namespace enigma_user {}
-
-using namespace enigma_user;
+#include "SHELLmain.h"
 
 #ifndef JUST_DEFINE_IT_RUN
-  #include "Preprocessor_Environment_Editable/IDE_EDIT_resourcenames.h"
-#endif
-#include "Preprocessor_Environment_Editable/IDE_EDIT_whitespace.h"
-  #ifndef JUST_DEFINE_IT_RUN
-  #include "Universal_System/syntax_quirks.h"
-
-  #include "Universal_System/Instances/with.h"
-  #include "Preprocessor_Environment_Editable/IDE_EDIT_evparent.h"
-  #include "Preprocessor_Environment_Editable/IDE_EDIT_events.h"
-  #include "Preprocessor_Environment_Editable/IDE_EDIT_objectdeclarations.h"
   #include "Preprocessor_Environment_Editable/IDE_EDIT_timelines.h"
-  #include "Preprocessor_Environment_Editable/IDE_EDIT_globals.h"
-  #include "Preprocessor_Environment_Editable/IDE_EDIT_objectaccess.h"
   #include "Preprocessor_Environment_Editable/IDE_EDIT_objectfunctionality.h"
   #include "Preprocessor_Environment_Editable/IDE_EDIT_roomcreates.h"
   #include "Preprocessor_Environment_Editable/IDE_EDIT_roomarrays.h"
@@ -0,0 +1,32 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "Universal_System/codecs.h"
+
+#include <lz4.h>
+
+namespace {
+
+long lz4_decode(const unsigned char* in, size_t insize, unsigned char* out, size_t outsize) {
+  return LZ4_decompress_safe((const char*) in, (char*) out, insize, outsize);
+}
+
+struct lz4_registration {
+  lz4_registration() { enigma::codec_register(enigma::codec_lz4, lz4_decode); }
+} register_lz4;
+
+}  // namespace
@@ -0,0 +1,40 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "Universal_System/codecs.h"
+
+#include <zstd.h>
+
+namespace {
+
+// Each thread decoding blobs keeps one context rather than making one per blob.
+struct decode_context {
+  ZSTD_DCtx* ctx = ZSTD_createDCtx();
+  ~decode_context() { ZSTD_freeDCtx(ctx); }
+};
+
+long zstd_decode(const unsigned char* in, size_t insize, unsigned char* out, size_t outsize) {
+  thread_local decode_context context;
+  const size_t written = ZSTD_decompressDCtx(context.ctx, out, outsize, in, insize);
+  return ZSTD_isError(written) ? -1 : long(written);
+}
+
+struct zstd_registration {
+  zstd_registration() { enigma::codec_register(enigma::codec_zstd, zstd_decode); }
+} register_zstd;
+
+}  // namespace
@@ -4,6 +4,7 @@
 
 #include "Universal_System/Object_Tiers/collisions_object.h"
 #include "Universal_System/Instances/instance_system.h"
+#include "Universal_System/snapshot.h"
 #include "implement.h"
 #include "include.h"
 
@@ -29,4 +30,5 @@ void action_set_alarm(int steps, int alarmno)
 
 namespace enigma {
 extension_alarm::extension_alarm() { for (int i = 0; i < 12; i++) alarm[i] = -1; }
+void extension_alarm::$snapshot_fields(snapshot_io &io) { io(alarm); }
 }
@@ -5,10 +5,14 @@
 #include <Universal_System/var4.h>
 
 namespace enigma {
+  class snapshot_io;
   struct extension_alarm
   {
     var alarm;
     extension_alarm();
+    #ifndef JUST_DEFINE_IT_RUN
+    void $snapshot_fields(snapshot_io &io);
+    #endif
   };
 }
 
@@ -27,10 +27,14 @@
  \********************************************************************************/
 
 #include <float.h>
+#include <math.h>
+#include <string.h>
 #include <random>
 #include <algorithm>
 #include <iterator>
+#include <functional>
 #include <map>
+#include <unordered_map>
 #include <deque>
 #include <vector>
 
@@ -42,6 +46,10 @@
 using namespace std;
 
 #include "include.h"
+#include "Universal_System/handle_table.h"
+#include "Universal_System/snapshot.h"
+
+using enigma::handle_table;
 
 template<typename T> static inline T maxv(T a, T b) { return (a > b) ? a : b; }
 template<typename T> static inline T minv(T a, T b) { return (a < b) ? a : b; }
@@ -57,145 +65,366 @@ void mt_random_shuffle(RandomIt first, RandomIt last) {
   std::shuffle(first, last, g);
 }
 
-template <typename t>
-class grid
+// Kernels over a run of packed grid cells. The sum carries on a running total
+// one cell at a time, so it rounds exactly like the old cell-by-cell loop. Max
+// and min don't depend on order, so they keep four lanes, which vectorize.
+static inline double sum_span(const double *v, size_t n, double s)
+{
+    for (size_t i = 0; i < n; ++i) s += v[i];
+    return s;
+}
+static inline double max_span(const double *v, size_t n, double m)
+{
+    double m0 = m, m1 = m, m2 = m, m3 = m;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        m0 = v[i] > m0 ? v[i] : m0;
+        m1 = v[i + 1] > m1 ? v[i + 1] : m1;
+        m2 = v[i + 2] > m2 ? v[i + 2] : m2;
+        m3 = v[i + 3] > m3 ? v[i + 3] : m3;
+    }
+    for (; i < n; ++i) m0 = v[i] > m0 ? v[i] : m0;
+    m0 = m1 > m0 ? m1 : m0;
+    m2 = m3 > m2 ? m3 : m2;
+    return m2 > m0 ? m2 : m0;
+}
+static inline double min_span(const double *v, size_t n, double m)
+{
+    double m0 = m, m1 = m, m2 = m, m3 = m;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        m0 = v[i] < m0 ? v[i] : m0;
+        m1 = v[i + 1] < m1 ? v[i + 1] : m1;
+        m2 = v[i + 2] < m2 ? v[i + 2] : m2;
+        m3 = v[i + 3] < m3 ? v[i + 3] : m3;
+    }
+    for (; i < n; ++i) m0 = v[i] < m0 ? v[i] : m0;
+    m0 = m1 < m0 ? m1 : m0;
+    m2 = m3 < m2 ? m3 : m2;
+    return m2 < m0 ? m2 : m0;
+}
+// Index of the first value within variant::epsilon of x, or n.
+static inline size_t find_span(const double *v, size_t n, double x)
+{
+    const double eps = variant::epsilon;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const bool hit0 = v[i] - eps <= x && v[i] + eps >= x, hit1 = v[i + 1] - eps <= x && v[i + 1] + eps >= x,
+                   hit2 = v[i + 2] - eps <= x && v[i + 2] + eps >= x, hit3 = v[i + 3] - eps <= x && v[i + 3] + eps >= x;
+        if (hit0 | hit1 | hit2 | hit3) break;
+    }
+    for (; i < n; ++i)
+        if (v[i] - eps <= x && v[i] + eps >= x) return i;
+    return n;
+}
+// These are plain loops on purpose: when a grid region is copied onto itself,
+// they have to see the cells they already wrote, the same as a cell-by-cell copy.
+static inline void fill_span(double *v, size_t n, double x)             { for (size_t i = 0; i < n; ++i) v[i] = x; }
+static inline void add_span(double *v, size_t n, double x)              { for (size_t i = 0; i < n; ++i) v[i] += x; }
+static inline void multiply_span(double *v, size_t n, double x)         { for (size_t i = 0; i < n; ++i) v[i] *= x; }
+static inline void copy_span(double *v, const double *src, size_t n)     { for (size_t i = 0; i < n; ++i) v[i] = src[i]; }
+static inline void add_span(double *v, const double *src, size_t n)      { for (size_t i = 0; i < n; ++i) v[i] += src[i]; }
+static inline void multiply_span(double *v, const double *src, size_t n) { for (size_t i = 0; i < n; ++i) v[i] *= src[i]; }
+
+// A ds_grid. Every cell's number lives in one packed array of doubles, so
+// grids of reals are a flat 8 bytes a cell and region operations run on
+// whole rows at a time. A cell holding anything other than a real (a string,
+// usually) also gets an entry in a side table with its full variant; its
+// number stays in the packed array, which is what arithmetic on it reads.
+// Rows keep a count of such cells, and only rows that have any take the
+// cell-by-cell path.
+class grid_data
 {
     unsigned int xgrid, ygrid;
-    t *grid_array;
+    vector<double> reals;
+    unordered_map<size_t, variant> others;
+    vector<unsigned> row_others;
+
+    size_t index(unsigned int x, unsigned int y) const { return size_t(y) * xgrid + x; }
+
+    void promote(size_t i, const variant &val)
+    {
+        auto it = others.emplace(i, val);
+        if (it.second)
+            ++row_others[i / xgrid];
+        else
+            it.first->second = val;
+    }
+    void demote(size_t i)
+    {
+        unsigned &count = row_others[i / xgrid];
+        if (count && others.erase(i))
+            --count;
+    }
+    void demote_span(size_t i, size_t n)
+    {
+        if (row_others[i / xgrid])
+            for (size_t j = i; j < i + n; ++j)
+                demote(j);
+    }
+    bool rows_plain(int py1, int py2) const
+    {
+        for (int i = py1; i < py2; i++)
+            if (row_others[i]) return false;
+        return true;
+    }
+
+    // The variant in a cell.
+    variant cell(size_t i) const
+    {
+        if (row_others[i / xgrid]) {
+            auto it = others.find(i);
+            if (it != others.end()) {
+                variant val = it->second;
+                val.rval.d = reals[i];
+                return val;
+            }
+        }
+        return reals[i];
+    }
+    void set_cell(size_t i, const variant &val)
+    {
+        reals[i] = val.rval.d;
+        if (val.type == variant::ty_real)
+            demote(i);
+        else
+            promote(i, val);
+    }
+    // cell += val, which appends for strings and adds numbers otherwise.
+    void add_cell(size_t i, const variant &val)
+    {
+        if (row_others[i / xgrid]) {
+            auto it = others.find(i);
+            if (it != others.end() && it->second.type == variant::ty_string) {
+                it->second.sval() += val.sval();
+                return;
+            }
+        }
+        reals[i] += val.rval.d;
+    }
+    // cell *= val, which leaves a real whatever the cell held.
+    void multiply_cell(size_t i, double val)
+    {
+        reals[i] *= val;
+        demote(i);
+    }
+
+    // Clips the region between two corners to the grid as [px1, px2) x [py1, py2).
+    bool clip_region(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, int &px1, int &py1, int &px2, int &py2) const
+    {
+        const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
+        if (xd <= 0 || yd <= 0)
+            return false;
+        px1 = maxv(tx1, 0); py1 = maxv(ty1, 0); px2 = minv(tx2 + 1, (int)xgrid); py2 = minv(ty2 + 1, (int)ygrid);
+        return true;
+    }
+    // Clips the disk's bounding box to the grid the same way.
+    bool clip_disk(const double x, const double y, const double r, int &px1, int &py1, int &px2, int &py2) const
+    {
+        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
+        if (!xgrid || !ygrid || !(tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid)))
+            return false;
+        px1 = maxv(tx1, 0); py1 = maxv(ty1, 0); px2 = minv(tx2, (int)xgrid); py2 = minv(ty2, (int)ygrid);
+        return true;
+    }
+    static bool in_disk(const double x, const double y, const double rr, int ii, int i)
+    {
+        return (x - ii)*(x - ii) + (y - i)*(y - i) <= rr;
+    }
+
+    // Index of the first cell in the region equal to val, or -1.
+    ptrdiff_t find_in_region(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, const variant &val) const
+    {
+        int px1, py1, px2, py2;
+        if (!clip_region(x1, y1, x2, y2, px1, py1, px2, py2) || px2 <= px1)
+            return -1;
+        for (int i = py1; i < py2; i++)
+        {
+            const size_t row = index(px1, i), n = px2 - px1;
+            if (row_others[i]) {
+                for (size_t j = row; j < row + n; ++j)
+                    if (tequal(cell(j), val))
+                        return j;
+            } else if (val.type == variant::ty_real) {
+                const size_t j = find_span(&reals[row], n, val.rval.d);
+                if (j < n)
+                    return row + j;
+            }
+        }
+        return -1;
+    }
+    // Index of the first cell in the disk equal to val, or -1.
+    ptrdiff_t find_in_disk(const double x, const double y, const double r, const variant &val) const
+    {
+        const double rr = r*r;
+        int px1, py1, px2, py2;
+        if (clip_disk(x, y, r, px1, py1, px2, py2))
+            for (int i = py1; i < py2; i++)
+                for (int ii = px1; ii < px2; ii++)
+                    if (in_disk(x, y, rr, ii, i) && tequal(cell(index(ii, i)), val))
+                        return index(ii, i);
+        return -1;
+    }
 
     public:
-    grid() {}
-    grid(const unsigned int w, const unsigned int h) {
-      ygrid = h; xgrid = w; grid_array = new t[w*h];
+    grid_data(): xgrid(0), ygrid(0) {}
+    grid_data(const unsigned int w, const unsigned int h, const variant &val): xgrid(w), ygrid(h), row_others(h, 0) {
+        reals.resize(size_t(w) * h);
+        clear(val);
     }
-    ~grid() {}
 
-    void destroy()
+    void clear(const variant &val)
     {
-        delete[] grid_array;
+        others.clear();
+        fill(row_others.begin(), row_others.end(), 0);
+        fill_span(reals.data(), reals.size(), val.rval.d);
+        if (val.type != variant::ty_real)
+            for (size_t i = 0; i < reals.size(); ++i)
+                promote(i, val);
     }
-    void clear(const t val)
+    void snapshot(enigma::snapshot_io &io)
     {
-        for (unsigned i = 0; i < ygrid; i++)
-            for (unsigned ii = 0; ii < xgrid; ii++)
-                grid_array[i * xgrid + ii] = val;
+        unsigned w = xgrid, h = ygrid;
+        unsigned long long n = others.size();
+        io(w); io(h);
+        if (io.loading()) {
+            if (!io.fits(size_t(w) * h, sizeof(double))) return;
+            *this = grid_data(w, h, 0);
+        }
+        io(reals);
+        io(n);
+        if (io.loading()) {
+            for (unsigned long long i = 0; i < n && io.ok(); ++i) {
+                unsigned long long index = 0;
+                variant val;
+                io(index); io(val);
+                if (index < reals.size()) promote(index, val);
+            }
+        } else {
+            for (auto &o : others) {
+                unsigned long long index = o.first;
+                io(index); io(o.second);
+            }
+        }
     }
     void resize(unsigned w, unsigned h)
     {
-        grid<variant> temp(w, h);
+        grid_data temp(w, h, variant());
         const unsigned int wm = minv(xgrid, w), hm = minv(ygrid, h);
         for (unsigned i = 0; i < hm; i++)
-            for (unsigned ii = 0; ii < wm; ii++)
-                temp.grid_array[i * w + ii] = grid_array[i * xgrid + ii];
-        delete[] grid_array;
-        (*this) = temp;
+        {
+            copy_span(&temp.reals[temp.index(0, i)], &reals[index(0, i)], wm);
+            temp.demote_span(temp.index(0, i), wm);
+            if (row_others[i])
+                for (unsigned ii = 0; ii < wm; ii++)
+                    temp.set_cell(temp.index(ii, i), cell(index(ii, i)));
+        }
+        (*this) = std::move(temp);
     }
-    void copy(const grid& copy_id)
+    void copy(const grid_data& copy_id)
     {
-        delete[] grid_array;
-        grid_array = new t[copy_id.ygrid*copy_id.xgrid];
-        xgrid = copy_id.xgrid;
-        ygrid = copy_id.ygrid;
-        for (unsigned i = 0; i < ygrid; i++)
-            for (unsigned ii = 0; ii < xgrid; ii++)
-                grid_array[i * xgrid + ii] = copy_id.grid_array[i * copy_id.xgrid + ii];
+        (*this) = copy_id;
     }
-    unsigned int width()
+    unsigned int width() const
     {
         return xgrid;
     }
-    unsigned int height()
+    unsigned int height() const
     {
         return ygrid;
     }
-    void insert(const unsigned int x, const unsigned int y, const t val)
+    void insert(const unsigned int x, const unsigned int y, const variant &val)
     {
         if (x < xgrid && y < ygrid)
-            grid_array[y * xgrid + x] = val;
+            set_cell(index(x, y), val);
     }
-    void add(const unsigned int x, const unsigned int y, const t val)
+    void add(const unsigned int x, const unsigned int y, const variant &val)
     {
         if (x < xgrid && y < ygrid)
-            grid_array[y * xgrid + x] += val;
+            add_cell(index(x, y), val);
     }
     void multiply(const unsigned int x, const unsigned int y, const double val)
     {
         if (x < xgrid && y < ygrid)
-            grid_array[y * xgrid + x] *= val;
-    }
-    void insert_region(const unsigned int x1, const unsigned int y1, unsigned int x2, const unsigned int y2, const t val)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-                   grid_array[i * xgrid + ii] = val;
-       }
-    }
-    void add_region(const unsigned int x1, const unsigned int y1, unsigned int x2, const unsigned int y2, const t val)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-                   grid_array[i * xgrid + ii] += val;
-       }
+            multiply_cell(index(x, y), val);
+    }
+    void insert_region(const unsigned int x1, const unsigned int y1, unsigned int x2, const unsigned int y2, const variant &val)
+    {
+        int px1, py1, px2, py2;
+        if (clip_region(x1, y1, x2, y2, px1, py1, px2, py2))
+            for (int i = py1; i < py2; i++)
+            {
+                if (px2 <= px1) break;
+                const size_t row = index(px1, i), n = px2 - px1;
+                fill_span(&reals[row], n, val.rval.d);
+                if (val.type == variant::ty_real)
+                    demote_span(row, n);
+                else
+                    for (size_t j = row; j < row + n; ++j)
+                        promote(j, val);
+            }
+    }
+    void add_region(const unsigned int x1, const unsigned int y1, unsigned int x2, const unsigned int y2, const variant &val)
+    {
+        int px1, py1, px2, py2;
+        if (clip_region(x1, y1, x2, y2, px1, py1, px2, py2))
+            for (int i = py1; i < py2; i++)
+            {
+                if (px2 <= px1) break;
+                const size_t row = index(px1, i), n = px2 - px1;
+                if (!row_others[i])
+                    add_span(&reals[row], n, val.rval.d);
+                else
+                    for (size_t j = row; j < row + n; ++j)
+                        add_cell(j, val);
+            }
     }
     void multiply_region(const unsigned int x1, const unsigned int y1, unsigned int x2, const unsigned int y2, const double val)
     {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-                   grid_array[i * xgrid + ii] *= val;
-       }
+        int px1, py1, px2, py2;
+        if (clip_region(x1, y1, x2, y2, px1, py1, px2, py2))
+            for (int i = py1; i < py2; i++)
+            {
+                if (px2 <= px1) break;
+                const size_t row = index(px1, i), n = px2 - px1;
+                multiply_span(&reals[row], n, val);
+                demote_span(row, n);
+            }
     }
-    void insert_disk(const double x, const double y, const double r, const t val)
+    void insert_disk(const double x, const double y, const double r, const variant &val)
     {
         const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
-        {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
+        int px1, py1, px2, py2;
+        if (clip_disk(x, y, r, px1, py1, px2, py2))
             for (int i = py1; i < py2; i++)
                 for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
-                        grid_array[i * xgrid + ii] = val;
-        }
+                    if (in_disk(x, y, rr, ii, i))
+                        set_cell(index(ii, i), val);
     }
-    void add_disk(const double x, const double y, const double r, const t val)
+    void add_disk(const double x, const double y, const double r, const variant &val)
     {
         const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
-        {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
+        int px1, py1, px2, py2;
+        if (clip_disk(x, y, r, px1, py1, px2, py2))
             for (int i = py1; i < py2; i++)
                 for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
-                        grid_array[i * xgrid + ii] += val;
-        }
+                    if (in_disk(x, y, rr, ii, i))
+                        add_cell(index(ii, i), val);
     }
     void multiply_disk(const double x, const double y, const double r, const double val)
     {
         const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
-        {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
+        int px1, py1, px2, py2;
+        if (clip_disk(x, y, r, px1, py1, px2, py2))
             for (int i = py1; i < py2; i++)
                 for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
-                        grid_array[i * xgrid + ii] *= val;
-        }
+                    if (in_disk(x, y, rr, ii, i))
+                        multiply_cell(index(ii, i), val);
     }
-    void insert_grid_region(const grid& source_id, const unsigned int sx1, const unsigned int sy1, const unsigned int sx2, const unsigned int sy2, const unsigned int x, const unsigned int y)
+
+    // The grid-region operations go row by row, in order, so a region laid
+    // over itself comes out the same as it did cell by cell.
+    void insert_grid_region(const grid_data& source_id, const unsigned int sx1, const unsigned int sy1, const unsigned int sx2, const unsigned int sy2, const unsigned int x, const unsigned int y)
     {
         if (x < xgrid && y < ygrid)
         {
@@ -203,13 +432,19 @@ class grid
             if (xd > 0 && yd > 0)
             {
                 const int upx = minv(tx2 - tx1 + 1, minv(int(xgrid - x), xd)), upy = minv(ty2 - ty1 + 1, minv(int(ygrid - y), yd));
-                for (int i = 0; i < upy; i++)
-                    for (int ii = 0; ii < upx; ii++)
-                        grid_array[(y + i)*xgrid + (x + ii)] = source_id.grid_array[(ty1 + i)*source_id.xgrid + (tx1 + ii)];
+                for (int i = 0; i < upy && upx > 0; i++)
+                {
+                    const size_t row = index(x, y + i), src = source_id.index(tx1, ty1 + i);
+                    if (!row_others[y + i] && !source_id.row_others[ty1 + i])
+                        copy_span(&reals[row], &source_id.reals[src], upx);
+                    else
+                        for (int ii = 0; ii < upx; ii++)
+                            set_cell(row + ii, source_id.cell(src + ii));
+                }
             }
         }
     }
-    void add_grid_region(const grid& source_id, const unsigned int sx1, const unsigned int sy1, const unsigned int sx2, const unsigned int sy2, const unsigned int x, const unsigned int y)
+    void add_grid_region(const grid_data& source_id, const unsigned int sx1, const unsigned int sy1, const unsigned int sx2, const unsigned int sy2, const unsigned int x, const unsigned int y)
     {
         if (x < xgrid && y < ygrid)
         {
@@ -217,13 +452,19 @@ class grid
             if (xd > 0 && yd > 0)
             {
                 const int upx = minv(tx2 - tx1 + 1, minv(int(xgrid - x), xd)), upy = minv(ty2 - ty1 + 1, minv(int(ygrid - y), yd));
-                for (int i = 0; i < upy; i++)
-                    for (int ii = 0; ii < upx; ii++)
-                        grid_array[(y + i)*xgrid + (x + ii)] += source_id.grid_array[(ty1 + i)*source_id.xgrid + (tx1 + ii)];
+                for (int i = 0; i < upy && upx > 0; i++)
+                {
+                    const size_t row = index(x, y + i), src = source_id.index(tx1, ty1 + i);
+                    if (!row_others[y + i])
+                        add_span(&reals[row], &source_id.reals[src], upx);
+                    else
+                        for (int ii = 0; ii < upx; ii++)
+                            add_cell(row + ii, source_id.cell(src + ii));
+                }
             }
         }
     }
-    void multiply_grid_region(const grid& source_id, const unsigned int sx1, const unsigned int sy1, const unsigned int sx2, const unsigned int sy2, const unsigned int x, const unsigned int y)
+    void multiply_grid_region(const grid_data& source_id, const unsigned int sx1, const unsigned int sy1, const unsigned int sx2, const unsigned int sy2, const unsigned int x, const unsigned int y)
     {
         if (x < xgrid && y < ygrid)
         {
@@ -231,254 +472,218 @@ class grid
             if (xd > 0 && yd > 0)
             {
                 const int upx = minv(tx2 - tx1 + 1, minv(int(xgrid - x), xd)), upy = minv(ty2 - ty1 + 1, minv(int(ygrid - y), yd));
-                for (int i = 0; i < upy; i++)
-                    for (int ii = 0; ii < upx; ii++)
-                        grid_array[(y + i)*xgrid + (x + ii)] *= source_id.grid_array[(ty1 + i)*source_id.xgrid + (tx1 + ii)];
+                for (int i = 0; i < upy && upx > 0; i++)
+                {
+                    const size_t row = index(x, y + i);
+                    multiply_span(&reals[row], &source_id.reals[source_id.index(tx1, ty1 + i)], upx);
+                    demote_span(row, upx);
+                }
             }
         }
     }
 
-    t find(unsigned int x, unsigned int y)
-    {
-        return (grid_array[y * xgrid + x]);
-    }
-    t find_region_sum(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           variant sum = 0;
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-                   sum += grid_array[i * xgrid + ii];
-           return sum;
-       }
-       return t();
-    }
-    t find_region_max(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       t val_check;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           t max_check = grid_array[py1 * xgrid + px1];
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-               {
-                   val_check = grid_array[i * xgrid + ii];
-                   if (val_check > max_check)
-                       max_check = val_check;
-               }
-           return max_check;
-       }
-       return t();
-    }
-    t find_region_min(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       t val_check;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           t min_check = grid_array[py1 * xgrid + px1];
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-               {
-                   val_check = grid_array[i * xgrid + ii];
-                   if (val_check < min_check)
-                       min_check = val_check;
-               }
-           return min_check;
-       }
-       return t();
-    }
-    t find_region_mean(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           t sum = 0;
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-                   sum += grid_array[i * xgrid + ii];
-           const double region_size = (py2 - py1)*(px2 - px1);
-           return sum/region_size;
-       }
-       return t();
+    variant find(unsigned int x, unsigned int y) const
+    {
+        return cell(index(x, y));
+    }
+    variant find_region_sum(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) const
+    {
+        int px1, py1, px2, py2;
+        if (clip_region(x1, y1, x2, y2, px1, py1, px2, py2))
+        {
+            double sum = 0;
+            for (int i = py1; i < py2 && px1 < px2; i++)
+                sum = sum_span(&reals[index(px1, i)], px2 - px1, sum);
+            return sum;
+        }
+        return variant();
+    }
+    // With only reals in the region, max and min come straight off the packed
+    // cells. Anything else has to be compared as a variant, in cell order.
+    variant find_region_max(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) const
+    {
+        int px1, py1, px2, py2;
+        if (clip_region(x1, y1, x2, y2, px1, py1, px2, py2))
+        {
+            if (rows_plain(py1, py2))
+            {
+                double max_check = reals[index(px1, py1)];
+                for (int i = py1; i < py2 && px1 < px2; i++)
+                    max_check = max_span(&reals[index(px1, i)], px2 - px1, max_check);
+                return max_check;
+            }
+            variant max_check = cell(index(px1, py1)), val_check;
+            for (int i = py1; i < py2; i++)
+                for (int ii = px1; ii < px2; ii++)
+                {
+                    val_check = cell(index(ii, i));
+                    if (val_check > max_check)
+                        max_check = val_check;
+                }
+            return max_check;
+        }
+        return variant();
+    }
+    variant find_region_min(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) const
+    {
+        int px1, py1, px2, py2;
+        if (clip_region(x1, y1, x2, y2, px1, py1, px2, py2))
+        {
+            if (rows_plain(py1, py2))
+            {
+                double min_check = reals[index(px1, py1)];
+                for (int i = py1; i < py2 && px1 < px2; i++)
+                    min_check = min_span(&reals[index(px1, i)], px2 - px1, min_check);
+                return min_check;
+            }
+            variant min_check = cell(index(px1, py1)), val_check;
+            for (int i = py1; i < py2; i++)
+                for (int ii = px1; ii < px2; ii++)
+                {
+                    val_check = cell(index(ii, i));
+                    if (val_check < min_check)
+                        min_check = val_check;
+                }
+            return min_check;
+        }
+        return variant();
     }
-    t find_disk_sum(const double x, const double y, const double r)
+    variant find_region_mean(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) const
+    {
+        int px1, py1, px2, py2;
+        if (clip_region(x1, y1, x2, y2, px1, py1, px2, py2))
+        {
+            double sum = 0;
+            for (int i = py1; i < py2 && px1 < px2; i++)
+                sum = sum_span(&reals[index(px1, i)], px2 - px1, sum);
+            const double region_size = (py2 - py1)*(px2 - px1);
+            return sum/region_size;
+        }
+        return variant();
+    }
+    variant find_disk_sum(const double x, const double y, const double r) const
     {
         const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
+        int px1, py1, px2, py2;
+        if (clip_disk(x, y, r, px1, py1, px2, py2))
         {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
-            t sum = t();
+            variant sum = variant();
             for (int i = py1; i < py2; i++)
                 for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
-                        sum += grid_array[i * xgrid + ii];
+                    if (in_disk(x, y, rr, ii, i))
+                        sum += cell(index(ii, i));
             return sum;
         }
-        return t();
+        return variant();
     }
-    t find_disk_max(const double x, const double y, const double r)
+    variant find_disk_max(const double x, const double y, const double r) const
     {
         const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
+        int px1, py1, px2, py2;
+        if (clip_disk(x, y, r, px1, py1, px2, py2))
         {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
-            t max_check = grid_array[py1 * xgrid + px1];
+            variant max_check = cell(index(px1, py1));
             for (int i = py1; i < py2; i++)
                 for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
+                    if (in_disk(x, y, rr, ii, i))
                     {
-                        const double val_check = grid_array[i * xgrid + ii];
+                        const double val_check = reals[index(ii, i)];
                         if (val_check > max_check)
                             max_check = val_check;
                     }
             return max_check;
         }
-        return t();
+        return variant();
     }
-    t find_disk_min(const double x, const double y, const double r)
+    variant find_disk_min(const double x, const double y, const double r) const
     {
         const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
+        int px1, py1, px2, py2;
+        if (clip_disk(x, y, r, px1, py1, px2, py2))
         {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
-            t min_check = grid_array[lrint(y) * xgrid + lrint(x)];
+            // Start from the center cell, kept on the grid when the center rounds off it.
+            variant min_check = cell(index(minv(maxv(lrint(x), 0L), long(xgrid) - 1), minv(maxv(lrint(y), 0L), long(ygrid) - 1)));
             for (int i = py1; i < py2; i++)
                 for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
+                    if (in_disk(x, y, rr, ii, i))
                     {
-                        const double val_check = grid_array[i * xgrid + ii];
+                        const double val_check = reals[index(ii, i)];
                         if (val_check < min_check)
                             min_check = val_check;
                     }
             return min_check;
         }
-        return t();
+        return variant();
     }
-    t find_disk_mean(const double x, const double y, const double r)
+    variant find_disk_mean(const double x, const double y, const double r) const
     {
         const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
+        int px1, py1, px2, py2;
+        if (clip_disk(x, y, r, px1, py1, px2, py2))
         {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
-            t sum = t();
+            variant sum = variant();
             double region_size = 0;
             for (int i = py1; i < py2; i++)
                 for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
+                    if (in_disk(x, y, rr, ii, i))
                     {
-                        sum += grid_array[i * xgrid + ii];
+                        sum += cell(index(ii, i));
                         ++region_size;
                     }
            return sum/region_size;
         }
-        return t();
-    }
-    bool value_region_exists(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, const t val)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-                   if (tequal(grid_array[i * xgrid + ii], val))
-                       return true;
-       }
-       return false;
-    }
-    int value_region_x(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, const t val)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-                   if (tequal(grid_array[i * xgrid + ii], val))
-                      return ii;
-       }
-       return 0;
-    }
-    int value_region_y(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, const t val)
-    {
-       const int tx1 = minv(x1, x2),  ty1 = minv(y1, y2), tx2 = maxv(x1, x2), ty2 = maxv(y1, y2), xd = xgrid - tx1, yd = ygrid - ty1;
-       if (xd > 0 && yd > 0)
-       {
-           const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2 + 1, (int)xgrid), py2 = minv(ty2 + 1, (int)ygrid);
-           for (int i = py1; i < py2; i++)
-               for (int ii = px1; ii < px2; ii++)
-                   if (tequal(grid_array[i * xgrid + ii], val))
-                       return i;
-       }
-       return 0;
-    }
-    bool value_disk_exists(const double x, const double y, const double r, const t val)
+        return variant();
+    }
+    bool value_region_exists(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, const variant &val) const
     {
-        const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
-        {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
-            for (int i = py1; i < py2; i++)
-                for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
-                        if (tequal(grid_array[i * xgrid + ii], val))
-                            return true;
-        }
-        return false;
+        return find_in_region(x1, y1, x2, y2, val) >= 0;
     }
-    int value_disk_x(const double x, const double y, const double r, const t val)
+    int value_region_x(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, const variant &val) const
     {
-        const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
-        {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
-            for (int i = py1; i < py2; i++)
-                for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
-                        if (tequal(grid_array[i * xgrid + ii], val))
-                            return i;
-        }
-        return 0;
+        const ptrdiff_t i = find_in_region(x1, y1, x2, y2, val);
+        return i < 0 ? 0 : i % xgrid;
     }
-    int value_disk_y(const double x, const double y, const double r, const t val)
+    int value_region_y(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, const variant &val) const
     {
-        const double rr = r*r;
-        const int tx1 = int(x - r), ty1 = int(y - r), tx2 = int(x + r + 1), ty2 = int(y + r + 1);
-        if (tx2 >= 0 && ty2 >=0 && tx1 < int(xgrid) && ty1 < int(ygrid))
-        {
-            const int px1 = maxv(tx1, 0), py1 = maxv(ty1, 0), px2 = minv(tx2, (int)xgrid), py2 = minv(ty2, (int)ygrid);
-            for (int i = py1; i < py2; i++)
-                for (int ii = px1; ii < px2; ii++)
-                    if ((x - ii)*(x - ii) + (y - i)*(y - i) <= rr)
-                        if (tequal(grid_array[i * xgrid + ii], val))
-                            return ii;
-        }
-        return 0;
+        const ptrdiff_t i = find_in_region(x1, y1, x2, y2, val);
+        return i < 0 ? 0 : i / xgrid;
+    }
+    bool value_disk_exists(const double x, const double y, const double r, const variant &val) const
+    {
+        return find_in_disk(x, y, r, val) >= 0;
+    }
+    int value_disk_x(const double x, const double y, const double r, const variant &val) const
+    {
+        const ptrdiff_t i = find_in_disk(x, y, r, val);
+        return i < 0 ? 0 : i / xgrid;
+    }
+    int value_disk_y(const double x, const double y, const double r, const variant &val) const
+    {
+        const ptrdiff_t i = find_in_disk(x, y, r, val);
+        return i < 0 ? 0 : i % xgrid;
     }
     void shuffle()
     {
-        mt_random_shuffle(grid_array, grid_array + (xgrid*ygrid - 1));
+        if (reals.size() < 2)
+            return;
+        if (others.empty())
+        {
+            mt_random_shuffle(reals.begin(), reals.end() - 1);
+            return;
+        }
+        vector<size_t> order(reals.size() - 1);
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        mt_random_shuffle(order.begin(), order.end());
+        grid_data temp(*this);
+        for (size_t i = 0; i < order.size(); ++i)
+            set_cell(i, temp.cell(order[i]));
     }
 };
 
 /* ds_grids */
 
-static map<unsigned int, grid<variant> > ds_grids;
-static unsigned int ds_grids_maxid = 0;
+static handle_table<grid_data> ds_grids("ds_grid");
 
 namespace enigma_user
 {
@@ -486,16 +691,13 @@ namespace enigma_user
 unsigned int ds_grid_create(const unsigned int w, const unsigned int h)
 {
   //Creates a new grid. The function returns an integer as an id that must be used in all other functions to access the particular grid.
-  pair<map<unsigned int, grid<variant> >::iterator, bool> ins = ds_grids.insert(pair<unsigned int, grid<variant> >(ds_grids_maxid++, grid<variant>(w, h)));
-  ins.first->second.clear(0);
-  return ds_grids_maxid-1;
+  return ds_grids.add(grid_data(w, h, 0));
 }
 
 void ds_grid_destroy(const unsigned int id)
 {
   //Destroys the grid
-  ds_grids[id].destroy();
-  ds_grids.erase(ds_grids.find(id));
+  ds_grids.destroy(id);
 }
 
 void ds_grid_clear(const unsigned int id, const variant val)
@@ -698,15 +900,13 @@ void ds_grid_shuffle(const unsigned int id)
 bool ds_grid_exists(const unsigned int id)
 {
   //returns whether the grid exists
-  return (ds_grids.find(id) != ds_grids.end());
+  return ds_grids.exists(id);
 }
 
 unsigned int ds_grid_duplicate(const unsigned int source)
 {
   //creates and returns a new grid containing a copy of the source grid
-  ds_grids.insert(pair<unsigned int, grid<variant> >(ds_grids_maxid++, grid<variant>(0, 0)));
-  ds_grids[ds_grids_maxid-1].copy(ds_grids[source]);
-  return ds_grids_maxid-1;
+  return ds_grids.add(ds_grids[source]);
 }
 
 std::string ds_grid_write(const unsigned int id)
@@ -716,7 +916,7 @@ std::string ds_grid_write(const unsigned int id)
   ss.width(4);
   ss.fill('0');
 
-  grid<variant> dsGrid = ds_grids[id];
+  const grid_data &dsGrid = ds_grids[id];
 
   // Write size
   ss << std::hex << dsGrid.width();
@@ -742,7 +942,7 @@ std::string ds_grid_write(const unsigned int id)
       if (vari.type == ty_real)
       {
         ss.width(16);
-        char* b = (char*)&vari.rval.d;
+        const char* b = (const char*)&vari.rval.d;
         for (unsigned i = 0; i < sizeof(double); ++i)
           ss << b[i];
       }
@@ -836,8 +1036,311 @@ void ds_grid_read(const unsigned int id, std::string value)
 
 /* ds_maps */
 
-static map<unsigned int, multimap<variant, variant> > ds_maps;
-static unsigned int ds_maps_maxid = 0;
+// A map from variant keys to variant values, hashed with open addressing.
+// Entries are kept in slots (reused through a free list) and threaded into a
+// list of distinct keys in the order each key first went in, which is the
+// order ds_map_find_first/next walk; that makes every step O(1). As with the
+// multimap this replaces, a key can be added more than once: later entries
+// for a key hang off the first one, and lookups see the earliest. The table
+// itself holds one bucket per distinct key, pointing at that key's first
+// entry, and is kept at most half full.
+class map_data
+{
+    struct entry {
+        variant key, value;
+        size_t hash;
+        int prev, next;  // Neighboring distinct keys, in insertion order.
+        int dup_next;    // The next entry with this key.
+        int dup_last;    // On a key's first entry, the last entry with its key.
+    };
+
+    vector<entry> entries;
+    vector<int> free_slots;
+    vector<int> buckets;  // Entry index, or -1 if empty.
+    int first = -1, last = -1;
+    size_t count = 0, keys = 0;
+
+    // Reals hash by which 2^-20-wide bin they fall in; keys within
+    // variant::epsilon of each other are equal, so a lookup near the edge of a
+    // bin also checks the neighboring one. Reals too large to bin hash by bits,
+    // since epsilon is below their precision anyway.
+    static constexpr double bins_per_unit = 1 << 20;
+    static constexpr double bin_limit = 1e15;
+
+    static size_t mix(unsigned long long x)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return size_t(x ^ (x >> 31));
+    }
+    static size_t hash_bin(int type, long long bin) { return mix((unsigned long long)bin * 4 + (type + 1)); }
+    static size_t hash_of(const variant &key)
+    {
+        if (key.type == enigma_user::ty_string) return std::hash<std::string>()(key.sval());
+        const double scaled = key.rval.d * bins_per_unit;
+        if (!(fabs(scaled) < bin_limit)) {
+            unsigned long long bits;
+            const double d = key.rval.d;
+            memcpy(&bits, &d, sizeof bits);
+            return mix(bits ^ (unsigned long long)(key.type + 1) << 62);
+        }
+        return hash_bin(key.type, (long long)floor(scaled));
+    }
+
+    // The bucket holding key's first entry, or -1.
+    int find_bucket(const variant &key, size_t hash) const
+    {
+        if (buckets.empty()) return -1;
+        const size_t mask = buckets.size() - 1;
+        for (size_t b = hash & mask; buckets[b] >= 0; b = (b + 1) & mask) {
+            const entry &e = entries[buckets[b]];
+            if (e.hash == hash && e.key == key) return int(b);
+        }
+        return -1;
+    }
+    int find_bucket(const variant &key) const
+    {
+        const size_t hash = hash_of(key);
+        const int b = find_bucket(key, hash);
+        if (b >= 0 || key.type == enigma_user::ty_string) return b;
+        const double scaled = key.rval.d * bins_per_unit;
+        if (!(fabs(scaled) < bin_limit)) return b;
+        const double bin = floor(scaled), reach = variant::epsilon * bins_per_unit;
+        if (scaled - bin < reach) return find_bucket(key, hash_bin(key.type, (long long)bin - 1));
+        if (bin + 1 - scaled <= reach) return find_bucket(key, hash_bin(key.type, (long long)bin + 1));
+        return -1;
+    }
+    // Index of key's first entry, or -1.
+    int find(const variant &key) const
+    {
+        const int b = find_bucket(key);
+        return b < 0 ? -1 : buckets[b];
+    }
+
+    void place(int index)
+    {
+        const size_t mask = buckets.size() - 1;
+        size_t b = entries[index].hash & mask;
+        while (buckets[b] >= 0) b = (b + 1) & mask;
+        buckets[b] = index;
+    }
+    void grow()
+    {
+        vector<int> old(max<size_t>(16, buckets.size() * 2), -1);
+        buckets.swap(old);
+        for (int index : old)
+            if (index >= 0) place(index);
+    }
+    // Empties a bucket, shifting back later entries of its run that would
+    // otherwise become unreachable.
+    void unplace(size_t hole)
+    {
+        const size_t mask = buckets.size() - 1;
+        for (size_t b = (hole + 1) & mask; buckets[b] >= 0; b = (b + 1) & mask) {
+            const size_t home = entries[buckets[b]].hash & mask;
+            if (((b - home) & mask) >= ((b - hole) & mask)) {
+                buckets[hole] = buckets[b];
+                hole = b;
+            }
+        }
+        buckets[hole] = -1;
+    }
+
+    int new_entry(const variant &key, const variant &value)
+    {
+        int index;
+        if (free_slots.empty()) {
+            index = entries.size();
+            entries.push_back(entry());
+        } else {
+            index = free_slots.back();
+            free_slots.pop_back();
+        }
+        entry &e = entries[index];
+        e.key = key;
+        e.value = value;
+        e.dup_next = -1;
+        e.dup_last = index;
+        ++count;
+        return index;
+    }
+    void free_entry(int index)
+    {
+        entries[index].key = variant();
+        entries[index].value = variant();
+        free_slots.push_back(index);
+        --count;
+    }
+    int bucket_of(int index) const
+    {
+        const size_t mask = buckets.size() - 1;
+        size_t b = entries[index].hash & mask;
+        while (buckets[b] != index) b = (b + 1) & mask;
+        return int(b);
+    }
+    void unlink(const entry &e)
+    {
+        (e.prev >= 0 ? entries[e.prev].next : first) = e.next;
+        (e.next >= 0 ? entries[e.next].prev : last) = e.prev;
+    }
+
+    // Drops key's first entry. If the key has more, the next takes its place
+    // in the bucket and in the key order.
+    void erase_first(int bucket)
+    {
+        const int index = buckets[bucket];
+        entry &e = entries[index];
+        if (e.dup_next >= 0) {
+            entry &d = entries[e.dup_next];
+            d.prev = e.prev;
+            d.next = e.next;
+            d.dup_last = e.dup_last;
+            (d.prev >= 0 ? entries[d.prev].next : first) = e.dup_next;
+            (d.next >= 0 ? entries[d.next].prev : last) = e.dup_next;
+            buckets[bucket] = e.dup_next;
+        } else {
+            unlink(e);
+            unplace(bucket);
+            --keys;
+        }
+        free_entry(index);
+    }
+    // Drops every entry with the key whose first entry is in this bucket.
+    void erase_all(int bucket)
+    {
+        const int index = buckets[bucket];
+        unlink(entries[index]);
+        unplace(bucket);
+        --keys;
+        for (int d = index; d >= 0; ) {
+            const int next = entries[d].dup_next;
+            free_entry(d);
+            d = next;
+        }
+    }
+
+    public:
+    size_t size() const { return count; }
+    bool empty() const { return !count; }
+    void clear()
+    {
+        entries.clear();
+        free_slots.clear();
+        buckets.clear();
+        first = last = -1;
+        count = keys = 0;
+    }
+
+    void add(const variant &key, const variant &value)
+    {
+        const int head = find(key);
+        const int index = new_entry(key, value);
+        entry &e = entries[index];
+        if (head >= 0) {
+            e.hash = entries[head].hash;
+            entries[entries[head].dup_last].dup_next = index;
+            entries[head].dup_last = index;
+            return;
+        }
+        e.hash = hash_of(key);
+        e.prev = last;
+        e.next = -1;
+        (last >= 0 ? entries[last].next : first) = index;
+        last = index;
+        if (++keys * 2 > buckets.size()) grow();
+        place(index);
+    }
+
+    const variant *find_value(const variant &key) const
+    {
+        const int index = find(key);
+        return index < 0 ? NULL : &entries[index].value;
+    }
+    bool exists(const variant &key) const { return find(key) >= 0; }
+
+    // Replaces the value of key's first entry, as if by deleting it and adding
+    // the key again, without moving the key in the iteration order. Returns
+    // false if the key isn't there.
+    bool replace(const variant &key, const variant &value)
+    {
+        const int b = find_bucket(key);
+        if (b < 0) return false;
+        const int index = buckets[b];
+        if (entries[index].dup_next < 0)
+            entries[index].value = value;
+        else {
+            erase_first(b);
+            add(key, value);
+        }
+        return true;
+    }
+    void erase(const variant &key)
+    {
+        const int b = find_bucket(key);
+        if (b >= 0) erase_first(b);
+    }
+    // Erases every entry from key `from` up to, but not including, key `to`.
+    // Does nothing unless both exist with `from` at or before `to`.
+    void erase(const variant &from, const variant &to)
+    {
+        const int start = find(from), stop = find(to);
+        if (start < 0 || stop < 0) return;
+        int i = start;
+        while (i >= 0 && i != stop) i = entries[i].next;
+        if (i < 0) return;
+        for (i = start; i != stop; ) {
+            const int next = entries[i].next;
+            erase_all(bucket_of(i));
+            i = next;
+        }
+    }
+
+    // Iteration over distinct keys, in the order they were first added.
+    const variant *first_key() const { return first < 0 ? NULL : &entries[first].key; }
+    const variant *last_key() const { return last < 0 ? NULL : &entries[last].key; }
+    const variant *next_key(const variant &key) const
+    {
+        const int index = find(key);
+        return index < 0 || entries[index].next < 0 ? NULL : &entries[entries[index].next].key;
+    }
+    const variant *previous_key(const variant &key) const
+    {
+        const int index = find(key);
+        return index < 0 || entries[index].prev < 0 ? NULL : &entries[entries[index].prev].key;
+    }
+
+    // Calls f(key, value) for every entry: each key in order, with its
+    // repeated entries straight after it.
+    template<typename F> void for_each(F f) const
+    {
+        for (int i = first; i >= 0; i = entries[i].next)
+            for (int d = i; d >= 0; d = entries[d].dup_next)
+                f(entries[d].key, entries[d].value);
+    }
+
+    // Saved as the entries in for_each order; adding them back in that order
+    // rebuilds the same iteration order and duplicate chains.
+    void snapshot(enigma::snapshot_io &io)
+    {
+        unsigned long long n = count;
+        io(n);
+        if (!io.loading()) {
+            for (int i = first; i >= 0; i = entries[i].next)
+                for (int d = i; d >= 0; d = entries[d].dup_next)
+                    io(entries[d].key), io(entries[d].value);
+            return;
+        }
+        clear();
+        for (unsigned long long i = 0; i < n && io.ok(); ++i) {
+            variant key, value;
+            io(key); io(value);
+            add(key, value);
+        }
+    }
+};
+
+static handle_table<map_data> ds_maps("ds_map");
 
 namespace enigma_user
 {
@@ -845,14 +1348,13 @@ namespace enigma_user
 unsigned int ds_map_create()
 {
   //Creates a new map. The function returns an integer as an id that must be used in all other functions to access the particular map.
-  ds_maps.insert(pair<unsigned int, multimap<variant, variant> >(ds_maps_maxid++, multimap<variant, variant>()));
-  return ds_maps_maxid-1;
+  return ds_maps.add(map_data());
 }
 
 void ds_map_destroy(const unsigned int id)
 {
   //Destroys the map
-  ds_maps.erase(ds_maps.find(id));
+  ds_maps.destroy(id);
 }
 
 void ds_map_clear(const unsigned int id)
@@ -882,7 +1384,7 @@ bool ds_map_empty(const unsigned int id)
 void ds_map_add(const unsigned int id, const variant key, const variant val)
 {
   //Adds the value and corresponding key to the map.
-  ds_maps[id].insert(pair<variant, variant>(key, val));
+  ds_maps[id].add(key, val);
 }
 
 void ds_map_replace(const unsigned int id, const variant key, const variant val)
@@ -896,115 +1398,87 @@ void ds_map_replace(const unsigned int id, const variant key, const variant val)
   //not exist in the global async_load map.
 
   //Replaces the value corresponding with the key with a new value
-  multimap<variant, variant>::iterator it = ds_maps[id].find(key);
-  if (it != ds_maps[id].end())
-  {
-    ds_maps[id].erase(it);
-    ds_maps[id].insert(pair<variant, variant>(key, val));
-  }
+  ds_maps[id].replace(key, val);
 }
 
 //NOTE: Special function, see todo comment above.
 void ds_map_overwrite(const unsigned int id, const variant key, const variant val)
 {
   //Replaces the value corresponding with the key with a new value, adding it if it was not found in the map.
-  multimap<variant, variant>::iterator it = ds_maps[id].find(key);
-  if (it != ds_maps[id].end())
+  map_data &dsMap = ds_maps[id];
+  if (!dsMap.replace(key, val))
   {
-    ds_maps[id].erase(it);
+    dsMap.add(key, val);
   }
-  ds_maps[id].insert(pair<variant, variant>(key, val));
 }
 
 void ds_map_delete(const unsigned int id, const variant key)
 {
   //Deletes the key and the corresponding value from the map
-  multimap<variant, variant>::iterator it = ds_maps[id].find(key);
-  if (it != ds_maps[id].end())
-  {
-    ds_maps[id].erase(it);
-  }
+  ds_maps[id].erase(key);
 }
 
 void ds_map_delete(const unsigned int id, const variant first, const variant last)
 {
-  //Deletes the keys and corresponding values in the range between first and last
-  multimap<variant, variant>::iterator itf = ds_maps[id].find(first), itl = ds_maps[id].find(last);
-  if (itf != ds_maps[id].end() && itl != ds_maps[id].end())
-  {
-    ds_maps[id].erase(itf, itl);
-  }
+  //Deletes the keys and corresponding values from first up to last, in the map's order
+  ds_maps[id].erase(first, last);
 }
 
 bool ds_map_exists(const unsigned int id, const variant key)
 {
   //returns whether the key exists in the map
-  return (ds_maps[id].find(key) != ds_maps[id].end());
+  return ds_maps[id].exists(key);
 }
 
 variant ds_map_find_value(const unsigned int id, const variant key)
 {
   //Returns the value corresponding to the key in the map
-  multimap<variant, variant>::iterator it = ds_maps[id].find(key);
-  return ((it == ds_maps[id].end()) ? variant() : (*it).second);
+  const variant *val = ds_maps[id].find_value(key);
+  return val ? *val : variant();
 }
 
 variant ds_map_find_previous(const unsigned int id, const variant key)
 {
-  //Returns the largest key in the map smaller than the indicated key
-  multimap<variant, variant>::reverse_iterator rit;
-  variant key_check;
-  for (rit = ds_maps[id].rbegin(); rit != ds_maps[id].rend(); rit++)
-  {
-    if ((key_check = (*rit).first) < key)
-    {
-      return key_check;
-    }
-  }
-  return variant();
+  //Returns the key before the indicated key in the map's order (the order keys were
+  //first added), or undefined if the key is first or isn't in the map. The old sorted
+  //map gave the largest smaller key, even for a key it didn't hold.
+  const variant *prev = ds_maps[id].previous_key(key);
+  return prev ? *prev : variant();
 }
 
 variant ds_map_find_next(const unsigned int id, const variant key)
 {
-  //Returns the smallest key in the map larger than the indicated key
-  multimap<variant, variant>::iterator it;
-  variant key_check;
-  for (it = ds_maps[id].begin(); it != ds_maps[id].end(); it++)
-  {
-    if ((key_check = (*it).first) > key)
-    {
-      return key_check;
-    }
-  }
-  return variant();
+  //Returns the key after the indicated key in the map's order (the order keys were
+  //first added), or undefined if the key is last or isn't in the map. The old sorted
+  //map gave the smallest larger key, even for a key it didn't hold.
+  const variant *next = ds_maps[id].next_key(key);
+  return next ? *next : variant();
 }
 
 variant ds_map_find_first(const unsigned int id)
 {
-  //Returns the smallest key in the map
-  multimap<variant, variant>::iterator it = ds_maps[id].begin();
-  return (it == ds_maps[id].end()) ? variant() : (*it).first;
+  //Returns the first key in the map's order
+  const variant *key = ds_maps[id].first_key();
+  return key ? *key : variant();
 }
 
 variant ds_map_find_last(const unsigned int id)
 {
-  //Returns the largest key in the map
-  multimap<variant, variant>::reverse_iterator rit = ds_maps[id].rbegin();
-  return ((rit == ds_maps[id].rend()) ? variant() : (*rit).first);
+  //Returns the last key in the map's order
+  const variant *key = ds_maps[id].last_key();
+  return key ? *key : variant();
 }
 
 bool ds_map_exists(const unsigned int id)
 {
   //returns whether the map exists
-  return (ds_maps.find(id) != ds_maps.end());
+  return ds_maps.exists(id);
 }
 
 unsigned int ds_map_duplicate(const unsigned int source)
 {
   //creates and returns a new map containing a copy of the source map
-  ds_maps.insert(pair<unsigned int, multimap<variant, variant> >(++ds_maps_maxid, multimap<variant, variant>()));
-  ds_maps[ds_maps_maxid-1] = ds_maps[source];
-  return ds_maps_maxid-1;
+  return ds_maps.add(ds_maps[source]);
 }
 
 std::string ds_map_write(const unsigned int id)
@@ -1014,55 +1488,52 @@ std::string ds_map_write(const unsigned int id)
   ss.width(4);
   ss.fill('0');
 
-  std::multimap<variant, variant> dsMap = ds_maps[id];
+  const map_data &dsMap = ds_maps[id];
 
   // Write size
   ss << std::hex << dsMap.size();
 
-  std::multimap<variant, variant>::iterator it = dsMap.begin();
-  while (it != dsMap.end())
+  dsMap.for_each([&](const variant &key, const variant &val)
   {
     // Write type
     ss.width(2);
-    ss << (unsigned int)(((*it).first.type == ty_real) ? 0x00 : 0x01);
+    ss << (unsigned int)((key.type == ty_real) ? 0x00 : 0x01);
 
     // Write data
-    if ((*it).first.type == ty_real)
+    if (key.type == ty_real)
     {
       ss.width(16);
-            char* b = (char*)&(*it).first.rval.d;
+            const char* b = (const char*)&key.rval.d;
             for (unsigned i = 0; i < sizeof(double); ++i)
             ss << b[i];
     }
     else
     {
-      ss.width(4); ss << (*it).first.string_length();
+      ss.width(4); ss << key.string_length();
       ss.width(1);
-      for (size_t j = 0; j < (*it).first.string_length(); ++j)
-        ss << (*it).first.char_at(j);
+      for (size_t j = 0; j < key.string_length(); ++j)
+        ss << key.char_at(j);
     }
 
     // Write type
     ss.width(2);
-    ss << (unsigned int)(((*it).second.type == ty_real) ? 0x00 : 0x01);
+    ss << (unsigned int)((val.type == ty_real) ? 0x00 : 0x01);
 
     // Write data
-    if ((*it).second.type == ty_real)
+    if (val.type == ty_real)
     {
       ss.width(16);
-      char* b = (char*)&(*it).second.rval.d;
+      const char* b = (const char*)&val.rval.d;
       for (unsigned i = 0; i < sizeof(double); ++i)
         ss << b[i];    }
     else
     {
-      ss.width(4); ss << (*it).second.string_length();
+      ss.width(4); ss << val.string_length();
       ss.width(1);
-      for (size_t j = 0; j < (*it).second.string_length(); ++j)
-        ss << (*it).second.char_at(j);
+      for (size_t j = 0; j < val.string_length(); ++j)
+        ss << val.char_at(j);
     }
-
-    ++it;
-  }
+  });
 
   return ss.str();
 }
@@ -1150,7 +1621,7 @@ void ds_map_read(const unsigned int id, std::string value)
     }
 
     // Push value
-    ds_maps[id].insert(std::pair<variant, variant>(variKey, variValue));
+    ds_maps[id].add(variKey, variValue);
   }
 }
 
@@ -1158,8 +1629,7 @@ void ds_map_read(const unsigned int id, std::string value)
 
 /* ds_lists */
 
-static map<unsigned int, vector<variant> > ds_lists;
-static unsigned int ds_lists_maxid = 0;
+static handle_table<vector<variant>> ds_lists("ds_list");
 
 namespace enigma_user
 {
@@ -1167,14 +1637,13 @@ namespace enigma_user
 unsigned int ds_list_create()
 {
   //Creates a new list. The function returns an integer as an id that must be used in all other functions to access the particular list.
-  ds_lists.insert(pair<unsigned int, vector<variant> >(ds_lists_maxid++, vector<variant>()));
-  return ds_lists_maxid-1;
+  return ds_lists.add(vector<variant>());
 }
 
 void ds_list_destroy(const unsigned int id)
 {
   //Destroys the list
-  ds_lists.erase(ds_lists.find(id));
+  ds_lists.destroy(id);
 }
 
 void ds_list_clear(const unsigned int id)
@@ -1286,15 +1755,13 @@ void ds_list_shuffle(const unsigned int id)
 bool ds_list_exists(const unsigned int id)
 {
   //returns whether the list exists
-  return (ds_lists.find(id) != ds_lists.end());
+  return ds_lists.exists(id);
 }
 
 unsigned int ds_list_duplicate(const unsigned int source)
 {
   //creates and returns a new list containing a copy of the source list
-  ds_lists.insert(pair<unsigned int, vector<variant> >(++ds_lists_maxid, vector<variant>()));
-  ds_lists[ds_lists_maxid-1] = ds_lists[source];
-  return ds_lists_maxid-1;
+  return ds_lists.add(ds_lists[source]);
 }
 
 std::string ds_list_write(const unsigned int id)
@@ -1304,7 +1771,7 @@ std::string ds_list_write(const unsigned int id)
   ss.width(4);
   ss.fill('0');
 
-  std::vector<variant> dsList = ds_lists[id];
+  const std::vector<variant> &dsList = ds_lists[id];
 
   // Write count
   ss << dsList.size();
@@ -1318,7 +1785,7 @@ std::string ds_list_write(const unsigned int id)
     if (dsList[i].type == ty_real)
     {
       ss.width(16);
-      char* b = (char*)&dsList[i].rval.d;
+      const char* b = (const char*)&dsList[i].rval.d;
       for (unsigned i = 0; i < sizeof(double); ++i)
           ss << b[i];
     }
@@ -1394,8 +1861,219 @@ void ds_list_read(const unsigned int id, std::string value)
 
 /* ds_prioritys */
 
-static map<unsigned int, multimap<variant, variant> > ds_prioritys;
-static unsigned int ds_prioritys_maxid = 0;
+// A priority queue of (value, priority) entries. Entries sit in slots reused
+// through a free list; a min-heap and a max-heap of slot numbers order them by
+// priority, and each entry keeps its position in both, so adding, popping
+// either end, and deleting or reprioritizing a value are all O(log n). The
+// by-value functions go through `values`, which maps each value to its slots.
+// Ties in priority go to the smaller value, then to the earlier insertion.
+class priority_data
+{
+    typedef multimap<variant, unsigned> value_index;
+    enum { min_heap, max_heap };
+
+    struct entry {
+        value_index::iterator where;  // Our value, in the index.
+        variant priority;
+        unsigned long long order;     // When we were added, for ties.
+        size_t heap_pos[2];
+    };
+
+    vector<entry> entries;
+    vector<unsigned> free_slots;
+    vector<unsigned> heaps[2];
+    value_index values;
+    unsigned long long next_order = 0;
+
+    // Whether slot a belongs above slot b in the given heap.
+    bool above(int h, unsigned a, unsigned b) const
+    {
+        const entry &ea = entries[a], &eb = entries[b];
+        if (h == min_heap ? ea.priority < eb.priority : ea.priority > eb.priority) return true;
+        if (h == min_heap ? eb.priority < ea.priority : eb.priority > ea.priority) return false;
+        if (ea.where->first < eb.where->first) return true;
+        if (eb.where->first < ea.where->first) return false;
+        return ea.order < eb.order;
+    }
+    void place(int h, size_t pos, unsigned slot)
+    {
+        heaps[h][pos] = slot;
+        entries[slot].heap_pos[h] = pos;
+    }
+    void sift_up(int h, size_t pos)
+    {
+        const unsigned slot = heaps[h][pos];
+        while (pos > 0 && above(h, slot, heaps[h][(pos - 1) / 2])) {
+            place(h, pos, heaps[h][(pos - 1) / 2]);
+            pos = (pos - 1) / 2;
+        }
+        place(h, pos, slot);
+    }
+    void sift_down(int h, size_t pos)
+    {
+        const unsigned slot = heaps[h][pos];
+        const size_t n = heaps[h].size();
+        for (size_t child; (child = 2 * pos + 1) < n; pos = child) {
+            if (child + 1 < n && above(h, heaps[h][child + 1], heaps[h][child])) ++child;
+            if (!above(h, heaps[h][child], slot)) break;
+            place(h, pos, heaps[h][child]);
+        }
+        place(h, pos, slot);
+    }
+    // Moves the entry at pos up or down until the heap is in order again.
+    void fix(int h, size_t pos)
+    {
+        if (pos > 0 && above(h, heaps[h][pos], heaps[h][(pos - 1) / 2]))
+            sift_up(h, pos);
+        else
+            sift_down(h, pos);
+    }
+    void heap_remove(int h, size_t pos)
+    {
+        const unsigned last = heaps[h].back();
+        heaps[h].pop_back();
+        if (pos < heaps[h].size()) {
+            place(h, pos, last);
+            fix(h, pos);
+        }
+    }
+    void remove(unsigned slot)
+    {
+        entry &e = entries[slot];
+        heap_remove(min_heap, e.heap_pos[min_heap]);
+        heap_remove(max_heap, e.heap_pos[max_heap]);
+        values.erase(e.where);
+        e.priority = variant();
+        free_slots.push_back(slot);
+    }
+    // The slot holding val, or -1. With duplicates, the earliest added.
+    int find(const variant &val)
+    {
+        value_index::iterator it = values.find(val);
+        return it == values.end() ? -1 : int(it->second);
+    }
+
+    public:
+    priority_data() {}
+    priority_data(const priority_data &other) { *this = other; }
+    priority_data &operator=(const priority_data &other)
+    {
+        if (this == &other) return *this;
+        entries = other.entries;
+        free_slots = other.free_slots;
+        heaps[min_heap] = other.heaps[min_heap];
+        heaps[max_heap] = other.heaps[max_heap];
+        next_order = other.next_order;
+
+        // The entries point into the other queue's index; build our own, adding
+        // values in their original order so duplicates keep theirs.
+        values.clear();
+        vector<unsigned> live(heaps[min_heap]);
+        sort(live.begin(), live.end(), [&](unsigned a, unsigned b) { return entries[a].order < entries[b].order; });
+        for (unsigned slot : live)
+            entries[slot].where = values.insert(make_pair(other.entries[slot].where->first, slot));
+        return *this;
+    }
+
+    size_t size() const { return heaps[min_heap].size(); }
+    bool empty() const { return heaps[min_heap].empty(); }
+    void clear()
+    {
+        entries.clear();
+        free_slots.clear();
+        heaps[min_heap].clear();
+        heaps[max_heap].clear();
+        values.clear();
+    }
+
+    void add(const variant &val, const variant &prio)
+    {
+        unsigned slot;
+        if (free_slots.empty()) {
+            slot = entries.size();
+            entries.push_back(entry());
+        } else {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+        entry &e = entries[slot];
+        e.where = values.insert(make_pair(val, slot));
+        e.priority = prio;
+        e.order = next_order++;
+        for (int h = min_heap; h <= max_heap; h++) {
+            heaps[h].push_back(slot);
+            sift_up(h, heaps[h].size() - 1);
+        }
+    }
+    // Like deleting the value and adding it back with the new priority.
+    void change_priority(const variant &val, const variant &prio)
+    {
+        const int slot = find(val);
+        if (slot < 0) return;
+        entry &e = entries[slot];
+        values.erase(e.where);
+        e.where = values.insert(make_pair(val, unsigned(slot)));
+        e.priority = prio;
+        e.order = next_order++;
+        fix(min_heap, e.heap_pos[min_heap]);
+        fix(max_heap, e.heap_pos[max_heap]);
+    }
+    variant priority_of(const variant &val)
+    {
+        const int slot = find(val);
+        return slot < 0 ? variant() : entries[slot].priority;
+    }
+    void delete_value(const variant &val)
+    {
+        const int slot = find(val);
+        if (slot >= 0) remove(slot);
+    }
+    bool value_exists(const variant &val) { return find(val) >= 0; }
+
+    const variant &find_min() const { return entries[heaps[min_heap][0]].where->first; }
+    const variant &find_max() const { return entries[heaps[max_heap][0]].where->first; }
+    variant delete_min()
+    {
+        const variant val = find_min();
+        remove(heaps[min_heap][0]);
+        return val;
+    }
+    variant delete_max()
+    {
+        const variant val = find_max();
+        remove(heaps[max_heap][0]);
+        return val;
+    }
+
+    // Entries in value order, as (value, slot); see priority_at.
+    const value_index &by_value() const { return values; }
+    const variant &priority_at(unsigned slot) const { return entries[slot].priority; }
+
+    // Saved as (value, priority) pairs in insertion order, which is all the
+    // heaps need to break ties the same way once the pairs are added back.
+    void snapshot(enigma::snapshot_io &io)
+    {
+        unsigned long long n = size();
+        io(n);
+        if (!io.loading()) {
+            vector<unsigned> live(heaps[min_heap]);
+            sort(live.begin(), live.end(), [&](unsigned a, unsigned b) { return entries[a].order < entries[b].order; });
+            for (unsigned slot : live) {
+                variant val = entries[slot].where->first;
+                io(val); io(entries[slot].priority);
+            }
+            return;
+        }
+        clear();
+        for (unsigned long long i = 0; i < n && io.ok(); ++i) {
+            variant val, prio;
+            io(val); io(prio);
+            add(val, prio);
+        }
+    }
+};
+
+static handle_table<priority_data> ds_prioritys("ds_priority");
 
 namespace enigma_user
 {
@@ -1403,14 +2081,13 @@ namespace enigma_user
 unsigned int ds_priority_create()
 {
   //Creates a new priority queue. The function returns an integer as an id that must be used in all other functions to access the particular priority queue.
-  ds_prioritys.insert(pair<unsigned int, multimap<variant, variant> >(ds_prioritys_maxid++, multimap<variant, variant>()));
-  return ds_prioritys_maxid-1;
+  return ds_prioritys.add(priority_data());
 }
 
 void ds_priority_destroy(const unsigned int id)
 {
   //Destroys the priority queue
-  ds_prioritys.erase(ds_prioritys.find(id));
+  ds_prioritys.destroy(id);
 }
 
 void ds_priority_clear(const unsigned int id)
@@ -1440,115 +2117,75 @@ bool ds_priority_empty(const unsigned int id)
 void ds_priority_add(const unsigned int id, const variant val, const variant prio)
 {
   //Adds the value with the given priority to the priority queue
-  ds_prioritys[id].insert(pair<variant, variant>(val, prio));
+  ds_prioritys[id].add(val, prio);
 }
 
 void ds_priority_change_priority(const unsigned int id, const variant val, const variant prio)
 {
   //Changes the priority of the given value in the priority queue
-  multimap<variant, variant>::iterator it = ds_prioritys[id].find(val);
-  if (it != ds_prioritys[id].end())
-  {
-    ds_prioritys[id].erase(it);
-    ds_prioritys[id].insert(pair<variant, variant>(val, prio));
-  }
+  ds_prioritys[id].change_priority(val, prio);
 }
 
 variant ds_priority_find_priority(const unsigned int id, const variant val)
 {
   //Returns the priority of the given value in the priority queue
-  multimap<variant, variant>::iterator it = ds_prioritys[id].find(val);
-  return ((it == ds_prioritys[id].end()) ? variant() : (*it).second);
+  return ds_prioritys[id].priority_of(val);
 }
 
 void ds_priority_delete_value(const unsigned int id, const variant val)
 {
   //Deletes the given value (with its priority) from the priority queue
-  multimap<variant, variant>::iterator it = ds_prioritys[id].find(val);
-  if (it != ds_prioritys[id].end())
-  {
-    ds_prioritys[id].erase(it);
-  }
+  ds_prioritys[id].delete_value(val);
 }
 
 bool ds_priority_value_exists(const unsigned int id, const variant val)
 {
   //returns whether the value exists in the priority queue
-  return (ds_prioritys[id].find(val) != ds_prioritys[id].end());
+  return ds_prioritys[id].value_exists(val);
 }
 
 variant ds_priority_delete_min(const unsigned int id)
 {
-  //Returns the value with the smallest priority but does not delete it from the priority queue
-  multimap<variant, variant>::iterator it = ds_prioritys[id].begin(), it_check;
-  if (it == ds_prioritys[id].end()) {return 0;}
-  it_check = it++;
-  while (it != ds_prioritys[id].end())
-  {
-    if ((*it).second < (*it_check).second) {it_check = it;}
-    it++;
-  }
-  const variant val = (*it_check).first;
-  ds_prioritys[id].erase(it_check);
-  return val;
+  //Returns the value with the smallest priority and deletes it from the priority queue
+  priority_data &pq = ds_prioritys[id];
+  if (pq.empty()) {return 0;}
+  return pq.delete_min();
 }
 
 variant ds_priority_find_min(const unsigned int id)
 {
   //Returns the value with the smallest priority but does not delete it from the priority queue
-  multimap<variant, variant>::iterator it = ds_prioritys[id].begin(), it_check;
-  if (it == ds_prioritys[id].end()) {return variant();}
-  it_check = it++;
-  while (it != ds_prioritys[id].end())
-  {
-    if ((*it).second < (*it_check).second) {it_check = it;}
-    it++;
-  }
-  return ((*it_check).first);
+  priority_data &pq = ds_prioritys[id];
+  if (pq.empty()) {return variant();}
+  return pq.find_min();
 }
 
 variant ds_priority_delete_max(const unsigned int id)
 {
-  //Returns the value with the smallest priority but does not delete it from the priority queue
-  multimap<variant, variant>::iterator it = ds_prioritys[id].begin(), it_check;
-  if (it == ds_prioritys[id].end()) {return variant();}
-  it_check = it++;
-  while (it != ds_prioritys[id].end())
-  {
-    if ((*it).second > (*it_check).second) {it_check = it;}
-    it++;
-  }
-  const variant val = (*it_check).first;
-  ds_prioritys[id].erase(it_check);
-  return val;
+  //Returns the value with the largest priority and deletes it from the priority queue
+  priority_data &pq = ds_prioritys[id];
+  if (pq.empty()) {return variant();}
+  return pq.delete_max();
 }
 
 variant ds_priority_find_max(const unsigned int id)
 {
-  //Returns the value with the smallest priority but does not delete it from the priority queue
-  multimap<variant, variant>::iterator it = ds_prioritys[id].begin(), it_check;
-  if (it == ds_prioritys[id].end()) {return variant();}
-  it_check = it++;
-  while (it != ds_prioritys[id].end())
-  {
-    if ((*it).second > (*it_check).second) {it_check = it;}
-    it++;
-  }
-  return ((*it_check).first);
+  //Returns the value with the largest priority but does not delete it from the priority queue
+  priority_data &pq = ds_prioritys[id];
+  if (pq.empty()) {return variant();}
+  return pq.find_max();
 }
 
 bool ds_priority_exists(const unsigned int id)
 {
   //returns whether the priority queue exists
-  return (ds_prioritys.find(id) != ds_prioritys.end());
+  return ds_prioritys.exists(id);
 }
 
 unsigned int ds_priority_duplicate(const unsigned int source)
 {
   //creates and returns a new priority queue containing a copy of the source priority queue
-  ds_prioritys.insert(pair<unsigned int, multimap<variant, variant> >(++ds_prioritys_maxid, multimap<variant, variant>()));
-  ds_prioritys[ds_prioritys_maxid-1] = ds_prioritys[source];
-  return ds_prioritys_maxid-1;
+  return ds_prioritys.add(ds_prioritys[source]);
 }
 
 std::string ds_priority_write(const unsigned int id)
@@ -1558,39 +2195,38 @@ std::string ds_priority_write(const unsigned int id)
   ss.width(4);
   ss.fill('0');
 
-  std::multimap<variant, variant> dsPriority = ds_prioritys[id];
+  const priority_data &dsPriority = ds_prioritys[id];
 
   // Write size
   ss << std::hex << dsPriority.size();
 
-  std::multimap<variant, variant>::iterator it = dsPriority.begin();
-  while (it != dsPriority.end())
+  for (const auto &it : dsPriority.by_value())
   {
+    const variant &prio = dsPriority.priority_at(it.second);
+
     // Write type
     ss.width(2);
-    ss << (unsigned int)(((*it).first.type == ty_real) ? 0x00 : 0x01);
+    ss << (unsigned int)((it.first.type == ty_real) ? 0x00 : 0x01);
     ss.width(16);
-    char* b = (char*)&(*it).second.rval.d;
+    const char* b = (const char*)&prio.rval.d;
     for (unsigned i = 0; i < sizeof(double); ++i)
         ss << b[i];
 
     // Write data
-    if ((*it).first.type == ty_real)
+    if (it.first.type == ty_real)
     {
       ss.width(16);
-      char* b = (char*)&(*it).first.rval.d;
+      const char* b = (const char*)&it.first.rval.d;
       for (unsigned i = 0; i < sizeof(double); ++i)
           ss << b[i];
     }
     else
     {
-      ss.width(4); ss << (*it).first.string_length();
+      ss.width(4); ss << it.first.string_length();
       ss.width(1);
-      for (size_t j = 0; j < (*it).first.string_length(); ++j)
-        ss << (*it).first.char_at(j);
+      for (size_t j = 0; j < it.first.string_length(); ++j)
+        ss << it.first.char_at(j);
     }
-
-    ++it;
   }
 
   return ss.str();
@@ -1658,7 +2294,7 @@ void ds_priority_read(const unsigned int id, std::string value)
     }
 
     // Push value
-    ds_prioritys[id].insert(std::pair<variant, variant>(vari, prio));
+    ds_prioritys[id].add(vari, prio);
   }
 }
 
@@ -1666,8 +2302,7 @@ void ds_priority_read(const unsigned int id, std::string value)
 
 /* ds_queues */
 
-static map<unsigned int, deque<variant> > ds_queues;
-static unsigned int ds_queues_maxid = 0;
+static handle_table<deque<variant>> ds_queues("ds_queue");
 
 namespace enigma_user
 {
@@ -1675,14 +2310,13 @@ namespace enigma_user
 unsigned int ds_queue_create()
 {
   //Creates a new queue. The function returns an integer as an id that must be used in all other functions to access the particular queue.
-  ds_queues.insert(pair<unsigned int, deque<variant> >(ds_queues_maxid++, deque<variant>()));
-  return ds_queues_maxid-1;
+  return ds_queues.add(deque<variant>());
 }
 
 void ds_queue_destroy(const unsigned int id)
 {
   //Destroys the queue
-  ds_queues.erase(ds_queues.find(id));
+  ds_queues.destroy(id);
 }
 
 void ds_queue_clear(const unsigned int id)
@@ -1743,15 +2377,13 @@ variant ds_queue_tail(const unsigned int id)
 bool ds_queue_exists(const unsigned int id)
 {
   //returns whether the queue exists
-  return (ds_queues.find(id) != ds_queues.end());
+  return ds_queues.exists(id);
 }
 
 unsigned int ds_queue_duplicate(const unsigned int source)
 {
   //creates and returns a new queue containing a copy of the source queue
-  ds_queues.insert(pair<unsigned int, deque<variant> >(++ds_queues_maxid, deque<variant>()));
-  ds_queues[ds_queues_maxid-1] = ds_queues[source];
-  return ds_queues_maxid-1;
+  return ds_queues.add(ds_queues[source]);
 }
 
 std::string ds_queue_write(const unsigned int id)
@@ -1761,7 +2393,7 @@ std::string ds_queue_write(const unsigned int id)
   ss.width(4);
   ss.fill('0');
 
-  std::deque<variant> dsQueue = ds_queues[id];
+  const std::deque<variant> &dsQueue = ds_queues[id];
 
   // Write size
   ss << std::hex << dsQueue.size();
@@ -1776,7 +2408,7 @@ std::string ds_queue_write(const unsigned int id)
     if (dsQueue[i].type == ty_real)
     {
       ss.width(16);
-      char* b = (char*)&dsQueue[i].rval.d;
+      const char* b = (const char*)&dsQueue[i].rval.d;
       for (unsigned i = 0; i < sizeof(double); ++i)
           ss << b[i];
     }
@@ -1850,8 +2482,7 @@ void ds_queue_read(const unsigned int id, std::string value)
 
 /* ds_stacks */
 
-static map<unsigned int, deque<variant> > ds_stacks;
-static unsigned int ds_stacks_maxid = 0;
+static handle_table<deque<variant>> ds_stacks("ds_stack");
 
 namespace enigma_user
 {
@@ -1859,14 +2490,13 @@ namespace enigma_user
 unsigned int ds_stack_create()
 {
   //Creates a new stack. The function returns an integer as an id that must be used in all other functions to access the particular stack.
-  ds_stacks.insert(pair<unsigned int, deque<variant> >(ds_stacks_maxid++, deque<variant>()));
-  return ds_stacks_maxid-1;
+  return ds_stacks.add(deque<variant>());
 }
 
 void ds_stack_destroy(const unsigned int id)
 {
   //Destroys the stack
-  ds_stacks.erase(ds_stacks.find(id));
+  ds_stacks.destroy(id);
 }
 
 void ds_stack_clear(const unsigned int id)
@@ -1920,15 +2550,13 @@ variant ds_stack_top(const unsigned int id)
 bool ds_stack_exists(const unsigned int id)
 {
   //returns whether the stack exists
-  return (ds_stacks.find(id) != ds_stacks.end());
+  return ds_stacks.exists(id);
 }
 
 unsigned int ds_stack_duplicate(const unsigned int source)
 {
   //creates and returns a new stack containing a copy of the source stack
-  ds_stacks.insert(pair<unsigned int, deque<variant> >(++ds_stacks_maxid, deque<variant>()));
-  ds_stacks[ds_stacks_maxid-1] = ds_stacks[source];
-  return ds_stacks_maxid-1;
+  return ds_stacks.add(ds_stacks[source]);
 }
 
 std::string ds_stack_write(const unsigned int id)
@@ -1938,7 +2566,7 @@ std::string ds_stack_write(const unsigned int id)
   ss.width(4);
   ss.fill('0');
 
-  std::deque<variant> dsStack = ds_stacks[id];
+  const std::deque<variant> &dsStack = ds_stacks[id];
 
   // Write size
   ss << std::hex << dsStack.size();
@@ -1953,7 +2581,7 @@ std::string ds_stack_write(const unsigned int id)
     if (dsStack[i].type == ty_real)
     {
       ss.width(16);
-      char* b = (char*)&dsStack[i].rval.d;
+      const char* b = (const char*)&dsStack[i].rval.d;
       for (unsigned i = 0; i < sizeof(double); ++i)
         ss << b[i];
     }
@@ -2024,3 +2652,17 @@ void ds_stack_read(const unsigned int id, std::string value)
 }
 
 }
+
+/* game_save/game_load */
+
+static void snapshot_data_structures(enigma::snapshot_io &io)
+{
+  ds_grids.snapshot(io);
+  ds_maps.snapshot(io);
+  ds_lists.snapshot(io);
+  ds_prioritys.snapshot(io);
+  ds_queues.snapshot(io);
+  ds_stacks.snapshot(io);
+}
+
+static enigma::snapshot_section data_structures_section("DS  ", snapshot_data_structures);
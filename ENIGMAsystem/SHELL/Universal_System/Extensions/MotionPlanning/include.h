@@ -1,3 +1,5 @@
 #include "motion_planning.h"
 #include "mp_movement.h"
+#include "mp_grid_async.h"
+#include "mp_grid_flow.h"
 #include "actions.h"
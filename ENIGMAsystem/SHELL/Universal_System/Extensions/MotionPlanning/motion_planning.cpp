@@ -71,45 +71,18 @@ void mp_grid_copy(unsigned id, unsigned srcid)
     enigma::grid *grid = enigma::gridstructarray[id];
     enigma::grid *sgrid = enigma::gridstructarray[srcid];
 
-    grid->nodearray.clear();
-    grid->nodearray.reserve(sgrid->hcells*sgrid->vcells);
+    grid->nodearray = sgrid->nodearray;
     grid->vcells = sgrid->vcells;
     grid->hcells = sgrid->hcells;
     grid->cellwidth = sgrid->cellwidth;
     grid->cellheight = sgrid->cellheight;
     grid->speed_modifier = sgrid->speed_modifier;
     grid->threshold = sgrid->threshold;
+    grid->jps = sgrid->jps;
     grid->left = sgrid->left;
     grid->top = sgrid->top;
-    for (unsigned int i = 0; i < sgrid->hcells*sgrid->vcells; i++)
-    {
-        enigma::node node(floor(i / sgrid->vcells),i % sgrid->vcells,0,0,0,sgrid->nodearray[i].cost);
-        grid->nodearray.push_back(node);
-    }
-
-    for (unsigned int i = 0; i < grid->hcells; i++){
-        for (unsigned int c = 0; c < grid->vcells; c++){
-        if (i>0){
-            grid->nodearray[i*grid->vcells+c].neighbor_nodes.push_back(&grid->nodearray[(i-1)*grid->vcells+c]); //left
-            if (c>0)
-                grid->nodearray[i*grid->vcells+c].neighbor_nodes.push_back(&grid->nodearray[(i-1)*grid->vcells+c-1]); //top-left
-            if (c<grid->vcells-1)
-                grid->nodearray[i*grid->vcells+c].neighbor_nodes.push_back(&grid->nodearray[(i-1)*grid->vcells+c+1]); //bottom-left
-        }
-        if (c>0)
-            grid->nodearray[i*grid->vcells+c].neighbor_nodes.push_back(&grid->nodearray[i*grid->vcells+c-1]); //top
-        if (i<grid->hcells-1){
-            grid->nodearray[i*grid->vcells+c].neighbor_nodes.push_back(&grid->nodearray[(i+1)*grid->vcells+c]); //right
-            if (c>0)
-                grid->nodearray[i*grid->vcells+c].neighbor_nodes.push_back(&grid->nodearray[(i+1)*grid->vcells+c-1]); //top-right
-            if (c<grid->vcells-1)
-                grid->nodearray[i*grid->vcells+c].neighbor_nodes.push_back(&grid->nodearray[(i+1)*grid->vcells+c+1]); //bottom-bottom
-        }
-        if (c<grid->vcells-1)
-            grid->nodearray[i*grid->vcells+c].neighbor_nodes.push_back(&grid->nodearray[i*grid->vcells+c+1]); //bottom
-
-        }
-    }
+    grid->build_topology();
+    grid->changed();
 }
 
 void mp_grid_clear_all(unsigned id, unsigned cost)
@@ -117,12 +90,14 @@ void mp_grid_clear_all(unsigned id, unsigned cost)
     for (vector<enigma::node>::iterator it = enigma::gridstructarray[id]->nodearray.begin(); it!=enigma::gridstructarray[id]->nodearray.end(); ++it)
         (*it).cost = cost;
     enigma::gridstructarray[id]->threshold = cost;
+    enigma::gridstructarray[id]->changed();
 }
 
 void mp_grid_clear_cell(unsigned id,int h,int v, unsigned cost)
 {
     enigma::gridstructarray[id]->nodearray[h*enigma::gridstructarray[id]->vcells+v].cost = cost;
     if (enigma::gridstructarray[id]->threshold<cost){enigma::gridstructarray[id]->threshold=cost;}
+    enigma::gridstructarray[id]->changed();
 }
 
 void mp_grid_add_rectangle(unsigned id,double x1,double y1,double x2,double y2, unsigned cost)
@@ -141,6 +116,7 @@ void mp_grid_add_rectangle(unsigned id,double x1,double y1,double x2,double y2,
     }
     if (cost>max_cost){max_cost=cost;}
     if (grid->threshold<max_cost){grid->threshold=max_cost;}
+    grid->changed();
 }
 
 void mp_grid_add_instances(unsigned id,int obj,bool prec,unsigned cost)
@@ -158,6 +134,7 @@ void mp_grid_add_instances(unsigned id,int obj,bool prec,unsigned cost)
     }
     if (cost>max_cost){max_cost=cost;}
     if (grid->threshold<max_cost){grid->threshold=max_cost;}
+    grid->changed();
 }
 
 void mp_grid_reset_threshold(unsigned id)
@@ -167,6 +144,7 @@ void mp_grid_reset_threshold(unsigned id)
     for (vector<enigma::node>::iterator it = grid->nodearray.begin(); it!=grid->nodearray.end(); ++it)
         if ((*it).cost>max_cost){max_cost=(*it).cost;}
     grid->threshold=max_cost;
+    grid->changed();
 }
 
 void mp_grid_clear_rectangle(unsigned id,double x1,double y1,double x2,double y2, unsigned cost)
@@ -180,6 +158,7 @@ void mp_grid_add_cell(unsigned id,int h,int v, unsigned cost)
     enigma::gridstructarray[id]->nodearray[h*enigma::gridstructarray[id]->vcells+v].cost = cost;
     if (cost>max_cost){max_cost=cost;}
     if (enigma::gridstructarray[id]->threshold<max_cost){enigma::gridstructarray[id]->threshold=max_cost;}
+    enigma::gridstructarray[id]->changed();
 }
 
 unsigned mp_grid_get_cell(unsigned id,int h,int v)
@@ -195,6 +174,7 @@ unsigned mp_grid_get_threshold(unsigned id)
 void mp_grid_set_threshold(unsigned id, unsigned value)
 {
     enigma::gridstructarray[id]->threshold = value;
+    enigma::gridstructarray[id]->changed();
 }
 
 double mp_grid_get_speed_modifier(unsigned id)
@@ -207,42 +187,58 @@ void mp_grid_set_speed_modifier(unsigned id, double value)
     enigma::gridstructarray[id]->speed_modifier = value;
 }
 
+bool mp_grid_get_jps(unsigned id)
+{
+    return enigma::gridstructarray[id]->jps;
+}
+
+void mp_grid_set_jps(unsigned id, bool enable)
+{
+    enigma::gridstructarray[id]->jps = enable;
+}
+
 bool mp_grid_path(unsigned id,unsigned pathid,double xstart,double ystart,double xgoal,double ygoal,bool allowdiag)
 {
     enigma::grid *gr = enigma::gridstructarray[id];
-    int vc = int(enigma::gridstructarray[id]->vcells),
-    xs = floor((xstart-gr->left)/int(gr->cellwidth)), ys = floor((ystart-gr->top)/int(gr->cellheight)),
-    xg = floor((xgoal-gr->left)/int(gr->cellwidth)), yg = floor((ygoal-gr->top)/int(gr->cellheight));
-    if (xs<0 or xg<0) return false;
-    if (xs>int(gr->hcells)-1 or xg>int(gr->hcells)-1) return false;
-    if (ys<0 or yg<0) return false;
-    if (ys>int(gr->vcells)-1 or yg>int(gr->vcells)-1) return false;
-    
-    bool status = true; //status to check if we can reach the destination
-    multimap<unsigned,enigma::node*> nodelist = enigma::find_path(id, &gr->nodearray[xs*vc+ys], &gr->nodearray[xg*vc+yg], allowdiag, status);
+    unsigned start, goal;
+    if (!gr->cell_at(xstart, ystart, start) || !gr->cell_at(xgoal, ygoal, goal)) return false;
+
+    static vector<unsigned> nodelist;
+    bool status = enigma::find_path(id, start, goal, allowdiag, nodelist); //status to check if we can reach the destination
+    enigma::grid_route_to_path(pathid, *gr, gr->left, gr->top, gr->cellwidth, gr->cellheight, gr->speed_modifier, xstart, ystart, start, xgoal, ygoal, goal, nodelist, status);
+    return true;
+}
+
+}
+
+namespace enigma
+{
+
+void grid_route_to_path(unsigned pathid, const grid_cells &cells, int left, int top, unsigned cellwidth, unsigned cellheight, double speed_modifier,
+    double xstart, double ystart, unsigned start, double xgoal, double ygoal, unsigned goal, const vector<unsigned> &route, bool status)
+{
     enigma::path *path = enigma::pathstructarray[pathid];
     path->pointarray.clear();
 
     //push the very first point
-    enigma::path_point point(xstart,ystart,gr->speed_modifier/double(gr->nodearray[xs*vc+ys].cost));
+    enigma::path_point point(xstart,ystart,speed_modifier/double(cells.nodearray[start].cost));
     path->pointarray.push_back(point);
-    multimap<unsigned,enigma::node*>::reverse_iterator it;
-    for (it=nodelist.rbegin(); it != nodelist.rend(); it++)
+    for (vector<unsigned>::const_iterator it=route.begin(); it != route.end(); it++)
     {
-            point = enigma::path_point(gr->left+((*it).second->x+0.5)*gr->cellwidth,gr->top+((*it).second->y+0.5)*gr->cellheight,gr->speed_modifier/double((*it).second->cost));
+            const enigma::node &n = cells.nodearray[*it];
+            point = enigma::path_point(left+(n.x+0.5)*cellwidth,top+(n.y+0.5)*cellheight,speed_modifier/double(n.cost));
             path->pointarray.push_back(point);
     }
 
     //push the very last point if we can reach the destination
     if (status == true){
-        point = enigma::path_point(xgoal,ygoal,gr->speed_modifier/double(gr->nodearray[xg*vc+yg].cost));
+        point = enigma::path_point(xgoal,ygoal,speed_modifier/double(cells.nodearray[goal].cost));
         path->pointarray.push_back(point);
     } else if (path->pointarray.size()==1) {
-        point = enigma::path_point(path->pointarray.back().x,path->pointarray.back().y,gr->speed_modifier/double(gr->nodearray[xg*vc+yg].cost));
+        point = enigma::path_point(path->pointarray.back().x,path->pointarray.back().y,speed_modifier/double(cells.nodearray[goal].cost));
         path->pointarray.push_back(point);
     }
     enigma::path_recalculate(pathid);
-    return true;
 }
 
 }
@@ -263,18 +259,23 @@ void mp_grid_draw_neighbours(unsigned int id, unsigned int h, unsigned int v, un
     if (v>grid->vcells-1) return;
     draw_primitive_begin(8);
     unsigned int vc = enigma::gridstructarray[id]->vcells;
-    for (vector<enigma::node*>::iterator it = enigma::gridstructarray[id]->nodearray[h*vc+v].neighbor_nodes.begin(); it!=enigma::gridstructarray[id]->nodearray[h*vc+v].neighbor_nodes.end(); ++it){
-        draw_vertex_color(grid->left+(*it)->x*grid->cellwidth,grid->top+(*it)->y*grid->cellheight,0x0000FF,(mode==0?0.5:1.0));
-        draw_vertex_color(grid->left+((*it)->x+1)*grid->cellwidth,grid->top+(*it)->y*grid->cellheight,0x0000FF,(mode==0?0.5:1.0));
-        draw_vertex_color(grid->left+((*it)->x+1)*grid->cellwidth,grid->top+((*it)->y+1)*grid->cellheight,0x0000FF,(mode==0?0.5:1.0));
-        draw_vertex_color(grid->left+(*it)->x*grid->cellwidth,grid->top+((*it)->y+1)*grid->cellheight,0x0000FF,(mode==0?0.5:1.0));
+    const enigma::node &center = grid->nodearray[h*vc+v];
+    for (unsigned d = 0; d < 8; d++){
+        if (!(center.neighbours & (1 << d))) continue;
+        const enigma::node *it = &grid->nodearray[h*vc+v+grid->neighbour_offset[d]];
+        draw_vertex_color(grid->left+it->x*grid->cellwidth,grid->top+it->y*grid->cellheight,0x0000FF,(mode==0?0.5:1.0));
+        draw_vertex_color(grid->left+(it->x+1)*grid->cellwidth,grid->top+it->y*grid->cellheight,0x0000FF,(mode==0?0.5:1.0));
+        draw_vertex_color(grid->left+(it->x+1)*grid->cellwidth,grid->top+(it->y+1)*grid->cellheight,0x0000FF,(mode==0?0.5:1.0));
+        draw_vertex_color(grid->left+it->x*grid->cellwidth,grid->top+(it->y+1)*grid->cellheight,0x0000FF,(mode==0?0.5:1.0));
     }
     draw_primitive_end();
     if (mode==1){
         int tc = draw_get_color();
         draw_set_color_rgba(255,255,255,1);
-        for (vector<enigma::node*>::iterator it = enigma::gridstructarray[id]->nodearray[h*vc+v].neighbor_nodes.begin(); it!=enigma::gridstructarray[id]->nodearray[h*vc+v].neighbor_nodes.end(); ++it){
-            draw_text(((*it)->x+0.5)*grid->cellwidth,((*it)->y+0.5)*grid->cellheight,(*it)->x*grid->vcells+(*it)->y);
+        for (unsigned d = 0; d < 8; d++){
+            if (!(center.neighbours & (1 << d))) continue;
+            const enigma::node *it = &grid->nodearray[h*vc+v+grid->neighbour_offset[d]];
+            draw_text((it->x+0.5)*grid->cellwidth,(it->y+0.5)*grid->cellheight,it->x*grid->vcells+it->y);
         }
         draw_set_color(tc);
     }
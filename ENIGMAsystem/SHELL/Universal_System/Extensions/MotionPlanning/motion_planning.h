@@ -45,5 +45,8 @@ void mp_grid_set_threshold(unsigned id, unsigned threshold = 1);
 void mp_grid_reset_threshold(unsigned id);
 double mp_grid_get_speed_modifier(unsigned id);
 void mp_grid_set_speed_modifier(unsigned id, double value);
+bool mp_grid_get_jps(unsigned id);
+// Jump point search: much faster diagonal paths on grids where every passable cell costs the same.
+void mp_grid_set_jps(unsigned id, bool enable = true);
 }
 
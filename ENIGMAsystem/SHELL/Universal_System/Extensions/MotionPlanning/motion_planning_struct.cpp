@@ -27,67 +27,73 @@
 \********************************************************************************/
 
 #include <vector>
-#include <map>
-#include <list>
 #include "motion_planning_struct.h"
 #include <cmath>
 #include <algorithm>
 #include <cstdlib>
-//#include <iostream>
-using std::multimap;
-using std::pair;
-using std::list;
 
 namespace enigma
 {
 	grid** gridstructarray;
 	size_t grid_idmax=0;
+
+	// left, top, right, bottom, top-left, top-right, bottom-right, bottom-left
+	const int dir_x[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+	const int dir_y[8] = { 0, -1, 0, 1, -1, -1, 1, 1 };
+	const unsigned char diag_sides[4][2] = { {0, 1}, {2, 1}, {2, 3}, {0, 3} };
 }
 
 namespace enigma
 {
-    grid::grid(unsigned int idp,int leftp,int topp,unsigned int hcellsp,unsigned int vcellsp,unsigned int cellwidthp,unsigned int cellheightp,unsigned thresholdp,double speed_modifierp):
-        id(idp), left(leftp), top(topp), hcells(hcellsp), vcells(vcellsp), cellwidth(cellwidthp), cellheight(cellheightp), threshold(thresholdp), speed_modifier(speed_modifierp), nodearray()
+    grid_cells::grid_cells(unsigned int hcellsp, unsigned int vcellsp, unsigned int thresholdp):
+        hcells(hcellsp), vcells(vcellsp), threshold(thresholdp), nodearray()
     {
-        gridstructarray[id] = this;
-        gridstructarray[id]->nodearray.reserve(hcells*vcells);
-        for (unsigned int i = 0; i < hcells*vcells; i++)
-        {
-            node nnode(floor(i / vcells),i % vcells,0,0,0,1);
-            gridstructarray[id]->nodearray.push_back(nnode);
-        }
+        build_topology();
+    }
 
-        grid *gr = gridstructarray[id];
+    void grid_cells::build_topology()
+    {
+        if (nodearray.size() != hcells*vcells)
+            nodearray.assign(hcells*vcells, node(0,0,1));
+        for (unsigned d = 0; d < 8; d++)
+            neighbour_offset[d] = dir_x[d]*int(vcells) + dir_y[d];
 
         for (unsigned int i = 0; i < hcells; i++){
             for (unsigned int c = 0; c < vcells; c++){
-            if (i>0){
-                gr->nodearray[i*vcells+c].neighbor_nodes.push_back(&gr->nodearray[(i-1)*vcells+c]); //left
-                if (c>0)
-                    gr->nodearray[i*vcells+c].neighbor_nodes.push_back(&gr->nodearray[(i-1)*vcells+c-1]); //top-left
-                if (c<vcells-1)
-                    gr->nodearray[i*vcells+c].neighbor_nodes.push_back(&gr->nodearray[(i-1)*vcells+c+1]); //bottom-left
-            }
-            if (c>0)
-                gr->nodearray[i*vcells+c].neighbor_nodes.push_back(&gr->nodearray[i*vcells+c-1]); //top
-            if (i<hcells-1){
-                gr->nodearray[i*vcells+c].neighbor_nodes.push_back(&gr->nodearray[(i+1)*vcells+c]); //right
-                if (c>0)
-                    gr->nodearray[i*vcells+c].neighbor_nodes.push_back(&gr->nodearray[(i+1)*vcells+c-1]); //top-right
-                if (c<vcells-1)
-                    gr->nodearray[i*vcells+c].neighbor_nodes.push_back(&gr->nodearray[(i+1)*vcells+c+1]); //bottom-bottom
-            }
-            if (c<vcells-1)
-                gr->nodearray[i*vcells+c].neighbor_nodes.push_back(&gr->nodearray[i*vcells+c+1]); //bottom
-
+                node &n = nodearray[i*vcells+c];
+                n.x = i, n.y = c, n.neighbours = 0;
+                for (unsigned d = 0; d < 8; d++)
+                    if (int(i)+dir_x[d] >= 0 && int(i)+dir_x[d] < int(hcells) && int(c)+dir_y[d] >= 0 && int(c)+dir_y[d] < int(vcells))
+                        n.neighbours |= 1 << d;
             }
         }
+    }
+
+    grid::grid(unsigned int idp,int leftp,int topp,unsigned int hcellsp,unsigned int vcellsp,unsigned int cellwidthp,unsigned int cellheightp,unsigned thresholdp,double speed_modifierp):
+        grid_cells(hcellsp, vcellsp, thresholdp), id(idp), left(leftp), top(topp), cellwidth(cellwidthp), cellheight(cellheightp), speed_modifier(speed_modifierp), jps(false)
+    {
+        gridstructarray[id] = this;
 
         if (enigma::grid_idmax < id+1)
           enigma::grid_idmax = id+1;
     }
     grid::~grid() { gridstructarray[id] = NULL; }
 
+    std::shared_ptr<const grid_cells> grid::cells_snapshot()
+    {
+        if (!snapshot)
+            snapshot = std::make_shared<const grid_cells>(*this);
+        return snapshot;
+    }
+
+    bool grid::cell_at(double x, double y, unsigned &cell) const
+    {
+        const int h = floor((x-left)/int(cellwidth)), v = floor((y-top)/int(cellheight));
+        if (h<0 || h>int(hcells)-1 || v<0 || v>int(vcells)-1) return false;
+        cell = h*vcells+v;
+        return true;
+    }
+
     void gridstructarray_reallocate()
     {
         enigma::grid** gridold = gridstructarray;
@@ -97,137 +103,311 @@ namespace enigma
     }
 
     //Helper functions
-    static inline unsigned find_heuristic(const node* n0, const node* n1, bool allow_diag) //Distance from n0 to n1
+    static inline unsigned find_heuristic(const node &n0, const node &n1, bool allow_diag) //Distance from n0 to n1
     {
         if (!allow_diag){
-            return fabs((int)n0->x-(int)n1->x) + fabs((int)n0->y-(int)n1->y);
+            return fabs((int)n0.x-(int)n1.x) + fabs((int)n0.y-(int)n1.y);
         } else {
-            return fmax(fabs((int)n0->x-(int)n1->x) , fabs((int)n0->y-(int)n1->y));
+            return fmax(fabs((int)n0.x-(int)n1.x) , fabs((int)n0.y-(int)n1.y));
+        }
+    }
+
+    // Every cell costs at least 1 and a diagonal step at least 2, so the
+    // Manhattan distance never overestimates, with or without diagonals.
+    static inline unsigned search_heuristic(const node &n0, const node &n1)
+    {
+        return std::abs((int)n0.x-(int)n1.x) + std::abs((int)n0.y-(int)n1.y);
+    }
+
+    static inline unsigned step_cost(unsigned cost, bool diagonal) //Diagonal steps cost ceil(cost/2.5) extra
+    {
+        return diagonal ? cost + unsigned((2ull*cost + 4)/5) : cost;
+    }
+
+    static inline int sign(int x) { return (x > 0) - (x < 0); }
+
+    void path_search::begin(const grid_cells &gr)
+    {
+        if (nodes.size() != gr.nodearray.size()) {
+            nodes.assign(gr.nodearray.size(), search_node());
+            generation = 0;
+        }
+        if (++generation == 0) { //wrapped around, so old stamps could look current
+            for (search_node &n : nodes) n.generation = 0;
+            generation = 1;
         }
+        heap.clear();
     }
 
-    static inline int find_priority(multimap<unsigned,node*> &m, node* value){
-        multimap<unsigned,node*>::iterator it;
-        for (it = m.begin(); it != m.end(); it++)
-            if (it->second == value) return (int)it->first;
-        return -1;
+    void path_search::sift_up(unsigned pos)
+    {
+        const unsigned n = heap[pos];
+        while (pos > 0) {
+            const unsigned parent = (pos - 1) / 2;
+            if (!less(n, heap[parent])) break;
+            heap[pos] = heap[parent];
+            nodes[heap[pos]].heap_index = pos;
+            pos = parent;
+        }
+        heap[pos] = n;
+        nodes[n].heap_index = pos;
+    }
+
+    void path_search::sift_down(unsigned pos)
+    {
+        const unsigned n = heap[pos], size = heap.size();
+        for (;;) {
+            unsigned child = 2*pos + 1;
+            if (child >= size) break;
+            if (child + 1 < size && less(heap[child + 1], heap[child])) child++;
+            if (!less(heap[child], n)) break;
+            heap[pos] = heap[child];
+            nodes[heap[pos]].heap_index = pos;
+            pos = child;
+        }
+        heap[pos] = n;
+        nodes[n].heap_index = pos;
+    }
+
+    void path_search::push(unsigned n)
+    {
+        heap.push_back(n);
+        sift_up(heap.size() - 1);
+    }
+
+    unsigned path_search::pop()
+    {
+        const unsigned top = heap[0];
+        heap[0] = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) sift_down(0);
+        nodes[top].heap_index = CLOSED;
+        return top;
     }
 
-    static inline bool check_corners(unsigned id, node* n0, node* n1) //There must be a better way to do this
+    void path_search::relax(unsigned from, unsigned to, unsigned g, unsigned h)
     {
-        for (vector<enigma::node*>::iterator it0 = n0->neighbor_nodes.begin(); it0!=n0->neighbor_nodes.end(); ++it0)
+        search_node &sn = nodes[to];
+        if (sn.generation != generation) { //first time this search reaches the node
+            sn.generation = generation;
+            sn.g = g;
+            sn.f = g + h;
+            sn.came_from = from;
+            push(to);
+        } else if (sn.heap_index != CLOSED && g < sn.g) { //already open, but this is a better path
+            sn.f -= sn.g - g;
+            sn.g = g;
+            sn.came_from = from;
+            sift_up(sn.heap_index);
+        }
+    }
+
+    bool path_search::astar(const grid_cells &gr, unsigned start, unsigned goal, bool allow_diag, unsigned &end)
+    {
+        const node &destination = gr.nodearray[goal];
+        nodes[start].generation = generation;
+        nodes[start].g = 0;
+        nodes[start].f = search_heuristic(gr.nodearray[start], destination);
+        nodes[start].came_from = start;
+        push(start);
+
+        //if the destination can't be reached, the path goes to the closest cell that can
+        end = start;
+        unsigned nearest_h = find_heuristic(gr.nodearray[start], destination, allow_diag);
+
+        const unsigned directions = allow_diag ? 8 : 4;
+        while (!heap.empty())
         {
-            for (vector<enigma::node*>::iterator it1 = n1->neighbor_nodes.begin(); it1!=n1->neighbor_nodes.end(); ++it1)
-            {
-                if ((*it0)==(*it1) && (*it0)->cost >= gridstructarray[id]->threshold)
+            const unsigned current = pop();
+            if (current == goal) {
+                end = goal;
                 return true;
             }
+            const node &cn = gr.nodearray[current];
+            const unsigned h = find_heuristic(cn, destination, allow_diag);
+            if (h <= nearest_h) end = current, nearest_h = h;
+
+            const unsigned g = nodes[current].g;
+            for (unsigned d = 0; d < directions; d++)
+            {
+                if (!(cn.neighbours & (1 << d))) continue;
+                const unsigned next = current + gr.neighbour_offset[d];
+                if (!gr.passable(next)) continue;
+                //don't cut corners around impassable cells
+                if (d >= 4 && (!gr.passable(current + gr.neighbour_offset[diag_sides[d-4][0]]) || !gr.passable(current + gr.neighbour_offset[diag_sides[d-4][1]])))
+                    continue;
+                relax(current, next, g + step_cost(gr.nodearray[next].cost, d >= 4), search_heuristic(gr.nodearray[next], destination));
+            }
         }
         return false;
     }
 
-    multimap<unsigned,node*> find_path(unsigned id, node* n0, node* n1, bool allow_diag, bool &status)
+    // Walks from (x, y) in direction (dx, dy) until reaching the goal or a cell
+    // that has a neighbour only reachable optimally through it. Diagonal moves
+    // never cut corners, matching astar.
+    static bool jump(const grid_cells &gr, int x, int y, int dx, int dy, int gx, int gy, int &jx, int &jy)
     {
-        node* current;
-        for (unsigned int i = 0; i < gridstructarray[id]->hcells*gridstructarray[id]->vcells; i++)
-        {
-            gridstructarray[id]->nodearray[i].F=0;
-            gridstructarray[id]->nodearray[i].G=0;
-            gridstructarray[id]->nodearray[i].H=0;
-            gridstructarray[id]->nodearray[i].came_from=NULL;
+        int ix, iy;
+        for (;;) {
+            x += dx, y += dy;
+            if (!gr.passable(x, y)) return false;
+            if (x == gx && y == gy) break;
+            if (dx && dy) {
+                if (jump(gr, x, y, dx, 0, gx, gy, ix, iy) || jump(gr, x, y, 0, dy, gx, gy, ix, iy)) break;
+                if (!gr.passable(x + dx, y) || !gr.passable(x, y + dy)) return false;
+            } else if (dx) {
+                if ((gr.passable(x, y - 1) && !gr.passable(x - dx, y - 1)) || (gr.passable(x, y + 1) && !gr.passable(x - dx, y + 1))) break;
+            } else {
+                if ((gr.passable(x - 1, y) && !gr.passable(x - 1, y - dy)) || (gr.passable(x + 1, y) && !gr.passable(x + 1, y - dy))) break;
+            }
         }
+        jx = x, jy = y;
+        return true;
+    }
 
-        node* start = n0;
-        node* destination = n1;
-        multimap<unsigned,node*> OPEN;
-        list<node*> CLOSED;
-        multimap<unsigned,node*> mm_ret;
-
-        if (start == destination)
-            return mm_ret;
-        start->H = find_heuristic(start,destination,allow_diag);
-        start->F = start->H;
-        OPEN.insert(pair<unsigned,node*>(start->F,start));
+    bool path_search::jump_point_search(const grid_cells &gr, unsigned start, unsigned goal)
+    {
+        const node &destination = gr.nodearray[goal];
+        const int gx = destination.x, gy = destination.y;
+        nodes[start].generation = generation;
+        nodes[start].g = 0;
+        nodes[start].f = search_heuristic(gr.nodearray[start], destination);
+        nodes[start].came_from = start;
+        push(start);
 
-        while (find(CLOSED.begin(), CLOSED.end(), destination) == CLOSED.end() && !OPEN.empty())
-        //loop until destination is in the closed list or the open multimap is empty
+        while (!heap.empty())
         {
-            //this is basically ds_priority_delete_min
-            {
-              multimap<unsigned,node*>::iterator it = OPEN.begin(), it_check;
-              it_check = it++;
-              while (it != OPEN.end())
-              {
-                  if ((*it).first < (*it_check).first) {it_check = it;}
-                  it++;
-              }
-              current = (*it_check).second;
-              OPEN.erase(it_check);
+            const unsigned current = pop();
+            if (current == goal) return true;
+            const node &cn = gr.nodearray[current];
+            const int x = cn.x, y = cn.y;
+
+            //only follow the directions a path through this jump point can continue in
+            int dirs[8][2], count = 0;
+            if (current == start) {
+                for (unsigned d = 0; d < 8; d++)
+                    dirs[count][0] = dir_x[d], dirs[count++][1] = dir_y[d];
+            } else {
+                const node &pn = gr.nodearray[nodes[current].came_from];
+                const int dx = sign(x - (int)pn.x), dy = sign(y - (int)pn.y);
+                if (dx && dy) {
+                    const bool along_x = gr.passable(x + dx, y), along_y = gr.passable(x, y + dy);
+                    if (along_y) dirs[count][0] = 0, dirs[count++][1] = dy;
+                    if (along_x) dirs[count][0] = dx, dirs[count++][1] = 0;
+                    if (along_x && along_y) dirs[count][0] = dx, dirs[count++][1] = dy;
+                } else {
+                    //(ax, ay) points along the travel direction, (sx, sy) to one side
+                    const int ax = dx, ay = dy, sx = dy, sy = dx;
+                    const bool ahead = gr.passable(x + ax, y + ay), side0 = gr.passable(x + sx, y + sy), side1 = gr.passable(x - sx, y - sy);
+                    if (ahead) {
+                        dirs[count][0] = ax, dirs[count++][1] = ay;
+                        if (side0) dirs[count][0] = ax + sx, dirs[count++][1] = ay + sy;
+                        if (side1) dirs[count][0] = ax - sx, dirs[count++][1] = ay - sy;
+                    }
+                    if (side0) dirs[count][0] = sx, dirs[count++][1] = sy;
+                    if (side1) dirs[count][0] = -sx, dirs[count++][1] = -sy;
+                }
             }
 
-            CLOSED.push_front(current);
-            for (vector<enigma::node*>::iterator it = current->neighbor_nodes.begin(); it!=current->neighbor_nodes.end(); ++it)
-            { //go trough all the neighbors (should be faster then 8 if cycles like in the init)
-                if (!allow_diag && (*it)->x != current->x && (*it)->y != current->y)
-                    continue;
+            const unsigned g = nodes[current].g;
+            for (int i = 0; i < count; i++)
+            {
+                const int dx = dirs[i][0], dy = dirs[i][1];
+                if (dx && dy && (!gr.passable(x + dx, y) || !gr.passable(x, y + dy))) continue;
+                int jx, jy;
+                if (!jump(gr, x, y, dx, dy, gx, gy, jx, jy)) continue;
 
-                bool cutting = false;
-                if (allow_diag == true  && (*it)->x != current->x && (*it)->y != current->y)
-                        cutting = check_corners(id, current, (*it));
-
-                if (find(CLOSED.begin(), CLOSED.end(), (*it)) == CLOSED.end() && (*it)->cost<gridstructarray[id]->threshold && cutting == false){
-                    if (find_priority(OPEN,(*it)) == -1){ //if the node isn't on the open list
-                        (*it)->came_from = current;
-                        (*it)->G = current->G + (*it)->cost;
-                        if ((*it)->x != current->x && (*it)->y != current->y)
-                            (*it)->G += ceil((*it)->cost/2.5); //if it is diagonal increase the move cost
-                        (*it)->H = find_heuristic(*it,destination,allow_diag);
-                        (*it)->F = (*it)->G + (*it)->H;
-                        OPEN.insert(pair<unsigned,node*>((*it)->F,(*it)));
-
-                    }else{ //if the node is already on the open list we just have to see if it is a better path
-                        unsigned temp_G = current->G + (*it)->cost;
-                        if (temp_G < (*it)->G) {
-                            (*it)->came_from = current;
-                            (*it)->G = current->G + (*it)->cost;
-                            if ((*it)->x != current->x && (*it)->y != current->y)
-                                (*it)->G += ceil((*it)->cost/2.5);
-                            (*it)->H = find_heuristic(*it,destination,allow_diag);
-                            (*it)->F = (*it)->G + (*it)->H;
-                        }
-                    }
+                //cost of every cell the jump passes over
+                unsigned jg = g;
+                for (int cx = x + dx, cy = y + dy; ; cx += dx, cy += dy) {
+                    jg += step_cost(gr.nodearray[cx*gr.vcells + cy].cost, dx && dy);
+                    if (cx == jx && cy == jy) break;
                 }
+                relax(current, jx*gr.vcells + jy, jg, search_heuristic(gr.nodearray[jx*gr.vcells + jy], destination));
             }
         }
-        node *last, *nearest;
-        unsigned i = 0;
-        status = true;
-        if (find(CLOSED.begin(), CLOSED.end(), destination) == CLOSED.end())
-        {   //this is for if the destionation can't be found if
-            status = false;
-            nearest = start;
-
-            list<node*>::iterator it;
-            for (it=CLOSED.begin(); it != CLOSED.end(); it++){
-                (*it)->H = find_heuristic(*it,destination,allow_diag);
-                if ((*it)->H < nearest->H)
-                    nearest = *it;
+        return false;
+    }
+
+    bool path_search::find(const grid_cells &gr, unsigned start, unsigned goal, bool allow_diag, bool jps, vector<unsigned> &path)
+    {
+        path.clear();
+        if (start == goal)
+            return true;
+
+        unsigned end = goal;
+        bool found = false;
+        if (jps && allow_diag) {
+            begin(gr);
+            found = jump_point_search(gr, start, goal);
+        }
+        if (!found) { //jump points are too sparse to pick the closest reachable cell from, so fall back to astar
+            begin(gr);
+            found = astar(gr, start, goal, allow_diag, end);
+        }
+
+        //walk back from the end, filling in the cells each jump skipped over
+        for (unsigned n = end; n != start; )
+        {
+            const unsigned from = nodes[n].came_from;
+            if (n != end) path.push_back(n);
+            const node &a = gr.nodearray[n], &b = gr.nodearray[from];
+            const int dx = sign((int)b.x - (int)a.x), dy = sign((int)b.y - (int)a.y);
+            for (int x = a.x + dx, y = a.y + dy; x != (int)b.x || y != (int)b.y; x += dx, y += dy)
+                path.push_back(x*gr.vcells + y);
+            n = from;
+        }
+        std::reverse(path.begin(), path.end());
+        return found;
+    }
+
+    void path_search::flood(const grid_cells &gr, unsigned goal, bool allow_diag, vector<unsigned> &distance, vector<unsigned char> &step)
+    {
+        begin(gr);
+        nodes[goal].generation = generation;
+        nodes[goal].g = nodes[goal].f = 0;
+        nodes[goal].came_from = goal;
+        if (gr.passable(goal)) //nothing can path into an impassable goal
+            push(goal);
+
+        //search backwards from the goal; stepping from p into c costs what entering c does
+        const unsigned directions = allow_diag ? 8 : 4;
+        while (!heap.empty())
+        {
+            const unsigned current = pop();
+            const node &cn = gr.nodearray[current];
+            const unsigned g = nodes[current].g + step_cost(cn.cost, false), gd = nodes[current].g + step_cost(cn.cost, true);
+            for (unsigned d = 0; d < directions; d++)
+            {
+                if (!(cn.neighbours & (1 << d))) continue;
+                const unsigned prev = current + gr.neighbour_offset[d];
+                if (!gr.passable(prev)) continue;
+                if (d >= 4 && (!gr.passable(current + gr.neighbour_offset[diag_sides[d-4][0]]) || !gr.passable(current + gr.neighbour_offset[diag_sides[d-4][1]])))
+                    continue;
+                relax(current, prev, d >= 4 ? gd : g, 0);
             }
-            destination = nearest;
-            if (start == destination)
-                return mm_ret;
         }
 
-        //mm_ret.insert(pair<unsigned,node*>(i,destination));
-        last = destination;
-        while (last->came_from != start){
-            i += 1;
-            mm_ret.insert(pair<unsigned,node*>(i,last->came_from));
-            last = last->came_from;
+        //direction d from (x, y) leads to (x+dir_x[d], y+dir_y[d]); index by (dx+1)*3 + dy+1
+        static const unsigned char direction_of[9] = { 4, 0, 7, 1, NO_STEP, 3, 5, 2, 6 };
+        distance.resize(nodes.size());
+        step.resize(nodes.size());
+        for (unsigned n = 0; n < nodes.size(); n++)
+        {
+            if (nodes[n].generation != generation) {
+                distance[n] = UNREACHABLE;
+                step[n] = NO_STEP;
+                continue;
+            }
+            distance[n] = nodes[n].g;
+            const node &a = gr.nodearray[n], &b = gr.nodearray[nodes[n].came_from];
+            step[n] = direction_of[((int)b.x - (int)a.x + 1)*3 + (int)b.y - (int)a.y + 1];
         }
+    }
 
-        //delete CLOSED;
-        //delete OPEN;
-        return mm_ret; //return the multimap containing a list of all the nodes that are in the path.
+    bool find_path(unsigned id, unsigned n0, unsigned n1, bool allow_diag, vector<unsigned> &path)
+    {
+        grid *gr = gridstructarray[id];
+        return gr->search.find(*gr, n0, n1, allow_diag, gr->jps, path);
     }
 }
@@ -39,35 +39,101 @@
 #endif
 
 #include <vector>
-#include <map>
+#include <memory>
 #include <cstddef>
 
 
 using std::vector;
-using std::multimap;
 
 namespace enigma
 {
   struct node
   {
-    unsigned x, y, F, H, G, cost;
-    node* came_from;
-    vector<node*> neighbor_nodes;
-    node(unsigned X = 0, unsigned Y = 0, unsigned f = 0, unsigned h = 0, unsigned g = 0, unsigned Cost = 0, node* CameFrom = NULL):
-      x(X), y(Y), F(f), H(h), G(g), cost(Cost), came_from(CameFrom) {}
+    unsigned x, y, cost;
+    unsigned char neighbours; // Bit d is set when the cell in direction d is inside the grid.
+    node(unsigned X = 0, unsigned Y = 0, unsigned Cost = 0): x(X), y(Y), cost(Cost), neighbours(0) {}
   };
-  struct grid
+
+  // Directions 0-3 are orthogonal, 4-7 diagonal; diagonal d sits between orthogonals diag_sides[d-4][0] and [1].
+  extern const int dir_x[8], dir_y[8];
+  extern const unsigned char diag_sides[4][2];
+
+  // The part of a grid a path search reads: dimensions, costs and topology.
+  // Worker threads search copies of this while the game keeps editing the grid.
+  struct grid_cells
+  {
+    unsigned int hcells, vcells;
+    unsigned threshold;
+    vector<node> nodearray;
+    int neighbour_offset[8]; // Index delta to the neighbour in each direction.
+    grid_cells(unsigned int hcells, unsigned int vcells, unsigned int threshold);
+    // Rebuilds nodearray for the current dimensions, keeping costs when the cell count is unchanged.
+    void build_topology();
+    bool passable(unsigned n) const { return nodearray[n].cost < threshold; }
+    bool passable(int x, int y) const { return x >= 0 && y >= 0 && unsigned(x) < hcells && unsigned(y) < vcells && passable(x*vcells + y); }
+  };
+
+  // Scratch state for one search at a time. Per-node state is tagged with the
+  // generation of the search that wrote it, so a new search starts by bumping
+  // the generation instead of clearing the whole grid.
+  struct path_search
+  {
+    struct search_node
+    {
+      unsigned generation;
+      unsigned g, f;
+      unsigned came_from;
+      unsigned heap_index; // Position in heap, or CLOSED.
+    };
+    static const unsigned CLOSED = ~0u;
+
+    vector<search_node> nodes;
+    vector<unsigned> heap; // Binary min-heap of node indices ordered by f, then by larger g.
+    unsigned generation;
+
+    path_search(): generation(0) {}
+    // Writes the cells strictly between start and goal into path. When the goal can't be reached, the path leads
+    // toward the closest cell that can and false is returned.
+    bool find(const grid_cells &gr, unsigned start, unsigned goal, bool allow_diag, bool jps, vector<unsigned> &path);
+    // Computes every cell's path cost to goal, and the direction of its first step there (NO_STEP if none).
+    void flood(const grid_cells &gr, unsigned goal, bool allow_diag, vector<unsigned> &distance, vector<unsigned char> &step);
+    static const unsigned UNREACHABLE = ~0u;
+    static const unsigned char NO_STEP = 0xFF;
+
+   private:
+    void begin(const grid_cells &gr);
+    bool less(unsigned a, unsigned b) const { return nodes[a].f < nodes[b].f || (nodes[a].f == nodes[b].f && nodes[a].g > nodes[b].g); }
+    void push(unsigned n);
+    unsigned pop();
+    void sift_up(unsigned pos);
+    void sift_down(unsigned pos);
+    void relax(unsigned from, unsigned to, unsigned g, unsigned h);
+    bool astar(const grid_cells &gr, unsigned start, unsigned goal, bool allow_diag, unsigned &end);
+    bool jump_point_search(const grid_cells &gr, unsigned start, unsigned goal);
+  };
+
+  struct grid: grid_cells
   {
     unsigned int id;
     int left, top;
-    unsigned int hcells, vcells, cellwidth, cellheight;
-    unsigned threshold;
+    unsigned int cellwidth, cellheight;
     double speed_modifier;
-    vector<node> nodearray;
+    bool jps; // Use jump point search for diagonal paths; assumes every passable cell has the same cost.
+    path_search search;
     grid(unsigned int id,int left,int top,unsigned int hcells,unsigned int vcells,unsigned int cellwidth,unsigned int cellheight, unsigned int threshold, double speed_modifier);
     ~grid();
+    // Copy of the cells for searching off the main thread, shared until the grid is next edited.
+    std::shared_ptr<const grid_cells> cells_snapshot();
+    void changed() { snapshot.reset(); }
+    // Finds the cell containing room position (x, y); false when it is outside the grid.
+    bool cell_at(double x, double y, unsigned &cell) const;
+   private:
+    std::shared_ptr<const grid_cells> snapshot;
   };
   extern grid** gridstructarray;
   void gridstructarray_reallocate();
-  multimap<unsigned,node*> find_path(unsigned id, node* n0, node* n1, bool allow_diag, bool &status);
+  bool find_path(unsigned id, unsigned n0, unsigned n1, bool allow_diag, vector<unsigned> &path);
+  // Turns the cells found by a search into a path resource, the way mp_grid_path always has.
+  void grid_route_to_path(unsigned pathid, const grid_cells &cells, int left, int top, unsigned cellwidth, unsigned cellheight, double speed_modifier,
+      double xstart, double ystart, unsigned start, double xgoal, double ygoal, unsigned goal, const vector<unsigned> &route, bool status);
 }
@@ -0,0 +1,152 @@
+/********************************************************************************\
+**                                                                              **
+**  Copyright (C) 2026 enigma-dev contributors                                  **
+**                                                                              **
+**  This file is a part of the ENIGMA Development Environment.                  **
+**                                                                              **
+**                                                                              **
+**  ENIGMA is free software: you can redistribute it and/or modify it under the **
+**  terms of the GNU General Public License as published by the Free Software   **
+**  Foundation, version 3 of the license or any later version.                  **
+**                                                                              **
+**  This application and its source code is distributed AS-IS, WITHOUT ANY      **
+**  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS   **
+**  FOR A PARTICULAR PURPOSE. See the GNU General Public License for more       **
+**  details.                                                                    **
+**                                                                              **
+**  You should have recieved a copy of the GNU General Public License along     **
+**  with this code. If not, see <http://www.gnu.org/licenses/>                  **
+**                                                                              **
+**  ENIGMA is an environment designed to create games and other programs with a **
+**  high-level, fully compilable language. Developers of ENIGMA or anything     **
+**  associated with ENIGMA are in no way responsible for its users or           **
+**  applications created by its users, or damages caused by the environment     **
+**  or programs made in the environment.                                        **
+**                                                                              **
+\********************************************************************************/
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "Universal_System/worker_pool.h"
+#include "../Paths/pathstruct.h"
+#include "motion_planning_struct.h"
+#include "mp_grid_async.h"
+
+namespace enigma
+{
+  namespace {
+    struct path_request
+    {
+      std::shared_ptr<const grid_cells> cells;
+      int left, top;
+      unsigned cellwidth, cellheight;
+      double speed_modifier;
+      double xstart, ystart, xgoal, ygoal;
+      unsigned start, goal;
+      bool allow_diag, jps;
+      vector<unsigned> route;
+      bool status = false;
+      bool done = false; // Guarded by path_mtx.
+      std::atomic<bool> cancelled{false};
+    };
+
+    // Requests are solved as tasks on the shared worker pool, each thread with
+    // its own search scratch. The game waits on a request's done flag with these.
+    std::mutex path_mtx;
+    std::condition_variable path_finished;
+
+    void solve(const std::shared_ptr<path_request>& req)
+    {
+      static thread_local path_search search;
+      if (!req->cancelled)
+        req->status = search.find(*req->cells, req->start, req->goal, req->allow_diag, req->jps, req->route);
+      {
+        std::lock_guard<std::mutex> lock(path_mtx);
+        req->done = true;
+      }
+      path_finished.notify_all();
+    }
+
+    bool request_ready(const path_request& req)
+    {
+      std::lock_guard<std::mutex> lock(path_mtx);
+      return req.done;
+    }
+
+    void request_wait(const path_request& req)
+    {
+      std::unique_lock<std::mutex> lock(path_mtx);
+      path_finished.wait(lock, [&req] { return req.done; });
+    }
+
+    std::map<int, std::shared_ptr<path_request>> path_requests;
+    int path_request_next = 0;
+
+    std::shared_ptr<path_request> find_request(int request)
+    {
+      std::map<int, std::shared_ptr<path_request>>::iterator it = path_requests.find(request);
+      return it == path_requests.end() ? nullptr : it->second;
+    }
+  }
+}
+
+namespace enigma_user
+{
+
+int mp_grid_path_request(unsigned id, double xstart, double ystart, double xgoal, double ygoal, bool allowdiag)
+{
+    enigma::grid *gr = enigma::gridstructarray[id];
+    unsigned start, goal;
+    if (!gr->cell_at(xstart, ystart, start) || !gr->cell_at(xgoal, ygoal, goal)) return -1;
+
+    std::shared_ptr<enigma::path_request> req = std::make_shared<enigma::path_request>();
+    req->cells = gr->cells_snapshot();
+    req->left = gr->left, req->top = gr->top;
+    req->cellwidth = gr->cellwidth, req->cellheight = gr->cellheight;
+    req->speed_modifier = gr->speed_modifier;
+    req->xstart = xstart, req->ystart = ystart, req->xgoal = xgoal, req->ygoal = ygoal;
+    req->start = start, req->goal = goal;
+    req->allow_diag = allowdiag, req->jps = gr->jps;
+
+    const int request = enigma::path_request_next++;
+    enigma::path_requests[request] = req;
+    enigma::shared_workers().post([req] { enigma::solve(req); });
+    return request;
+}
+
+bool mp_grid_path_request_exists(int request)
+{
+    return enigma::path_requests.count(request) != 0;
+}
+
+bool mp_grid_path_request_ready(int request)
+{
+    std::shared_ptr<enigma::path_request> req = enigma::find_request(request);
+    return req && enigma::request_ready(*req);
+}
+
+bool mp_grid_path_request_get(int request, unsigned path)
+{
+    std::shared_ptr<enigma::path_request> req = enigma::find_request(request);
+    if (!req) return false;
+    enigma::request_wait(*req);
+    enigma::grid_route_to_path(path, *req->cells, req->left, req->top, req->cellwidth, req->cellheight, req->speed_modifier,
+        req->xstart, req->ystart, req->start, req->xgoal, req->ygoal, req->goal, req->route, req->status);
+    enigma::path_requests.erase(request);
+    return req->status;
+}
+
+void mp_grid_path_request_cancel(int request)
+{
+    std::shared_ptr<enigma::path_request> req = enigma::find_request(request);
+    if (!req) return;
+    req->cancelled = true;
+    enigma::path_requests.erase(request);
+}
+
+}
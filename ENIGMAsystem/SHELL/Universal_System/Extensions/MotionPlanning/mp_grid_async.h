@@ -0,0 +1,45 @@
+/********************************************************************************\
+**                                                                              **
+**  Copyright (C) 2026 enigma-dev contributors                                  **
+**                                                                              **
+**  This file is a part of the ENIGMA Development Environment.                  **
+**                                                                              **
+**                                                                              **
+**  ENIGMA is free software: you can redistribute it and/or modify it under the **
+**  terms of the GNU General Public License as published by the Free Software   **
+**  Foundation, version 3 of the license or any later version.                  **
+**                                                                              **
+**  This application and its source code is distributed AS-IS, WITHOUT ANY      **
+**  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS   **
+**  FOR A PARTICULAR PURPOSE. See the GNU General Public License for more       **
+**  details.                                                                    **
+**                                                                              **
+**  You should have recieved a copy of the GNU General Public License along     **
+**  with this code. If not, see <http://www.gnu.org/licenses/>                  **
+**                                                                              **
+**  ENIGMA is an environment designed to create games and other programs with a **
+**  high-level, fully compilable language. Developers of ENIGMA or anything     **
+**  associated with ENIGMA are in no way responsible for its users or           **
+**  applications created by its users, or damages caused by the environment     **
+**  or programs made in the environment.                                        **
+**                                                                              **
+\********************************************************************************/
+
+namespace enigma_user
+{
+
+// Queues a path search to run on a worker thread against the grid as it is now; later edits to the grid don't
+// affect it. Returns a request id, or -1 if either point is outside the grid.
+int mp_grid_path_request(unsigned id, double xstart, double ystart, double xgoal, double ygoal, bool allowdiag);
+// Whether the request is still outstanding, that is, it hasn't been got or cancelled yet.
+bool mp_grid_path_request_exists(int request);
+// Whether the request has finished and mp_grid_path_request_get will not wait.
+bool mp_grid_path_request_ready(int request);
+// Writes the result into path like mp_grid_path does, waiting for it if need be, and frees the request.
+// Returns whether the goal was reached, which mp_grid_path doesn't report (it returns true whenever both
+// points are on the grid); also false if there is no such request, which mp_grid_path_request_exists tells apart.
+bool mp_grid_path_request_get(int request, unsigned path);
+// Frees a request whose result is no longer wanted.
+void mp_grid_path_request_cancel(int request);
+
+}
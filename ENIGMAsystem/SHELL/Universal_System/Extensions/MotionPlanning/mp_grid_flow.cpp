@@ -0,0 +1,142 @@
+/********************************************************************************\
+**                                                                              **
+**  Copyright (C) 2026 enigma-dev contributors                                  **
+**                                                                              **
+**  This file is a part of the ENIGMA Development Environment.                  **
+**                                                                              **
+**                                                                              **
+**  ENIGMA is free software: you can redistribute it and/or modify it under the **
+**  terms of the GNU General Public License as published by the Free Software   **
+**  Foundation, version 3 of the license or any later version.                  **
+**                                                                              **
+**  This application and its source code is distributed AS-IS, WITHOUT ANY      **
+**  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS   **
+**  FOR A PARTICULAR PURPOSE. See the GNU General Public License for more       **
+**  details.                                                                    **
+**                                                                              **
+**  You should have recieved a copy of the GNU General Public License along     **
+**  with this code. If not, see <http://www.gnu.org/licenses/>                  **
+**                                                                              **
+**  ENIGMA is an environment designed to create games and other programs with a **
+**  high-level, fully compilable language. Developers of ENIGMA or anything     **
+**  associated with ENIGMA are in no way responsible for its users or           **
+**  applications created by its users, or damages caused by the environment     **
+**  or programs made in the environment.                                        **
+**                                                                              **
+\********************************************************************************/
+
+#include <vector>
+#include <cmath>
+
+#include "../Paths/pathstruct.h"
+#include "motion_planning_struct.h"
+#include "mp_grid_flow.h"
+
+namespace enigma
+{
+  namespace {
+    struct flow_field
+    {
+      unsigned grid;
+      double xgoal, ygoal;
+      bool allow_diag;
+      // The grid's placement when the field was computed, so sampling doesn't depend on the grid.
+      int left, top;
+      unsigned cellwidth, cellheight, hcells, vcells;
+      vector<unsigned> distance;
+      vector<unsigned char> step;
+    };
+
+    vector<flow_field*> flowfields;
+    path_search flow_search;
+
+    // Degrees for each of the eight directions, as point_direction would give them.
+    const double step_direction[8] = { 180, 90, 0, 270, 135, 45, 315, 225 };
+
+    bool flow_compute(flow_field &ff)
+    {
+      grid *gr = gridstructarray[ff.grid];
+      unsigned goal;
+      if (!gr || !gr->cell_at(ff.xgoal, ff.ygoal, goal)) return false;
+      ff.left = gr->left, ff.top = gr->top;
+      ff.cellwidth = gr->cellwidth, ff.cellheight = gr->cellheight;
+      ff.hcells = gr->hcells, ff.vcells = gr->vcells;
+      flow_search.flood(*gr, goal, ff.allow_diag, ff.distance, ff.step);
+      return true;
+    }
+
+    bool flow_cell(const flow_field &ff, double x, double y, unsigned &cell)
+    {
+      const int h = floor((x-ff.left)/int(ff.cellwidth)), v = floor((y-ff.top)/int(ff.cellheight));
+      if (h<0 || h>int(ff.hcells)-1 || v<0 || v>int(ff.vcells)-1) return false;
+      cell = h*ff.vcells+v;
+      return true;
+    }
+  }
+}
+
+namespace enigma_user
+{
+
+int mp_grid_flow_create(unsigned id, double xgoal, double ygoal, bool allowdiag)
+{
+    enigma::flow_field *ff = new enigma::flow_field();
+    ff->grid = id;
+    ff->xgoal = xgoal, ff->ygoal = ygoal;
+    ff->allow_diag = allowdiag;
+    if (!enigma::flow_compute(*ff)) {
+        delete ff;
+        return -1;
+    }
+    enigma::flowfields.push_back(ff);
+    return enigma::flowfields.size()-1;
+}
+
+bool mp_grid_flow_exists(int field)
+{
+    return field >= 0 && size_t(field) < enigma::flowfields.size() && enigma::flowfields[field];
+}
+
+void mp_grid_flow_destroy(int field)
+{
+    if (!mp_grid_flow_exists(field)) return;
+    delete enigma::flowfields[field];
+    enigma::flowfields[field] = NULL;
+}
+
+void mp_grid_flow_update(int field)
+{
+    if (!mp_grid_flow_exists(field)) return;
+    enigma::flow_compute(*enigma::flowfields[field]);
+}
+
+bool mp_grid_flow_set_goal(int field, double xgoal, double ygoal)
+{
+    if (!mp_grid_flow_exists(field)) return false;
+    enigma::flow_field *ff = enigma::flowfields[field];
+    const double xold = ff->xgoal, yold = ff->ygoal;
+    ff->xgoal = xgoal, ff->ygoal = ygoal;
+    if (enigma::flow_compute(*ff)) return true;
+    ff->xgoal = xold, ff->ygoal = yold;
+    return false;
+}
+
+double mp_grid_flow_get_direction(int field, double x, double y)
+{
+    if (!mp_grid_flow_exists(field)) return -1;
+    const enigma::flow_field *ff = enigma::flowfields[field];
+    unsigned cell;
+    if (!enigma::flow_cell(*ff, x, y, cell) || ff->step[cell] == enigma::path_search::NO_STEP) return -1;
+    return enigma::step_direction[ff->step[cell]];
+}
+
+double mp_grid_flow_get_distance(int field, double x, double y)
+{
+    if (!mp_grid_flow_exists(field)) return -1;
+    const enigma::flow_field *ff = enigma::flowfields[field];
+    unsigned cell;
+    if (!enigma::flow_cell(*ff, x, y, cell) || ff->distance[cell] == enigma::path_search::UNREACHABLE) return -1;
+    return ff->distance[cell];
+}
+
+}
@@ -0,0 +1,46 @@
+/********************************************************************************\
+**                                                                              **
+**  Copyright (C) 2026 enigma-dev contributors                                  **
+**                                                                              **
+**  This file is a part of the ENIGMA Development Environment.                  **
+**                                                                              **
+**                                                                              **
+**  ENIGMA is free software: you can redistribute it and/or modify it under the **
+**  terms of the GNU General Public License as published by the Free Software   **
+**  Foundation, version 3 of the license or any later version.                  **
+**                                                                              **
+**  This application and its source code is distributed AS-IS, WITHOUT ANY      **
+**  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS   **
+**  FOR A PARTICULAR PURPOSE. See the GNU General Public License for more       **
+**  details.                                                                    **
+**                                                                              **
+**  You should have recieved a copy of the GNU General Public License along     **
+**  with this code. If not, see <http://www.gnu.org/licenses/>                  **
+**                                                                              **
+**  ENIGMA is an environment designed to create games and other programs with a **
+**  high-level, fully compilable language. Developers of ENIGMA or anything     **
+**  associated with ENIGMA are in no way responsible for its users or           **
+**  applications created by its users, or damages caused by the environment     **
+**  or programs made in the environment.                                        **
+**                                                                              **
+\********************************************************************************/
+
+namespace enigma_user
+{
+
+// A flow field stores, for every cell of a grid, the cost of the best path to one goal and the direction to take
+// first, so any number of instances can steer toward the goal with one lookup each.
+// Returns -1 if the goal is outside the grid.
+int mp_grid_flow_create(unsigned id, double xgoal, double ygoal, bool allowdiag);
+void mp_grid_flow_destroy(int field);
+bool mp_grid_flow_exists(int field);
+// Recomputes the field after the grid has been edited.
+void mp_grid_flow_update(int field);
+// Moves the goal and recomputes the field. Returns false if the goal is outside the grid.
+bool mp_grid_flow_set_goal(int field, double xgoal, double ygoal);
+// Direction to move in from (x, y), or -1 at the goal, outside the grid, or where the goal can't be reached.
+double mp_grid_flow_get_direction(int field, double x, double y);
+// Path cost from (x, y) to the goal, or -1 where the goal can't be reached.
+double mp_grid_flow_get_distance(int field, double x, double y);
+
+}
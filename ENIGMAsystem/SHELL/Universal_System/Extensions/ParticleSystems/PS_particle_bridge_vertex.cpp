@@ -0,0 +1,242 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+// Particle renderer shared by every graphics system. All quads of a system are
+// written into one persistent vertex buffer and drawn with a vertex_submit per
+// run of consecutive particles that share a texture and blend mode.
+
+#include "PS_particle_system.h"
+#include "PS_particle_instance.h"
+#include "PS_particle_sprites.h"
+
+#include "Graphics_Systems/General/GSvertex.h"
+#include "Graphics_Systems/General/GSvertex_impl.h"
+#include "Graphics_Systems/General/GSprimitives.h"
+#include "Graphics_Systems/General/GSblend.h"
+#include "Universal_System/Resources/sprites_internal.h"
+#include "Universal_System/Resources/sprites.h"
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace enigma {
+  namespace particle_bridge {
+    namespace {
+      int vertex_format = -1;
+      int vertex_buffer = -1;
+
+      // One vertex_submit_range call.
+      struct particle_batch {
+        int texture;
+        bool additive;
+        unsigned start, count;
+      };
+      std::vector<particle_batch> batches;
+
+      // Everything a quad needs from a sprite subimage.
+      struct sprite_frame {
+        int sprite = -1, subimg = -1;
+        int texture = -1;
+        gs_scalar tx, ty, tw, th;
+        gs_scalar xoffset, yoffset, width, height;
+      };
+
+      void ensure_vertex_buffer()
+      {
+        if (!enigma_user::vertex_format_exists(vertex_format)) {
+          enigma_user::vertex_format_begin();
+          enigma_user::vertex_format_add_position();
+          enigma_user::vertex_format_add_textcoord();
+          enigma_user::vertex_format_add_color();
+          vertex_format = enigma_user::vertex_format_end();
+        }
+        if (!enigma_user::vertex_exists(vertex_buffer))
+          vertex_buffer = enigma_user::vertex_create_buffer();
+      }
+    }
+
+    void initialize_particle_bridge()
+    {
+      ensure_vertex_buffer();
+    }
+
+    void draw_particles(particle_store& pi_list, bool oldtonew, double wiggle, int subimage_index,
+      double x_offset, double y_offset)
+    {
+      const size_t count = pi_list.count();
+      if (count == 0) return;
+
+      ensure_vertex_buffer();
+      enigma_user::vertex_begin(vertex_buffer, vertex_format);
+      std::vector<VertexElement>& verts = vertexBuffers[vertex_buffer]->vertices;
+      verts.reserve(count * 6 * 5);
+      batches.clear();
+
+      // Neighbouring particles nearly always share a type, a frame and a
+      // color, so each of those is only looked up again when it changes.
+      const particle_type* last_pt = NULL;
+      int type_sprite = -1, type_subimages = 0;
+      int pixel_sprite = -2;
+      sprite_frame frame;
+      int last_color = -1, last_alpha = -1;
+      VertexElement packed_color((color_t)0);
+
+      for (size_t n = 0; n < count; n++) {
+        const size_t i = oldtonew ? n : count - 1 - n;
+        particle_type* pt = pi_list.pt[i];
+
+        double size, rot_degrees, xscale, yscale;
+        gs_scalar x = pi_list.x[i], y = pi_list.y[i];
+        int sprite_id, subimg = 0;
+        bool additive;
+
+        if (pt->alive) {
+          if (pt != last_pt) {
+            last_pt = pt;
+            if (pt->is_particle_sprite) {
+              type_sprite = pt->part_sprite ? get_particle_actual_sprite(pt->part_sprite->shape) : -1;
+            } else {
+              type_sprite = enigma_user::sprite_exists(pt->sprite_id) ? pt->sprite_id : -1;
+              type_subimages = type_sprite != -1 ? sprites.get(type_sprite).SubimageCount() : 0;
+            }
+          }
+
+          size = std::max(0.0, pi_list.size[i] + pt->size_wiggle*particle_system::get_wiggle_result(pi_list.size_wiggle_offset[i], wiggle));
+          rot_degrees = pi_list.angle[i] + pt->ang_wiggle*particle_system::get_wiggle_result(pi_list.ang_wiggle_offset[i], wiggle);
+          if (pt->ang_relative) {
+            rot_degrees += pi_list.direction[i];
+          }
+          if (size <= 0) continue;
+
+          sprite_id = type_sprite;
+          if (sprite_id == -1) continue;
+          if (!pt->is_particle_sprite) {
+            if (!pt->sprite_animated || type_subimages <= 0) {
+              subimg = pi_list.sprite_subimageindex_initial[i];
+            }
+            else if (pt->sprite_stretched) {
+              subimg = int(type_subimages*(1.0 - 1.0*pi_list.life_current[i]/pi_list.life_start[i]));
+              subimg = subimg >= type_subimages ? type_subimages - 1 : subimg;
+              subimg = subimg % type_subimages;
+            }
+            else {
+              subimg = (subimage_index + pi_list.sprite_subimageindex_initial[i]) % type_subimages;
+            }
+          }
+          xscale = pt->xscale*size;
+          yscale = pt->yscale*size;
+          additive = pt->blend_additive;
+        }
+        else { // Draw particle in a limited way if particle type not alive.
+          size = pi_list.size[i];
+          rot_degrees = pi_list.angle[i];
+          if (size <= 0) continue;
+
+          if (pixel_sprite == -2) {
+            particle_sprite* ps = get_particle_sprite(pt_sh_pixel);
+            pixel_sprite = ps ? get_particle_actual_sprite(ps->shape) : -1;
+          }
+          sprite_id = pixel_sprite;
+          if (sprite_id == -1) continue;
+          x = std::round(x);
+          y = std::round(y);
+          xscale = yscale = size;
+          additive = false;
+        }
+
+        if (sprite_id != frame.sprite || subimg != frame.subimg) {
+          const Sprite& spr = sprites.get(sprite_id);
+          const int usi = spr.ModSubimage(subimg);
+          const TexRect& rect = spr.GetTextureRect(usi);
+          frame.sprite = sprite_id;
+          frame.subimg = subimg;
+          frame.texture = spr.GetTexture(usi);
+          frame.tx = rect.x; frame.ty = rect.y;
+          frame.tw = rect.w; frame.th = rect.h;
+          frame.xoffset = spr.xoffset; frame.yoffset = spr.yoffset;
+          frame.width = spr.width; frame.height = spr.height;
+        }
+
+        // The color packing differs per graphics system, so let the backend
+        // pack it once and copy the packed element into every vertex.
+        const int color = pi_list.color[i], alpha = pi_list.alpha[i];
+        if (color != last_color || alpha != last_alpha) {
+          last_color = color;
+          last_alpha = alpha;
+          const size_t before = verts.size();
+          enigma_user::vertex_color(vertex_buffer, color, alpha/255.0);
+          if (verts.size() > before) {
+            packed_color = verts.back();
+            verts.erase(verts.begin() + before, verts.end());
+          }
+        }
+
+        if (batches.empty() || batches.back().texture != frame.texture || batches.back().additive != additive) {
+          batches.push_back({frame.texture, additive, unsigned(verts.size() / 5), 0});
+        }
+        batches.back().count += 6;
+
+        // Same corner math as draw_sprite_ext.
+        const double rot = rot_degrees * -M_PI/180.0;
+        const gs_scalar rx = std::cos(rot), ry = std::sin(rot);
+        const gs_scalar x1 = -xscale*frame.xoffset, x2 = x1 + xscale*frame.width;
+        const gs_scalar y1 = -yscale*frame.yoffset, y2 = y1 + yscale*frame.height;
+        x += x_offset;
+        y += y_offset;
+
+        const gs_scalar tlx = x + x1*rx - y1*ry, tly = y + x1*ry + y1*rx;
+        const gs_scalar trx = x + x2*rx - y1*ry, try_ = y + x2*ry + y1*rx;
+        const gs_scalar blx = x + x1*rx - y2*ry, bly = y + x1*ry + y2*rx;
+        const gs_scalar brx = x + x2*rx - y2*ry, bry = y + x2*ry + y2*rx;
+        const gs_scalar u1 = frame.tx, v1 = frame.ty;
+        const gs_scalar u2 = frame.tx + frame.tw, v2 = frame.ty + frame.th;
+
+        auto emit = [&verts, &packed_color](gs_scalar px, gs_scalar py, gs_scalar u, gs_scalar v) {
+          verts.push_back(px); verts.push_back(py);
+          verts.push_back(u); verts.push_back(v);
+          verts.push_back(packed_color);
+        };
+        emit(tlx, tly, u1, v1);
+        emit(trx, try_, u2, v1);
+        emit(blx, bly, u1, v2);
+        emit(blx, bly, u1, v2);
+        emit(trx, try_, u2, v1);
+        emit(brx, bry, u2, v2);
+      }
+
+      enigma_user::vertex_end(vertex_buffer);
+      if (batches.empty()) return;
+
+      const int blend_src  = enigma::blendMode[0];
+      const int blend_dest = enigma::blendMode[1];
+      bool blend_set = false, blend_additive = false;
+      for (const particle_batch& batch : batches) {
+        if (!blend_set || batch.additive != blend_additive) {
+          enigma_user::draw_set_blend_mode(batch.additive ? enigma_user::bm_add : enigma_user::bm_normal);
+          blend_set = true;
+          blend_additive = batch.additive;
+        }
+        enigma_user::vertex_submit_range(vertex_buffer, enigma_user::pr_trianglelist, batch.texture, batch.start, batch.count);
+      }
+
+      if (enigma::blendMode[0] != blend_src || enigma::blendMode[1] != blend_dest) {
+        enigma_user::draw_set_blend_mode_ext(blend_src, blend_dest);
+      }
+    }
+  }
+}
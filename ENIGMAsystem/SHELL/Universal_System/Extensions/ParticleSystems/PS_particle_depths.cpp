@@ -26,9 +26,38 @@
 \********************************************************************************/
 
 #include "PS_particle_depths.h"
+#include "PS_particle_system.h"
+
+#include <algorithm>
 
 namespace enigma
 {
   std::map<double,particle_depth_layer> negated_particle_depths;
-}
 
+  static bool by_id(const particle_system* a, const particle_system* b) {
+    return a->id < b->id;
+  }
+
+  void particle_depth_insert(particle_system* p_s)
+  {
+    std::vector<particle_system*>& systems = negated_particle_depths[-p_s->depth].particlesystems;
+    std::vector<particle_system*>::iterator it = std::lower_bound(systems.begin(), systems.end(), p_s, by_id);
+    if (it == systems.end() || *it != p_s) {
+      systems.insert(it, p_s);
+    }
+  }
+
+  void particle_depth_erase(particle_system* p_s)
+  {
+    std::map<double,particle_depth_layer>::iterator layer = negated_particle_depths.find(-p_s->depth);
+    if (layer == negated_particle_depths.end()) return;
+    std::vector<particle_system*>& systems = (*layer).second.particlesystems;
+    std::vector<particle_system*>::iterator it = std::lower_bound(systems.begin(), systems.end(), p_s, by_id);
+    if (it != systems.end() && *it == p_s) {
+      systems.erase(it);
+    }
+    if (systems.empty()) {
+      negated_particle_depths.erase(layer);
+    }
+  }
+}
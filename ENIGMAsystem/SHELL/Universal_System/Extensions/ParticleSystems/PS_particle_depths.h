@@ -28,16 +28,21 @@
 #ifndef ENIGMA_PS_PARTICLEDEPTH
 #define ENIGMA_PS_PARTICLEDEPTH
 
-#include <set>
+#include <vector>
 #include <map>
 
 namespace enigma
 {
+  struct particle_system;
   struct particle_depth_layer {
-    std::set<int> particlesystem_ids;
+    std::vector<particle_system*> particlesystems; // Ordered by id.
   };
   extern std::map<double,particle_depth_layer> negated_particle_depths; // NOTE: Depths are negated.
+
+  // Add or remove a system from the layer at its current depth.
+  // Layers left empty are dropped, so drawing only visits depths with systems.
+  void particle_depth_insert(particle_system* p_s);
+  void particle_depth_erase(particle_system* p_s);
 }
 
 #endif // ENIGMA_PS_PARTICLEDEPTH
-
@@ -0,0 +1,129 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "PS_particle_instance.h"
+#include "PS_particle_type.h"
+
+namespace enigma
+{
+  void particle_store::reserve(size_t n)
+  {
+    pt.reserve(n);
+    sprite_subimageindex_initial.reserve(n);
+    size.reserve(n), size_wiggle_offset.reserve(n);
+    angle.reserve(n), ang_wiggle_offset.reserve(n);
+    color.reserve(n), alpha.reserve(n);
+    life_current.reserve(n), life_start.reserve(n);
+    x.reserve(n), y.reserve(n);
+    speed.reserve(n), direction.reserve(n);
+    speed_wiggle_offset.reserve(n), dir_wiggle_offset.reserve(n);
+  }
+
+  void particle_store::clear()
+  {
+    pt.clear();
+    sprite_subimageindex_initial.clear();
+    size.clear(), size_wiggle_offset.clear();
+    angle.clear(), ang_wiggle_offset.clear();
+    color.clear(), alpha.clear();
+    life_current.clear(), life_start.clear();
+    x.clear(), y.clear();
+    speed.clear(), direction.clear();
+    speed_wiggle_offset.clear(), dir_wiggle_offset.clear();
+  }
+
+  void particle_store::push_back(const particle_instance& pi)
+  {
+    pt.push_back(pi.pt);
+    sprite_subimageindex_initial.push_back(pi.sprite_subimageindex_initial);
+    size.push_back(pi.size), size_wiggle_offset.push_back(pi.size_wiggle_offset);
+    angle.push_back(pi.angle), ang_wiggle_offset.push_back(pi.ang_wiggle_offset);
+    color.push_back(pi.color), alpha.push_back(pi.alpha);
+    life_current.push_back(pi.life_current), life_start.push_back(pi.life_start);
+    x.push_back(pi.x), y.push_back(pi.y);
+    speed.push_back(pi.speed), direction.push_back(pi.direction);
+    speed_wiggle_offset.push_back(pi.speed_wiggle_offset), dir_wiggle_offset.push_back(pi.dir_wiggle_offset);
+  }
+
+  particle_instance particle_store::get(size_t i) const
+  {
+    particle_instance pi;
+    pi.pt = pt[i];
+    pi.sprite_subimageindex_initial = sprite_subimageindex_initial[i];
+    pi.size = size[i], pi.size_wiggle_offset = size_wiggle_offset[i];
+    pi.angle = angle[i], pi.ang_wiggle_offset = ang_wiggle_offset[i];
+    pi.color = color[i], pi.alpha = alpha[i];
+    pi.life_current = life_current[i], pi.life_start = life_start[i];
+    pi.x = x[i], pi.y = y[i];
+    pi.speed = speed[i], pi.direction = direction[i];
+    pi.speed_wiggle_offset = speed_wiggle_offset[i], pi.dir_wiggle_offset = dir_wiggle_offset[i];
+    return pi;
+  }
+
+  template<typename T> static void compact_lane(std::vector<T>& lane, const std::vector<int>& life, size_t first, size_t kept)
+  {
+    size_t w = first;
+    for (size_t i = first; i < lane.size(); i++) {
+      if (life[i] > 0) lane[w++] = lane[i];
+    }
+    lane.resize(kept);
+  }
+
+  size_t particle_store::remove_dead()
+  {
+    const size_t n = count();
+    size_t first = 0;
+    while (first < n && life_current[first] > 0) first++;
+    if (first == n) return 0;
+
+    // Release the particle types first; the lanes still line up at this point.
+    size_t kept = first;
+    for (size_t i = first; i < n; i++) {
+      if (life_current[i] > 0) {
+        kept++;
+        continue;
+      }
+      particle_type* p_t = pt[i];
+      p_t->particle_count--;
+      if (p_t->particle_count <= 0 && !p_t->alive) {
+        // Particle type is no longer used, delete it.
+        const int pid = p_t->id;
+        delete p_t;
+        pt_manager.id_to_particletype.erase(pid);
+      }
+    }
+
+    // Compact lane by lane; the life lane goes last since it drives the others.
+    compact_lane(pt, life_current, first, kept);
+    compact_lane(sprite_subimageindex_initial, life_current, first, kept);
+    compact_lane(size, life_current, first, kept);
+    compact_lane(size_wiggle_offset, life_current, first, kept);
+    compact_lane(angle, life_current, first, kept);
+    compact_lane(ang_wiggle_offset, life_current, first, kept);
+    compact_lane(color, life_current, first, kept);
+    compact_lane(alpha, life_current, first, kept);
+    compact_lane(life_start, life_current, first, kept);
+    compact_lane(x, life_current, first, kept);
+    compact_lane(y, life_current, first, kept);
+    compact_lane(speed, life_current, first, kept);
+    compact_lane(direction, life_current, first, kept);
+    compact_lane(speed_wiggle_offset, life_current, first, kept);
+    compact_lane(dir_wiggle_offset, life_current, first, kept);
+    compact_lane(life_current, life_current, first, kept);
+    return n - kept;
+  }
+}
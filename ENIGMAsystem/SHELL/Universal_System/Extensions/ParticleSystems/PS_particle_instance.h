@@ -30,26 +30,56 @@
 
 #include "PS_particle_type.h"
 
+#include <vector>
+#include <cstddef>
+
 namespace enigma
 {
+  // A single particle, unpacked. Used to spawn particles and by the draw bridges;
+  // the particle system itself keeps its particles in a particle_store.
   struct particle_instance
   {
     particle_type* pt;
 
     int sprite_subimageindex_initial;
-    double size;
-    double size_wiggle_offset; // [-1;1].
-    double angle;
-    double ang_wiggle_offset; // [-1;1].
+    float size;
+    float size_wiggle_offset; // [-1;1].
+    float angle;
+    float ang_wiggle_offset; // [-1;1].
     int color;
     int alpha;
     int life_current, life_start;
-    double x, y;
-    double speed, direction;
-    double speed_wiggle_offset; // [-1;1].
-    double dir_wiggle_offset; // [-1;1].
+    float x, y;
+    float speed, direction;
+    float speed_wiggle_offset; // [-1;1].
+    float dir_wiggle_offset; // [-1;1].
+  };
+
+  // Particles of a system stored attribute by attribute, so that the update
+  // kernels stream through contiguous float lanes. Particle i is the i-th
+  // entry of every lane; lanes are kept in creation order (oldest first).
+  struct particle_store
+  {
+    std::vector<particle_type*> pt;
+    std::vector<int> sprite_subimageindex_initial;
+    std::vector<float> size, size_wiggle_offset;
+    std::vector<float> angle, ang_wiggle_offset;
+    std::vector<int> color, alpha;
+    std::vector<int> life_current, life_start;
+    std::vector<float> x, y;
+    std::vector<float> speed, direction;
+    std::vector<float> speed_wiggle_offset, dir_wiggle_offset;
+
+    size_t count() const { return pt.size(); }
+    bool empty() const { return pt.empty(); }
+    void reserve(size_t n);
+    void clear();
+    void push_back(const particle_instance& pi);
+    particle_instance get(size_t i) const;
+    // Removes every particle whose life_current is <= 0, keeping the order of
+    // the survivors, and releases its particle type. Returns how many died.
+    size_t remove_dead();
   };
 }
 
 #endif // ENIGMA_PS_PARTICLEINSTANCE
-
@@ -30,6 +30,7 @@
 #include "PS_particle_type.h"
 #include "PS_particle_system_manager.h"
 #include <cstddef>
+#include <algorithm>
 
 using enigma::particle_system;
 using enigma::particle_type;
@@ -63,27 +64,16 @@ namespace enigma_user {
   {
     particle_system* p_s = enigma::get_particlesystem(id);
     if (p_s != NULL) {
-      for (std::vector<enigma::particle_instance>::iterator it = p_s->pi_list.begin(); it != p_s->pi_list.end(); it++)
-      {
-        particle_type* pt = it->pt;
-
-        // Death handling.
-        pt->particle_count--;
-        if (pt->particle_count <= 0 && !pt->alive) {
-          // Particle type is no longer used, delete it.
-          int pid = pt->id;
-          delete pt;
-          enigma::pt_manager.id_to_particletype.erase(pid);
-        }
-      }
-      p_s->pi_list.clear();
+      // Kill every particle and let the store release their types.
+      std::fill(p_s->pi_list.life_current.begin(), p_s->pi_list.life_current.end(), 0);
+      p_s->pi_list.remove_dead();
     }
   }
   int part_particles_count(int id)
   {
     particle_system* p_s = enigma::get_particlesystem(id);
     if (p_s != NULL) {
-      return p_s->pi_list.size();
+      return p_s->pi_list.count();
     }
     return 0;
   }
@@ -38,6 +38,8 @@
 #include "Universal_System/Resources/sprites_internal.h"
 #include "Widget_Systems/widgets_mandatory.h" // show_error
 #include "Universal_System/math_consts.h"
+#include "Universal_System/worker_pool.h"
+#include "Graphics_Systems/General/GScolor_macros.h"
 
 inline int bounds(int value, int low, int high)
 {
@@ -55,12 +57,57 @@ namespace enigma
 {
   struct generation_info
   {
-    double x;
-    double y;
+    float x;
+    float y;
     int number;
-    particle_type* pt;
+    int pt_id; // Resolved once the dead particles have been removed.
   };
 
+  namespace {
+    // Systems above this many particles are updated in chunks of this size,
+    // spread over the shared worker pool.
+    const size_t particle_chunk_size = 8192;
+
+    size_t chunk_count(size_t count)
+    {
+      return std::max<size_t>(1, (count + particle_chunk_size - 1)/particle_chunk_size);
+    }
+
+    // Runs kernel(begin, end, chunk) over [0, count), chunked across the pool
+    // when the system is large enough to be worth it.
+    template<typename K> void for_each_chunk(size_t count, const K& kernel)
+    {
+      if (count <= particle_chunk_size) {
+        kernel(size_t(0), count, size_t(0));
+        return;
+      }
+      shared_workers().run(chunk_count(count), [&](size_t c) {
+        kernel(c*particle_chunk_size, std::min(count, (c + 1)*particle_chunk_size), c);
+      });
+    }
+
+    inline int lerp_color(int c1, int c2, float part)
+    {
+      const int r = int((1 - part)*COL_GET_R(c1) + part*COL_GET_R(c2));
+      const int g = int((1 - part)*COL_GET_G(c1) + part*COL_GET_G(c2));
+      const int b = int((1 - part)*COL_GET_B(c1) + part*COL_GET_B(c2));
+      return r | (g << 8) | (b << 16);
+    }
+
+    // A changer with both of its particle types resolved for this step.
+    struct active_changer
+    {
+      particle_changer* changer;
+      int from_id, to_id;
+    };
+
+    // What a chunk of the update kernel produced besides the lanes it wrote.
+    struct chunk_output
+    {
+      std::vector<generation_info> deaths, steps, changes;
+    };
+  }
+
   double particle_system::get_wiggle_result(double wiggle_offset) {
     return get_wiggle_result(wiggle_offset, wiggle);
   }
@@ -79,7 +126,7 @@ namespace enigma
     oldtonew = true;
     auto_update = true, auto_draw = true;
     depth = 0.0;
-    pi_list = std::vector<particle_instance>();
+    pi_list.clear();
     id_to_emitter = std::map<int,particle_emitter*>();
     emitter_max_id = 0;
     id_to_attractor = std::map<int,particle_attractor*>();
@@ -93,264 +140,254 @@ namespace enigma
     hidden = false;
   }
 
-  static inline bool is_dead_from_old_age(particle_instance& pi) {
-    return pi.life_current <= 0;
-  }
-
-  void particle_system::update_particlesystem()
+  // Ages, recolors and moves particles [begin, end), then runs the changers on
+  // them. Touches only its own slice of the lanes, so slices may run in parallel;
+  // anything that creates or frees particles is recorded in out for later.
+  static void update_particle_range(particle_store& ps, size_t begin, size_t end, float wiggle,
+      const std::vector<active_changer>& changers, chunk_output& out)
   {
-    // Increase wiggle.
-    wiggle += 1.0/wiggle_frequency;
-    if (wiggle > 1.0) {
-      wiggle -= 1.0;
-    }
-    // Increase subimage_index.
-    subimage_index++;
+    const float deg = float(M_PI/180.0);
+    // Per-type constants, recomputed only when the type changes; particles of
+    // one type tend to sit next to each other since they are emitted together.
+    const particle_type* last_pt = NULL;
+    float size_incr = 0, ang_incr = 0, speed_incr = 0, dir_incr = 0;
+    float speed_wiggle = 0, dir_wiggle = 0, grav_x = 0, grav_y = 0;
+    bool has_gravity = false;
 
-    std::vector<generation_info> particles_to_generate;
-    // Handle life and death.
+    for (size_t i = begin; i < end; i++)
     {
-      for (std::vector<particle_instance>::iterator it = pi_list.begin(); it != pi_list.end(); it++)
-      {
-        // Decrease life.
-        it->life_current--;
-        if (it->life_current <= 0) { // Death.
-          particle_type* pt = it->pt;
-
-          // Generated upon end of life.
-          if (pt->alive && pt->death_on) {
-            std::map<int,particle_type*>::iterator death_pt_it = pt_manager.id_to_particletype.find(pt->death_particle_id);
-            if (death_pt_it != pt_manager.id_to_particletype.end()) {
-              generation_info gen_info;
-              gen_info.x = it->x;
-              gen_info.y = it->y;
-              gen_info.number = pt->death_number;
-              gen_info.pt = (*death_pt_it).second;
-              particles_to_generate.push_back(gen_info);
-            }
-          }
+      particle_type* pt = ps.pt[i];
 
-          // Death handling.
-          // Only the clean-up is made here.
-          pt->particle_count--;
-          if (pt->particle_count <= 0 && !pt->alive) {
-            // Particle type is no longer used, delete it.
-            int pid = pt->id;
-            delete pt;
-            enigma::pt_manager.id_to_particletype.erase(pid);
-          }
+      // Life and death.
+      const int life = --ps.life_current[i];
+      if (life <= 0) {
+        // Generated upon end of life.
+        if (pt->alive && pt->death_on) {
+          out.deaths.push_back(generation_info{ps.x[i], ps.y[i], pt->death_number, pt->death_particle_id});
         }
+        continue;
       }
-      pi_list.erase(std::remove_if(pi_list.begin(), pi_list.end(), is_dead_from_old_age), pi_list.end());
-    }
-    // Shape.
-    {
-      std::vector<particle_instance>::iterator end = pi_list.end();
-      for (std::vector<particle_instance>::iterator it = pi_list.begin(); it !=end; it++)
-      {
-        particle_type* pt = it->pt;
-        if (pt->alive) {
-          it->size = std::max(it->size + pt->size_incr, 0.0);
-          it->angle = fmod(it->angle + pt->ang_incr, 360.0);
+
+      float speed = ps.speed[i], direction = ps.direction[i];
+      float heading_x, heading_y; // cos and -sin of the direction moved in.
+      if (pt->alive) {
+        if (pt != last_pt) {
+          last_pt = pt;
+          size_incr = pt->size_incr, ang_incr = pt->ang_incr;
+          speed_incr = pt->speed_incr, dir_incr = pt->dir_incr;
+          speed_wiggle = pt->speed_wiggle, dir_wiggle = pt->dir_wiggle;
+          grav_x = pt->grav_amount*cos(pt->grav_dir*M_PI/180.0);
+          grav_y = -pt->grav_amount*sin(pt->grav_dir*M_PI/180.0);
+          has_gravity = !fzero(pt->grav_amount);
         }
-      }
-    }
-    // Color and blending.
-    {
-      std::vector<particle_instance>::iterator end = pi_list.end();
-      for (std::vector<particle_instance>::iterator it = pi_list.begin(); it !=end; it++)
-      {
-        particle_type* pt = it->pt;
-        // Color.
-        switch(pt->c_mode) {
-        default:
-        case one_color : {break;}
-        case two_color : {
-          if (pt->alive) {
-            const int r1 = color_get_red(pt->color1),
-                g1 = color_get_green(pt->color1),
-                b1 = color_get_blue(pt->color1);
-            const int r2 = color_get_red(pt->color2),
-                g2 = color_get_green(pt->color2),
-                b2 = color_get_blue(pt->color2);
-            const double part = 1.0 - 1.0*it->life_current/it->life_start;
-            it->color = make_color_rgb(int((1-part)*r1 + part*r2),int((1-part)*g1 + part*g2),int((1-part)*b1 + part*b2));
-          }
-          break;
+
+        // Shape.
+        ps.size[i] = std::max(ps.size[i] + size_incr, 0.0f);
+        ps.angle[i] = fmodf(ps.angle[i] + ang_incr, 360.0f);
+
+        // Color and blending.
+        const float part = 1.0f - float(life)/ps.life_start[i];
+        if (pt->c_mode == two_color) {
+          ps.color[i] = lerp_color(pt->color1, pt->color2, part);
         }
-        case three_color : {
-          if (pt->alive) {
-            double part = 1.0 - 1.0*it->life_current/it->life_start;
-            int first_color, second_color;
-            if (part <= 0.5) {
-              part = 2.0*part;
-              first_color = pt->color1;
-              second_color = pt->color2;
-            }
-            else {
-              part = 2.0*(part - 0.5);
-              first_color = pt->color2;
-              second_color = pt->color3;
-            }
-            const int r1 = color_get_red(first_color),
-                g1 = color_get_green(first_color),
-                b1 = color_get_blue(first_color);
-            const int r2 = color_get_red(second_color),
-                g2 = color_get_green(second_color),
-                b2 = color_get_blue(second_color);
-            it->color = make_color_rgb(int((1-part)*r1 + part*r2),int((1-part)*g1 + part*g2),int((1-part)*b1 + part*b2));
-          }
-          break;
+        else if (pt->c_mode == three_color) {
+          ps.color[i] = part <= 0.5f ? lerp_color(pt->color1, pt->color2, 2.0f*part)
+                                     : lerp_color(pt->color2, pt->color3, 2.0f*(part - 0.5f));
         }
-        case mix_color : {break;}
-        case rgb_color : {break;}
-        case hsv_color : {break;}
+        if (pt->a_mode == two_alpha) {
+          ps.alpha[i] = bounds(int((1 - part)*pt->alpha1 + part*pt->alpha2), 0, 255);
         }
-        // Alpha.
-        switch(pt->a_mode) {
-        default:
-        case one_alpha : {break;}
-        case two_alpha : {
-          if (pt->alive) {
-            const int alpha1 = pt->alpha1;
-            const int alpha2 = pt->alpha2;
-            const double part = 1.0 - 1.0*it->life_current/it->life_start;
-            it->alpha = bounds(int((1-part)*alpha1 + part*alpha2), 0, 255);
-          }
-          break;
+        else if (pt->a_mode == three_alpha) {
+          ps.alpha[i] = part <= 0.5f ? bounds(int((1 - 2.0f*part)*pt->alpha1 + 2.0f*part*pt->alpha2), 0, 255)
+                                     : bounds(int((2.0f - 2.0f*part)*pt->alpha2 + (2.0f*part - 1.0f)*pt->alpha3), 0, 255);
+        }
+
+        // Generated each step.
+        if (pt->step_on) {
+          out.steps.push_back(generation_info{ps.x[i], ps.y[i], pt->step_number, pt->step_particle_id});
         }
-        case three_alpha : {
-          if (pt->alive) {
-            const int alpha1 = pt->alpha1;
-            const int alpha2 = pt->alpha2;
-            const int alpha3 = pt->alpha3;
-            double part = 1.0 - 1.0*it->life_current/it->life_start;
-            int first_alpha, second_alpha;
-            if (part <= 0.5) {
-              part = 2.0*part;
-              first_alpha = alpha1;
-              second_alpha = alpha2;
-            }
-            else {
-              part = 2.0*(part - 0.5);
-              first_alpha = alpha2;
-              second_alpha = alpha3;
-            }
-            it->alpha = bounds(int((1-part)*first_alpha + part*second_alpha), 0, 255);
+
+        // Speed, direction and gravity.
+        speed += speed_incr;
+        direction += dir_incr;
+        if (speed < 0) {
+          speed = -speed;
+          direction += 180.0f;
+        }
+        direction = fmodf(direction, 360.0f);
+        heading_x = cosf(direction*deg), heading_y = -sinf(direction*deg);
+        if (has_gravity) {
+          const float vx = speed*heading_x + grav_x;
+          const float vy = speed*heading_y + grav_y;
+          const float new_speed = sqrtf(vx*vx + vy*vy);
+          if (!(fzero(vx) && fzero(vy))) {
+            // The new heading falls out of the velocity; no need for more trig.
+            direction = -atan2f(vy, vx)/deg;
+            heading_x = vx/new_speed, heading_y = vy/new_speed;
           }
-          break;
+          speed = new_speed;
         }
+        ps.speed[i] = speed, ps.direction[i] = direction;
+
+        speed += speed_wiggle*particle_system::get_wiggle_result(ps.speed_wiggle_offset[i], wiggle);
+        if (dir_wiggle != 0) {
+          direction += dir_wiggle*particle_system::get_wiggle_result(ps.dir_wiggle_offset[i], wiggle);
+          heading_x = cosf(direction*deg), heading_y = -sinf(direction*deg);
         }
       }
-    }
-    // Step.
-    {
-      for (std::vector<particle_instance>::iterator it = pi_list.begin(); it != pi_list.end(); it++)
-      {
-        particle_type* pt = it->pt;
+      else {
+        heading_x = cosf(direction*deg), heading_y = -sinf(direction*deg);
+      }
+      // Move.
+      const float x = ps.x[i] + speed*heading_x;
+      const float y = ps.y[i] + speed*heading_y;
+      ps.x[i] = x, ps.y[i] = y;
 
-        // Generated each step.
-        if (pt->alive && pt->step_on) {
-          std::map<int,particle_type*>::iterator step_pt_it = pt_manager.id_to_particletype.find(pt->step_particle_id);
-          if (step_pt_it != pt_manager.id_to_particletype.end()) {
-            generation_info gen_info;
-            gen_info.x = it->x;
-            gen_info.y = it->y;
-            gen_info.number = pt->step_number;
-            gen_info.pt = (*step_pt_it).second;
-            particles_to_generate.push_back(gen_info);
-          }
+      // Changers. A particle is changed by at most one changer per step.
+      for (const active_changer& ch : changers) {
+        if (pt->id == ch.from_id && ch.changer->is_inside(x, y)) {
+          // Removed with the other dead particles; replaced by one of the new type.
+          ps.life_current[i] = 0;
+          out.changes.push_back(generation_info{x, y, 1, ch.to_id});
+          break;
         }
       }
     }
-    // Move particles.
+  }
+
+  // Applies attractors, destroyers and deflectors to particles [begin, end).
+  // Like update_particle_range, this only touches its own slice of the lanes.
+  static void interact_particle_range(particle_store& ps, size_t begin, size_t end,
+      const std::vector<particle_attractor*>& attractors, const std::vector<particle_destroyer*>& destroyers,
+      const std::vector<particle_deflector*>& deflectors)
+  {
+    const float deg = float(M_PI/180.0);
+    for (size_t i = begin; i < end; i++)
     {
-      std::vector<particle_instance>::iterator end = pi_list.end();
-      for (std::vector<particle_instance>::iterator it = pi_list.begin(); it !=end; it++)
+      // Attractors.
+      for (const particle_attractor* p_a : attractors)
       {
-        particle_type* pt = it->pt;
-        if (pt->alive) {
-          it->speed += pt->speed_incr;
-          it->direction += pt->dir_incr;
-          if (it->speed < 0) {
-            it->speed = -it->speed;
-            it->direction += 180.0;
+        // If the particle is not inside the attractor range of influence,
+        // or is at the attractor's exact position, skip to the next attractor.
+        const double dx = ps.x[i] - p_a->x;
+        const double dy = ps.y[i] - p_a->y;
+        const double relative_distance = sqrt(dx*dx + dy*dy)/std::max(1.0, p_a->dist_effect);
+        if (relative_distance > 1.0 || (fzero(dx) && fzero(dy))) {
+          continue;
+        }
+        const double direction_radians = atan2(dy, -dx);
+        // Determine force.
+        double force_effective_strength;
+        switch (p_a->force_kind)  {
+        case ps_fo_constant : force_effective_strength = p_a->force_strength; break;
+        case ps_fo_linear : force_effective_strength = (1.0 - relative_distance)*p_a->force_strength; break;
+        case ps_fo_quadratic : force_effective_strength = (1.0 - relative_distance)*(1.0 - relative_distance)*p_a->force_strength; break;
+        default : force_effective_strength = p_a->force_strength; break;
+        }
+        // Apply force.
+        if (p_a->additive) {
+          const float speed = ps.speed[i], direction = ps.direction[i];
+          const float vx = speed*cosf(direction*deg) + force_effective_strength*cos(direction_radians);
+          const float vy = -speed*sinf(direction*deg) - force_effective_strength*sin(direction_radians);
+          ps.speed[i] = sqrtf(vx*vx + vy*vy);
+          if (!(fzero(vx) && fzero(vy))) {
+            ps.direction[i] = -atan2f(vy, vx)/deg;
           }
-          it->direction = fmod(it->direction, 360.0);
-          const double speed = it->speed, direction = it->direction;
-          const double grav_amount = pt->grav_amount, grav_dir = pt->grav_dir;
-          const double vx = speed*cos(direction*M_PI/180.0) + grav_amount*cos(grav_dir*M_PI/180.0);
-          const double vy = -(speed*sin(direction*M_PI/180.0) + grav_amount*sin(grav_dir*M_PI/180.0));
-          it->speed = sqrt(vx*vx + vy*vy);
-          it->direction = fzero(vx) && fzero(vy) ? direction : -atan2(vy,vx)*180.0/M_PI;
         }
-        double speed = it->speed, direction = it->direction;
-        if (pt->alive) {
-          speed += pt->speed_wiggle*get_wiggle_result(it->speed_wiggle_offset);
-          direction += pt->dir_wiggle*get_wiggle_result(it->dir_wiggle_offset);
+        else {
+          ps.x[i] += force_effective_strength*cos(direction_radians);
+          ps.y[i] -= force_effective_strength*sin(direction_radians);
         }
-        it->x += speed*cos(direction*M_PI/180.0);
-        it->y += -speed*sin(direction*M_PI/180.0);
       }
-    }
-    // Changers.
-    {
-      std::map<int,particle_changer*>::iterator end1 = id_to_changer.end();
-      for (std::map<int,particle_changer*>::iterator ch_it = id_to_changer.begin(); ch_it != end1; ch_it++)
+
+      // Destroyers.
+      bool destroyed = false;
+      for (particle_destroyer* p_ds : destroyers) {
+        if (p_ds->is_inside(ps.x[i], ps.y[i])) {
+          // Removed with the other dead particles after the pass.
+          ps.life_current[i] = 0;
+          destroyed = true;
+          break;
+        }
+      }
+      if (destroyed) continue;
+
+      // Deflectors.
+      for (particle_deflector* p_df : deflectors)
       {
-        particle_changer* p_ch = (*ch_it).second;
-        particle_type* pt1;
-        particle_type* pt2;
-        std::map<int,enigma::particle_type*>::iterator pt_it1 = enigma::pt_manager.id_to_particletype.find(p_ch->parttypeid1);
-        if (pt_it1 == enigma::pt_manager.id_to_particletype.end()) {
-          continue;
+        if (!p_df->is_inside(ps.x[i], ps.y[i])) continue;
+        // Direction changing.
+        float direction = fmodf(ps.direction[i] + 360.0f, 360.0f);
+        switch (p_df->deflection_kind) {
+        case ps_de_horizontal : {
+          direction = direction <= 180.0f ? 180.0f - direction : 540.0f - direction;
+          break;
         }
-        std::map<int,enigma::particle_type*>::iterator pt_it2 = enigma::pt_manager.id_to_particletype.find(p_ch->parttypeid2);
-        if (pt_it2 == enigma::pt_manager.id_to_particletype.end()) {
-          continue;
+        case ps_de_vertical : {
+          direction = 360.0f - direction;
+          break;
         }
-        pt1 = (*pt_it1).second;
-        pt2 = (*pt_it2).second;
-
-        std::vector<particle_instance>::iterator end2 = pi_list.end();
-        for (std::vector<particle_instance>::iterator it = pi_list.begin(); it != end2; it++)
-        {
-          if (p_ch->is_inside(it->x, it->y) && it->pt->id == pt1->id && it->life_current > 0) { // Skip particles with life_current <= 0.
-            // Store position of old particle.
-            const double x = it->x, y = it->y;
-            // Destroy the old particle.
-            // Only the clean-up is made here. The actual removal is handle after the loops by remove_if and erase.
-            pt1->particle_count--;
-            if (pt1->particle_count <= 0 && !pt1->alive) {
-              // Particle type is no longer used, delete it.
-              int pid = pt1->id;
-              delete pt1;
-              enigma::pt_manager.id_to_particletype.erase(pid);
-            }
-            // Internally when handling changers, setting life_current to 0 indicates that the particle has been removed.
-            it->life_current = 0;
-            // Create a new particle at its position.
-            generation_info gen_info;
-            gen_info.x = x;
-            gen_info.y = y;
-            gen_info.number = 1;
-            gen_info.pt = pt2;
-            particles_to_generate.push_back(gen_info);
-          }
+        default : {
+          break;
         }
+        }
+        ps.direction[i] = direction;
+        // Friction handling.
+        const float speed = ps.speed[i];
+        const float new_speed = std::max(0.0f, speed - float(p_df->friction));
+        const float friction_effect = speed - new_speed;
+        ps.speed[i] = new_speed;
+        // Move one step.
+        ps.x[i] += friction_effect*cosf(direction*deg);
+        ps.y[i] -= friction_effect*sinf(direction*deg);
       }
-      // Erase all particles with life_current <= 0.
-      pi_list.erase(std::remove_if(pi_list.begin(), pi_list.end(), is_dead_from_old_age), pi_list.end());
     }
-    // Generate particles.
-    for (std::vector<generation_info>::iterator it = particles_to_generate.begin(); it != particles_to_generate.end(); it++)
+  }
+
+  void particle_system::update_particlesystem()
+  {
+    // Increase wiggle.
+    wiggle += 1.0/wiggle_frequency;
+    if (wiggle > 1.0) {
+      wiggle -= 1.0;
+    }
+    // Increase subimage_index.
+    subimage_index++;
+
+    // Changers whose particle types both still exist.
+    std::vector<active_changer> changers;
+    for (std::map<int,particle_changer*>::iterator ch_it = id_to_changer.begin(); ch_it != id_to_changer.end(); ch_it++)
     {
-      double x = (*it).x, y = (*it).y;
-      int number = (*it).number;
-      particle_type* pt = (*it).pt;
-      number = number >= 0 ? number : (rand() % (-number) < 1 ? 1 : 0); // Create particle with probability -1/number.
-      create_particles(x, y, pt, number);
+      particle_changer* p_ch = (*ch_it).second;
+      if (pt_manager.id_to_particletype.count(p_ch->parttypeid1) && pt_manager.id_to_particletype.count(p_ch->parttypeid2)) {
+        changers.push_back(active_changer{p_ch, p_ch->parttypeid1, p_ch->parttypeid2});
+      }
     }
+
+    // Life, shape, color, step generation, motion and changers in one pass.
+    std::vector<chunk_output> outputs(chunk_count(pi_list.count()));
+    const float wiggle_amount = wiggle;
+    for_each_chunk(pi_list.count(), [&](size_t begin, size_t end, size_t chunk) {
+      update_particle_range(pi_list, begin, end, wiggle_amount, changers, outputs[chunk]);
+    });
+    pi_list.remove_dead();
+
+    // Generate particles: death spawns first, then step spawns, then changes.
+    particle_type* last_pt = NULL;
+    int last_pt_id = 0;
+    const auto generate = [&](const generation_info& gen) {
+      if (last_pt == NULL || last_pt_id != gen.pt_id) {
+        std::map<int,particle_type*>::iterator pt_it = pt_manager.id_to_particletype.find(gen.pt_id);
+        if (pt_it == pt_manager.id_to_particletype.end()) return;
+        last_pt = (*pt_it).second, last_pt_id = gen.pt_id;
+      }
+      const int number = gen.number >= 0 ? gen.number : (rand() % (-gen.number) < 1 ? 1 : 0); // Create particle with probability -1/number.
+      create_particles(gen.x, gen.y, last_pt, number);
+    };
+    for (const chunk_output& out : outputs) for (const generation_info& gen : out.deaths) generate(gen);
+    for (const chunk_output& out : outputs) for (const generation_info& gen : out.steps) generate(gen);
+    for (const chunk_output& out : outputs) for (const generation_info& gen : out.changes) generate(gen);
+
     // Emitters.
     {
       std::map<int,particle_emitter*>::iterator end = id_to_emitter.end();
@@ -371,112 +408,24 @@ namespace enigma
         }
       }
     }
-    // Attractors.
-    {
-      std::map<int,particle_attractor*>::iterator end = id_to_attractor.end();
-      for (std::map<int,particle_attractor*>::iterator at_it = id_to_attractor.begin(); at_it != end; at_it++)
-      {
-        particle_attractor* p_a = (*at_it).second;
-        std::vector<particle_instance>::iterator end1 = pi_list.end();
-        for (std::vector<particle_instance>::iterator it = pi_list.begin(); it != end1; it++)
-        {
-          // If the particle is not inside the attractor range of influence,
-          // or is at the attractor's exact position,
-          // skip to next attractor.
-          const double dx = it->x - p_a->x;
-          const double dy = it->y - p_a->y;
-          const double relative_distance = sqrt(dx*dx + dy*dy)/std::max(1.0, p_a->dist_effect);
-          if (relative_distance > 1.0 || (fzero(dx) && fzero(dy))) {
-            continue;
-          }
-          const double direction_radians = atan2(-(p_a->y - it->y), p_a->x - it->x);
-          // Determine force.
-          double force_effective_strength;
-          switch (p_a->force_kind)  {
-          case ps_fo_constant : force_effective_strength = p_a->force_strength; break;
-          case ps_fo_linear : force_effective_strength = (1.0 - relative_distance)*p_a->force_strength; break;
-          case ps_fo_quadratic : force_effective_strength = (1.0 - relative_distance)*(1.0 - relative_distance)*p_a->force_strength; break;
-          default : force_effective_strength = p_a->force_strength; break;
-          }
-          // Apply force.
-          if (p_a->additive) {
-            const double vx = it->speed*cos(it->direction*M_PI/180.0) + force_effective_strength*cos(direction_radians);
-            const double vy = -it->speed*sin(it->direction*M_PI/180.0) - force_effective_strength*sin(direction_radians);
-            it->speed = sqrt(vx*vx + vy*vy);
-            const double direction = it->direction;
-            it->direction = fzero(vx) && fzero(vy) ? direction : -atan2(vy,vx)*180.0/M_PI;
-          }
-          else {
-            it->x += force_effective_strength*cos(direction_radians);
-            it->y += -force_effective_strength*sin(direction_radians);
-          }
-        }
-      }
-    }
-    // Destroyers.
-    {
-      std::map<int,particle_destroyer*>::iterator end1 = id_to_destroyer.end();
-      for (std::map<int,particle_destroyer*>::iterator ds_it = id_to_destroyer.begin(); ds_it != end1; ds_it++)
-      {
-        particle_destroyer* p_ds = (*ds_it).second;
-        std::vector<particle_instance>::iterator end2 = pi_list.end();
-        for (std::vector<particle_instance>::iterator it = pi_list.begin(); it != end2; it++)
-        {
-          if (p_ds->is_inside(it->x, it->y) && it->life_current > 0) { // Skip particles with life_current <= 0.
-            particle_type* pt = it->pt;
-
-            // Death handling.
-            // Only the clean-up is made here. The actual removal is handle after the loops by remove_if and erase.
-            pt->particle_count--;
-            if (pt->particle_count <= 0 && !pt->alive) {
-              // Particle type is no longer used, delete it.
-              int pid = pt->id;
-              delete pt;
-              enigma::pt_manager.id_to_particletype.erase(pid);
-            }
-            // Internally when handling destroyers, setting life_current to 0 indicates that the particle has been removed.
-            it->life_current = 0;
-          }
-        }
-      }
-      // Erase all particles with life_current <= 0.
-      pi_list.erase(std::remove_if(pi_list.begin(), pi_list.end(), is_dead_from_old_age), pi_list.end());
-    }
-    // Deflectors.
+
+    // Attractors, destroyers and deflectors in one pass.
+    if (!id_to_attractor.empty() || !id_to_destroyer.empty() || !id_to_deflector.empty())
     {
-      std::map<int,particle_deflector*>::iterator end = id_to_deflector.end();
-      for (std::map<int,particle_deflector*>::iterator df_it = id_to_deflector.begin(); df_it != end; df_it++)
-      {
-        particle_deflector* p_df = (*df_it).second;
-        std::vector<particle_instance>::iterator end2 = pi_list.end();
-        for (std::vector<particle_instance>::iterator it = pi_list.begin(); it != end2; it++)
-        {
-          if (p_df->is_inside(it->x, it->y)) {
-            // Direction changing.
-            it->direction = fmod(it->direction + 360.0, 360.0);
-            switch (p_df->deflection_kind) {
-            case ps_de_horizontal : {
-              it->direction = it->direction <= 180.0 ? 180.0 - it->direction : 540.0 - it->direction;
-              break;
-            }
-            case ps_de_vertical : {
-              it->direction = 360.0 - it->direction;
-              break;
-            }
-            default : {
-              break;
-            }
-            }
-            // Friction handling.
-            const double new_speed = std::max(0.0, it->speed - p_df->friction);
-            const double friction_effect = it->speed - new_speed;
-            it->speed = new_speed;
-            // Move one step.
-            it->x += friction_effect*cos(it->direction*M_PI/180.0);
-            it->y += -friction_effect*sin(it->direction*M_PI/180.0);
-          }
-        }
-      }
+      std::vector<particle_attractor*> attractors;
+      for (std::map<int,particle_attractor*>::iterator it = id_to_attractor.begin(); it != id_to_attractor.end(); it++)
+        attractors.push_back((*it).second);
+      std::vector<particle_destroyer*> destroyers;
+      for (std::map<int,particle_destroyer*>::iterator it = id_to_destroyer.begin(); it != id_to_destroyer.end(); it++)
+        destroyers.push_back((*it).second);
+      std::vector<particle_deflector*> deflectors;
+      for (std::map<int,particle_deflector*>::iterator it = id_to_deflector.begin(); it != id_to_deflector.end(); it++)
+        deflectors.push_back((*it).second);
+
+      for_each_chunk(pi_list.count(), [&](size_t begin, size_t end, size_t) {
+        interact_particle_range(pi_list, begin, end, attractors, destroyers, deflectors);
+      });
+      pi_list.remove_dead();
     }
   }
   void particle_system::draw_particlesystem()
@@ -48,7 +48,7 @@ namespace enigma
     // Initialization
     void initialize_particle_bridge();
     // Drawing
-    void draw_particles(std::vector<particle_instance>& pi_list, bool oldtonew, double wiggle, int subimage_index,
+    void draw_particles(particle_store& pi_list, bool oldtonew, double wiggle, int subimage_index,
         double x_offset, double y_offset);
   }
   
@@ -66,7 +66,7 @@ namespace enigma
     bool oldtonew;
     double x_offset, y_offset;
     double depth; // Integer stored as double.
-    std::vector<particle_instance> pi_list;
+    particle_store pi_list;
     bool auto_update, auto_draw;
     void initialize();
     void update_particlesystem();
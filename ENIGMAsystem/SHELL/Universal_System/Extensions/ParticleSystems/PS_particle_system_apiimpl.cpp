@@ -55,7 +55,7 @@ namespace enigma_user {
     p_s->id = ps_manager.max_id;
 
     // Drawing is automatic, so register in depth.
-    enigma::negated_particle_depths[-p_s->depth].particlesystem_ids.insert(ps_manager.max_id);
+    enigma::particle_depth_insert(p_s);
 
     return ps_manager.max_id;
   }
@@ -65,6 +65,9 @@ namespace enigma_user {
     // Remember to destroy the system.
     particle_system* p_s = enigma::get_particlesystem(id);
     if (p_s != NULL) {
+      if (p_s->auto_draw) {
+        enigma::particle_depth_erase(p_s);
+      }
       delete p_s;
       enigma::ps_manager.id_to_particlesystem.erase(id);
     }
@@ -98,9 +101,9 @@ namespace enigma_user {
       if (p_s->auto_draw) {
         // If the particle system has automatic drawing enabled, it is in the depth system,
         // and it should be moved.
-        const double current_depth = p_s->depth;
-        enigma::negated_particle_depths[-current_depth].particlesystem_ids.erase(p_s->id);
-        enigma::negated_particle_depths[-new_depth].particlesystem_ids.insert(p_s->id);
+        enigma::particle_depth_erase(p_s);
+        p_s->depth = new_depth;
+        enigma::particle_depth_insert(p_s);
       }
       else {
         // If the particle system does not have automatic drawing enabled, it is not in the depth system,
@@ -134,10 +137,10 @@ namespace enigma_user {
       bool auto_draw_before = p_s->auto_draw;
       p_s->auto_draw = automatic;
       if (automatic && !auto_draw_before) { // Add to drawing depths.
-        enigma::negated_particle_depths[-p_s->depth].particlesystem_ids.insert(p_s->id);
+        enigma::particle_depth_insert(p_s);
       }
       else if (!automatic && auto_draw_before) { // Remove from drawing depths.
-        enigma::negated_particle_depths[-p_s->depth].particlesystem_ids.erase(p_s->id);
+        enigma::particle_depth_erase(p_s);
       }
     }
   }
@@ -53,14 +53,11 @@ namespace enigma
     const std::map<double,particle_depth_layer>::iterator ne_upper_it = negated_particle_depths.find(-low);
     for (std::map<double,particle_depth_layer>::iterator ne_it = negated_particle_depths.lower_bound(-high); ne_it != ne_end && ne_it != ne_upper_it; ne_it++)
     {
-      std::set<int>::iterator ps_ids_end = (*ne_it).second.particlesystem_ids.end();
-      for (std::set<int>::iterator  ps_ids_it = (*ne_it).second.particlesystem_ids.begin();  ps_ids_it != ps_ids_end;  ps_ids_it++)
+      const std::vector<particle_system*>& systems = (*ne_it).second.particlesystems;
+      for (particle_system* p_s : systems)
       {
-        std::map<int,particle_system*>::iterator ps_it = ps_manager.id_to_particlesystem.find(*ps_ids_it);
-        if (ps_it != ps_manager.id_to_particlesystem.end()) {
-          if ((*ps_it).second->auto_draw) {
-            (*ps_it).second->draw_particlesystem();
-          }
+        if (p_s->auto_draw) {
+          p_s->draw_particlesystem();
         }
       }
     }
@@ -3,6 +3,7 @@
 #endif
 
 namespace enigma {
+  class snapshot_io;
   struct extension_path
   {
     int path_index;
@@ -19,5 +20,8 @@ namespace enigma {
     extension_path(): path_index(-1), path_endaction(0), path_orientation(0), path_position(0), path_positionprevious(0), path_scale(1), path_speed(0) {}
 
     virtual variant myevent_pathend() { return 1; }
+    #ifndef JUST_DEFINE_IT_RUN
+    void $snapshot_fields(snapshot_io &io);
+    #endif
   };
 }
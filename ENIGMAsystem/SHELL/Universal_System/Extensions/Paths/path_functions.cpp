@@ -49,12 +49,20 @@ namespace enigma {
 
 #include "Universal_System/Object_Tiers/collisions_object.h"
 #include "Universal_System/Instances/instance_system.h"
+#include "Universal_System/snapshot.h"
 #include "implement.h"
 
 namespace enigma {
   namespace extension_cast {
     extension_path *as_extension_path(object_basic*);
   }
+
+  void extension_path::$snapshot_fields(snapshot_io &io) {
+    io(path_index); io(path_endaction); io(path_orientation);
+    io(path_position); io(path_positionprevious);
+    io(path_scale); io(path_speed);
+    io(path_xstart); io(path_ystart);
+  }
 }
 
 namespace enigma_user
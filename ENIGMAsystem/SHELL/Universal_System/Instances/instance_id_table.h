@@ -0,0 +1,202 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_INSTANCE_ID_TABLE_H
+#define ENIGMA_INSTANCE_ID_TABLE_H
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace enigma {
+
+// Table of instances (or their list nodes) indexed directly by instance ID.
+// IDs are handed out densely from 100000 upward and are never reused, so the
+// ID itself is the slot and a lookup is two loads rather than a tree walk.
+// Slots live in fixed-size pages that are allocated on first use and freed
+// once empty, so a game churning through IDs only pays for the live ones.
+// Each page keeps a bitmap of its occupied slots, and the table a bitmap of
+// its allocated pages, so finding the next or previous entry skips empty
+// stretches 64 slots or 64 pages at a time.
+// Iteration visits occupied slots in ID order, and erasing an entry never
+// invalidates iterators to other entries (so `erase(it++)` works as it did
+// with std::map).
+template<typename T> class instance_id_table {
+  static const int first_id = 100000;
+  static const int page_bits = 10;
+  static const size_t page_size = size_t(1) << page_bits;
+  static const size_t page_words = page_size / 64;
+
+  struct page {
+    T slots[page_size] = {};
+    uint64_t occupied[page_words] = {};
+    size_t used = 0;
+  };
+  std::vector<std::unique_ptr<page> > pages;
+  std::vector<uint64_t> allocated;  // Bit p is set while pages[p] exists.
+  size_t count = 0;
+
+  static void set_bit(uint64_t *bits, size_t i)   { bits[i >> 6] |= uint64_t(1) << (i & 63); }
+  static void clear_bit(uint64_t *bits, size_t i) { bits[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+  // Lowest set bit at or after `from` in the first `words` words, or -1.
+  static ptrdiff_t first_set(const uint64_t *bits, size_t words, size_t from) {
+    for (size_t w = from >> 6; w < words; ++w) {
+      const uint64_t v = bits[w] & (w == from >> 6 ? ~uint64_t(0) << (from & 63) : ~uint64_t(0));
+      if (v) return ptrdiff_t(w << 6) + __builtin_ctzll(v);
+    }
+    return -1;
+  }
+  // Highest set bit at or before `upto`, or -1.
+  static ptrdiff_t last_set(const uint64_t *bits, size_t upto) {
+    for (size_t w = (upto >> 6) + 1; w-- > 0; ) {
+      const uint64_t v = bits[w] & (w == upto >> 6 && (upto & 63) != 63 ? (uint64_t(2) << (upto & 63)) - 1 : ~uint64_t(0));
+      if (v) return ptrdiff_t(w << 6) + 63 - __builtin_clzll(v);
+    }
+    return -1;
+  }
+
+  T *slot(int id) const {
+    if (id < first_id) return NULL;
+    const size_t idx = id - first_id, p = idx >> page_bits;
+    if (p >= pages.size() || !pages[p]) return NULL;
+    return &pages[p]->slots[idx & (page_size - 1)];
+  }
+
+  // First occupied ID at or after `id`, or -1.
+  int next_occupied(int id) const {
+    if (id < first_id) id = first_id;
+    const size_t idx = id - first_id;
+    const size_t p = idx >> page_bits;
+    if (p >= pages.size()) return -1;
+    if (const page *pg = pages[p].get()) {
+      const ptrdiff_t s = first_set(pg->occupied, page_words, idx & (page_size - 1));
+      if (s >= 0) return first_id + int((p << page_bits) + s);
+    }
+    const ptrdiff_t q = first_set(allocated.data(), allocated.size(), p + 1);
+    if (q < 0) return -1;
+    return first_id + int((size_t(q) << page_bits) + first_set(pages[q]->occupied, page_words, 0));
+  }
+
+ public:
+  typedef std::pair<int, T> value_type;
+
+  class iterator {
+    friend class instance_id_table;
+    const instance_id_table *table;
+    value_type kv;
+    iterator(const instance_id_table *t, int id): table(t), kv(id, id < 0 ? T() : *t->slot(id)) {}
+
+   public:
+    iterator(): table(NULL), kv(-1, T()) {}
+    const value_type &operator*() const { return kv; }
+    const value_type *operator->() const { return &kv; }
+    iterator &operator++() {
+      const int id = table->next_occupied(kv.first + 1);
+      kv.first = id;
+      kv.second = id < 0 ? T() : *table->slot(id);
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator ret(*this);
+      ++*this;
+      return ret;
+    }
+    bool operator==(const iterator &other) const { return kv.first == other.kv.first; }
+    bool operator!=(const iterator &other) const { return kv.first != other.kv.first; }
+  };
+
+  iterator begin() const { return iterator(this, next_occupied(first_id)); }
+  iterator end() const { return iterator(this, -1); }
+  iterator find(int id) const {
+    T *s = slot(id);
+    return s && *s ? iterator(this, id) : end();
+  }
+
+  // The entry for `id`, or a null T if there isn't one.
+  T get(int id) const {
+    T *s = slot(id);
+    return s ? *s : T();
+  }
+
+  // The entry with the greatest ID below `id`, or a null T if there isn't one.
+  T find_before(int id) const {
+    if (id <= first_id || pages.empty()) return T();
+    size_t idx = id - 1 - first_id, p = idx >> page_bits;
+    if (p >= pages.size()) {
+      p = pages.size() - 1;
+      idx = (p << page_bits) + page_size - 1;
+    }
+    if (const page *pg = pages[p].get()) {
+      const ptrdiff_t s = last_set(pg->occupied, idx & (page_size - 1));
+      if (s >= 0) return pg->slots[s];
+    }
+    const ptrdiff_t q = p ? last_set(allocated.data(), p - 1) : -1;
+    if (q < 0) return T();
+    const page *pg = pages[q].get();
+    return pg->slots[last_set(pg->occupied, page_size - 1)];
+  }
+
+  std::pair<iterator, bool> insert(const value_type &kv) {
+    if (kv.first < first_id || !kv.second) return std::make_pair(end(), false);
+    const size_t idx = kv.first - first_id, p = idx >> page_bits;
+    if (p >= pages.size()) {
+      pages.resize(p + 1);
+      allocated.resize((p >> 6) + 1);
+    }
+    if (!pages[p]) {
+      pages[p].reset(new page());
+      set_bit(allocated.data(), p);
+    }
+    T &s = pages[p]->slots[idx & (page_size - 1)];
+    if (s) return std::make_pair(iterator(this, kv.first), false);
+    s = kv.second;
+    set_bit(pages[p]->occupied, idx & (page_size - 1));
+    ++pages[p]->used;
+    ++count;
+    return std::make_pair(iterator(this, kv.first), true);
+  }
+
+  size_t erase(int id) {
+    T *s = slot(id);
+    if (!s || !*s) return 0;
+    *s = T();
+    --count;
+    const size_t idx = id - first_id, p = idx >> page_bits;
+    std::unique_ptr<page> &pg = pages[p];
+    clear_bit(pg->occupied, idx & (page_size - 1));
+    if (!--pg->used) {
+      pg.reset();
+      clear_bit(allocated.data(), p);
+    }
+    return 1;
+  }
+  void erase(const iterator &it) { erase(it->first); }
+
+  size_t size() const { return count; }
+  bool empty() const { return !count; }
+  void clear() {
+    pages.clear();
+    allocated.clear();
+    count = 0;
+  }
+};
+
+}  //namespace enigma
+
+#endif  //ENIGMA_INSTANCE_ID_TABLE_H
@@ -28,7 +28,6 @@ class iterator {
   enigma::inst_iter temp_iter;
   enigma::inst_iter* it;
 
-  void addme();
   void copy(const iterator& other);
 
  public:
@@ -36,8 +35,6 @@ class iterator {
   object_basic* operator*() const;
   object_basic* operator->() const;
 
-  void handle_unlink(const inst_iter* dead);
-
   iterator& operator++();
   iterator operator++(int);
   iterator& operator--();
@@ -52,8 +49,6 @@ class iterator {
   iterator(object_basic*);
   iterator();
 
-  ~iterator();
-
   class with;
 };
 
@@ -62,7 +57,6 @@ class iterator::with : iterator, iterator_level {
   with(const iterator& push) : iterator(push), iterator_level(it) {}
 };
 
-void update_iterators_for_destroy(const inst_iter*);
 iterator instance_list_first();
 iterator fetch_inst_iter_by_id(int id);
 iterator fetch_inst_iter_by_int(int x);
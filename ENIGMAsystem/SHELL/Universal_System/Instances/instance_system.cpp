@@ -17,6 +17,7 @@
 *** with this code. If not, see <http://www.gnu.org/licenses/>
 **/
 
+#include <algorithm>
 #include <map>
 #include <deque>
 #include <set>
@@ -40,8 +41,8 @@ namespace enigma_user {
 namespace enigma
 {
   inst_iter::inst_iter(object_basic* i,inst_iter *n = NULL,inst_iter *p = NULL):
-      inst(i), next(n), prev(p) {}
-  inst_iter::inst_iter() {}
+      inst(i), next(n), prev(p), dead(false) {}
+  inst_iter::inst_iter(): dead(false) {}
 
   objectid_base::objectid_base(): inst_iter(NULL,NULL,this), count(0) {}
   event_iter::event_iter(string n): inst_iter(NULL,NULL,this), name(n) {}
@@ -51,16 +52,53 @@ namespace enigma
   /*------ New iterator system -----------------------------------------------*\
   \*--------------------------------------------------------------------------*/
 
-  set<iterator*> central_iterator_cache;
-  typedef set<iterator*>::iterator central_iterator_cache_iterator;
+  /*------ Node storage ------------------------------------------------------*\
+  \*--------------------------------------------------------------------------*/
 
-  object_basic* iterator::operator*()  const { return it->inst; }
-  object_basic* iterator::operator->() const { return it->inst; }
+  inst_iter *inst_iter_pool::alloc(object_basic* inst, inst_iter *n, inst_iter *p)
+  {
+    inst_iter *node;
+    if (free_list) {
+      node = free_list;
+      free_list = node->next;
+    } else {
+      if (chunk_used == chunk_size) {
+        // Grow geometrically so small lists stay small, but cap the chunk so
+        // a huge list doesn't demand one enormous contiguous block.
+        chunk_size = chunk_size ? std::min<size_t>(chunk_size * 2, 4096) : 16;
+        chunks.emplace_back(new inst_iter[chunk_size]);
+        chunk_used = 0;
+      }
+      node = &chunks.back()[chunk_used++];
+    }
+    node->inst = inst;
+    node->next = n;
+    node->prev = p;
+    node->dead = false;
+    return node;
+  }
+
+  void inst_iter_pool::release(inst_iter *node)
+  {
+    node->next = free_list;
+    free_list = node;
+  }
+
+  // Unlinked nodes are not released right away. They are marked dead and keep
+  // their next/prev pointers, so anything still standing on one can step off
+  // of it with next_alive(). They go back to their pool in
+  // dispose_destroyed_instances, once no event loop or iterator can hold them.
+  static vector<pair<inst_iter*, inst_iter_pool*> > tombstones;
 
-  void iterator::addme() {
-    central_iterator_cache.insert(this);
+  static inline void tombstone(inst_iter* which, inst_iter_pool* pool) {
+    if (which->dead) return;
+    which->dead = true;
+    tombstones.push_back(make_pair(which, pool));
   }
 
+  object_basic* iterator::operator*()  const { return it->inst; }
+  object_basic* iterator::operator->() const { return it->inst; }
+
   void iterator::copy(const iterator& other) {
     // If the other pointer indicates its own temporary object, copy
     // it into our temporary object and point to ours, instead.
@@ -69,39 +107,29 @@ namespace enigma
       it = &temp_iter;
     } else {
       // Otherwise, assume the pointer is from one of the global lists.
-      // Registering ourself with the central iterator list will handle
-      // memory management caveats, for us.
+      // Nodes on those lists are tombstoned rather than freed when unlinked,
+      // so the pointer stays valid until dispose_destroyed_instances.
       it = other.it;
     }
   }
 
-  void iterator::handle_unlink(const inst_iter *dead) {
-    if (it) {
-      if (it->next == dead) {
-        it->next = dead->next;
-      } else if (it->prev == dead) {
-        it->prev = dead->prev;
-      }
-    }
-  }
-
   iterator::operator bool() { return it; }
   iterator &iterator::operator++() {
-    it = it->next;
+    it = it->next_alive();
     return *this;
   }
   iterator  iterator::operator++(int) {
     iterator ret(*this);
-    it = it->next;
+    it = it->next_alive();
     return ret;
   }
   iterator &iterator::operator--() {
-    it = it->prev;
+    it = it->prev_alive();
     return *this;
   }
   iterator  iterator::operator--(int) {
     iterator ret(*this);
-    it = it->prev;
+    it = it->prev_alive();
     return ret;
   }
 
@@ -120,34 +148,15 @@ namespace enigma
     return *this;
   }
 
-  // Always add ourself to the central iterator cache, because future
-  // assignment could cause us to point to something deleteable
-  iterator::iterator(): it(NULL) {
-    addme();
-  }
+  // Construction is just a pointer copy; destroy-safety comes from the
+  // tombstoned nodes, not from tracking live iterators.
+  iterator::iterator(): it(NULL) {}
   iterator::iterator(const iterator& other) {
     copy(other);
-    addme();
-  }
-  iterator::iterator(inst_iter* iter): it(iter) {
-    addme();
   }
+  iterator::iterator(inst_iter* iter): it(iter) {}
   iterator::iterator(object_basic* ob):
-      temp_iter(ob, NULL, NULL), it(&temp_iter) {
-    addme();
-  }
-
-  iterator:: ~iterator() {
-    central_iterator_cache.erase(this);
-  }
-
-  void update_iterators_for_destroy(const inst_iter* dd)
-  {
-    for (central_iterator_cache_iterator it = central_iterator_cache.begin();
-         it != central_iterator_cache.end(); ++it) {
-      (*it)->handle_unlink(dd);
-    }
-  }
+      temp_iter(ob, NULL, NULL), it(&temp_iter) {}
 
 
   /*------Iterator methods ---------------------------------------------------*\
@@ -155,7 +164,7 @@ namespace enigma
 
   inst_iter *event_iter::add_inst(object_basic* ninst)
   {
-    inst_iter *a = new inst_iter(ninst,NULL,prev);
+    inst_iter *a = pool.alloc(ninst,NULL,prev);
     if (prev) prev->next = a; // If we have a final item, set its next node to this item.
     else next = a; // Otherwise, set our first item to this item.
     return prev = a; // Either way, our last item is this item now.
@@ -167,12 +176,12 @@ namespace enigma
     if (which->next) which->next->prev = which->prev;
     if (prev == which) prev = which->prev; // If our last item is this, decrement our last item.
     if (next == which) next = NULL; // If our first item is this, we have no item.
-    update_iterators_for_destroy(which);
+    tombstone(which, &pool);
   }
 
   inst_iter *objectid_base::add_inst(object_basic* ninst)
   {
-    inst_iter *a = new inst_iter(ninst,NULL,prev);
+    inst_iter *a = pool.alloc(ninst,NULL,prev);
     if (prev) prev->next = a;
     else next = a;
     return prev = a;
@@ -185,7 +194,7 @@ namespace enigma
     objectid_base *a = objects + oid;
     if (a->prev == which) a->prev = which->prev;
     a->count--;
-    update_iterators_for_destroy(which);
+    tombstone(which, &a->pool);
   }
 
   /* **  Variables ** */
@@ -196,9 +205,13 @@ namespace enigma
   objectid_base *objects;
 
   // This is the all-inclusive, centralized list of instances.
-  map<int,inst_iter*> instance_list;
-  map<int,object_basic*> instance_deactivated_list;
-  typedef map<int,inst_iter*>::iterator iliter;
+  // Its nodes are also threaded together in ID order, starting at instance_list_head.
+  instance_id_table<inst_iter*> instance_list;
+  instance_id_table<object_basic*> instance_deactivated_list;
+  static inst_iter_pool instance_list_pool;
+  static inst_iter *instance_list_head = NULL;
+  unsigned long instance_link_count = 0;
+  void (*instance_changed_hook)(object_basic*) = NULL;
   typedef pair<int,inst_iter*> inode_pair;
 
 
@@ -220,10 +233,12 @@ namespace enigma
       : oiter(instance_event_iterator),
         prev_other(instance_other),
         niter(ninst, NULL, NULL) {
+    if (oiter) note_instance_changed(oiter->inst);
     instance_event_iterator = &niter;
     instance_other = ninst;
   }
   temp_event_scope::~temp_event_scope() {
+    note_instance_changed(niter.inst);
     instance_event_iterator = oiter;
     instance_other = prev_other;
   }
@@ -232,8 +247,7 @@ namespace enigma
   // Retrieve the first instance on the complete list.
   iterator instance_list_first()
   {
-    iliter a = instance_list.begin();
-    return a != instance_list.end() ? a->second : NULL;
+    return instance_list_head;
   }
 
   extern size_t object_idmax;
@@ -256,13 +270,13 @@ namespace enigma
     if (x < 100000)
       return size_t(x) < object_idmax ? objects[x].next ? objects[x].next->inst : NULL : NULL;
 
-    iliter a = instance_list.find(x);
-    return a != instance_list.end() ? a->second->inst : NULL;
+    inst_iter *a = instance_list.get(x);
+    return a ? a->inst : NULL;
   }
   object_basic* fetch_instance_by_id(int x)
   {
-    iliter a = instance_list.find(x);
-    return a != instance_list.end() ? a->second->inst : NULL;
+    inst_iter *a = instance_list.get(x);
+    return a ? a->inst : NULL;
   }
 
   iterator fetch_inst_iter_by_int(int x)
@@ -284,16 +298,16 @@ namespace enigma
       return objects[x].next;
 
     // ID-based lookup
-    iliter a = instance_list.find(x);
-    return a != instance_list.end() ? iterator(a->second->inst) : iterator();
+    inst_iter *a = instance_list.get(x);
+    return a ? iterator(a->inst) : iterator();
   }
   iterator fetch_inst_iter_by_id(int x)
   {
     if (x < 100000)
       return iterator();
 
-    iliter a = instance_list.find(x);
-    return a != instance_list.end() ? iterator(a->second->inst) : iterator();
+    inst_iter *a = instance_list.get(x);
+    return a ? iterator(a->inst) : iterator();
   }
 
   iterator fetch_roominst_iter_by_id(int x)
@@ -302,51 +316,40 @@ namespace enigma
       return iterator();
 
     //Check if it's a deactivated instance first.
-    std::map<int,enigma::object_basic*>::iterator rIt = enigma::instance_deactivated_list.find(x);
-    if (rIt!=enigma::instance_deactivated_list.end()) {
-      return iterator(rIt->second);
+    if (object_basic *deactivated = instance_deactivated_list.get(x)) {
+      return iterator(deactivated);
     }
 
     //Else, it's still live (or was null). Use normal dispatch.
     return fetch_inst_iter_by_id(x);
   }
 
-  // Implementation for frontend
-  // (Wrapper struct to lower compile time)
-  typedef struct winstance_list_iterator {
-    instance_list_iterator w;
-    winstance_list_iterator(instance_list_iterator n): w(n) {}
-  } *pinstance_list_iterator;
-  void winstance_list_iterator_delete(pinstance_list_iterator whop) {
-    delete whop;
-  }
-
   //Link in an instance
   pinstance_list_iterator link_instance(object_basic* who)
   {
-    inst_iter *ins = new inst_iter(who);
+    inst_iter *ins = instance_list_pool.alloc(who, NULL, NULL);
     enigma_user::instance_id.push_back(who->id);
-    pair<iliter,bool> it = instance_list.insert(inode_pair(who->id,ins));
+    pair<instance_list_iterator,bool> it = instance_list.insert(inode_pair(who->id,ins));
     if (!it.second) {
-      delete ins;
-      return new winstance_list_iterator(it.first);
+      instance_list_pool.release(ins);
+      return it.first->second;
     }
-    if (it.first != instance_list.begin())
+    // New IDs are almost always the largest, so this is usually the tail.
+    if (inst_iter *ib = instance_list.find_before(who->id))
     {
-      iliter ib = it.first; ib--; // Find the previous iterator
-      ins->prev = ib->second; // Link this to previous instance
-      ib->second->next = ins; // Link previous instance to this
+      ins->prev = ib; // Link this to previous instance
+      ins->next = ib->next; // Link this to next instance
+      ib->next = ins; // Link previous instance to this
     }
-    else ins->prev = NULL; // Found nothing.
-
-    iliter in = it.first; in++; // Find next iterator
-    if (in != instance_list.end())
+    else
     {
-      ins->next = in->second, // Link this to next instance
-      in->second->prev = ins; // Link next to this
+      ins->prev = NULL; // Found nothing; we're the new head.
+      ins->next = instance_list_head;
+      instance_list_head = ins;
     }
-    else ins->next = NULL;
-    return new winstance_list_iterator(it.first);
+    if (ins->next) ins->next->prev = ins; // Link next to this
+    ++instance_link_count;
+    return ins;
   }
   inst_iter *link_obj_instance(object_basic* who, int oid)
   {
@@ -364,21 +367,16 @@ namespace enigma
     for (set<object_basic*>::iterator i = cleanups.begin(); i != cleanups.end(); i++)
       delete (*i);
     cleanups.clear();
+    for (const auto &dead : tombstones)
+      dead.second->release(dead.first);
+    tombstones.clear();
   }
-  void unlink_main(instance_list_iterator who)
-  {
-    inst_iter *a = who->second;
-    if (a->prev) a->prev->next = a->next;
-    if (a->next) a->next->prev = a->prev;
-    instance_list.erase(who);
-    update_iterators_for_destroy(a);
-  }
-  void unlink_main(pinstance_list_iterator whop)
+  void unlink_main(pinstance_list_iterator a)
   {
-    inst_iter *a = whop->w->second;
     if (a->prev) a->prev->next = a->next;
+    else instance_list_head = a->next;
     if (a->next) a->next->prev = a->prev;
-    instance_list.erase(whop->w);
-    update_iterators_for_destroy(a);
+    instance_list.erase(a->inst->id);
+    tombstone(a, &instance_list_pool);
   }
 }
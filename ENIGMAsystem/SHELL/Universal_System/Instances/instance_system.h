@@ -23,20 +23,23 @@
 #define ENIGMA_INSTANCE_SYSTEM_H
 
 #include "instance_iterator.h"
+#include "instance_id_table.h"
 #include "Universal_System/Object_Tiers/object.h"
 #include "Universal_System/reflexive_types.h"
 #include "Universal_System/var4.h"
 
-#include <map>
 #include <set>
 
 namespace enigma {
 
-typedef std::map<int, inst_iter*>::iterator instance_list_iterator;
-extern std::map<int, inst_iter*> instance_list;
-extern std::map<int, object_basic*> instance_deactivated_list;
+typedef instance_id_table<inst_iter*>::iterator instance_list_iterator;
+typedef instance_id_table<object_basic*>::iterator instance_deactivated_list_iterator;
+extern instance_id_table<inst_iter*> instance_list;
+extern instance_id_table<object_basic*> instance_deactivated_list;
 extern std::set<object_basic*> cleanups;
-void unlink_main(instance_list_iterator who);
+// Bumped whenever an instance is created or reactivated into instance_list,
+// so caches keyed on the live set can tell when they've missed someone.
+extern unsigned long instance_link_count;
 
 }  //namespace enigma
 
@@ -20,20 +20,72 @@
 #define INSTANCE_SYSTEM_BASE_h
 
 #include "Universal_System/Object_Tiers/object.h"
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace enigma
 {
   typedef variant instance_t;
 
+  // Told about each instance whose variables user code may just have changed:
+  // event loops and with() report an instance as they step off of it, entering
+  // or leaving an iterator_level or temp_event_scope reports the instance it
+  // leaves, and dot access reports the one it reaches into. Set by systems that keep state
+  // derived from instance variables (the collision broad phase); NULL while
+  // nobody is listening.
+  extern void (*instance_changed_hook)(object_basic*);
+  inline void note_instance_changed(object_basic *inst) {
+    if (instance_changed_hook && inst) instance_changed_hook(inst);
+  }
+
   struct inst_iter
   {
     object_basic* inst;     // Inst is first member for non-arithmetic dereference
     inst_iter *next, *prev; // Double linked for active removal
-    bool dead;              // Whether or not this instance has been destroyed. Should be accessed rarely.
+    bool dead;              // Whether this node has been unlinked; dead nodes keep their links until disposal.
     //std::deque<inst_iter*>::iterator instance_id_index;
     inst_iter(object_basic* i,inst_iter *n,inst_iter *p);
     inst_iter();
+
+    // Step over any nodes unlinked since we last moved. Iterators standing on
+    // a dead node can still walk off of it this way, which is what keeps
+    // destroying instances mid-iteration safe.
+    inst_iter *next_alive() const {
+      inst_iter *n = next;
+      while (n && n->dead) n = n->next;
+      return n;
+    }
+    // next_alive() for loops that ran the instance's code before moving on.
+    inst_iter *next_after_code() const {
+      note_instance_changed(inst);
+      return next_alive();
+    }
+    inst_iter *prev_alive() const {
+      inst_iter *p = prev;
+      while (p && p->dead) p = p->prev;
+      return p;
+    }
+  };
+
+  // Slab allocator for inst_iter nodes. Each instance list owns one, so the
+  // nodes of a list are carved from the same chunks in the order they were
+  // linked and walking an event list mostly touches neighbouring memory.
+  // Released nodes are kept on a free list (threaded through `next`) and
+  // handed out again before any new chunk is allocated.
+  class inst_iter_pool
+  {
+    std::vector<std::unique_ptr<inst_iter[]>> chunks;
+    inst_iter *free_list = NULL;
+    size_t chunk_used = 0, chunk_size = 0;
+
+    public:
+    inst_iter *alloc(object_basic* inst, inst_iter *next, inst_iter *prev);
+    void release(inst_iter *node);
+
+    inst_iter_pool() {}
+    inst_iter_pool(const inst_iter_pool&) = delete;
+    inst_iter_pool &operator=(const inst_iter_pool&) = delete;
   };
 
   class temp_event_scope
@@ -54,6 +106,7 @@ namespace enigma
     // Inherits inst_iter *next:    First of instances for which to perform this event (Can be NULL)
     // Inherits inst_iter *prev:    The last instance for which to perform it. (Can be NULL)
     std::string name; // Event name
+    inst_iter_pool pool; // Storage for this list's nodes
     inst_iter *add_inst(object_basic* inst);  // Append an instance to the list
     void unlink(inst_iter*);
     event_iter(std::string name);
@@ -67,6 +120,7 @@ namespace enigma
     // Inherits inst_iter *next:    First of instances for which to perform this event (Can be NULL)
     // Inherits inst_iter *prev:    The last instance for which to perform it. (Can be NULL)
     size_t count;     // Number of instances on this list
+    inst_iter_pool pool; // Storage for this list's nodes
     inst_iter *add_inst(object_basic* inst);  // Append an instance to the list
     objectid_base();
   };
@@ -85,12 +139,14 @@ namespace enigma
     object_basic* stored_other;
     iterator_level(inst_iter* push_to, object_basic* push_other):
         stored_it(instance_event_iterator), stored_other(instance_other) {
+      if (instance_event_iterator) note_instance_changed(instance_event_iterator->inst);
       instance_event_iterator = push_to;
       instance_other = push_other;
     }
     iterator_level(inst_iter* push_to):
         iterator_level(push_to, instance_event_iterator->inst) {}
     ~iterator_level() {
+      if (instance_event_iterator) note_instance_changed(instance_event_iterator->inst);
       instance_event_iterator = stored_it;
       instance_other = stored_other;
     }
@@ -29,13 +29,14 @@
 #define ENIGMA_INSTANCE_SYSTEM_FRONTEND_H
 
 #include "instance_system_base.h"
+#include "instance_id_table.h"
 
 namespace enigma
 {
-  
-// This is an iterator typedef for use with the red-black backbone of the instance list.
-typedef struct winstance_list_iterator *pinstance_list_iterator;
-void winstance_list_iterator_delete(pinstance_list_iterator);
+
+// An instance's node on the main instance list, which links instances in ID order.
+typedef inst_iter *pinstance_list_iterator;
+extern instance_id_table<object_basic*> instance_deactivated_list;
 
 // Linking
 pinstance_list_iterator link_instance(object_basic* who);
@@ -25,95 +25,72 @@
 #include "Universal_System/math_consts.h"
 #include "Universal_System/Resources/sprites.h"
 #include "Universal_System/Resources/sprites_internal.h"
+#include "Universal_System/snapshot.h"
 
 #include <cmath>
 #include <floatcomp.h>
 
-using enigma_user::sprite_get_bbox_right_relative;
-using enigma_user::sprite_get_bbox_left_relative;
-using enigma_user::sprite_get_bbox_top_relative;
-using enigma_user::sprite_get_bbox_bottom_relative;
 
 namespace enigma
 {
-    int object_collisions::$bbox_left() const
+    const world_bbox& object_collisions::$bbox_world() const
     {
+        const Sprite& spr = sprites.get(mask_index >= 0 ? mask_index : sprite_index);
+        const int left = spr.bbox.left() - spr.xoffset, top = spr.bbox.top() - spr.yoffset,
+                  right = spr.bbox.right() - spr.xoffset, bottom = spr.bbox.bottom() - spr.yoffset;
+
+        world_bbox_cache &c = $bbox_cache;
+        if (c.valid && c.x == x && c.y == y && c.xscale == image_xscale && c.yscale == image_yscale && c.angle == image_angle &&
+            c.rel_left == left && c.rel_top == top && c.rel_right == right && c.rel_bottom == bottom)
+            return c.box;
+
+        c.x = x; c.y = y;
+        c.xscale = image_xscale; c.yscale = image_yscale; c.angle = image_angle;
+        c.rel_left = left; c.rel_top = top; c.rel_right = right; c.rel_bottom = bottom;
+        c.valid = true;
+
+        const bool xsp = (image_xscale >= 0), ysp = (image_yscale >= 0);
+        const double lsc = left*image_xscale, rsc = (right+1)*image_xscale-1, tsc = top*image_yscale, bsc = (bottom+1)*image_yscale-1;
         if (fzero(image_angle))
-            return (image_xscale >= 0) ?
-                   ((mask_index >= 0 ? sprite_get_bbox_left_relative(mask_index)*image_xscale : (sprite_index >= 0 ? sprite_get_bbox_left_relative(sprite_index)*image_xscale : 0)) + x + .5) :
-                   ((mask_index >= 0 ? (sprite_get_bbox_right_relative(mask_index) + 1)*image_xscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_right_relative(sprite_index) + 1)*image_xscale - 1: 0)) + x + .5);
+        {
+            c.box.left   = (xsp ? lsc : rsc) + x + .5;
+            c.box.right  = (xsp ? rsc : lsc) + x + .5;
+            c.box.top    = (ysp ? tsc : bsc) + y + .5;
+            c.box.bottom = (ysp ? bsc : tsc) + y + .5;
+            return c.box;
+        }
 
         const double arad = image_angle*(M_PI/180.0);
+        const double sina = sin(arad), cosa = cos(arad);
         const int quad = int(fmod(fmod(image_angle, 360) + 360, 360)/90.0);
-        double w, h;
-        w = ((image_xscale >= 0)^(quad == 1 || quad == 2)) ?
-            (mask_index >= 0 ? sprite_get_bbox_left_relative(mask_index)*image_xscale : (sprite_index >= 0 ? sprite_get_bbox_left_relative(sprite_index)*image_xscale : 0)) :
-            (mask_index >= 0 ? (sprite_get_bbox_right_relative(mask_index) + 1)*image_xscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_right_relative(sprite_index) + 1)*image_xscale - 1: 0));
-        h = ((image_yscale >= 0)^(quad == 2 || quad == 3)) ?
-            (mask_index >= 0 ? sprite_get_bbox_top_relative(mask_index)*image_yscale : (sprite_index >= 0 ? sprite_get_bbox_top_relative(sprite_index)*image_yscale : 0)) :
-            (mask_index >= 0 ? (sprite_get_bbox_bottom_relative(mask_index) + 1)*image_yscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_bottom_relative(sprite_index) + 1)*image_yscale - 1: 0));
-
-        return cos(arad)*w + sin(arad)*h + x + .5;
+        const bool q12 = (quad == 1 || quad == 2), q23 = (quad == 2 || quad == 3),
+                   xs12 = xsp^q12, xs23 = xsp^q23, ys12 = ysp^q12, ys23 = ysp^q23;
+
+        c.box.left   = cosa*(xs12 ? lsc : rsc) + sina*(ys23 ? tsc : bsc) + x + .5;
+        c.box.right  = cosa*(xs12 ? rsc : lsc) + sina*(ys23 ? bsc : tsc) + x + .5;
+        c.box.top    = cosa*(ys12 ? tsc : bsc) - sina*(xs23 ? rsc : lsc) + y + .5;
+        c.box.bottom = cosa*(ys12 ? bsc : tsc) - sina*(xs23 ? lsc : rsc) + y + .5;
+        return c.box;
     }
 
-    int object_collisions::$bbox_right() const
+    int object_collisions::$bbox_left() const
     {
-        if (fzero(image_angle))
-            return (image_xscale >= 0) ?
-                   ((mask_index >= 0 ? (sprite_get_bbox_right_relative(mask_index) + 1)*image_xscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_right_relative(sprite_index) + 1)*image_xscale - 1: 0)) + x + .5) :
-                   ((mask_index >= 0 ? sprite_get_bbox_left_relative(mask_index)*image_xscale : (sprite_index >= 0 ? sprite_get_bbox_left_relative(sprite_index)*image_xscale : 0)) + x + .5);
+        return (mask_index >= 0 || sprite_index >= 0) ? $bbox_world().left : int(x + .5);
+    }
 
-        const double arad = image_angle*(M_PI/180.0);
-        const int quad = int(fmod(fmod(image_angle, 360) + 360, 360)/90.0);
-        double w, h;
-        w = ((image_xscale >= 0)^(quad == 1 || quad == 2)) ?
-            (mask_index >= 0 ? (sprite_get_bbox_right_relative(mask_index) + 1)*image_xscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_right_relative(sprite_index) + 1)*image_xscale - 1: 0)) :
-            (mask_index >= 0 ? sprite_get_bbox_left_relative(mask_index)*image_xscale : (sprite_index >= 0 ? sprite_get_bbox_left_relative(sprite_index)*image_xscale : 0));
-        h = ((image_yscale >= 0)^(quad == 2 || quad == 3)) ?
-            (mask_index >= 0 ? (sprite_get_bbox_bottom_relative(mask_index) + 1)*image_yscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_bottom_relative(sprite_index) + 1)*image_yscale - 1: 0)) :
-            (mask_index >= 0 ? sprite_get_bbox_top_relative(mask_index)*image_yscale : (sprite_index >= 0 ? sprite_get_bbox_top_relative(sprite_index)*image_yscale : 0));
-
-        return cos(arad)*w + sin(arad)*h + x + .5;
+    int object_collisions::$bbox_right() const
+    {
+        return (mask_index >= 0 || sprite_index >= 0) ? $bbox_world().right : int(x + .5);
     }
 
     int object_collisions::$bbox_top() const
     {
-        if (fzero(image_angle))
-            return (image_yscale >= 0) ?
-                ((mask_index >= 0 ? sprite_get_bbox_top_relative(mask_index)*image_yscale : (sprite_index >= 0 ? sprite_get_bbox_top_relative(sprite_index)*image_yscale : 0)) + y + .5):
-                ((mask_index >= 0 ? (sprite_get_bbox_bottom_relative(mask_index) + 1)*image_yscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_bottom_relative(sprite_index) + 1)*image_yscale - 1: 0)) + y + .5);
-
-        const double arad = image_angle*(M_PI/180.0);
-        const int quad = int(fmod(fmod(image_angle, 360) + 360, 360)/90.0);
-        double w, h;
-        w = ((image_xscale >= 0)^(quad == 2 || quad == 3)) ?
-            (mask_index >= 0 ? (sprite_get_bbox_right_relative(mask_index) + 1)*image_xscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_right_relative(sprite_index) + 1)*image_xscale - 1: 0)) :
-            (mask_index >= 0 ? sprite_get_bbox_left_relative(mask_index)*image_xscale : (sprite_index >= 0 ? sprite_get_bbox_left_relative(sprite_index)*image_xscale : 0));
-        h = ((image_yscale >= 0)^(quad == 1 || quad == 2)) ?
-            (mask_index >= 0 ? sprite_get_bbox_top_relative(mask_index)*image_yscale : (sprite_index >= 0 ? sprite_get_bbox_top_relative(sprite_index)*image_yscale : 0)) :
-            (mask_index >= 0 ? (sprite_get_bbox_bottom_relative(mask_index) + 1)*image_yscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_bottom_relative(sprite_index) + 1)*image_yscale - 1: 0));
-
-        return cos(arad)*h -sin(arad)*w + y + .5;
+        return (mask_index >= 0 || sprite_index >= 0) ? $bbox_world().top : int(y + .5);
     }
 
     int object_collisions::$bbox_bottom() const
     {
-        if (fzero(image_angle))
-            return (image_yscale >= 0) ?
-                ((mask_index >= 0 ? (sprite_get_bbox_bottom_relative(mask_index) + 1)*image_yscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_bottom_relative(sprite_index) + 1)*image_yscale - 1: 0)) + y + .5) :
-                ((mask_index >= 0 ? sprite_get_bbox_top_relative(mask_index)*image_yscale : (sprite_index >= 0 ? sprite_get_bbox_top_relative(sprite_index)*image_yscale : 0)) + y + .5);
-
-        const double arad = image_angle*(M_PI/180.0);
-        const int quad = int(fmod(fmod(image_angle, 360) + 360, 360)/90.0);
-        double w, h;
-        w = ((image_xscale >= 0)^(quad == 2 || quad == 3)) ?
-            (mask_index >= 0 ? sprite_get_bbox_left_relative(mask_index)*image_xscale : (sprite_index >= 0 ? sprite_get_bbox_left_relative(sprite_index)*image_xscale : 0)) :
-            (mask_index >= 0 ? (sprite_get_bbox_right_relative(mask_index) + 1)*image_xscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_right_relative(sprite_index) + 1)*image_xscale - 1: 0));
-        h = ((image_yscale >= 0)^(quad == 1 || quad == 2)) ?
-            (mask_index >= 0 ? (sprite_get_bbox_bottom_relative(mask_index) + 1)*image_yscale - 1 : (sprite_index >= 0 ? (sprite_get_bbox_bottom_relative(sprite_index) + 1)*image_yscale - 1: 0)) :
-            (mask_index >= 0 ? sprite_get_bbox_top_relative(mask_index)*image_yscale : (sprite_index >= 0 ? sprite_get_bbox_top_relative(sprite_index)*image_yscale : 0));
-
-        return cos(arad)*h - sin(arad)*w + y + .5;
+        return (mask_index >= 0 || sprite_index >= 0) ? $bbox_world().bottom : int(y + .5);
     }
 
     const BoundingBox object_collisions::$bbox_relative() const
@@ -139,4 +116,18 @@ namespace enigma
     }
 
     object_collisions::~object_collisions() {}
+
+    void object_collisions::$snapshot(snapshot_io &io) {
+        object_transform::$snapshot(io);
+        io(mask_index);
+        io(solid);
+        io(polygon_index);
+        io(polygon_xscale);
+        io(polygon_yscale);
+        io(polygon_angle);
+        if (io.loading()) {
+            $bbox_cache.valid = false;
+            $polygon_cache.reset();
+        }
+    }
 }
@@ -37,8 +37,31 @@
 #include "transform_object.h"
 #include "Universal_System/Resources/sprites_internal.h" //bbox_rect
 
+#include <memory>
+
 namespace enigma
 {
+  // An instance's mask box in room coordinates, edges inclusive.
+  struct world_bbox {
+    int left, top, right, bottom;
+  };
+
+  // The last world box computed for an instance, along with everything it was
+  // computed from. There's no hook on writes to x, y and friends, so instead of
+  // a dirty flag the inputs are compared on each use; that's a handful of
+  // compares against the sin/cos/fmod it saves for a resting instance.
+  struct world_bbox_cache {
+    cs_scalar x, y;
+    gs_scalar xscale, yscale, angle;
+    int rel_left, rel_top, rel_right, rel_bottom;
+    bool valid = false;
+    world_bbox box;
+  };
+
+  // Room-space copy of an instance's polygon, kept by collision systems that
+  // use polygons. Defined alongside the code that fills it in.
+  struct polygon_world_cache;
+
   struct object_collisions: object_transform
   {
     // Bit Mask
@@ -60,16 +83,26 @@ namespace enigma
         int $bbox_bottom() const;
         const BoundingBox $bbox_relative() const;
         const BoundingBox& $bbox() const;
+        // World box of the sprite/mask at the instance's current transform.
+        // Only meaningful if the instance has a sprite or mask.
+        const world_bbox& $bbox_world() const;
         #define bbox_left   $bbox_left()
         #define bbox_right  $bbox_right()
         #define bbox_top    $bbox_top()
         #define bbox_bottom $bbox_bottom()
+
+        //Cached geometry; see world_bbox_cache.
+        mutable world_bbox_cache $bbox_cache;
+        mutable std::shared_ptr<polygon_world_cache> $polygon_cache;
       #endif
-      
+
     //Constructors
       object_collisions();
       object_collisions(unsigned, int);
       virtual ~object_collisions();
+      #ifndef JUST_DEFINE_IT_RUN
+      virtual void $snapshot(snapshot_io &io);
+      #endif
   };
 } //namespace enigma
 
@@ -23,6 +23,7 @@
 
 #include "Universal_System/depth_draw.h"
 #include "graphics_object.h"
+#include "Universal_System/snapshot.h"
 
 #include <math.h>
 #include <floatcomp.h>
@@ -39,8 +40,26 @@ namespace enigma
   }
   object_graphics::~object_graphics() {}
 
+  void object_graphics::$snapshot(snapshot_io &io) {
+    object_timelines::$snapshot(io);
+    io(sprite_index);
+    io(image_index);
+    io(image_speed);
+    io(image_single);
+    // Depth goes through assignment on load so the instance moves to the
+    // right draw list.
+    variant d = depth;
+    io(d);
+    if (io.loading()) depth = d;
+    io(visible);
+    io(image_xscale);
+    io(image_yscale);
+    io(image_angle);
+  }
+
   variant object_graphics::myevent_draw()      { return 0; }
   bool object_graphics::myevent_draw_subcheck() { return 0; }
+  bool object_graphics::myevent_draw_is_default() { return 0; }
   variant object_graphics::myevent_drawgui()   { return 0; }
   bool object_graphics::myevent_drawgui_subcheck() { return 0; }
   variant object_graphics::myevent_drawresize()   { return 0; }
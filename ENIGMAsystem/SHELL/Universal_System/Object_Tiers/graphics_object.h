@@ -70,6 +70,9 @@ namespace enigma
 
       virtual variant myevent_draw();
       virtual bool myevent_draw_subcheck();
+      // True when the object has no Draw event of its own and just draws its
+      // sprite, so its sprite's box bounds what it draws.
+      virtual bool myevent_draw_is_default();
       virtual variant myevent_drawgui();
       virtual bool myevent_drawgui_subcheck();
       virtual variant myevent_drawresize();
@@ -96,6 +99,9 @@ namespace enigma
       object_graphics();
       object_graphics(unsigned x, int y);
       virtual ~object_graphics();
+      #ifndef JUST_DEFINE_IT_RUN
+      virtual void $snapshot(snapshot_io &io);
+      #endif
   };
 } //namespace enigma
 
@@ -33,6 +33,7 @@
 #include <string>
 #include <vector>
 #include "Universal_System/Resources/AssetArray.h"
+#include "Universal_System/snapshot.h"
 
 namespace enigma
 {
@@ -43,9 +44,8 @@ namespace enigma
     #ifdef DEBUG_MODE
       using enigma_user::show_error;
       static inline int DEBUG_ID_CHECK(int id, int objind) {
-        std::map<int, inst_iter*>::iterator it = instance_list.find(id);
-        if (it != instance_list.end()) {
-          DEBUG_MESSAGE("Two instances were given the same ID! Object `" + enigma_user::object_get_name(it->second->inst->object_index)
+        if (inst_iter *it = instance_list.get(id)) {
+          DEBUG_MESSAGE("Two instances were given the same ID! Object `" + enigma_user::object_get_name(it->inst->object_index)
                      + "' and new object `" + enigma_user::object_get_name(objind)
                      + "' both have ID " + toString(id)
                      + "': A new ID has been assigned so the game can continue, but references by this ID may fail."
@@ -72,6 +72,7 @@ namespace enigma
     variant object_basic::myevent_roomstart()   { return 0; }
     variant object_basic::myevent_roomend()   { return 0; }
     variant object_basic::myevent_destroy()   { return 0; }
+    void object_basic::$snapshot(snapshot_io&) {}
 
     object_basic::object_basic(): id(-4), object_index(-4) {}
     object_basic::object_basic(int uid, int uoid): id(DEBUG_ID_CHECK(uid, uoid)), object_index(uoid) {}
@@ -151,6 +152,12 @@ void object_set_visible(int objid, bool val)
   enigma::objectdata[objid]->visible = val;
 }
 
+void object_set_draw_culling(int objid, bool val)
+{
+  errcheck_v(objid,"Object doesn't exist");
+  enigma::objectdata[objid]->draw_culling = val;
+}
+
 int object_get_depth(int objid)
 {
   errcheck(objid,"Object doesn't exist");
@@ -199,6 +206,12 @@ bool object_get_visible(int objid)
   return enigma::objectdata[objid]->visible;
 }
 
+int object_get_draw_culling(int objid)
+{
+  errcheck(objid,"Object doesn't exist");
+  return enigma::objectdata[objid]->draw_culling;
+}
+
 bool object_is_ancestor(int objid, int acid)
 {
   errcheck(objid,"Object doesn't exist");
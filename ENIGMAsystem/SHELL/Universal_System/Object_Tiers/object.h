@@ -51,6 +51,8 @@ namespace enigma_user {
 
 namespace enigma
 {
+    class snapshot_io;
+
     extern int maxid;
     extern int id_current;
     extern int objectcount;
@@ -74,6 +76,12 @@ namespace enigma
       virtual variant myevent_roomend();
       virtual variant myevent_destroy();
 
+      #ifndef JUST_DEFINE_IT_RUN
+      // Saves or restores this instance's variables for game_save/game_load.
+      // Each tier adds its own after its parent's; see snapshot.h.
+      virtual void $snapshot(snapshot_io &io);
+      #endif
+
       object_basic();
       object_basic(int uid, int uoid);
       virtual ~object_basic();
@@ -92,6 +100,10 @@ namespace enigma
         double mask;
         double parent;
         int id;
+        // Whether instances may be skipped when outside the view being drawn
+        // (see draw_set_view_culling): 1 yes, 0 no, -1 only those drawn by the
+        // default Draw event. Set at run time, so the compiler leaves it out.
+        int draw_culling = -1;
     };
     void objectdata_load();
     void constructor(object_basic* instance);
@@ -107,6 +119,7 @@ namespace enigma_user {
     void object_set_sprite(int objid, int val);
     void object_set_polygon(int objid, int val);
     void object_set_visible(int objid, bool val);
+    void object_set_draw_culling(int objid, bool val);
     
     int object_get_depth(int objid);
     int object_get_mask(int objid);
@@ -116,6 +129,7 @@ namespace enigma_user {
     int object_get_sprite(int objid);
     int object_get_polygon(int objid);
     bool object_get_visible(int objid);
+    int object_get_draw_culling(int objid);
     
     bool object_is_ancestor(int objid, int acid);
 }
@@ -32,6 +32,7 @@
 #include "Universal_System/reflexive_types.h"
 
 #include "planar_object.h"
+#include "Universal_System/snapshot.h"
 
 #ifdef PATH_EXT_SET
 #  include "Universal_System/Extensions/Paths/path_functions.h"
@@ -73,6 +74,21 @@ namespace enigma
   //This just needs implemented virtually so instance_destroy works.
   object_planar::~object_planar() {}
 
+  void object_planar::$snapshot(snapshot_io &io)
+  {
+    object_basic::$snapshot(io);
+    io(x); io(y);
+    io(xprevious); io(yprevious);
+    io(xstart); io(ystart);
+    #ifdef ISLOCAL_persistent
+      io(persistent);
+    #endif
+    // The motion variables are written raw; they are kept in agreement with
+    // each other, so restoring all four needs no recomputation.
+    io(direction); io(speed); io(hspeed); io(vspeed);
+    io(gravity); io(gravity_direction); io(friction);
+  }
+
   void propagate_locals(object_planar* instance)
   {
     #ifdef PATH_EXT_SET // TODO(#997): this does not belong here...
@@ -60,6 +60,9 @@ namespace enigma
       object_planar();
       object_planar(unsigned, int);
       virtual ~object_planar();
+      #ifndef JUST_DEFINE_IT_RUN
+      virtual void $snapshot(snapshot_io &io);
+      #endif
   };
 
   void propagate_locals(object_planar*);
@@ -24,6 +24,7 @@
 */
 
 #include "timelines_object.h"
+#include "Universal_System/snapshot.h"
 
 namespace enigma
 {
@@ -35,6 +36,15 @@ namespace enigma
   //This just needs implemented virtually so instance_destroy works.
   object_timelines::~object_timelines() {}
 
+  void object_timelines::$snapshot(snapshot_io &io) {
+    object_planar::$snapshot(io);
+    io(timeline_index);
+    io(timeline_running);
+    io(timeline_speed);
+    io(timeline_position);
+    io(timeline_loop);
+  }
+
   void object_timelines::advance_curr_timeline() 
   {
     //Find the next instant (it may be right now).
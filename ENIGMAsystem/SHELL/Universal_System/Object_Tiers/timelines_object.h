@@ -55,6 +55,9 @@ namespace enigma
     object_timelines();
     object_timelines(unsigned x, int y);
     virtual ~object_timelines();
+    #ifndef JUST_DEFINE_IT_RUN
+    virtual void $snapshot(snapshot_io &io);
+    #endif
 
     //Object-local timelines functionality.
     void advance_curr_timeline();
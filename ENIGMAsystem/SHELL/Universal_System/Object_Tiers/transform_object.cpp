@@ -21,10 +21,17 @@
 */
 
 #include "transform_object.h"
+#include "Universal_System/snapshot.h"
 
 namespace enigma
 {
   object_transform::object_transform(): object_graphics() {}
   object_transform::object_transform(unsigned _x, int _y): object_graphics(_x,_y) {}
   object_transform::~object_transform() {}
+
+  void object_transform::$snapshot(snapshot_io &io) {
+    object_graphics::$snapshot(io);
+    io(image_alpha);
+    io(image_blend);
+  }
 }
@@ -36,6 +36,9 @@ namespace enigma
       object_transform();
       object_transform(unsigned x, int y);
       virtual ~object_transform();
+      #ifndef JUST_DEFINE_IT_RUN
+      virtual void $snapshot(snapshot_io &io);
+      #endif
   };
 } //namespace ennigma
 
@@ -19,6 +19,8 @@
 #include "backgrounds_internal.h"
 #include "libEGMstd.h"
 #include "resinit.h"
+#include "resource_pack.h"
+#include "Universal_System/codecs.h"
 #include "Universal_System/zlib.h"
 #include "Universal_System/image_formats.h"
 #include "Universal_System/nlpo2.h"
@@ -27,7 +29,9 @@
 #include "Platforms/platforms_mandatory.h"
 #include "Platforms/General/fileio.h"
 
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 namespace enigma
 {
@@ -74,24 +78,18 @@ namespace enigma
       unsigned int size;
       if (!fread_wrapper(&size,4,1,exe)){};
       
-      unsigned char* cpixels=new unsigned char[size+1];
-      if (!cpixels)
-      {
-        DEBUG_MESSAGE("Failed to load background: Cannot allocate enough memory " + enigma_user::toString(unpacked), MESSAGE_TYPE::M_ERROR);
-        break;
-      }
-      unsigned int sz2=fread_wrapper(cpixels,1,size,exe);
-      if (size!=sz2) {
-        DEBUG_MESSAGE("Failed to load background: Data is truncated before exe end. Read " + enigma_user::toString(sz2) + " out of expected " + enigma_user::toString(size), MESSAGE_TYPE::M_ERROR);
-        return;
-      }
-      unsigned char* pixels=new unsigned char[unpacked+1];
-      if (zlib_decompress(cpixels,size,unpacked,pixels) != unpacked)
+      // Inflate straight from the file into the texture's pixels
+      unsigned char* pixels=new unsigned char[unpacked];
+      if (zlib_decompress_file(exe,size,unpacked,pixels) != unpacked)
       {
+        delete[] pixels;
+        if (feof_wrapper(exe)) {
+          DEBUG_MESSAGE("Failed to load background: Data is truncated before exe end. Expected " + enigma_user::toString(size), MESSAGE_TYPE::M_ERROR);
+          return;
+        }
         DEBUG_MESSAGE("Background load error: Background does not match expected size", MESSAGE_TYPE::M_ERROR);
         continue;
       }
-      delete[] cpixels;
 
       unsigned fw, fh;
       int texID = graphics_create_texture(RawImage(pixels, width, height), false, &fw, &fh);
@@ -99,4 +97,72 @@ namespace enigma
       backgrounds.assign(bkgid, std::move(bkg));
     }
   }
+
+  void pack_loadbackgrounds(const resource_pack &pack)
+  {
+    struct background_record {
+      int id;
+      unsigned width, height;
+      int useAsTileset, tileWidth, tileHeight, hOffset, vOffset, hSep, vSep;
+      const unsigned char *data;
+      unsigned size;
+      int codec;
+      unsigned char *pixels;
+    };
+
+    std::vector<const resource_toc_entry*> entries = pack.assets("BKG ");
+    if (entries.empty()) return;
+
+    std::vector<background_record> records(entries.size());
+    int bkg_highid = 0;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+      background_record &rec = records[i];
+      resource_cursor in(pack.at(entries[i]->offset, entries[i]->size), entries[i]->size);
+      rec.id = in.i(); rec.width = in.i(); rec.height = in.i();
+      in.i(); in.i(); in.i(); // transparent, smooth edges, preload
+      rec.useAsTileset = in.i(); rec.tileWidth = in.i(); rec.tileHeight = in.i();
+      rec.hOffset = in.i(); rec.vOffset = in.i(); rec.hSep = in.i(); rec.vSep = in.i();
+      rec.size = in.i();
+      rec.data = in.bytes(rec.size);
+      rec.codec = entries[i]->codec();
+      rec.pixels = nullptr;
+      if (!in.ok || rec.id != entries[i]->id) {
+        DEBUG_MESSAGE("Failed to load background: Record is truncated", MESSAGE_TYPE::M_ERROR);
+        rec.id = -1;
+      }
+      if (rec.id > bkg_highid) bkg_highid = rec.id;
+    }
+    backgrounds.resize(bkg_highid+1);
+
+    // Inflate a batch on every core, then make the textures on this thread
+    for (size_t first = 0; first < records.size(); first += resource_batch_size)
+    {
+      const size_t count = std::min(resource_batch_size, records.size() - first);
+      parallel_for(count, [&](size_t i) {
+        background_record &rec = records[first + i];
+        if (rec.id < 0) return;
+        const size_t unpacked = rec.width*rec.height*4;
+        rec.pixels = new unsigned char[unpacked];
+        if (!codec_decompress(rec.codec, rec.data, rec.size, rec.pixels, unpacked)) {
+          delete[] rec.pixels;
+          rec.pixels = nullptr;
+        }
+      });
+
+      for (size_t i = first; i < first + count; i++)
+      {
+        background_record &rec = records[i];
+        if (rec.id < 0) continue;
+        if (!rec.pixels) {
+          DEBUG_MESSAGE("Background load error: Background does not match expected size", MESSAGE_TYPE::M_ERROR);
+          continue;
+        }
+        unsigned fw, fh;
+        int texID = graphics_create_texture(RawImage(rec.pixels, rec.width, rec.height), false, &fw, &fh);
+        Background bkg(rec.width, rec.height, fw, fh, texID, rec.useAsTileset, rec.tileWidth, rec.tileHeight, rec.hOffset, rec.vOffset, rec.hSep, rec.vSep);
+        backgrounds.assign(rec.id, std::move(bkg));
+      }
+    }
+  }
 } //namespace enigma
@@ -125,6 +125,7 @@ void exe_loadfonts(FILE_t* exe) {
     font.texture = graphics_create_texture(RawImage(pixels, twid, thgt), false);
     font.twid = twid;
     font.thgt = thgt;
+    font.index_glyphs();
 
     sprite_fonts[fntid] = std::move(font);
 
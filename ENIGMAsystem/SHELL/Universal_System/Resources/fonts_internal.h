@@ -29,6 +29,7 @@
 #include "AssetArray.h"
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <stdint.h>
 
@@ -37,7 +38,7 @@ namespace enigma
   struct fontglyph
   {
     fontglyph() : x(0), y(0), x2(0), y2(0), tx(0), ty(0), tx2(0), ty2(0), xs(0) {}
-    bool empty();
+    bool empty() const;
     int   x,  y,  x2,  y2; // Draw coordinates, relative to the top-left corner of a full glyph. Added to xx and yy for draw.
     float tx, ty, tx2, ty2; // Texture coords: used to locate glyph on bound font texture
     float xs; // Spacing: used to increment xx
@@ -47,12 +48,19 @@ namespace enigma
     unsigned int glyphstart;
     std::vector<fontglyph> glyphs;
   };
+  // Where a code point's glyph sits in glyphRanges; range is -1 for no glyph.
+  struct fontglyphref {
+    fontglyphref() : range(-1), index(0) {}
+    fontglyphref(int r, unsigned i) : range(r), index(i) {}
+    int range;
+    unsigned index;
+  };
   class SpriteFont
   {
    public:
      SpriteFont() : name(""), fontname(""), fontsize(0),
        bold(false), italic(false), height(0), yoffset(0), texture(-1),
-       twid(0), thgt(0) {}
+       twid(0), thgt(0), revision(0) {}
     // Trivia
     std::string name, fontname;
     int fontsize; 
@@ -66,8 +74,18 @@ namespace enigma
     int texture;
     int twid, thgt;
 
+    // Glyph lookup: a direct table for ASCII and a hash for everything else,
+    // so findGlyph doesn't search the ranges. index_glyphs() rebuilds both and
+    // bumps the revision, which tells cached text layouts they're stale; call
+    // it after changing glyphRanges or any glyph in them.
+    fontglyphref asciiGlyphs[128];
+    std::unordered_map<uint32_t, fontglyphref> glyphIndex;
+    unsigned revision;
+    void index_glyphs();
+
     void destroy() { 
       glyphRanges.clear();
+      index_glyphs();
       if (texture >= 0) graphics_delete_texture(texture);
       texture = -1;
     }
@@ -89,7 +107,7 @@ namespace enigma
   extern int rawfontcount, rawfontmaxid;
   int font_new(uint32_t gs, uint32_t gc); // Creates a new font, allocating 'gc' glyphs
   int font_pack(SpriteFont *font, int spr, uint32_t gcount, bool prop, int sep);
-  fontglyph findGlyph(const SpriteFont& fnt, uint32_t character);
+  const fontglyph& findGlyph(const SpriteFont& fnt, uint32_t character);
 } //namespace enigma
 
 #endif //ENIGMA_FONTS_INTERNAL_H
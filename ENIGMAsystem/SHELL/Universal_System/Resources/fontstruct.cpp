@@ -38,10 +38,28 @@ namespace enigma
 {
   AssetArray<SpriteFont, -1> sprite_fonts;
 
-  bool fontglyph::empty() {
+  bool fontglyph::empty() const {
     return !(std::abs(x2-x) > 0 && std::abs(y2-y) > 0);
   }
 
+  static unsigned font_revisions = 0;
+
+  void SpriteFont::index_glyphs() {
+    for (fontglyphref& ref : asciiGlyphs) ref = fontglyphref();
+    glyphIndex.clear();
+    // Walk the ranges backwards so that where ranges overlap, the first one
+    // wins, as it did when findGlyph searched them in order.
+    for (size_t r = glyphRanges.size(); r--; ) {
+      const fontglyphrange& fgr = glyphRanges[r];
+      for (size_t i = 0; i < fgr.glyphs.size(); i++) {
+        const uint32_t character = fgr.glyphstart + i;
+        if (character < 128) asciiGlyphs[character] = fontglyphref(r, i);
+        else glyphIndex[character] = fontglyphref(r, i);
+      }
+    }
+    revision = ++font_revisions;
+  }
+
   int font_new(uint32_t gs, uint32_t gc) // Creates a new font, allocating 'gc' glyphs
   {
     SpriteFont ret;
@@ -51,6 +69,7 @@ namespace enigma
 
     ret.glyphRanges.push_back(fgr);
     ret.height = 0;
+    ret.index_glyphs();
 
     return sprite_fonts.add(std::move(ret));
   }
@@ -167,18 +186,24 @@ namespace enigma
       font->twid = w;
       font->thgt = h;
       font->yoffset = 0;
+      font->index_glyphs();
 
       return true;
   }
 
-fontglyph findGlyph(const SpriteFont& fnt, uint32_t character) {
-  for (size_t i = 0; i < fnt.glyphRanges.size(); i++) {
-    fontglyphrange fgr = fnt.glyphRanges[i];
-    if (character >= fgr.glyphstart && character < fgr.glyphstart + fgr.glyphs.size()) {
-      return fgr.glyphs[character - fgr.glyphstart];
-    }
+const fontglyph& findGlyph(const SpriteFont& fnt, uint32_t character) {
+  static const fontglyph none;
+  fontglyphref ref;
+  if (character < 128) {
+    ref = fnt.asciiGlyphs[character];
+  } else {
+    auto it = fnt.glyphIndex.find(character);
+    if (it == fnt.glyphIndex.end()) return none;
+    ref = it->second;
   }
-  return fontglyph();
+  if (ref.range < 0 || size_t(ref.range) >= fnt.glyphRanges.size()) return none;
+  const fontglyphrange& fgr = fnt.glyphRanges[ref.range];
+  return ref.index < fgr.glyphs.size() ? fgr.glyphs[ref.index] : none;
 }
 
 } // namespace enigma
@@ -244,6 +269,7 @@ bool font_replace(int ind, string name, int size, bool bold, bool italic, uint32
   fgr.glyphstart = first;
 
   fnt->glyphRanges.push_back(fgr);
+  fnt->index_glyphs();
 
   return true;
 }
@@ -275,42 +301,42 @@ int font_add_sprite(int spr, uint32_t first, bool prop, int sep)
 }
 
 float font_get_glyph_texture_left(int fnt, uint32_t character) {
-  const enigma::fontglyph glyph = enigma::findGlyph(sprite_fonts[fnt], character);
+  const enigma::fontglyph& glyph = enigma::findGlyph(sprite_fonts[fnt], character);
   return glyph.tx;
 }
 
 float font_get_glyph_texture_top(int fnt, uint32_t character) {
-  const enigma::fontglyph glyph = enigma::findGlyph(sprite_fonts[fnt], character);
+  const enigma::fontglyph& glyph = enigma::findGlyph(sprite_fonts[fnt], character);
   return glyph.ty;
 }
 
 float font_get_glyph_texture_right(int fnt, uint32_t character) {
-  const enigma::fontglyph glyph = enigma::findGlyph(sprite_fonts[fnt], character);
+  const enigma::fontglyph& glyph = enigma::findGlyph(sprite_fonts[fnt], character);
   return glyph.tx2;
 }
 
 float font_get_glyph_texture_bottom(int fnt, uint32_t character) {
-  const enigma::fontglyph glyph = enigma::findGlyph(sprite_fonts[fnt], character);
+  const enigma::fontglyph& glyph = enigma::findGlyph(sprite_fonts[fnt], character);
   return glyph.ty2;
 }
 
 float font_get_glyph_left(int fnt, uint32_t character) {
-  const enigma::fontglyph glyph = enigma::findGlyph(sprite_fonts[fnt], character);
+  const enigma::fontglyph& glyph = enigma::findGlyph(sprite_fonts[fnt], character);
   return glyph.x;
 }
 
 float font_get_glyph_top(int fnt, uint32_t character) {
-  const enigma::fontglyph glyph = enigma::findGlyph(sprite_fonts[fnt], character);
+  const enigma::fontglyph& glyph = enigma::findGlyph(sprite_fonts[fnt], character);
   return glyph.y;
 }
 
 float font_get_glyph_right(int fnt, uint32_t character) {
-  const enigma::fontglyph glyph = enigma::findGlyph(sprite_fonts[fnt], character);
+  const enigma::fontglyph& glyph = enigma::findGlyph(sprite_fonts[fnt], character);
   return glyph.x2;
 }
 
 float font_get_glyph_bottom(int fnt, uint32_t character) {
-  const enigma::fontglyph glyph = enigma::findGlyph(sprite_fonts[fnt], character);
+  const enigma::fontglyph& glyph = enigma::findGlyph(sprite_fonts[fnt], character);
   return glyph.y2;
 }
 
@@ -17,6 +17,7 @@
 **/
 
 #include "resinit.h"
+#include "resource_pack.h"
 #include "sprites_internal.h"
 #include "backgrounds_internal.h"
 #include "Universal_System/roomsystem.h"
@@ -31,6 +32,7 @@
 #include "Platforms/General/fileio.h"
 
 #include <ctime>
+#include <memory>
 
 namespace enigma_user
 {
@@ -47,6 +49,35 @@ namespace enigma
   extern int game_settings_initialize();
   extern void extensions_initialize();
 
+  // Loads a "res1" block. Sprites and backgrounds are found through the table
+  // of contents and inflated on every core; the other sections are read in
+  // order from where the table says they start.
+  static void load_indexed_resources(FILE_t* resfile, const char* path, int pos)
+  {
+    int toc_pos;
+    fseek_wrapper(resfile,-12,SEEK_END);
+    if (!fread_wrapper(&toc_pos,4,1,resfile)) return;
+
+    std::shared_ptr<resource_pack> pack = std::make_shared<resource_pack>();
+    if (!pack->open(path, resfile, pos, toc_pos)) {
+      DEBUG_MESSAGE("Resource load fail: resource index unreadable", MESSAGE_TYPE::M_ERROR);
+      return;
+    }
+    const auto seek_section = [&](const char* type) {
+      const resource_toc_entry* section = pack->section(type);
+      if (section) fseek_wrapper(resfile,section->offset,SEEK_SET);
+      return section != nullptr;
+    };
+
+    enigma::pack_loadsprs(pack);
+    if (seek_section("SND ")) enigma::exe_loadsounds(resfile);
+    enigma::pack_loadbackgrounds(*pack);
+    if (seek_section("FNT ")) enigma::exe_loadfonts(resfile);
+    #ifdef PATH_EXT_SET
+    if (seek_section("PTH ")) enigma::exe_loadpaths(resfile);
+    #endif
+  }
+
   //This is like main(), only cross-api
   int initialize_everything()
   {
@@ -72,6 +103,7 @@ namespace enigma
     // Open the exe for resource load
     do { // Allows break
       FILE_t* resfile;
+      std::string respath = resource_file_path;
       if (resource_file_path != std::string("$exe")) {
         if (!(resfile = fopen_wrapper(resource_file_path,"rb"))) {
           DEBUG_MESSAGE("Resource load fail: exe unopenable", MESSAGE_TYPE::M_ERROR);
@@ -80,6 +112,7 @@ namespace enigma
       } else {
         char exename[4097];
         windowsystem_write_exename(exename);
+        respath = exename;
         if (!(resfile = fopen_wrapper(exename,"rb"))) {
           DEBUG_MESSAGE("No resource data in exe", MESSAGE_TYPE::M_ERROR);
           break;
@@ -89,7 +122,7 @@ namespace enigma
       // Read the magic number so we know we're looking at our own data
       fseek_wrapper(resfile,-8,SEEK_END);
       char str_quad[4];
-      if (!fread_wrapper(str_quad,4,1,resfile) or str_quad[0] != 'r' or str_quad[1] != 'e' or str_quad[2] != 's' or str_quad[3] != '0') {
+      if (!fread_wrapper(str_quad,4,1,resfile) or str_quad[0] != 'r' or str_quad[1] != 'e' or str_quad[2] != 's' or (str_quad[3] != '0' and str_quad[3] != '1')) {
         DEBUG_MESSAGE("No resource data in exe", MESSAGE_TYPE::M_ERROR);
         break;
       }
@@ -98,6 +131,13 @@ namespace enigma
       int pos;
       if (!fread_wrapper(&pos,4,1,resfile)) break;
 
+      // Version 1 blocks end with a table of contents
+      if (str_quad[3] == '1') {
+        load_indexed_resources(resfile, respath.c_str(), pos);
+        fclose_wrapper(resfile);
+        break;
+      }
+
       // Go to the start of the resource data
       fseek_wrapper(resfile,pos,SEEK_SET);
       if (!fread_wrapper(&nullhere,4,1,resfile)) break;
@@ -125,6 +125,7 @@ namespace enigma
     void Polygon::setOffset(glm::vec2 off)
     {
         this->offset = off;
+        revision = nextRevision();
         recomputeOffsetPoints();
         if (concave)
             decomposeConcave();
@@ -139,6 +140,7 @@ namespace enigma
     {
         this->points.push_back(point);
         this->offsetPoints.push_back(glm::vec2(point.x + offset.x, point.y + offset.y));
+        revision = nextRevision();
     }
 
     void Polygon::addPoint(int x, int y) 
@@ -146,6 +148,7 @@ namespace enigma
         glm::vec2 point(x, y);
         this->points.push_back(point);
         this->offsetPoints.push_back(glm::vec2(x + offset.x, y + offset.y));
+        revision = nextRevision();
     }
 
     void Polygon::removePoint(int x, int y) 
@@ -154,12 +157,14 @@ namespace enigma
         points.erase(std::remove(points.begin(), points.end(), point), points.end());
         glm::vec2 point2(x + offset.x, y + offset.y);
         offsetPoints.erase(std::remove(offsetPoints.begin(), offsetPoints.end(), point2), offsetPoints.end());
+        revision = nextRevision();
     }
     void Polygon::removePoint(const glm::vec2& point) 
     {
         points.erase(std::remove(points.begin(), points.end(), point), points.end());
         glm::vec2 point2(point.x + offset.x, point.y + offset.y);
         offsetPoints.erase(std::remove(offsetPoints.begin(), offsetPoints.end(), point2), offsetPoints.end());
+        revision = nextRevision();
     }
 
     void Polygon::copy(const Polygon& obj) 
@@ -172,6 +177,7 @@ namespace enigma
         this->subpolygons = obj.subpolygons;
         this->concave = obj.concave;
         this->offset = obj.offset;
+        this->revision = nextRevision();
     }
 
     void Polygon::copy(const glm::vec2* points, int size) 
@@ -181,6 +187,7 @@ namespace enigma
             for (int i = 0; i < size; ++i) {
                 this->points.push_back(points[i]);
             }
+            this->revision = nextRevision();
         }
     }
     
@@ -227,6 +234,12 @@ namespace enigma
         // Debugging Ends
     }
 
+    unsigned Polygon::nextRevision()
+    {
+        static unsigned revisions = 0;
+        return ++revisions;
+    }
+
     void Polygon::recomputeOffsetPoints()
     {
         offsetPoints.clear();
@@ -38,6 +38,8 @@ namespace enigma
 			int width;
 			glm::vec2 offset;
 			bool concave;
+			// Changes whenever the points or offset do; unique across all polygons
+			unsigned revision = nextRevision();
 
 			// Asset Array mandatory attributes
 			bool _destroyed = false;
@@ -65,6 +67,7 @@ namespace enigma
 			int getWidth();
 			glm::vec2 getOffset();
 			bool isConcave();
+			unsigned getRevision() const { return revision; }
 
 			// Computational Getters
 			int getNumPoints();
@@ -95,6 +98,7 @@ namespace enigma
 		
 		private:
 			void recomputeOffsetPoints();
+			static unsigned nextRevision();
 	};
 
 	// MinMax Projection class; to determine collision
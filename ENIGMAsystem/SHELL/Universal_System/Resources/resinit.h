@@ -34,15 +34,24 @@
 
 #include "Platforms/General/fileio.h"
 
+#include <memory>
+
 namespace enigma 
 {
 
+class resource_pack;
+
 void exe_loadsprs(FILE_t* exe);
 void exe_loadsounds(FILE_t* exe);
 void exe_loadbackgrounds(FILE_t* exe);
 void exe_loadfonts(FILE_t* exe);
 void exe_loadpaths(FILE_t* exe);
 
+// Loaders for "res1" games, which find their records through the pack's table
+// of contents and inflate them on every core.
+void pack_loadsprs(const std::shared_ptr<resource_pack>& pack);
+void pack_loadbackgrounds(const resource_pack& pack);
+
 } //namespace enigma
 
 #endif //ENIGMA_RESINIT_H
@@ -0,0 +1,126 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "resource_pack.h"
+#include "Universal_System/worker_pool.h"
+#include "Widget_Systems/widgets_mandatory.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+  #include "Universal_System/estring.h" // widen
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace enigma {
+
+resource_pack::~resource_pack() {
+  if (!mapping_) return;
+  #ifdef _WIN32
+  UnmapViewOfFile(mapping_);
+  #else
+  munmap(mapping_, size_);
+  #endif
+}
+
+bool resource_pack::open(const char *path, FILE_t *file, unsigned block_start, unsigned toc_start) {
+  // The table itself is small, so read it straight from the file
+  fseek_wrapper(file, toc_start, SEEK_SET);
+  int magic, count;
+  if (!fread_wrapper(&magic, 4, 1, file) || memcmp(&magic, "TOC ", 4) != 0) return false;
+  if (!fread_wrapper(&count, 4, 1, file) || count < 0) return false;
+  toc_.resize(count);
+  for (resource_toc_entry &e : toc_) {
+    if (!fread_wrapper(e.type, 4, 1, file)) return false;
+    if (!fread_wrapper(&e.id, 4, 1, file)) return false;
+    if (!fread_wrapper(&e.offset, 4, 1, file)) return false;
+    if (!fread_wrapper(&e.size, 4, 1, file)) return false;
+    if (!fread_wrapper(&e.flags, 4, 1, file)) return false;
+  }
+
+  return map(path) || read(file, block_start, toc_start);
+}
+
+bool resource_pack::map(const char *path) {
+  #ifdef _WIN32
+  HANDLE f = CreateFileW(widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (f == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER size;
+  HANDLE m = GetFileSizeEx(f, &size) ? CreateFileMappingW(f, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+  CloseHandle(f);
+  if (!m) return false;
+  mapping_ = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(m);  // The view keeps the mapping alive
+  if (!mapping_) return false;
+  size_ = size.QuadPart;
+  #else
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  void *m = fstat(fd, &st) == 0 && st.st_size > 0 ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close(fd);  // The mapping outlives the descriptor
+  if (m == MAP_FAILED) return false;
+  mapping_ = m;
+  size_ = st.st_size;
+  #endif
+  data_ = (const unsigned char*) mapping_;
+  base_ = 0;
+  return true;
+}
+
+bool resource_pack::read(FILE_t *file, unsigned block_start, unsigned block_end) {
+  if (block_end < block_start) return false;
+  buffer_.resize(block_end - block_start);
+  fseek_wrapper(file, block_start, SEEK_SET);
+  if (fread_wrapper(buffer_.data(), 1, buffer_.size(), file) != buffer_.size()) {
+    DEBUG_MESSAGE("Resource load error: Data is truncated before exe end", MESSAGE_TYPE::M_ERROR);
+    return false;
+  }
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+  base_ = block_start;
+  return true;
+}
+
+const unsigned char *resource_pack::at(unsigned offset, unsigned size) const {
+  if (offset < base_ || offset - base_ > size_ || size > size_ - (offset - base_)) return nullptr;
+  return data_ + (offset - base_);
+}
+
+const resource_toc_entry *resource_pack::section(const char type[4]) const {
+  for (const resource_toc_entry &e : toc_)
+    if (e.id == -1 && e.is(type)) return &e;
+  return nullptr;
+}
+
+std::vector<const resource_toc_entry*> resource_pack::assets(const char type[4]) const {
+  std::vector<const resource_toc_entry*> res;
+  for (const resource_toc_entry &e : toc_)
+    if (e.id != -1 && e.is(type)) res.push_back(&e);
+  return res;
+}
+
+void parallel_for(size_t count, const std::function<void(size_t)> &job) {
+  shared_workers().run(count, job);
+}
+
+} // namespace enigma
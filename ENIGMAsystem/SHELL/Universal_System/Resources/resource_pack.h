@@ -0,0 +1,109 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_RESOURCE_PACK_H
+#define ENIGMA_RESOURCE_PACK_H
+
+#include "Platforms/General/fileio.h"
+
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace enigma {
+
+// One entry of the table of contents at the end of a "res1" resource block:
+// where a record starts in the file and how long it is. An ID of -1 marks a
+// whole section ("SPR ", "SND ", ...) rather than a single asset.
+struct resource_toc_entry {
+  char type[4];
+  int id;
+  unsigned offset, size;
+  int flags;
+
+  bool is(const char t[4]) const { return !memcmp(type, t, 4); }
+  // The codec (see codecs.h) of every compressed blob in the record.
+  int codec() const { return (flags >> 8) & 0xFF; }
+};
+
+enum {
+  resource_deferred = 1  // Decode the asset the first time the game uses it.
+};
+
+// Read-only view of the resource file. The file is memory-mapped where the
+// platform allows; otherwise the resource block is read into memory. Either
+// way, records are looked up through the table of contents and read in place.
+class resource_pack {
+ public:
+  resource_pack() {}
+  ~resource_pack();
+  resource_pack(const resource_pack&) = delete;
+  resource_pack &operator=(const resource_pack&) = delete;
+
+  // Opens the block described by the trailer of a "res1" file. `file` is the
+  // already open resource file, used when the path can't be mapped.
+  bool open(const char *path, FILE_t *file, unsigned block_start, unsigned toc_start);
+
+  // The bytes at a file offset, or null if the range is outside the block.
+  const unsigned char *at(unsigned offset, unsigned size) const;
+
+  const resource_toc_entry *section(const char type[4]) const;
+  std::vector<const resource_toc_entry*> assets(const char type[4]) const;
+
+ private:
+  bool map(const char *path);
+  bool read(FILE_t *file, unsigned block_start, unsigned block_end);
+
+  const unsigned char *data_ = nullptr;
+  size_t size_ = 0, base_ = 0;  // data_ holds file offsets [base_, base_ + size_).
+  void *mapping_ = nullptr;
+  std::vector<unsigned char> buffer_;
+  std::vector<resource_toc_entry> toc_;
+};
+
+// How many images the loaders inflate before making their textures. This
+// bounds how much decoded pixel data is held at once.
+const size_t resource_batch_size = 64;
+
+// Reads ints from a record in the pack, the same way the exe_load* functions
+// read them from the file. Once a read runs off the end, ok is false and
+// every later read comes back zero.
+struct resource_cursor {
+  const unsigned char *pos, *end;
+  bool ok;
+
+  resource_cursor(const unsigned char *data, unsigned size): pos(data), end(data + size), ok(data != nullptr) {}
+  int i() {
+    int v = 0;
+    if (const unsigned char *p = bytes(4)) memcpy(&v, p, 4);
+    return v;
+  }
+  const unsigned char *bytes(size_t n) {
+    if (!ok || size_t(end - pos) < n) { ok = false; return nullptr; }
+    const unsigned char *p = pos;
+    pos += n;
+    return p;
+  }
+};
+
+// Calls job(0) through job(count - 1) spread over the hardware threads and
+// returns once they have all finished. Jobs must not touch the graphics API.
+void parallel_for(size_t count, const std::function<void(size_t)> &job);
+
+} // namespace enigma
+
+#endif // ENIGMA_RESOURCE_PACK_H
@@ -17,7 +17,9 @@
 
 #include "libEGMstd.h"
 #include "resinit.h"
+#include "resource_pack.h"
 #include "sprites_internal.h"
+#include "Universal_System/codecs.h"
 #include "Universal_System/zlib.h"
 #include "Platforms/General/fileio.h"
 #include "Graphics_Systems/graphics_mandatory.h"
@@ -25,12 +27,109 @@
 #include "Widget_Systems/widgets_mandatory.h"
 
 #include <cstring>
+#include <memory>
 #include <string>
 
 using enigma_user::toString;
 
 namespace enigma
 {
+  namespace
+  {
+    collision_type read_collision_type(unsigned shape)
+    {
+      switch (shape)
+      {
+        case ct_precise: return ct_precise;
+        case ct_bbox: return ct_bbox;
+        case ct_ellipse: return ct_ellipse;
+        case ct_diamond: return ct_diamond;
+        case ct_polygon: return ct_bbox; //FIXME: Change to ct_polygon once polygons are supported.
+        case ct_circle: return ct_circle;
+        default: return ct_bbox;
+      }
+    }
+
+    // A sprite record from the resource pack, read but not yet decoded.
+    struct sprite_record
+    {
+      struct subimage {
+        const unsigned char *data;
+        unsigned size;
+        int unpacked;
+        unsigned char *pixels;
+      };
+
+      int id, width, height, xorig, yorig, bbt, bbb, bbl, bbr;
+      int codec;
+      collision_type coll_type;
+      bool deferred;
+      std::vector<subimage> subimages;
+
+      bool read(const resource_pack &pack, const resource_toc_entry &e)
+      {
+        resource_cursor in(pack.at(e.offset, e.size), e.size);
+        id = in.i(); width = in.i(); height = in.i();
+        xorig = in.i(); yorig = in.i();
+        bbt = in.i(); bbb = in.i(); bbl = in.i(); bbr = in.i();
+        in.i(); // bbox mode
+        coll_type = read_collision_type(in.i());
+        deferred = e.flags & resource_deferred;
+        codec = e.codec();
+
+        const int count = in.i();
+        for (int ii = 0; ii < count && in.ok; ii++)
+        {
+          subimage s;
+          s.unpacked = in.i();
+          s.size = in.i();
+          s.data = in.bytes(s.size);
+          s.pixels = nullptr;
+          if (!in.ok) break;
+          if (s.unpacked != width * height * 4)
+            DEBUG_MESSAGE("Sprite load error: Sprite does not match expected size", MESSAGE_TYPE::M_ERROR);
+          else
+            subimages.push_back(s);
+          if (in.i())
+          {
+            DEBUG_MESSAGE("Sprite load error: Null terminator expected", MESSAGE_TYPE::M_ERROR);
+            break;
+          }
+        }
+        if (!in.ok)
+          DEBUG_MESSAGE("Failed to load sprite: Record is truncated", MESSAGE_TYPE::M_ERROR);
+        return in.ok && id == e.id;
+      }
+
+      // Decodes straight into the buffer the texture is made from. Safe to
+      // call from any thread; touches nothing but the subimage.
+      void decompress(subimage &s) const
+      {
+        s.pixels = new unsigned char[s.unpacked];
+        if (!codec_decompress(codec, s.data, s.size, s.pixels, s.unpacked))
+        {
+          delete[] s.pixels;
+          s.pixels = nullptr;
+        }
+      }
+
+      // Hands the decoded subimages to the sprite; this makes the textures, so main thread only.
+      void add_to(Sprite &spr)
+      {
+        for (subimage &s : subimages)
+        {
+          if (!s.pixels)
+          {
+            DEBUG_MESSAGE("Sprite load error: Subimage failed to decompress", MESSAGE_TYPE::M_ERROR);
+            continue;
+          }
+          spr.AddSubimage(RawImage(s.pixels, width, height), coll_type, coll_type == ct_precise ? s.pixels : nullptr);
+          s.pixels = nullptr;
+        }
+      }
+    };
+  }
+
   void exe_loadsprs(FILE_t *exe)
   {
     int nullhere;
@@ -66,17 +165,7 @@ namespace enigma
       if (!fread_wrapper(&bbm, 4,1,exe)) return;
       if (!fread_wrapper(&shape, 4,1,exe)) return;
 
-      collision_type coll_type;
-      switch (shape)
-      {
-        case ct_precise: coll_type = ct_precise; break;
-        case ct_bbox: coll_type = ct_bbox; break;
-        case ct_ellipse: coll_type = ct_ellipse; break;
-        case ct_diamond: coll_type = ct_diamond; break;
-        case ct_polygon: coll_type = ct_bbox; break; //FIXME: Change to ct_polygon once polygons are supported.
-        case ct_circle: coll_type = ct_circle; break;
-        default: coll_type = ct_bbox; break;
-      };
+      collision_type coll_type = read_collision_type(shape);
 
       int subimages;
       if (!fread_wrapper(&subimages,4,1,exe)) return; //co//ut << "Subimages: " << subimages << endl;
@@ -90,25 +179,19 @@ namespace enigma
         if (!fread_wrapper(&unpacked,4,1,exe)) return;
         unsigned int size;
         if (!fread_wrapper(&size,4,1,exe)) return; //co//ut << "Alloc size: " << size << endl;
-        unsigned char* cpixels=new unsigned char[size+1];
-        if (!cpixels)
-        {  //FIXME: Uncomment these when tostring is available
-          DEBUG_MESSAGE("Failed to load sprite: Cannot allocate enough memory "+ toString(unpacked), MESSAGE_TYPE::M_ERROR);
-          break;
-        }
-        unsigned int sz2=fread_wrapper(cpixels,1,size,exe);
-        if (size!=sz2) {
-          DEBUG_MESSAGE("Failed to load sprite: Data is truncated before exe end. Read "+toString(sz2)+
-                                  " out of expected "+toString(size), MESSAGE_TYPE::M_ERROR);
-          return;
-        }
-        unsigned char* pixels=new unsigned char[unpacked+1];
-        if (zlib_decompress(cpixels,size,unpacked,pixels) != unpacked)
+        // Inflate straight from the file into the texture's pixels
+        unsigned char* pixels=new unsigned char[unpacked];
+        if (zlib_decompress_file(exe,size,unpacked,pixels) != unpacked)
         {
+          delete[] pixels;
+          if (feof_wrapper(exe)) {
+            DEBUG_MESSAGE("Failed to load sprite: Data is truncated before exe end. Expected "+toString(size), MESSAGE_TYPE::M_ERROR);
+            return;
+          }
           DEBUG_MESSAGE("Sprite load error: Sprite does not match expected size", MESSAGE_TYPE::M_ERROR);
+          if (!fread_wrapper(&nullhere,4,1,exe)) return;
           continue;
         }
-        delete[] cpixels;
 
         unsigned char* collision_data = 0;
         switch (coll_type)
@@ -136,4 +219,51 @@ namespace enigma
       sprites.assign(sprid, std::move(spr));
     }
   }
+
+  void pack_loadsprs(const std::shared_ptr<resource_pack> &pack)
+  {
+    std::vector<const resource_toc_entry*> entries = pack->assets("SPR ");
+    if (entries.empty()) return;
+
+    std::vector<sprite_record> records(entries.size());
+    int spr_highid = 0;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+      if (!records[i].read(*pack, *entries[i])) records[i].id = -1;
+      if (records[i].id > spr_highid) spr_highid = records[i].id;
+    }
+    sprites.resize(spr_highid+1);
+
+    // Inflate a batch of subimages across all cores, then make their textures
+    // here; batching keeps only a few decoded images in memory at a time
+    for (size_t first = 0, last; first < records.size(); first = last)
+    {
+      std::vector<std::pair<const sprite_record*, sprite_record::subimage*>> work;
+      for (last = first; last < records.size() && work.size() < resource_batch_size; last++)
+        if (records[last].id >= 0 && !records[last].deferred)
+          for (sprite_record::subimage &s : records[last].subimages) work.push_back({&records[last], &s});
+      parallel_for(work.size(), [&](size_t i) { work[i].first->decompress(*work[i].second); });
+
+      for (size_t i = first; i < last; i++)
+      {
+        sprite_record &rec = records[i];
+        const int id = rec.id;
+        if (id < 0) continue;
+        Sprite spr(rec.width, rec.height, rec.xorig, rec.yorig);
+        spr.SetBBox(rec.bbl, rec.bbt, rec.bbr-rec.bbl, rec.bbb-rec.bbt);
+        if (!rec.deferred)
+          rec.add_to(spr);
+        else
+        {
+          // The pack stays open for as long as a sprite might still need it
+          std::shared_ptr<sprite_record> deferred = std::make_shared<sprite_record>(std::move(rec));
+          spr.DeferSubimages(deferred->subimages.size(), [pack, deferred](Sprite &s) {
+            for (sprite_record::subimage &sub : deferred->subimages) deferred->decompress(sub);
+            deferred->add_to(s);
+          });
+        }
+        sprites.assign(id, std::move(spr));
+      }
+    }
+  }
 }
@@ -3,8 +3,11 @@
 #include "Universal_System/nlpo2.h"
 #include "Universal_System/Instances/instance_system.h"
 #include "Universal_System/Object_Tiers/graphics_object.h"
+#include "Widget_Systems/widgets_mandatory.h"
 #include "sprites_internal.h"
 
+#include <string>
+
 namespace enigma {
 
 AssetArray<Sprite> sprites;
@@ -27,13 +30,28 @@ void Subimage::FreeTexture() {
   textureID = -1;
 }
 
+void Sprite::Decode() const {
+  if (!_decode) return;
+  // Clear it first, since decoding adds subimages the normal way
+  std::function<void(Sprite&)> decode = std::move(_decode);
+  _decode = nullptr;
+  decode(const_cast<Sprite&>(*this));
+  // Subimages that fail to decode are skipped, so the count promised up front may be short
+  if (_subimages.size() != _decodeCount)
+    DEBUG_MESSAGE("Sprite decode error: Expected " + std::to_string(_decodeCount) + " subimages but decoded "
+                  + std::to_string(_subimages.size()), MESSAGE_TYPE::M_ERROR);
+  _decodeCount = 0;
+}
+
 void Sprite::SetTexture(int subimg, int textureID, TexRect texRect) { 
+  Decode();
   Subimage& s = _subimages.get(subimg);
   s.textureID = textureID;
   s.textureBounds = texRect;
 }
 
 const int Sprite::ModSubimage(int subimg) const {
+  Decode(); // Every caller fetches the subimage next, and decoding can change the count
   if (SubimageCount() == 0) return 0;
   if (subimg >= 0) return subimg % SubimageCount();
   return int(((enigma::object_graphics*)enigma::instance_event_iterator->inst)->image_index) % SubimageCount();
@@ -46,14 +64,17 @@ Sprite::Sprite(const Sprite& s) {
   yoffset = s.yoffset;
   bbox = s.bbox;
   bbox_mode = s.bbox_mode;
+  _decode = s._decode;
+  _decodeCount = s._decodeCount;
   
-  for (size_t i = 0; i < s.SubimageCount(); ++i) {
-    Subimage copy(s.GetSubimage(i), true);
+  for (size_t i = 0; i < s._subimages.size(); ++i) {
+    Subimage copy(s._subimages.get(i), true);
     _subimages.add(std::move(copy));
   }
 }
 
 int Sprite::AddSubimage(int texid, TexRect texRect, collision_type ct, void* collisionData, bool mipmap) {
+  Decode();
   Subimage subimg;
   subimg.textureID = texid;
   subimg.textureBounds = texRect;
@@ -68,6 +89,7 @@ int Sprite::AddSubimage(const RawImage& img, collision_type ct, void* collisionD
 }
 
 void Sprite::AddSubimage(const Subimage& s) {
+  Decode();
   Subimage copy(s, true);
   _subimages.add(std::move(copy));
 }
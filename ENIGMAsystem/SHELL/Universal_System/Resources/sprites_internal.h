@@ -30,6 +30,8 @@
 #include "Universal_System/scalar.h"
 #include "Universal_System/image_formats.h"
 
+#include <functional>
+
 namespace enigma {
 
 using BoundingBox = Rect<int>;
@@ -60,13 +62,18 @@ public:
   Sprite(int width, int height, int xoffset = 0, int yoffset = 0) : width(width), height(height), xoffset(xoffset), yoffset(yoffset) 
     { bbox = {0, 0, width, height}; }
     
-  size_t SubimageCount() const { return _subimages.size(); }
+  size_t SubimageCount() const { return _decode ? _decodeCount : _subimages.size(); }
   
-  void FreeTextures() { for (std::pair<int, Subimage&> s : _subimages) s.second.FreeTexture(); }
-  const int& GetTexture(int subimg) const { return _subimages.get(subimg).textureID; }
+  void FreeTextures() { _decode = nullptr; for (std::pair<int, Subimage&> s : _subimages) s.second.FreeTexture(); }
+  const int& GetTexture(int subimg) const { Decode(); return _subimages.get(subimg).textureID; }
   const int ModSubimage(int subimg) const;
   void SetTexture(int subimg, int textureID, TexRect texRect);
-  const TexRect& GetTextureRect(int subimg) const { return _subimages.get(subimg).textureBounds; } 
+  const TexRect& GetTextureRect(int subimg) const { Decode(); return _subimages.get(subimg).textureBounds; } 
+  
+  /// Leave the sprite's subimages undecoded until something asks for one.
+  /// `decode` adds the `count` subimages when that happens; until then SubimageCount()
+  /// reports `count`, and afterwards however many actually decoded.
+  void DeferSubimages(size_t count, std::function<void(Sprite&)> decode) { _decodeCount = count; _decode = std::move(decode); }
   
   /// Add Subimage from existing texture
   int AddSubimage(int texid, TexRect texRect, collision_type ct = ct_precise, void* collisionData = nullptr, bool mipmap = false);
@@ -75,7 +82,7 @@ public:
   /// Copy an existing subimage into the sprite (duplicating the texture)
   void AddSubimage(const Subimage& s);
   
-  const Subimage& GetSubimage(int index) const { return _subimages.get(index); }
+  const Subimage& GetSubimage(int index) const { Decode(); return _subimages.get(index); }
   
   void SetBBox(int x, int y, int w, int h) { bbox = {x, y, w, h}; }
   
@@ -94,6 +101,10 @@ public:
 protected:
   bool _destroyed = false;
   AssetArray<Subimage> _subimages;
+  
+  void Decode() const;
+  mutable std::function<void(Sprite&)> _decode;
+  mutable size_t _decodeCount = 0;
 };
 
 extern AssetArray<Sprite> sprites;
@@ -72,6 +72,7 @@ int buffer_base64_decode_ext(int buffer, std::string str, unsigned offset);
 std::string buffer_base64_encode(int buffer, unsigned offset, unsigned size);
 std::string buffer_md5(int buffer, unsigned offset, unsigned size);
 std::string buffer_sha1(int buffer, unsigned offset, unsigned size);
+unsigned buffer_crc32(int buffer, unsigned offset, unsigned size);
 
 void *buffer_get_address(int buffer);
 unsigned buffer_get_size(int buffer);
@@ -80,7 +81,7 @@ int buffer_get_type(int buffer);
 void buffer_get_surface(int buffer, int surface, int mode, unsigned offset = 0, int modulo = 0);
 void buffer_set_surface(int buffer, int surface, int mode, unsigned offset = 0, int modulo = 0);
 void buffer_resize(int buffer, unsigned size);
-void buffer_seek(int buffer, int base, unsigned offset);
+void buffer_seek(int buffer, int base, int offset);
 unsigned buffer_sizeof(int type);
 int buffer_tell(int buffer);
 
@@ -90,6 +91,8 @@ void buffer_fill(int buffer, unsigned offset, int type, variant value, unsigned
 void buffer_poke(int buffer, unsigned offset, int type, variant value);
 void buffer_write(int buffer, int type, variant value);
 
+// See game_state.h. The save goes in at the buffer's position, and a load
+// reads from there.
 void game_save_buffer(int buffer);
 void game_load_buffer(int buffer);
 
@@ -26,6 +26,9 @@
 
 namespace enigma
 {
+  // The bytes of a buffer_* buffer and its read/write position. Values are
+  // stored little-endian, as in GM, and are moved with memcpy rather than a
+  // byte at a time.
   struct BinaryBuffer
   {
     std::vector<unsigned char> data;
@@ -37,11 +40,20 @@ namespace enigma
     ~BinaryBuffer() = default;
     unsigned GetSize();
     void Resize(unsigned size);
-    void Seek(unsigned offset);  
-    unsigned char ReadByte();
-    void WriteByte(unsigned char byte);
+    // Moves the position, clamped to the end of a fixed buffer and wrapped
+    // around a wrap buffer. A grow buffer only grows when written past its end.
+    void Seek(long long offset);
+    // The first position at or after pos that is a multiple of the alignment.
+    unsigned Align(unsigned pos);
+    // Copy count bytes at pos to or from the buffer. A grow buffer is enlarged
+    // to fit a write; a wrap buffer continues from its start; anything past
+    // the end of a fixed buffer is dropped (and reads as zero). Both return
+    // how many bytes actually reached the buffer.
+    unsigned Read(unsigned pos, void *dest, unsigned count);
+    unsigned Write(unsigned pos, const void *src, unsigned count);
   };
   
+  int add_buffer(BinaryBuffer *buffer);
   extern std::vector<BinaryBuffer*> buffers;
 }
 
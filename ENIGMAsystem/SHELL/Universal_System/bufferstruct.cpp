@@ -17,6 +17,8 @@
 
 #include "buffers.h"
 #include "buffers_internal.h"
+#include "checksums.h"
+#include "estring.h"
 #include "libEGMstd.h"
 
 #include "Resources/AssetArray.h" // TODO: start actually using for this resource
@@ -24,6 +26,10 @@
 #include "Graphics_Systems/General/GSsurface.h"
 #include "Widget_Systems/widgets_mandatory.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -44,52 +50,261 @@ unsigned BinaryBuffer::GetSize() { return data.size(); }
 
 void BinaryBuffer::Resize(unsigned size) { data.resize(size, 0); }
 
-void BinaryBuffer::Seek(unsigned offset) {
-  position = offset;
-  while (position >= GetSize()) {
-    switch (type) {
-      case enigma_user::buffer_grow:
-        Resize(position + 1);
-        return;
-      case enigma_user::buffer_wrap:
-        position -= GetSize();
-        return;
-      default:
-        position = GetSize() - (position - GetSize());
-        return;
-    }
+void BinaryBuffer::Seek(long long offset) {
+  const long long size = data.size();
+  if (type == enigma_user::buffer_wrap && size) {
+    offset = (offset % size + size) % size;
+  } else if (offset < 0) {
+    offset = 0;
+  } else if (type != enigma_user::buffer_grow && offset > size) {
+    offset = size;
   }
+  position = offset;
 }
 
-unsigned char BinaryBuffer::ReadByte() {
-  Seek(position);
-  unsigned char byte = data[position];
-  Seek(position + 1);
-  return byte;
+unsigned BinaryBuffer::Align(unsigned pos) {
+  if (alignment <= 1) return pos;
+  return (pos + alignment - 1) / alignment * alignment;
 }
 
-void BinaryBuffer::WriteByte(unsigned char byte) {
-  Seek(position);
-  data[position] = byte;
-  Seek(position + 1);
+unsigned BinaryBuffer::Read(unsigned pos, void *dest, unsigned count) {
+  unsigned char *bytes = reinterpret_cast<unsigned char*>(dest);
+  if (type == enigma_user::buffer_wrap && !data.empty()) {
+    for (unsigned done = 0; done < count; ) {
+      pos %= data.size();
+      const unsigned n = std::min<size_t>(count - done, data.size() - pos);
+      memcpy(bytes + done, &data[pos], n);
+      done += n;
+      pos += n;
+    }
+    return count;
+  }
+  const unsigned n = pos < data.size() ? std::min<size_t>(count, data.size() - pos) : 0;
+  if (n) memcpy(bytes, &data[pos], n);
+  memset(bytes + n, 0, count - n);
+  return n;
+}
+
+unsigned BinaryBuffer::Write(unsigned pos, const void *src, unsigned count) {
+  const unsigned char *bytes = reinterpret_cast<const unsigned char*>(src);
+  if (type == enigma_user::buffer_grow && size_t(pos) + count > data.size()) {
+    Resize(pos + count);
+  } else if (type == enigma_user::buffer_wrap && !data.empty()) {
+    const unsigned written = count;
+    if (count > data.size()) {  // Only the last lap of the write survives
+      bytes += count - data.size();
+      pos += count - data.size();
+      count = data.size();
+    }
+    pos %= data.size();
+    const unsigned first = std::min<size_t>(count, data.size() - pos);
+    memcpy(&data[pos], bytes, first);
+    memcpy(&data[0], bytes + first, count - first);
+    return written;
+  }
+  if (pos >= data.size()) return 0;
+  count = std::min<size_t>(count, data.size() - pos);
+  memcpy(&data[pos], bytes, count);
+  return count;
 }
 
-int get_free_buffer() {
-  for (unsigned i = 0; i < buffers.size(); i++) {
+int add_buffer(BinaryBuffer *buffer) {
+  for (size_t i = 0; i < buffers.size(); i++) {
     if (!buffers[i]) {
+      buffers[i] = buffer;
       return i;
     }
   }
-  return buffers.size();
+  buffers.push_back(buffer);
+  return buffers.size() - 1;
+}
+
+namespace {
+
+// IEEE half precision, as buffer_f16 stores it. Rounds to nearest even.
+uint16_t float_to_half(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, 4);
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  const uint32_t exponent = (bits >> 23) & 0xFF, mantissa = bits & 0x7FFFFF;
+  if (exponent == 0xFF) return sign | 0x7C00 | (mantissa ? 0x200 : 0);  // Infinity or NaN
+
+  const int e = int(exponent) - 127 + 15;
+  if (e >= 0x1F) return sign | 0x7C00;
+  uint32_t half, rest, halfway;
+  if (e > 0) {
+    half = (e << 10) | (mantissa >> 13);
+    rest = mantissa & 0x1FFF;
+    halfway = 0x1000;
+  } else {  // Subnormal, or too small to be anything but zero
+    if (e < -10) return sign;
+    const unsigned shift = 14 - e;
+    half = (mantissa | 0x800000) >> shift;
+    rest = (mantissa | 0x800000) & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+  }
+  if (rest > halfway || (rest == halfway && (half & 1))) ++half;  // A carry correctly bumps the exponent
+  return sign | half;
+}
+
+float half_to_float(uint16_t half) {
+  const uint32_t sign = uint32_t(half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1F, mantissa = half & 0x3FF, bits;
+  if (exponent == 0x1F) {
+    bits = sign | 0x7F800000 | (mantissa << 13);
+  } else if (exponent) {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (!mantissa) {
+    bits = sign;
+  } else {  // Subnormal; normalize it
+    exponent = 113;
+    while (!(mantissa & 0x400)) {
+      mantissa <<= 1;
+      --exponent;
+    }
+    bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+  }
+  float value;
+  memcpy(&value, &bits, 4);
+  return value;
+}
+
+template<typename T> unsigned put(unsigned char *out, T value) {
+  memcpy(out, &value, sizeof(T));
+  return sizeof(T);
+}
+
+template<typename T> T get(const unsigned char *in) {
+  T value;
+  memcpy(&value, in, sizeof(T));
+  return value;
+}
+
+// The integer part of d, wrapped to 64 bits. Converting a double that doesn't
+// fit straight to an integer is undefined, so reduce it mod 2^64 first (which
+// is exact); NaN and infinities come out as 0.
+uint64_t wrap_integer(double d) {
+  if (!std::isfinite(d)) return 0;
+  d = std::fmod(std::trunc(d), 18446744073709551616.0);
+  return d < 0 ? 0 - uint64_t(-d) : uint64_t(d);
+}
+// d as a float, with anything too large for one going to infinity rather than
+// being left to an undefined conversion.
+float narrow_float(double d) {
+  if (std::isfinite(d) && std::fabs(d) > FLT_MAX) return d > 0 ? HUGE_VALF : -HUGE_VALF;
+  return float(d);
+}
+
+// Stores a number as the given buffer type, which must not be a string type.
+// Integers wrap to their width as in GM. Returns the size written.
+unsigned encode(int type, const variant &value, unsigned char *out) {
+  using namespace enigma_user;
+  const double d = value.rval.d;
+  switch (type) {
+    case buffer_u8: case buffer_s8: return put<uint8_t>(out, uint8_t(wrap_integer(d)));
+    case buffer_bool: return put<uint8_t>(out, bool(value));
+    case buffer_u16: case buffer_s16: return put<uint16_t>(out, uint16_t(wrap_integer(d)));
+    case buffer_u32: case buffer_s32: return put<uint32_t>(out, uint32_t(wrap_integer(d)));
+    case buffer_u64: return put<uint64_t>(out, wrap_integer(d));
+    case buffer_f16: return put<uint16_t>(out, float_to_half(narrow_float(d)));
+    case buffer_f32: return put<float>(out, narrow_float(d));
+    case buffer_f64: return put<double>(out, d);
+  }
+  return 0;
 }
 
-std::vector<unsigned char> valToBytes(variant value, unsigned count) {
-  std::vector<unsigned char> result(0);
-  for (unsigned i = 0; i < count; i++) {
-    result.push_back(value >> ((i)*8));
+double decode(int type, const unsigned char *in) {
+  using namespace enigma_user;
+  switch (type) {
+    case buffer_u8: return get<uint8_t>(in);
+    case buffer_s8: return get<int8_t>(in);
+    case buffer_bool: return get<uint8_t>(in) != 0;
+    case buffer_u16: return get<uint16_t>(in);
+    case buffer_s16: return get<int16_t>(in);
+    case buffer_u32: return get<uint32_t>(in);
+    case buffer_s32: return get<int32_t>(in);
+    case buffer_u64: return get<uint64_t>(in);
+    case buffer_f16: return half_to_float(get<uint16_t>(in));
+    case buffer_f32: return get<float>(in);
+    case buffer_f64: return get<double>(in);
   }
-  return result;
+  return 0;
+}
+
+bool is_string_type(int type) {
+  return type == enigma_user::buffer_string || type == enigma_user::buffer_text;
 }
+
+// Reads a NUL-terminated string at pos; len receives the bytes it spans,
+// terminator included. An unterminated string runs to the end of the buffer,
+// or, in a wrap buffer, around to where it started.
+std::string peek_string(BinaryBuffer *b, unsigned pos, unsigned &len) {
+  const size_t size = b->data.size();
+  if (b->type == enigma_user::buffer_wrap && size) pos %= size;
+  if (pos >= size) {
+    len = 0;
+    return "";
+  }
+  const char *start = reinterpret_cast<const char*>(b->data.data());
+  if (const void *nul = memchr(start + pos, 0, size - pos)) {
+    len = static_cast<const char*>(nul) - (start + pos) + 1;
+    return std::string(start + pos, len - 1);
+  }
+  std::string str(start + pos, size - pos);
+  if (b->type == enigma_user::buffer_wrap) {
+    const void *nul = memchr(start, 0, pos);
+    str.append(start, nul ? static_cast<const char*>(nul) - start : pos);
+    len = str.size() + (nul != nullptr);
+  } else {
+    len = str.size();
+  }
+  return str;
+}
+
+// Reads a value at pos without moving the buffer's position. len receives
+// the bytes it spans.
+variant peek_value(BinaryBuffer *b, unsigned pos, int type, unsigned &len) {
+  if (is_string_type(type)) return peek_string(b, pos, len);
+  len = enigma_user::buffer_sizeof(type);
+  if (!len) return 0;
+  if (size_t(pos) + len <= b->data.size()) return decode(type, &b->data[pos]);
+  unsigned char bytes[8];
+  b->Read(pos, bytes, len);
+  return decode(type, bytes);
+}
+
+// Writes a value at pos without moving the buffer's position. Returns the
+// bytes it spans, whether or not they all fit.
+unsigned poke_value(BinaryBuffer *b, unsigned pos, int type, const variant &value) {
+  if (is_string_type(type)) {
+    const std::string str = value.to_string();
+    const unsigned len = str.size() + (type == enigma_user::buffer_string);
+    b->Write(pos, str.c_str(), len);
+    return len;
+  }
+  unsigned char bytes[8];
+  const unsigned len = encode(type, value, bytes);
+  if (size_t(pos) + len <= b->data.size()) memcpy(&b->data[pos], bytes, len);
+  else b->Write(pos, bytes, len);
+  return len;
+}
+
+// Calls fn on the one or two contiguous pieces of the buffer that hold size
+// bytes at offset, without copying them. The range is clipped to the end of
+// a fixed or grow buffer and wraps (at most once) around a wrap buffer.
+template<typename F> void for_each_span(BinaryBuffer *b, unsigned offset, unsigned size, F fn) {
+  const size_t total = b->data.size();
+  if (b->type == enigma_user::buffer_wrap && total) {
+    offset %= total;
+    const size_t len = std::min<size_t>(size, total), first = std::min<size_t>(len, total - offset);
+    if (first) fn(&b->data[offset], first);
+    if (len > first) fn(&b->data[0], len - first);
+  } else if (offset < total && size) {
+    fn(&b->data[offset], std::min<size_t>(size, total - offset));
+  }
+}
+
+}  // namespace
 }  // namespace enigma
 
 namespace enigma_user {
@@ -98,9 +313,7 @@ int buffer_create(unsigned size, int type, unsigned alignment) {
   enigma::BinaryBuffer* buffer = new enigma::BinaryBuffer(size);
   buffer->type = type;
   buffer->alignment = alignment;
-  int id = enigma::get_free_buffer();
-  enigma::buffers.insert(enigma::buffers.begin() + id, buffer);
-  return id;
+  return enigma::add_buffer(buffer);
 }
 
 void buffer_delete(int buffer) {
@@ -116,123 +329,115 @@ bool buffer_exists(int buffer) {
 void buffer_copy(int src_buffer, unsigned src_offset, unsigned size, int dest_buffer, unsigned dest_offset) {
   get_buffer(srcbuff, src_buffer);
   get_buffer(dstbuff, dest_buffer);
-
-  unsigned over = size - srcbuff->GetSize();
-  switch (dstbuff->type) {
-    case buffer_wrap:
-      dstbuff->data.insert(dstbuff->data.begin() + dest_offset, srcbuff->data.begin() + src_offset,
-                           srcbuff->data.begin() + src_offset + size - over);
-      dstbuff->data.insert(dstbuff->data.begin() + dest_offset, srcbuff->data.begin(), srcbuff->data.begin() + over);
-      break;
-    case buffer_grow:
-      dstbuff->data.insert(dstbuff->data.begin() + dest_offset, srcbuff->data.begin() + src_offset,
-                           srcbuff->data.begin() + src_offset + size);
-      break;
-    default:
-      dstbuff->data.insert(dstbuff->data.begin() + dest_offset, srcbuff->data.begin() + src_offset,
-                           srcbuff->data.begin() + src_offset + size - over);
-      break;
+  if (src_offset >= srcbuff->GetSize()) return;
+  size = std::min(size, srcbuff->GetSize() - src_offset);
+
+  if (srcbuff != dstbuff) {
+    dstbuff->Write(dest_offset, &srcbuff->data[src_offset], size);
+  } else if (size_t(dest_offset) + size <= dstbuff->GetSize()) {
+    memmove(&dstbuff->data[dest_offset], &srcbuff->data[src_offset], size);
+  } else {  // The write may grow or wrap over the source, so copy it out first
+    std::vector<unsigned char> bytes(srcbuff->data.begin() + src_offset, srcbuff->data.begin() + src_offset + size);
+    dstbuff->Write(dest_offset, bytes.data(), size);
   }
 }
 
 void buffer_save(int buffer, string filename) {
   get_buffer(binbuff, buffer);
-  std::ofstream myfile(filename.c_str());
-  if (!myfile.is_open()) {
-    DEBUG_MESSAGE("Unable to open file " + filename, MESSAGE_TYPE::M_ERROR);
-    return;
-  }
-  myfile.write(reinterpret_cast<const char*>(&binbuff->data[0]), binbuff->data.size());
-  myfile.close();
+  buffer_save_ext(buffer, filename, 0, binbuff->GetSize());
 }
 
 void buffer_save_ext(int buffer, string filename, unsigned offset, unsigned size) {
   get_buffer(binbuff, buffer);
-  std::ofstream myfile(filename.c_str());
+  std::ofstream myfile(filename.c_str(), std::ios::binary);
   if (!myfile.is_open()) {
     DEBUG_MESSAGE("Unable to open file " + filename, MESSAGE_TYPE::M_ERROR);
     return;
   }
 
-  unsigned over = size - binbuff->GetSize();
-  switch (binbuff->type) {
-    case buffer_wrap:
-      myfile.write(reinterpret_cast<const char*>(&binbuff->data[offset]), size - over);
-      myfile.write(reinterpret_cast<const char*>(&binbuff->data[0]), over);
-      break;
-    case buffer_grow:
-      //TODO: Might need to use min(size, binbuff->GetSize()); for the last parameter.
-      //Depends on whether Stupido will write 0's to fill in the entire size you gave it even though the data isn't that big.
-      myfile.write(reinterpret_cast<const char*>(&binbuff->data[offset]), size);
-      break;
-    default:
-      myfile.write(reinterpret_cast<const char*>(&binbuff->data[offset]), binbuff->GetSize());
-      break;
+  if (binbuff->type == buffer_wrap) {
+    std::vector<unsigned char> bytes(size);
+    binbuff->Read(offset, bytes.data(), size);
+    myfile.write(reinterpret_cast<const char*>(bytes.data()), size);
+  } else if (offset < binbuff->GetSize()) {
+    size = std::min(size, binbuff->GetSize() - offset);
+    myfile.write(reinterpret_cast<const char*>(&binbuff->data[offset]), size);
   }
+}
 
-  myfile.close();
+namespace {
+bool read_file(const string &filename, std::vector<unsigned char> &bytes) {
+  std::ifstream myfile(filename.c_str(), std::ios::binary | std::ios::ate);
+  if (!myfile.is_open()) {
+    DEBUG_MESSAGE("Unable to open file " + filename, MESSAGE_TYPE::M_ERROR);
+    return false;
+  }
+  bytes.resize(myfile.tellg());
+  myfile.seekg(0);
+  return bool(myfile.read(reinterpret_cast<char*>(bytes.data()), bytes.size()));
 }
+}  // namespace
 
 int buffer_load(string filename) {
   enigma::BinaryBuffer* buffer = new enigma::BinaryBuffer(0);
-  buffer->type = buffer_grow;
-  buffer->alignment = 1;
-  int id = enigma::get_free_buffer();
-  enigma::buffers.insert(enigma::buffers.begin() + id, buffer);
-
-  std::ifstream myfile(filename.c_str());
-  if (!myfile.is_open()) {
-    DEBUG_MESSAGE("Unable to open file " + filename, MESSAGE_TYPE::M_ERROR);
+  if (!read_file(filename, buffer->data)) {
+    delete buffer;
     return -1;
   }
-  myfile.read(reinterpret_cast<char*>(&buffer->data[0]), myfile.tellg());
-  myfile.close();
-
-  return id;
+  buffer->type = buffer_grow;
+  buffer->alignment = 1;
+  return enigma::add_buffer(buffer);
 }
 
 void buffer_load_ext(int buffer, string filename, unsigned offset) {
   get_buffer(binbuff, buffer);
-
-  std::ifstream myfile(filename.c_str());
-  if (!myfile.is_open()) {
-    DEBUG_MESSAGE("Unable to open file " + filename, MESSAGE_TYPE::M_ERROR);
-    return;
-  }
-  std::vector<char> data;
-  myfile.read(reinterpret_cast<char*>(&data[0]), myfile.tellg());
-  unsigned over = data.size() - binbuff->GetSize();
-  switch (binbuff->type) {
-    case buffer_wrap:
-      binbuff->data.insert(binbuff->data.begin() + offset, data.begin(), data.end() - over);
-      binbuff->data.insert(binbuff->data.begin(), data.begin(), data.begin() + over);
-      break;
-    case buffer_grow:
-      binbuff->data.insert(binbuff->data.begin() + offset, data.begin(), data.end());
-      break;
-    default:
-      binbuff->data.insert(binbuff->data.begin() + offset, data.begin(), data.end() - over);
-      break;
-  }
-
-  myfile.close();
+  std::vector<unsigned char> bytes;
+  if (read_file(filename, bytes)) binbuff->Write(offset, bytes.data(), bytes.size());
 }
 
 void buffer_fill(int buffer, unsigned offset, int type, variant value, unsigned size) {
   get_buffer(binbuff, buffer);
-  unsigned nsize = offset + size;
-  if (binbuff->GetSize() < nsize && binbuff->type == buffer_grow) {
-    binbuff->data.resize(nsize);
+  unsigned char bytes[8];
+  string str;
+  const unsigned char *pattern = bytes;
+  unsigned len;
+  if (type == buffer_string || type == buffer_text) {
+    str = value.to_string();
+    if (type == buffer_string) str.push_back(0);
+    pattern = reinterpret_cast<const unsigned char*>(str.data());
+    len = str.size();
+  } else {
+    len = enigma::encode(type, value, bytes);
   }
-  unsigned pos = offset;
-  for (unsigned i = 0; i < buffer_sizeof(type); i++) {
-    binbuff[pos] = value[i];
-    if (i > binbuff->GetSize()) {
-      if (binbuff->type != buffer_wrap) {
-        break;
-      }
-      pos = 0;
+
+  // Only whole values are written, each at an aligned position.
+  const unsigned stride = binbuff->Align(len);
+  if (!len || size < stride) return;
+  unsigned count = size / stride;
+  const size_t end = size_t(offset) + size_t(count) * stride;
+  if (binbuff->type == buffer_grow && end > binbuff->GetSize()) {
+    binbuff->Resize(end);
+  } else if (binbuff->type == buffer_wrap && end > binbuff->GetSize()) {
+    for (unsigned i = 0; i < count; i++) binbuff->Write(offset + i * stride, pattern, len);
+    return;
+  } else if (end > binbuff->GetSize()) {
+    count = offset < binbuff->GetSize() ? (binbuff->GetSize() - offset) / stride : 0;
+  }
+  if (!count) return;
+
+  unsigned char *dest = &binbuff->data[offset];
+  if (stride == 1) {
+    memset(dest, pattern[0], count);
+  } else if (stride == len) {  // Lay one value down, then keep doubling the filled span
+    const size_t total = size_t(count) * len;
+    memcpy(dest, pattern, len);
+    for (size_t done = len; done < total; ) {
+      const size_t n = std::min(done, total - done);
+      memcpy(dest + done, dest, n);
+      done += n;
     }
+  } else {
+    for (unsigned i = 0; i < count; i++) memcpy(dest + size_t(i) * stride, pattern, len);
   }
 }
   
@@ -282,19 +487,20 @@ void buffer_set_surface(int buffer, int surface, int mode, unsigned offset, int
 void buffer_resize(int buffer, unsigned size) {
   get_buffer(binbuff, buffer);
   binbuff->Resize(size);
+  binbuff->Seek(binbuff->position);
 }
 
-void buffer_seek(int buffer, int base, unsigned offset) {
+void buffer_seek(int buffer, int base, int offset) {
   get_buffer(binbuff, buffer);
   switch (base) {
     case buffer_seek_start:
       binbuff->Seek(offset);
       break;
     case buffer_seek_end:
-      binbuff->Seek(binbuff->GetSize() + offset);
+      binbuff->Seek((long long) binbuff->GetSize() + offset);
       break;
     case buffer_seek_relative:
-      binbuff->Seek(binbuff->position + offset);
+      binbuff->Seek((long long) binbuff->position + offset);
       break;
   }
 }
@@ -322,105 +528,90 @@ int buffer_tell(int buffer) {
 
 variant buffer_peek(int buffer, unsigned offset, int type) {
   get_bufferr(binbuff, buffer, -1);
-  binbuff->Seek(offset);
-  if (type != buffer_string) {
-    //unsigned dsize = buffer_sizeof(type) + binbuff->alignment - 1;
-    //NOTE: These buffers most likely need a little more code added to take care of endianess on different architectures.
-    //TODO: Fix floating point precision.
-    long res = 0;
-    for (unsigned i = 0; i < buffer_sizeof(type); i++) {
-      res += binbuff->ReadByte() << i * 8;
-    }
-    return res;
-  } else {
-    char byte = '1';
-    std::vector<char> data;
-    while (byte != 0x00) {
-      byte = binbuff->ReadByte();
-      data.push_back(byte);
-    }
-    return variant(&data[0]);
-  }
+  unsigned len;
+  return enigma::peek_value(binbuff, offset, type, len);
 }
 
 variant buffer_read(int buffer, int type) {
   get_bufferr(binbuff, buffer, -1);
-  return buffer_peek(buffer, binbuff->position, type);
+  const unsigned pos = binbuff->Align(binbuff->position);
+  unsigned len;
+  variant value = enigma::peek_value(binbuff, pos, type, len);
+  binbuff->Seek((long long) pos + len);
+  return value;
 }
 
 void buffer_poke(int buffer, unsigned offset, int type, variant value) {
   get_buffer(binbuff, buffer);
-  binbuff->Seek(offset);
-  if (type != buffer_string) {
-    //TODO: Implement buffer alignment.
-    //unsigned dsize = buffer_sizeof(type); //+ binbuff->alignment - 1;
-    std::vector<unsigned char> data = enigma::valToBytes(value, buffer_sizeof(type));
-    for (unsigned i = 0; i < data.size(); i++) {
-      binbuff->WriteByte(data[i]);
-    }
-  } else {
-    char byte = '1';
-    unsigned pos = 0;
-    while (byte != 0x00) {
-      byte = value[pos];
-      pos += 1;
-      binbuff->WriteByte(byte);
-    }
-    if (binbuff->alignment > pos) {
-      for (unsigned i = 0; i < binbuff->alignment - pos; i++) {
-        binbuff->WriteByte(0);
-      }
-    }
-  }
+  enigma::poke_value(binbuff, offset, type, value);
 }
 
 void buffer_write(int buffer, int type, variant value) {
   get_buffer(binbuff, buffer);
-  buffer_poke(buffer, binbuff->position, type, value);
+  const unsigned pos = binbuff->Align(binbuff->position);
+  binbuff->Seek((long long) pos + enigma::poke_value(binbuff, pos, type, value));
 }
 
 string buffer_md5(int buffer, unsigned offset, unsigned size) {
-  //get_bufferr(binbuff, buffer, 0);
-  //TODO: Write this function
-  return NULL;
+  get_bufferr(binbuff, buffer, "");
+  enigma::md5_hash hash;
+  enigma::for_each_span(binbuff, offset, size, [&](const unsigned char *data, size_t len) { hash.update(data, len); });
+  return hash.hexdigest();
 }
 
 string buffer_sha1(int buffer, unsigned offset, unsigned size) {
-  //get_bufferr(binbuff, buffer, 0);
-  //TODO: Write this function
-  return NULL;
+  get_bufferr(binbuff, buffer, "");
+  enigma::sha1_hash hash;
+  enigma::for_each_span(binbuff, offset, size, [&](const unsigned char *data, size_t len) { hash.update(data, len); });
+  return hash.hexdigest();
+}
+
+unsigned buffer_crc32(int buffer, unsigned offset, unsigned size) {
+  get_bufferr(binbuff, buffer, 0);
+  uint32_t crc = 0;
+  enigma::for_each_span(binbuff, offset, size, [&](const unsigned char *data, size_t len) {
+    crc = enigma::crc32_update(crc, data, len);
+  });
+  return crc;
 }
 
 int buffer_base64_decode(string str) {
-  enigma::BinaryBuffer* buffer = new enigma::BinaryBuffer(0);
+  enigma::BinaryBuffer* buffer = new enigma::BinaryBuffer(enigma::base64_decoded_size(str.data(), str.size()));
   buffer->type = buffer_grow;
   buffer->alignment = 1;
-  int id = enigma::get_free_buffer();
-  enigma::buffers.insert(enigma::buffers.begin() + id, buffer);
-  //TODO: Write this function
-  return id;
+  enigma::base64_decode(str.data(), str.size(), buffer->data.data());
+  return enigma::add_buffer(buffer);
 }
 
 int buffer_base64_decode_ext(int buffer, string str, unsigned offset) {
-  //get_bufferr(binbuff, buffer, -1);
-  //TODO: Write this function
-  return 0;
+  get_bufferr(binbuff, buffer, -1);
+  const size_t len = enigma::base64_decoded_size(str.data(), str.size());
+  if (binbuff->type == buffer_grow && offset + len > binbuff->GetSize()) binbuff->Resize(offset + len);
+  if (offset + len <= binbuff->GetSize()) {
+    enigma::base64_decode(str.data(), str.size(), binbuff->data.data() + offset);
+  } else {  // Clipped or wrapped, so decode it aside first
+    std::vector<unsigned char> bytes(len);
+    enigma::base64_decode(str.data(), str.size(), bytes.data());
+    binbuff->Write(offset, bytes.data(), len);
+  }
+  return len;
 }
 
 string buffer_base64_encode(int buffer, unsigned offset, unsigned size) {
-  //get_bufferr(binbuff, buffer, 0);
-  //TODO: Write this function
-  return NULL;
-}
-
-void game_save_buffer(int buffer) {
-  //get_buffer(binbuff, buffer);
-  //TODO: Write this function
-}
-
-void game_load_buffer(int buffer) {
-  //get_buffer(binbuff, buffer);
-  //TODO: Write this function
+  get_bufferr(binbuff, buffer, "");
+  // Base64 can only be joined at multiples of three bytes, so a range that
+  // wraps around is gathered into one piece first.
+  std::vector<std::pair<const unsigned char*, size_t>> spans;
+  enigma::for_each_span(binbuff, offset, size, [&](const unsigned char *data, size_t len) { spans.emplace_back(data, len); });
+  string res;
+  if (spans.size() == 1) {
+    enigma::base64_encode(spans[0].first, spans[0].second, res);
+  } else if (spans.size() == 2) {
+    std::vector<unsigned char> bytes(spans[0].first, spans[0].first + spans[0].second);
+    bytes.insert(bytes.end(), spans[1].first, spans[1].first + spans[1].second);
+    enigma::base64_encode(bytes.data(), bytes.size(), res);
+  }
+  return res;
 }
 
 }  // namespace enigma_user
@@ -0,0 +1,215 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "checksums.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <zlib.h>
+
+namespace enigma {
+
+namespace {
+
+inline uint32_t rotl(uint32_t x, unsigned n) { return (x << n) | (x >> (32 - n)); }
+
+inline uint32_t load_le(const unsigned char *p) {
+  return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+inline uint32_t load_be(const unsigned char *p) {
+  return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]);
+}
+
+std::string to_hex(const unsigned char *bytes, size_t size) {
+  static const char digits[] = "0123456789abcdef";
+  std::string res(size * 2, '0');
+  for (size_t i = 0; i < size; ++i) {
+    res[2 * i] = digits[bytes[i] >> 4];
+    res[2 * i + 1] = digits[bytes[i] & 15];
+  }
+  return res;
+}
+
+// Shared by both hashes: hashes whole blocks from data, keeping any
+// remainder in tail for the next call.
+template<typename Hash> void feed(Hash &h, uint64_t &length, unsigned char *tail,
+                                  const void *data, size_t size) {
+  const unsigned char *p = static_cast<const unsigned char*>(data);
+  size_t used = length % 64;
+  length += size;
+  if (used) {
+    const size_t n = std::min(size, 64 - used);
+    memcpy(tail + used, p, n);
+    p += n;
+    size -= n;
+    if (used + n < 64) return;
+    h.block(tail);
+  }
+  for (; size >= 64; p += 64, size -= 64) h.block(p);
+  memcpy(tail, p, size);
+}
+
+// Appends the 0x80 terminator, padding and 64-bit bit count to the tail and
+// hashes the last block or two.
+template<typename Hash> void pad(Hash &h, uint64_t length, unsigned char *tail, bool big_endian) {
+  size_t used = length % 64;
+  tail[used++] = 0x80;
+  if (used > 56) {
+    memset(tail + used, 0, 64 - used);
+    h.block(tail);
+    used = 0;
+  }
+  memset(tail + used, 0, 56 - used);
+  const uint64_t bits = length * 8;
+  for (int i = 0; i < 8; ++i)
+    tail[56 + i] = bits >> (big_endian ? 56 - 8 * i : 8 * i);
+  h.block(tail);
+}
+
+} // namespace
+
+// MD5 (RFC 1321)
+
+md5_hash::md5_hash(): state_{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476} {}
+
+#define MD5_STEP(f, a, b, c, d, x, k, s) \
+  a += f(b, c, d) + x + k; \
+  a = rotl(a, s) + b;
+#define MD5_F(x, y, z) (z ^ (x & (y ^ z)))
+#define MD5_G(x, y, z) (y ^ (z & (x ^ y)))
+#define MD5_H(x, y, z) (x ^ y ^ z)
+#define MD5_I(x, y, z) (y ^ (x | ~z))
+
+void md5_hash::block(const unsigned char *p) {
+  uint32_t x[16];
+  for (int i = 0; i < 16; ++i) x[i] = load_le(p + 4 * i);
+  uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+
+  MD5_STEP(MD5_F, a, b, c, d, x[ 0], 0xd76aa478,  7) MD5_STEP(MD5_F, d, a, b, c, x[ 1], 0xe8c7b756, 12)
+  MD5_STEP(MD5_F, c, d, a, b, x[ 2], 0x242070db, 17) MD5_STEP(MD5_F, b, c, d, a, x[ 3], 0xc1bdceee, 22)
+  MD5_STEP(MD5_F, a, b, c, d, x[ 4], 0xf57c0faf,  7) MD5_STEP(MD5_F, d, a, b, c, x[ 5], 0x4787c62a, 12)
+  MD5_STEP(MD5_F, c, d, a, b, x[ 6], 0xa8304613, 17) MD5_STEP(MD5_F, b, c, d, a, x[ 7], 0xfd469501, 22)
+  MD5_STEP(MD5_F, a, b, c, d, x[ 8], 0x698098d8,  7) MD5_STEP(MD5_F, d, a, b, c, x[ 9], 0x8b44f7af, 12)
+  MD5_STEP(MD5_F, c, d, a, b, x[10], 0xffff5bb1, 17) MD5_STEP(MD5_F, b, c, d, a, x[11], 0x895cd7be, 22)
+  MD5_STEP(MD5_F, a, b, c, d, x[12], 0x6b901122,  7) MD5_STEP(MD5_F, d, a, b, c, x[13], 0xfd987193, 12)
+  MD5_STEP(MD5_F, c, d, a, b, x[14], 0xa679438e, 17) MD5_STEP(MD5_F, b, c, d, a, x[15], 0x49b40821, 22)
+
+  MD5_STEP(MD5_G, a, b, c, d, x[ 1], 0xf61e2562,  5) MD5_STEP(MD5_G, d, a, b, c, x[ 6], 0xc040b340,  9)
+  MD5_STEP(MD5_G, c, d, a, b, x[11], 0x265e5a51, 14) MD5_STEP(MD5_G, b, c, d, a, x[ 0], 0xe9b6c7aa, 20)
+  MD5_STEP(MD5_G, a, b, c, d, x[ 5], 0xd62f105d,  5) MD5_STEP(MD5_G, d, a, b, c, x[10], 0x02441453,  9)
+  MD5_STEP(MD5_G, c, d, a, b, x[15], 0xd8a1e681, 14) MD5_STEP(MD5_G, b, c, d, a, x[ 4], 0xe7d3fbc8, 20)
+  MD5_STEP(MD5_G, a, b, c, d, x[ 9], 0x21e1cde6,  5) MD5_STEP(MD5_G, d, a, b, c, x[14], 0xc33707d6,  9)
+  MD5_STEP(MD5_G, c, d, a, b, x[ 3], 0xf4d50d87, 14) MD5_STEP(MD5_G, b, c, d, a, x[ 8], 0x455a14ed, 20)
+  MD5_STEP(MD5_G, a, b, c, d, x[13], 0xa9e3e905,  5) MD5_STEP(MD5_G, d, a, b, c, x[ 2], 0xfcefa3f8,  9)
+  MD5_STEP(MD5_G, c, d, a, b, x[ 7], 0x676f02d9, 14) MD5_STEP(MD5_G, b, c, d, a, x[12], 0x8d2a4c8a, 20)
+
+  MD5_STEP(MD5_H, a, b, c, d, x[ 5], 0xfffa3942,  4) MD5_STEP(MD5_H, d, a, b, c, x[ 8], 0x8771f681, 11)
+  MD5_STEP(MD5_H, c, d, a, b, x[11], 0x6d9d6122, 16) MD5_STEP(MD5_H, b, c, d, a, x[14], 0xfde5380c, 23)
+  MD5_STEP(MD5_H, a, b, c, d, x[ 1], 0xa4beea44,  4) MD5_STEP(MD5_H, d, a, b, c, x[ 4], 0x4bdecfa9, 11)
+  MD5_STEP(MD5_H, c, d, a, b, x[ 7], 0xf6bb4b60, 16) MD5_STEP(MD5_H, b, c, d, a, x[10], 0xbebfbc70, 23)
+  MD5_STEP(MD5_H, a, b, c, d, x[13], 0x289b7ec6,  4) MD5_STEP(MD5_H, d, a, b, c, x[ 0], 0xeaa127fa, 11)
+  MD5_STEP(MD5_H, c, d, a, b, x[ 3], 0xd4ef3085, 16) MD5_STEP(MD5_H, b, c, d, a, x[ 6], 0x04881d05, 23)
+  MD5_STEP(MD5_H, a, b, c, d, x[ 9], 0xd9d4d039,  4) MD5_STEP(MD5_H, d, a, b, c, x[12], 0xe6db99e5, 11)
+  MD5_STEP(MD5_H, c, d, a, b, x[15], 0x1fa27cf8, 16) MD5_STEP(MD5_H, b, c, d, a, x[ 2], 0xc4ac5665, 23)
+
+  MD5_STEP(MD5_I, a, b, c, d, x[ 0], 0xf4292244,  6) MD5_STEP(MD5_I, d, a, b, c, x[ 7], 0x432aff97, 10)
+  MD5_STEP(MD5_I, c, d, a, b, x[14], 0xab9423a7, 15) MD5_STEP(MD5_I, b, c, d, a, x[ 5], 0xfc93a039, 21)
+  MD5_STEP(MD5_I, a, b, c, d, x[12], 0x655b59c3,  6) MD5_STEP(MD5_I, d, a, b, c, x[ 3], 0x8f0ccc92, 10)
+  MD5_STEP(MD5_I, c, d, a, b, x[10], 0xffeff47d, 15) MD5_STEP(MD5_I, b, c, d, a, x[ 1], 0x85845dd1, 21)
+  MD5_STEP(MD5_I, a, b, c, d, x[ 8], 0x6fa87e4f,  6) MD5_STEP(MD5_I, d, a, b, c, x[15], 0xfe2ce6e0, 10)
+  MD5_STEP(MD5_I, c, d, a, b, x[ 6], 0xa3014314, 15) MD5_STEP(MD5_I, b, c, d, a, x[13], 0x4e0811a1, 21)
+  MD5_STEP(MD5_I, a, b, c, d, x[ 4], 0xf7537e82,  6) MD5_STEP(MD5_I, d, a, b, c, x[11], 0xbd3af235, 10)
+  MD5_STEP(MD5_I, c, d, a, b, x[ 2], 0x2ad7d2bb, 15) MD5_STEP(MD5_I, b, c, d, a, x[ 9], 0xeb86d391, 21)
+
+  state_[0] += a;
+  state_[1] += b;
+  state_[2] += c;
+  state_[3] += d;
+}
+
+#undef MD5_STEP
+#undef MD5_F
+#undef MD5_G
+#undef MD5_H
+#undef MD5_I
+
+void md5_hash::update(const void *data, size_t size) { feed(*this, length_, tail_, data, size); }
+
+std::string md5_hash::hexdigest() {
+  pad(*this, length_, tail_, false);
+  unsigned char digest[16];
+  for (int i = 0; i < 16; ++i) digest[i] = state_[i / 4] >> (8 * (i % 4));
+  return to_hex(digest, 16);
+}
+
+// SHA-1 (FIPS 180-4)
+
+sha1_hash::sha1_hash(): state_{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0} {}
+
+void sha1_hash::block(const unsigned char *p) {
+  uint32_t w[16];
+  for (int i = 0; i < 16; ++i) w[i] = load_be(p + 4 * i);
+  uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3], e = state_[4];
+
+  // The message schedule is kept as a ring of 16 words
+  for (int i = 0; i < 80; ++i) {
+    if (i >= 16) w[i & 15] = rotl(w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+    uint32_t f, k;
+    if (i < 20)      f = d ^ (b & (c ^ d)),       k = 0x5a827999;
+    else if (i < 40) f = b ^ c ^ d,               k = 0x6ed9eba1;
+    else if (i < 60) f = (b & c) | (d & (b | c)), k = 0x8f1bbcdc;
+    else             f = b ^ c ^ d,               k = 0xca62c1d6;
+    const uint32_t t = rotl(a, 5) + f + e + k + w[i & 15];
+    e = d;
+    d = c;
+    c = rotl(b, 30);
+    b = a;
+    a = t;
+  }
+
+  state_[0] += a;
+  state_[1] += b;
+  state_[2] += c;
+  state_[3] += d;
+  state_[4] += e;
+}
+
+void sha1_hash::update(const void *data, size_t size) { feed(*this, length_, tail_, data, size); }
+
+std::string sha1_hash::hexdigest() {
+  pad(*this, length_, tail_, true);
+  unsigned char digest[20];
+  for (int i = 0; i < 20; ++i) digest[i] = state_[i / 4] >> (24 - 8 * (i % 4));
+  return to_hex(digest, 20);
+}
+
+// zlib's crc32 is table-driven and already linked into every game; it only
+// takes a uInt length, so feed it in pieces.
+uint32_t crc32_update(uint32_t crc, const void *data, size_t size) {
+  const unsigned char *p = static_cast<const unsigned char*>(data);
+  while (size) {
+    const uInt n = std::min<size_t>(size, UINT_MAX);
+    crc = ::crc32(crc, p, n);
+    p += n;
+    size -= n;
+  }
+  return crc;
+}
+
+} // namespace enigma
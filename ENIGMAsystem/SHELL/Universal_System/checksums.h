@@ -0,0 +1,67 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifdef INCLUDED_FROM_SHELLMAIN
+#  error This file includes non-ENIGMA STL headers and should not be included from SHELLmain.
+#endif
+
+#ifndef ENIGMA_CHECKSUMS_H
+#define ENIGMA_CHECKSUMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace enigma {
+
+// Streaming MD5 and SHA-1. Feed the data through update() in as many pieces
+// as is convenient; whole 64-byte blocks are hashed straight out of the
+// caller's memory, so only a partial block at the end of a piece is copied.
+class md5_hash {
+ public:
+  md5_hash();
+  void update(const void *data, size_t size);
+  // The lowercase hex digest. The hash can't be updated afterwards.
+  std::string hexdigest();
+  // Hashes one whole 64-byte block; update() calls this.
+  void block(const unsigned char *p);
+
+ private:
+  uint32_t state_[4];
+  uint64_t length_ = 0;
+  unsigned char tail_[64];
+};
+
+class sha1_hash {
+ public:
+  sha1_hash();
+  void update(const void *data, size_t size);
+  std::string hexdigest();
+  void block(const unsigned char *p);
+
+ private:
+  uint32_t state_[5];
+  uint64_t length_ = 0;
+  unsigned char tail_[64];
+};
+
+// Continues a CRC-32 (the zlib/PNG polynomial) over more data. Start from 0.
+uint32_t crc32_update(uint32_t crc, const void *data, size_t size);
+
+} // namespace enigma
+
+#endif // ENIGMA_CHECKSUMS_H
@@ -0,0 +1,63 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "codecs.h"
+#include "Widget_Systems/widgets_mandatory.h"
+
+#include <string>
+#include <zlib.h>
+
+namespace enigma {
+
+namespace {
+
+long zlib_decode(const unsigned char* in, size_t insize, unsigned char* out, size_t outsize) {
+  uLongf written = outsize;
+  if (uncompress(out, &written, in, insize) != Z_OK) return -1;
+  return written;
+}
+
+// Filled in during static initialization, so it has to be built on first use.
+codec_decoder* decoders() {
+  static codec_decoder table[codec_count] = { zlib_decode };
+  return table;
+}
+
+}  // namespace
+
+void codec_register(int codec, codec_decoder decode) {
+  if (codec >= 0 && codec < codec_count) decoders()[codec] = decode;
+}
+
+const char* codec_name(int codec) {
+  switch (codec) {
+    case codec_zlib: return "zlib";
+    case codec_lz4:  return "LZ4";
+    case codec_zstd: return "zstd";
+    default: return "unknown";
+  }
+}
+
+bool codec_decompress(int codec, const unsigned char* in, size_t insize, unsigned char* out, size_t outsize) {
+  if (codec < 0 || codec >= codec_count || !decoders()[codec]) {
+    DEBUG_MESSAGE("Resource load error: this game was not built with " + std::string(codec_name(codec)) + " support", MESSAGE_TYPE::M_ERROR);
+    return false;
+  }
+  return decoders()[codec](in, insize, out, outsize) == long(outsize);
+}
+
+}  //namespace enigma
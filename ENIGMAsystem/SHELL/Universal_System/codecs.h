@@ -0,0 +1,50 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_CODECS_H
+#define ENIGMA_CODECS_H
+
+#include <cstddef>
+
+namespace enigma {
+
+/// Compression formats a blob in the resource block can be stored in. The
+/// numbers are written into games, so never reuse one.
+enum {
+  codec_zlib = 0,
+  codec_lz4  = 1,  // LZ4 block, for the fastest load.
+  codec_zstd = 2,  // Zstandard frame, for the smallest game.
+  codec_count
+};
+
+/// Decodes `insize` bytes into `out`, which has room for `outsize` bytes.
+/// Returns the number of bytes written, or a negative value on error.
+typedef long (*codec_decoder)(const unsigned char* in, size_t insize, unsigned char* out, size_t outsize);
+
+/// Zlib is always available. The others are in Universal_System/Codecs and
+/// are only built into games that were compiled with them; each registers
+/// itself when the game starts.
+void codec_register(int codec, codec_decoder decode);
+const char* codec_name(int codec);
+
+/// Decodes a blob straight into its final buffer. True only if the blob
+/// filled `out` exactly.
+bool codec_decompress(int codec, const unsigned char* in, size_t insize, unsigned char* out, size_t outsize);
+
+}  //namespace enigma
+
+#endif  //ENIGMA_CODECS_H
@@ -23,9 +23,13 @@
 #include <vector>
 #include "var4.h"
 #include "estring.h"
+#include "handle_table.h"
+#include "libEGMstd.h"
+#include "snapshot.h"
+
+#include <algorithm>
 
 #ifdef DEBUG_MODE
-#include "libEGMstd.h"
 #include "Widget_Systems/widgets_mandatory.h"
 #endif
 
@@ -67,113 +71,118 @@ static const char ldgrs[256] = {
   1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0
 };
 
-static const std::string base64_chars = 
+static const char base64_chars[] =
              "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
              "abcdefghijklmnopqrstuvwxyz"
              "0123456789+/";
 
-namespace enigma_user {
+namespace {
+// Each character's six bits, or 0xFF for anything that ends the encoded text
+// (padding, whitespace, or garbage).
+struct base64_table {
+  unsigned char value[256];
+  base64_table() {
+    memset(value, 0xFF, sizeof(value));
+    for (unsigned char i = 0; i < 64; ++i) value[(unsigned char) base64_chars[i]] = i;
+  }
+};
+const base64_table base64_values;
+
+size_t base64_valid_length(const char *str, size_t len) {
+  size_t n = 0;
+  while (n < len && base64_values.value[(unsigned char) str[n]] != 0xFF) ++n;
+  return n;
+}
+}  // namespace
+
+namespace enigma {
+
+void base64_encode(const unsigned char *data, size_t size, std::string &out) {
+  size_t pos = out.size();
+  out.resize(pos + (size + 2) / 3 * 4);
+  char *dest = &out[0] + pos;
+  // Three bytes become four characters; take them a group at a time
+  size_t i = 0;
+  for (; i + 3 <= size; i += 3, dest += 4) {
+    const unsigned v = data[i] << 16 | data[i + 1] << 8 | data[i + 2];
+    dest[0] = base64_chars[v >> 18];
+    dest[1] = base64_chars[(v >> 12) & 63];
+    dest[2] = base64_chars[(v >> 6) & 63];
+    dest[3] = base64_chars[v & 63];
+  }
+  if (i < size) {
+    const unsigned v = data[i] << 16 | (i + 1 < size ? data[i + 1] << 8 : 0);
+    dest[0] = base64_chars[v >> 18];
+    dest[1] = base64_chars[(v >> 12) & 63];
+    dest[2] = i + 1 < size ? base64_chars[(v >> 6) & 63] : '=';
+    dest[3] = '=';
+  }
+}
 
-bool is_base64(unsigned char c) {
-  return (isalnum(c) || (c == '+') || (c == '/'));
+size_t base64_decoded_size(const char *str, size_t len) {
+  const size_t n = base64_valid_length(str, len);
+  return n / 4 * 3 + (n % 4 ? n % 4 - 1 : 0);
 }
 
-string base64_encode(string const& str) {
-  size_t in_len = str.size();
-  string ret;
-  int i = 0;
-  int j = 0;
-  int in_ = 0;
-  unsigned char char_array_3[3];
-  unsigned char char_array_4[4];
-  
-  while (in_len--) {
-    char_array_3[i++] = str[in_]; in_++;
-    if (i == 3) {
-      char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-      char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-      char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-      char_array_4[3] = char_array_3[2] & 0x3f;
-
-      for(i = 0; (i <4) ; i++)
-        ret += base64_chars[char_array_4[i]];
-
-      i = 0;
-    }
+size_t base64_decode(const char *str, size_t len, unsigned char *out) {
+  const unsigned char *value = base64_values.value;
+  const size_t n = base64_valid_length(str, len);
+  const unsigned char *in = reinterpret_cast<const unsigned char*>(str);
+  unsigned char *dest = out;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4, dest += 3) {
+    const unsigned v = value[in[i]] << 18 | value[in[i + 1]] << 12 | value[in[i + 2]] << 6 | value[in[i + 3]];
+    dest[0] = v >> 16;
+    dest[1] = v >> 8;
+    dest[2] = v;
   }
-
-  if (i) {
-    for(j = i; j < 3; j++)
-      char_array_3[j] = '\0';
-
-    char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-    char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-    char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-    char_array_4[3] = char_array_3[2] & 0x3f;
-
-    for (j = 0; (j < i + 1); j++)
-      ret += base64_chars[char_array_4[j]];
-
-    while (i++ < 3)
-      ret += '=';
+  // A trailing group of two or three characters holds one or two bytes
+  if (n - i >= 2) {
+    const unsigned v = value[in[i]] << 18 | value[in[i + 1]] << 12 | (n - i == 3 ? value[in[i + 2]] << 6 : 0);
+    *dest++ = v >> 16;
+    if (n - i == 3) *dest++ = v >> 8;
   }
-
-  return ret;
-
+  return dest - out;
 }
 
-string base64_decode(string const& str) {
-  size_t in_len = str.size();
-  int i = 0;
-  int j = 0;
-  int in_ = 0;
-  unsigned char char_array_4[4], char_array_3[3];
-  string ret;
-
-  while (in_len-- && ( str[in_] != '=') && is_base64(str[in_])) {
-    char_array_4[i++] = str[in_]; in_++;
-    if (i ==4) {
-      for (i = 0; i <4; i++)
-        char_array_4[i] = base64_chars.find(char_array_4[i]);
-
-      char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-      char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-      char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
+}  // namespace enigma
 
-      for (i = 0; (i < 3); i++)
-        ret += char_array_3[i];
+static enigma::handle_table<string> string_builders("string_builder");
 
-      i = 0;
-    }
-  }
+static void snapshot_string_builders(enigma::snapshot_io &io) {
+  string_builders.snapshot(io);
+}
 
-  if (i) {
-    for (j = i; j <4; j++)
-      char_array_4[j] = 0;
+static enigma::snapshot_section string_builders_section("SB  ", snapshot_string_builders);
 
-    for (j = 0; j <4; j++)
-      char_array_4[j] = base64_chars.find(char_array_4[j]);
+namespace enigma_user {
 
-    char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-    char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-    char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
+bool is_base64(unsigned char c) {
+  return (isalnum(c) || (c == '+') || (c == '/'));
+}
 
-    for (j = 0; (j < i - 1); j++) ret += char_array_3[j];
-  }
+string base64_encode(string const& str) {
+  string ret;
+  enigma::base64_encode(reinterpret_cast<const unsigned char*>(str.data()), str.size(), ret);
+  return ret;
+}
 
+string base64_decode(string const& str) {
+  string ret(enigma::base64_decoded_size(str.data(), str.size()), '\0');
+  enigma::base64_decode(str.data(), str.size(), reinterpret_cast<unsigned char*>(&ret[0]));
   return ret;
 }
 
-double real(variant str) { return str.type ? atof(((string)str).c_str()) : (double) str; }
+double real(const variant &str) { return str.type ? atof(str.sval().c_str()) : (double) str; }
 
 string ansi_char(char byte) { return string(1,byte); }
 string chr(char val) { return string(1,val); }
-int ord(string str)  { return str[0]; }
+int ord(const string &str)  { return str[0]; }
 
-size_t string_length(string str) { return str.length(); }
+size_t string_length(const string &str) { return str.length(); }
 size_t string_length(const char* str) { return strlen(str); }
 
-size_t string_length_utf8(string str) { 
+size_t string_length_utf8(const string &str) { 
   size_t res = 0; 
   for (size_t i = 0; i < str.length(); ++i) 
     if ((str[i] & 0xC0) != 0x80) 
@@ -189,7 +198,7 @@ size_t string_length_utf8(const char* str) {
   return res; 
 }
 
-size_t string_pos(string substr,string str) {
+size_t string_pos(const string &substr, const string &str) {
   const size_t res = str.find(substr,0)+1;
   return res == string::npos ? 0 : (int)res;
 }
@@ -201,18 +210,20 @@ string string_format(double val, unsigned tot, unsigned dec) {
   return sbuf.data();
 }
 
-string string_copy(string str, int index, int count) {
+string string_copy(const string &str, int index, int count) {
   index = index < 0 ? 0 : index;
   return (size_t)index > str.length()? "": str.substr(index < 2? 0: index-1, count < 1? 0: count);
 }
 
-string string_set_byte_at(string str, int index, char byte) {
-  if (index<=1) return str + byte;
-  const size_t x = index-1;
-  return x>str.length()? str + byte: str.replace(x, 1, 1, byte);
+string string_set_byte_at(const string &str, int index, char byte) {
+  const size_t x = index <= 1 ? 0 : index-1;
+  if (index <= 1 || x >= str.length()) return str + byte;
+  string res(str);
+  res[x] = byte;
+  return res;
 }
 
-char string_byte_at(string str, int index) {
+char string_byte_at(const string &str, int index) {
   unsigned int n = index <= 1 ? 0 : (unsigned int)(index - 1);
   #ifdef DEBUG_MODE
     if (n > str.length())
@@ -221,7 +232,7 @@ char string_byte_at(string str, int index) {
   return str[n];
 }
 
-string string_char_at(string str,int index) {
+string string_char_at(const string &str,int index) {
   unsigned int n = index <= 1 ? 0 : (unsigned int)(index - 1);
   #ifdef DEBUG_MODE
     if (n > str.length())
@@ -230,91 +241,122 @@ string string_char_at(string str,int index) {
   return string(1, str[n]);
 }
 
-string string_delete(string str,int index,int count) {
-  return str.erase(index < 2? 0: index-1, count < 1? 0: count);
+string string_delete(const string &str,int index,int count) {
+  const size_t pos = std::min<size_t>(index < 2? 0: index-1, str.length());
+  const size_t n = std::min<size_t>(count < 1? 0: count, str.length() - pos);
+  string res;
+  res.reserve(str.length() - n);
+  res.append(str, 0, pos).append(str, pos + n, string::npos);
+  return res;
 }
 
-string string_insert(string substr,string str,int index) {
-  if (index<=1) return substr + str;
-  const size_t x = index-1;
-  return x>str.length()? str + substr: str.insert(x, substr);
+string string_insert(const string &substr, const string &str, int index) {
+  const size_t x = index <= 1 ? 0 : std::min<size_t>(index-1, str.length());
+  string res;
+  res.reserve(str.length() + substr.length());
+  res.append(str, 0, x).append(substr).append(str, x, string::npos);
+  return res;
 }
 
-string string_replace(string str,string substr,string newstr) {
-  size_t pos=str.find(substr,0);
-  return pos==(size_t)-1?str:str.replace(pos,substr.length(),newstr);
+string string_replace(const string &str, const string &substr, const string &newstr) {
+  const size_t pos=str.find(substr,0);
+  if (pos == string::npos) return str;
+  string res;
+  res.reserve(str.length() - substr.length() + newstr.length());
+  res.append(str, 0, pos).append(newstr).append(str, pos + substr.length(), string::npos);
+  return res;
 }
 
-string string_replace_all(string str,string substr,string newstr) {
-  return ::string_replace_all(str, substr, newstr);
+// Copies each stretch between matches once, so this is linear in the length
+// of the result rather than shifting the tail of the string for every match.
+string string_replace_all(const string &str, const string &substr, const string &newstr) {
+  if (substr.empty()) return str;
+  string res;
+  size_t last = 0, pos;
+  while ((pos = str.find(substr, last)) != string::npos) {
+    if (res.empty()) res.reserve(str.length() + (newstr.length() > substr.length() ? str.length() / 4 : 0));
+    res.append(str, last, pos - last).append(newstr);
+    last = pos + substr.length();
+  }
+  if (!last) return str;
+  res.append(str, last, string::npos);
+  return res;
 }
 
-size_t string_count(string substr,string str) {
+size_t string_count(const string &substr, const string &str) {
   size_t pos = 0, occ = 0;
   const size_t sublen = substr.length();
+  if (!sublen) return 0;
   while((pos=str.find(substr,pos)) != string::npos)
     occ++, pos += sublen;
   return occ;
 }
 
-string string_lower(string str) {
-  const size_t len = str.length();
+string string_lower(const string &str) {
+  string res(str);
+  const size_t len = res.length();
   for (size_t i = 0; i < len; ++i)
-    if (ldgrs[(int)(unsigned char)str[i]] & 2)
-      str[i] += 32;
-  return str;
+    if (ldgrs[(int)(unsigned char)res[i]] & 2)
+      res[i] += 32;
+  return res;
 }
 
-string string_upper(string str) {
-  const size_t len = str.length();
+string string_upper(const string &str) {
+  string res(str);
+  const size_t len = res.length();
   for (size_t i = 0; i < len; ++i)
-    if (ldgrs[(unsigned char)str[i]] & 1)
-      str[i] -= 32;
-  return str;
+    if (ldgrs[(unsigned char)res[i]] & 1)
+      res[i] -= 32;
+  return res;
 }
 
-string string_repeat(string str,int count) {
-  string ret; ret.reserve(str.length() * count);
+string string_repeat(const string &str,int count) {
+  string ret;
+  if (count <= 0) return ret;
+  ret.reserve(str.length() * count);
   for(int i = count; i; i--) ret.append(str);
   return ret;
 }
 
-string string_letters(string str) {
+string string_letters(const string &str) {
   string ret;
+  ret.reserve(str.length());
   for(const char*c=str.c_str();*c;c++)
     if(ldgrs[(unsigned char)*c]&3) ret+=*c;
   return ret;
 }
 
-string string_digits(string str) {
+string string_digits(const string &str) {
   string ret;
+  ret.reserve(str.length());
   for(const char*c=str.c_str();*c;c++)
     if(ldgrs[(unsigned char)*c]&4) ret += *c;
   return ret;
 }
 
-string string_lettersdigits(string str) {
+string string_lettersdigits(const string &str) {
   string ret;
+  ret.reserve(str.length());
   for(const char*c=str.c_str();*c;c++)
     if(ldgrs[(unsigned char)*c]) ret += *c;
   return ret;
 }
 
-bool string_isletters(string str) {
+bool string_isletters(const string &str) {
   for(const char*c = str.c_str(); *c; c++)
     if(!(ldgrs[(unsigned char)*c] & 3))
       return false;
   return true;
 }
 
-bool string_isdigits(string str) {
+bool string_isdigits(const string &str) {
   for(const char*c = str.c_str(); *c; c++)
     if(!(ldgrs[(unsigned char)*c] & 4))
       return false;
   return true;
 }
 
-bool string_islettersdigits(string str) {
+bool string_islettersdigits(const string &str) {
   for(const char*c=str.c_str(); *c; c++)
     if(!ldgrs[(unsigned char)*c])
       return false;
@@ -323,19 +365,19 @@ bool string_islettersdigits(string str) {
 
 //filename fucntions place here as they are just string based
 
-string filename_name(string fname)
+string filename_name(const string &fname)
 {
   size_t fp = fname.find_last_of("/\\");
   return fname.substr(fp+1);
 }
 
-string filename_path(string fname)
+string filename_path(const string &fname)
 {
   size_t fp = fname.find_last_of("/\\");
   return fname.substr(0,fp+1);
 }
 
-string filename_dir(string fname)
+string filename_dir(const string &fname)
 {
   size_t fp = fname.find_last_of("/\\");
   if (fp == string::npos)
@@ -343,7 +385,7 @@ string filename_dir(string fname)
   return fname.substr(0, fp);
 }
 
-string filename_drive(string fname)
+string filename_drive(const string &fname)
 {
   size_t fp = fname.find_first_of("/\\");
   if (!fp || fp == string::npos || fname[fp-1] != ':')
@@ -351,21 +393,21 @@ string filename_drive(string fname)
   return fname.substr(0, fp);
 }
 
-string filename_ext(string fname)
+string filename_ext(const string &fname)
 {
-  fname = filename_name(fname);
-  size_t fp = fname.find_last_of(".");
-  if (fp == string::npos)
+  const size_t name = fname.find_last_of("/\\");
+  const size_t fp = fname.find_last_of(".");
+  if (fp == string::npos || (name != string::npos && fp < name))
     return "";
   return fname.substr(fp);
 }
 
-string filename_change_ext(string fname, string newext)
+string filename_change_ext(const string &fname, const string &newext)
 {
   size_t fp = fname.find_last_of(".");
   if (fp == string::npos)
     return fname + newext;
-  return fname.replace(fp,fname.length(),newext);
+  return fname.substr(0, fp) + newext;
 }
 
 var string_split(const std::string &str, const std::string &delim,
@@ -386,4 +428,41 @@ var string_split(const std::string &str, const std::string &delim,
   return res;
 }
 
+unsigned string_builder_create(size_t capacity) {
+  string text;
+  text.reserve(capacity);
+  return string_builders.add(std::move(text));
+}
+
+void string_builder_destroy(unsigned id) {
+  string_builders.destroy(id);
+}
+
+bool string_builder_exists(unsigned id) {
+  return string_builders.exists(id);
+}
+
+void string_builder_append(unsigned id, const variant &value) {
+  string &text = string_builders[id];
+  if (value.type == enigma_user::ty_string) text += value.sval();
+  else text += toString(value);
+}
+
+void string_builder_append_line(unsigned id, const variant &value) {
+  string_builder_append(id, value);
+  string_builders[id] += '\n';
+}
+
+void string_builder_clear(unsigned id) {
+  string_builders[id].clear();
+}
+
+size_t string_builder_length(unsigned id) {
+  return string_builders[id].length();
+}
+
+string string_builder_get(unsigned id) {
+  return string_builders[id];
+}
+
 }
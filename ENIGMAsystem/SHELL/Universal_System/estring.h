@@ -34,6 +34,18 @@ std::string shorten(tstring str);
 
 #endif
 
+namespace enigma {
+
+// Raw base64 for callers that have the bytes in hand, such as the buffers.
+// Encoding appends to out. Decoding stops at the first character that isn't
+// base64 (including '=' padding); base64_decoded_size says how many bytes
+// base64_decode will write for the same text.
+void base64_encode(const unsigned char *data, size_t size, std::string &out);
+size_t base64_decoded_size(const char *str, size_t len);
+size_t base64_decode(const char *str, size_t len, unsigned char *out);
+
+}  //namespace enigma
+
 namespace enigma_user {
 
 std::string base64_encode(std::string const& str);
@@ -43,51 +55,66 @@ bool is_base64(unsigned char byte);
 
 std::string ansi_char(char byte);
 std::string chr(char val);
-int ord(std::string str);
+int ord(const std::string &str);
 
-double real(variant str);
+double real(const variant &str);
 
-size_t string_length(std::string str);
+// The string functions take their arguments by const reference, so a call
+// doesn't copy its inputs; only the result is a new string.
+size_t string_length(const std::string &str);
 size_t string_length(const char* str);
 #define string_byte_length(x) string_length(x)
-size_t string_length_utf8(std::string str);
+size_t string_length_utf8(const std::string &str);
 size_t string_length_utf8(const char* str);
-size_t string_pos(std::string substr, std::string str);
+size_t string_pos(const std::string &substr, const std::string &str);
 
 std::string string_format(double val, unsigned tot, unsigned dec);
-std::string string_copy(std::string str, int index, int count);
-std::string string_set_byte_at(std::string str, int pos, char byte);
-char string_byte_at(std::string str, int index);
-std::string string_char_at(std::string str, int index);
-std::string string_delete(std::string str, int index, int count);
-std::string string_insert(std::string substr, std::string str, int index);
-std::string string_replace(std::string str, std::string substr, std::string newstr);
-std::string string_replace_all(std::string str, std::string substr, std::string newstr);
-size_t string_count(std::string substr, std::string str);
-
-std::string string_lower(std::string str);
-std::string string_upper(std::string str);
-
-std::string string_repeat(std::string str, int count);
-
-std::string string_letters(std::string str);
-std::string string_digits(std::string str);
-std::string string_lettersdigits(std::string str);
-
-bool string_isletters(std::string str);
-bool string_isdigits(std::string str);
-bool string_islettersdigits(std::string str);
-
-std::string filename_name(std::string fname);
-std::string filename_path(std::string fname);
-std::string filename_dir(std::string fname);
-std::string filename_drive(std::string fname);
-std::string filename_ext(std::string fname);
-std::string filename_change_ext(std::string fname, std::string newext);
+std::string string_copy(const std::string &str, int index, int count);
+std::string string_set_byte_at(const std::string &str, int pos, char byte);
+char string_byte_at(const std::string &str, int index);
+std::string string_char_at(const std::string &str, int index);
+std::string string_delete(const std::string &str, int index, int count);
+std::string string_insert(const std::string &substr, const std::string &str, int index);
+std::string string_replace(const std::string &str, const std::string &substr, const std::string &newstr);
+std::string string_replace_all(const std::string &str, const std::string &substr, const std::string &newstr);
+size_t string_count(const std::string &substr, const std::string &str);
+
+std::string string_lower(const std::string &str);
+std::string string_upper(const std::string &str);
+
+std::string string_repeat(const std::string &str, int count);
+
+std::string string_letters(const std::string &str);
+std::string string_digits(const std::string &str);
+std::string string_lettersdigits(const std::string &str);
+
+bool string_isletters(const std::string &str);
+bool string_isdigits(const std::string &str);
+bool string_islettersdigits(const std::string &str);
+
+std::string filename_name(const std::string &fname);
+std::string filename_path(const std::string &fname);
+std::string filename_dir(const std::string &fname);
+std::string filename_drive(const std::string &fname);
+std::string filename_ext(const std::string &fname);
+std::string filename_change_ext(const std::string &fname, const std::string &newext);
 
 var string_split(const std::string &str, const std::string &delim,
                  bool skip_empty = false);
 
+// String builders collect text a piece at a time, for building long strings
+// (logs, exported files, UI text) without the copy that `s = s + piece`
+// makes on every step. Appending is amortized O(1); reals are written the way
+// string() writes them.
+unsigned string_builder_create(size_t capacity = 0);
+void string_builder_destroy(unsigned id);
+bool string_builder_exists(unsigned id);
+void string_builder_append(unsigned id, const variant &value);
+void string_builder_append_line(unsigned id, const variant &value);
+void string_builder_clear(unsigned id);
+size_t string_builder_length(unsigned id);
+std::string string_builder_get(unsigned id);
+
 }  //namespace enigma_user
 
 #endif  //ENIGMA_ESTRING_H
@@ -20,32 +20,135 @@
 #include "Platforms/General/fileio.h"
 #include "Resources/AssetArray.h"
 #include "Widget_Systems/widgets_mandatory.h"
+#include "buffers.h"
+#include "buffers_internal.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <iomanip>
 
+#ifdef _WIN32
+  #include "estring.h" // widen
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 #ifdef DEBUG_MODE
 #define try_io_and_print(f) print_and_clear_fs_status(__FUNCTION__, f);
+#define report_io_failure(f) DEBUG_MESSAGE(std::string("Operation: ") + __FUNCTION__ + " failed on: " + (f).fn, MESSAGE_TYPE::M_USER_ERROR)
 #else
 #define try_io_and_print(f)
+#define report_io_failure(f) ((void) 0)
 #endif
 
 namespace enigma {
-  
+
+  // Binary files go through a buffer this big, so a run of file_bin_write_byte
+  // calls reaches the OS in large blocks.
+  static const size_t file_bin_buffer_size = 256 * 1024;
+
+  // Files opened with file_bin_open for reading only are mapped into memory
+  // instead of streamed; reads are then plain loads from `view`. Everything
+  // else, including a file that can't be mapped, goes through `fs`.
   struct file {
     file() {}
-    file(const std::string& fName, std::ios_base::openmode mode) : fn(fName) { fs.open(fName, mode); }
-    file(file&& other) : fn(other.fn) { fs.swap(other.fs); }
+    file(const std::string& fName, std::ios_base::openmode mode) : fn(fName) {
+      if (mode & std::ios::binary) {
+        buffer.reset(new char[file_bin_buffer_size]);
+        fs.rdbuf()->pubsetbuf(buffer.get(), file_bin_buffer_size);
+      }
+      fs.open(fName, mode);
+    }
+    file(file&& other) : fn(other.fn), buffer(std::move(other.buffer)), mapping(other.mapping),
+        view(other.view), view_size(other.view_size), view_pos(other.view_pos) {
+      fs.swap(other.fs);
+      other.mapping = nullptr;
+      other.view = nullptr;
+    }
+    ~file() { unmap(); }
     std::string fn;
+    std::unique_ptr<char[]> buffer;  // Must outlive fs
     std::fstream fs;
+    void *mapping = nullptr;
+    const unsigned char *view = nullptr;
+    size_t view_size = 0, view_pos = 0;
+
+    bool mapped() const { return view != nullptr; }
+    bool map();
+    void unmap();
+    void close() { unmap(); fs.close(); }
     // AssArray mandatory
     static const char* getAssetTypeName() { return "FileHandle"; }
     bool isDestroyed() const { return false; }
-    void destroy() { fs.close(); }
+    void destroy() { close(); }
   };
-  
+
+  bool file::map() {
+    #ifdef _WIN32
+    HANDLE f = CreateFileW(widen(fn).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size)) { CloseHandle(f); return false; }
+    if (size.QuadPart == 0) {
+      // Empty files can't be mapped, and there's nothing to read anyway.
+      CloseHandle(f);
+      static const unsigned char nothing = 0;
+      view = &nothing;
+      view_size = view_pos = 0;
+      return true;
+    }
+    HANDLE m = CreateFileMappingW(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(f);
+    if (!m) return false;
+    void *v = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(m);  // The view keeps the mapping alive
+    if (!v) return false;
+    view_size = size.QuadPart;
+    #else
+    int fd = ::open(fn.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) { ::close(fd); return false; }
+    if (st.st_size == 0) {
+      ::close(fd);
+      static const unsigned char nothing = 0;
+      view = &nothing;
+      view_size = view_pos = 0;
+      return true;
+    }
+    void *v = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping outlives the descriptor
+    if (v == MAP_FAILED) return false;
+    view_size = st.st_size;
+    #endif
+    mapping = v;
+    view = (const unsigned char*) v;
+    view_pos = 0;
+    return true;
+  }
+
+  void file::unmap() {
+    if (mapping) {
+      #ifdef _WIN32
+      UnmapViewOfFile(mapping);
+      #else
+      munmap(mapping, view_size);
+      #endif
+    }
+    mapping = nullptr;
+    view = nullptr;
+    view_size = view_pos = 0;
+  }
+
   AssetArray<file> files;
   
   static void print_and_clear_fs_status(const std::string& operation, file& f) {
@@ -68,6 +171,45 @@ namespace enigma {
       return files.size()-1;
     } else return -1;
   }
+
+  static inline int file_map(const std::string& fname) {
+    file f;
+    f.fn = fname;
+    if (!f.map()) return file_open(fname, std::ios::in | std::ios::binary);
+    files.add(std::move(f));
+    return files.size()-1;
+  }
+
+  // How many bytes are left between the read position and the end of the file.
+  static size_t bytes_remaining(file& f) {
+    if (f.mapped()) return f.view_pos < f.view_size ? f.view_size - f.view_pos : 0;
+    std::streambuf *sb = f.fs.rdbuf();
+    const std::streamoff pos = sb->pubseekoff(0, std::ios::cur, std::ios::in);
+    const std::streamoff end = sb->pubseekoff(0, std::ios::end, std::ios::in);
+    sb->pubseekpos(pos, std::ios::in);
+    return pos < 0 || end < pos ? 0 : size_t(end - pos);
+  }
+
+  static size_t file_read(file& f, void *dest, size_t size) {
+    if (f.mapped()) {
+      size = std::min(size, bytes_remaining(f));
+      memcpy(dest, f.view + f.view_pos, size);
+      f.view_pos += size;
+      return size;
+    }
+    const std::streamsize got = f.fs.rdbuf()->sgetn(static_cast<char*>(dest), size);
+    return got < 0 ? 0 : size_t(got);
+  }
+
+  static size_t file_write(file& f, const void *src, size_t size) {
+    if (f.mapped()) {
+      report_io_failure(f);
+      return 0;
+    }
+    const std::streamsize put = f.fs.rdbuf()->sputn(static_cast<const char*>(src), size);
+    if (put < std::streamsize(size)) report_io_failure(f);
+    return put < 0 ? 0 : size_t(put);
+  }
 } // NAMESPACE enigma
 
 
@@ -91,7 +233,7 @@ int file_text_open_append(const std::string& fname) {
 // Closes the file with the given file id
 void file_text_close(int fileid) {
   if (fileid >= 0 && fileid < static_cast<int>(enigma::files.size())) {
-    enigma::files.get(fileid).fs.close();
+    enigma::files.get(fileid).close();
   } else DEBUG_MESSAGE("Cannot close an unopened file: " + std::to_string(fileid), MESSAGE_TYPE::M_USER_ERROR);
 }
 
@@ -129,12 +271,15 @@ std::string file_text_read_string(int fileid) {
   return line;
 }
 
+// Reads the rest of the file in one go. Line breaks are dropped, as when the
+// lines are read one at a time.
 std::string file_text_read_all(int fileid) {
-  std::string all, line;
-  while(std::getline(enigma::files.get(fileid).fs, line)) {
-    try_io_and_print(enigma::files.get(fileid))
-    all += line;
-  }
+  std::fstream &fs = enigma::files.get(fileid).fs;
+  std::ostringstream rest;
+  if (fs.rdbuf()->sgetc() != EOF) rest << fs.rdbuf();
+  std::string all = rest.str();
+  all.erase(std::remove(all.begin(), all.end(), '\n'), all.end());
+  fs.setstate(std::ios::eofbit);
   return all;
 }
 
@@ -170,7 +315,7 @@ void load_info(const std::string& fname) {
 int file_bin_open(const std::string& fname, int mode) {
   // TODO: add other modes like trunc / append?
   switch (mode) {
-    case 0: return enigma::file_open(fname, std::ios::in  | std::ios::binary);
+    case 0: return enigma::file_map(fname);
     case 1: return enigma::file_open(fname, std::ios::out | std::ios::binary);
     case 2: return enigma::file_open(fname, std::ios::in  | std::ios::out | std::ios::binary);
     default: return -1;
@@ -179,51 +324,111 @@ int file_bin_open(const std::string& fname, int mode) {
 
 // Rewrites the file with the given file id, that is, clears it and starts writing at the start.
 bool file_bin_rewrite(int fileid) {
-  enigma::files.get(fileid).fs.close();
-  enigma::files.get(fileid).fs.open(enigma::files.get(fileid).fn, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
-  try_io_and_print(enigma::files.get(fileid))
-  return enigma::files.get(fileid).fs.good();
+  enigma::file &f = enigma::files.get(fileid);
+  f.close();
+  if (!f.buffer) {
+    f.buffer.reset(new char[enigma::file_bin_buffer_size]);
+    f.fs.rdbuf()->pubsetbuf(f.buffer.get(), enigma::file_bin_buffer_size);
+  }
+  f.fs.open(f.fn, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+  try_io_and_print(f)
+  return f.fs.good();
 }
 
 // Closes the file with the given file id.
 void file_bin_close(int fileid) {
-  enigma::files.get(fileid).fs.close();
+  enigma::files.get(fileid).close();
 }
 
 // Returns the size (in bytes) of the file with the given file id.
 size_t file_bin_size(int fileid) {
-  size_t currPos = enigma::files.get(fileid).fs.tellg();
-  enigma::files.get(fileid).fs.seekg(0, enigma::files.get(fileid).fs.end);
-  size_t length = enigma::files.get(fileid).fs.tellg();
-  enigma::files.get(fileid).fs.seekg(currPos);
-  try_io_and_print(enigma::files.get(fileid))
+  enigma::file &f = enigma::files.get(fileid);
+  if (f.mapped()) return f.view_size;
+  size_t currPos = f.fs.tellg();
+  f.fs.seekg(0, f.fs.end);
+  size_t length = f.fs.tellg();
+  f.fs.seekg(currPos);
+  try_io_and_print(f)
   return length;
 }
 
 // Returns the current position (in bytes; 0 is the first position) of the file with the given file id.
 size_t file_bin_position(int fileid) {
-  return enigma::files.get(fileid).fs.tellg();
+  enigma::file &f = enigma::files.get(fileid);
+  if (f.mapped()) return f.view_pos;
+  return f.fs.tellg();
 }
 
 // Moves the current position of the file to the indicated position. To append to a file move the position to the size of the file before writing.
 void file_bin_seek(int fileid, size_t pos) {
-  enigma::files.get(fileid).fs.seekg(pos);
-  try_io_and_print(enigma::files.get(fileid))
+  enigma::file &f = enigma::files.get(fileid);
+  if (f.mapped()) {
+    f.view_pos = pos;
+    return;
+  }
+  f.fs.seekg(pos);
+  try_io_and_print(f)
 }
 
 // Writes a byte of data to the file with the given file id.
 void file_bin_write_byte(int fileid, unsigned char byte) {
-  enigma::files.get(fileid).fs << byte;
-  try_io_and_print(enigma::files.get(fileid))
+  enigma::file &f = enigma::files.get(fileid);
+  if (f.mapped() || f.fs.rdbuf()->sputc(byte) == EOF) report_io_failure(f);
 }
 
 // Reads a byte of data from the file and returns this
 int file_bin_read_byte(int fileid) {
-  unsigned char byte = 0;
-  enigma::files.get(fileid).fs >> std::noskipws >> byte;
-  bool good = enigma::files.get(fileid).fs.good();
-  try_io_and_print(enigma::files.get(fileid))
-  return (!good) ? -1 : static_cast<int>(byte);
+  enigma::file &f = enigma::files.get(fileid);
+  if (f.mapped()) return f.view_pos < f.view_size ? f.view[f.view_pos++] : -1;
+  const int byte = f.fs.rdbuf()->sbumpc();
+  if (byte == EOF) report_io_failure(f);
+  return byte == EOF ? -1 : byte;
+}
+
+// Reads up to size bytes from the file into the buffer, starting at offset in the buffer. The buffer grows, wraps or drops the excess according to its type. Returns how many bytes were read.
+size_t file_bin_read_buffer(int fileid, int buffer, unsigned offset, size_t size) {
+  get_bufferr(binbuff, buffer, 0);
+  enigma::file &f = enigma::files.get(fileid);
+  size = std::min(size, enigma::bytes_remaining(f));
+  if (f.mapped()) {
+    const unsigned read = binbuff->Write(offset, f.view + f.view_pos, size);
+    f.view_pos += read;
+    return read;
+  }
+  if (binbuff->type == buffer_grow && size_t(offset) + size > binbuff->data.size())
+    binbuff->Resize(offset + size);
+  if (size_t(offset) + size <= binbuff->data.size())
+    return enigma::file_read(f, binbuff->data.data() + offset, size);
+  std::vector<unsigned char> bytes(size);
+  bytes.resize(enigma::file_read(f, bytes.data(), size));
+  return binbuff->Write(offset, bytes.data(), bytes.size());
+}
+
+// Writes size bytes of the buffer, starting at offset, to the file. Returns how many bytes were written.
+size_t file_bin_write_buffer(int fileid, int buffer, unsigned offset, size_t size) {
+  get_bufferr(binbuff, buffer, 0);
+  enigma::file &f = enigma::files.get(fileid);
+  if (binbuff->type == buffer_wrap) {
+    std::vector<unsigned char> bytes(size);
+    binbuff->Read(offset, bytes.data(), size);
+    return enigma::file_write(f, bytes.data(), size);
+  }
+  if (offset >= binbuff->data.size()) return 0;
+  size = std::min<size_t>(size, binbuff->data.size() - offset);
+  return enigma::file_write(f, binbuff->data.data() + offset, size);
+}
+
+// Reads up to size bytes from the file and returns them as a string.
+std::string file_bin_read_string(int fileid, size_t size) {
+  enigma::file &f = enigma::files.get(fileid);
+  std::string str(std::min(size, enigma::bytes_remaining(f)), '\0');
+  str.resize(enigma::file_read(f, &str[0], str.size()));
+  return str;
+}
+
+// Writes the bytes of the string to the file.
+void file_bin_write_string(int fileid, const std::string& str) {
+  enigma::file_write(enigma::files.get(fileid), str.data(), str.size());
 }
 
 } // NAMESPACE enigma_user
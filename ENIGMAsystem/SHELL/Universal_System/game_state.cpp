@@ -0,0 +1,292 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#include "game_state.h"
+#include "snapshot.h"
+#include "buffers.h"
+#include "buffers_internal.h"
+#include "roomsystem.h"
+#include "Instances/callbacks_events.h"
+#include "Instances/instance.h"
+#include "Instances/instance_system.h"
+#include "Instances/instance_system_frontend.h"
+#include "Widget_Systems/widgets_mandatory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+
+// A save is a short header followed by tagged sections:
+//
+//   "ESAV" version room maxid
+//   { tag[4] length payload }...
+//   "END " 0
+//
+// Every section carries its length, so a load can step over sections it has
+// no reader for, and a damaged save is caught before anything is torn down.
+// The INST section holds one record per instance: object, ID, length, then
+// the instance's variables as its $snapshot() wrote them. DEAC holds the
+// deactivated instances the same way; they come back deactivated.
+
+namespace enigma {
+
+extern roomstruct** roomdata;
+
+namespace {
+
+const unsigned save_version = 1;
+const size_t header_size = 16, section_header_size = 8;
+
+struct section_entry {
+  char tag[4];
+  snapshot_section_fn fn;
+};
+
+std::vector<section_entry> &sections() {
+  static std::vector<section_entry> list;  // Filled during static initialization
+  return list;
+}
+
+// A game_load waits here for the end of the step.
+std::vector<unsigned char> pending_load;
+bool load_pending = false;
+
+// Reused between saves, so a save only allocates while the game is growing.
+std::vector<unsigned char> scratch;
+
+template<typename F> void write_section(std::vector<unsigned char> &data, const char tag[4], F body) {
+  data.insert(data.end(), tag, tag + 4);
+  const size_t at = data.size();
+  data.resize(at + 4);
+  snapshot_io io(data, false);
+  body(io);
+  const unsigned len = data.size() - at - 4;
+  memcpy(&data[at], &len, sizeof len);
+}
+
+// Writes a count, then a record for each instance `each` hands to its callback.
+template<typename F> void save_instance_records(snapshot_io &io, F each) {
+  const size_t count_at = io.tell();
+  unsigned count = 0;
+  io(count);
+  each([&](object_basic *inst) {
+    int object = inst->object_index, id = inst->id;
+    unsigned len = 0;
+    io(object); io(id); io(len);
+    const size_t start = io.tell();
+    inst->$snapshot(io);
+    io.patch(start - sizeof len, io.tell() - start);
+    ++count;
+  });
+  io.patch(count_at, count);
+}
+
+void save_instances(snapshot_io &io) {
+  save_instance_records(io, [](const std::function<void(object_basic*)> &record) {
+    for (iterator it = instance_list_first(); it; ++it) record(*it);
+  });
+}
+
+void save_deactivated(snapshot_io &io) {
+  save_instance_records(io, [](const std::function<void(object_basic*)> &record) {
+    for (const auto &entry : instance_deactivated_list) record(entry.second);
+  });
+}
+
+void load_instances(snapshot_io &io, bool deactivated) {
+  unsigned count = 0;
+  io(count);
+  for (unsigned i = 0; i < count && io.ok(); ++i) {
+    int object = 0, id = 0;
+    unsigned len = 0;
+    io(object); io(id); io(len);
+    const size_t end = io.tell() + len;
+    if (!io.fits(len)) break;
+    if (object_basic *inst = instance_create_id(0, 0, object, id)) {
+      inst->$snapshot(io);
+      if (deactivated) {
+        inst->deactivate();
+        instance_deactivated_list.insert(std::make_pair(int(inst->id), inst));
+      }
+    }
+    io.skip_to(end);
+  }
+}
+
+// Checks the framing of a save and returns its total length, or 0 if the
+// bytes aren't a save this game can read.
+size_t save_extent(const unsigned char *data, size_t size) {
+  unsigned version;
+  if (size < header_size || memcmp(data, "ESAV", 4)) return 0;
+  memcpy(&version, data + 4, 4);
+  if (version != save_version) return 0;
+  for (size_t pos = header_size; size - pos >= section_header_size; ) {
+    unsigned len;
+    memcpy(&len, data + pos + 4, 4);
+    if (!memcmp(data + pos, "END ", 4)) return pos + section_header_size;
+    pos += section_header_size;
+    if (len > size - pos) return 0;
+    pos += len;
+  }
+  return 0;
+}
+
+void save_game(std::vector<unsigned char> &data) {
+  int room = enigma_user::room, id_max = maxid;
+  data.insert(data.end(), "ESAV", "ESAV" + 4);
+  snapshot_io head(data, false);
+  unsigned version = save_version;
+  head(version); head(room); head(id_max);
+
+  write_section(data, "ROOM", snapshot_room_variables);
+  write_section(data, "GLOB", snapshot_globals);
+  for (const section_entry &s : sections())
+    write_section(data, s.tag, s.fn);
+  write_section(data, "INST", save_instances);
+  write_section(data, "DEAC", save_deactivated);
+  write_section(data, "END ", [](snapshot_io&) {});
+}
+
+// Replaces the running game with a save that queue_load has already vetted.
+bool load_game(std::vector<unsigned char> &data) {
+  int room, id_max;
+  memcpy(&room, data.data() + 8, 4);
+  memcpy(&id_max, data.data() + 12, 4);
+
+  // Out with the old, without any events; the new room's setup also drops
+  // deactivated instances, and the save brings back its own.
+  for (iterator it = instance_list_first(); it; ++it)
+    enigma_user::instance_destroy(it->id, false);
+  perform_callbacks_clean_up_roomend();
+  roomdata[room]->setup(false);
+  instance_event_iterator = &dummy_event_iterator;
+
+  snapshot_io io(data, true, header_size);
+  for (;;) {
+    char tag[4];
+    unsigned len;
+    io.bytes(tag, 4);
+    io(len);
+    if (!io.ok() || !memcmp(tag, "END ", 4)) break;
+    const size_t end = io.tell() + len;
+    if (!memcmp(tag, "ROOM", 4)) {
+      snapshot_room_variables(io);
+    } else if (!memcmp(tag, "GLOB", 4)) {
+      snapshot_globals(io);
+    } else if (!memcmp(tag, "INST", 4)) {
+      load_instances(io, false);
+    } else if (!memcmp(tag, "DEAC", 4)) {
+      load_instances(io, true);
+    } else {
+      for (const section_entry &s : sections())
+        if (!memcmp(s.tag, tag, 4)) { s.fn(io); break; }
+    }
+    if (io.tell() > end) {
+      DEBUG_MESSAGE("game_load: section " + std::string(tag, 4) + " ran past its end", MESSAGE_TYPE::M_ERROR);
+      return false;
+    }
+    io.skip_to(end);
+  }
+  maxid = id_max;
+  return io.ok();
+}
+
+bool queue_load(const unsigned char *data, size_t size) {
+  const size_t len = save_extent(data, size);
+  if (!len) {
+    DEBUG_MESSAGE("game_load: not a save file for this game", MESSAGE_TYPE::M_ERROR);
+    return false;
+  }
+  int room;
+  memcpy(&room, data + 8, 4);
+  if (!enigma_user::room_exists(room)) {
+    DEBUG_MESSAGE("game_load: the saved room no longer exists", MESSAGE_TYPE::M_ERROR);
+    return false;
+  }
+  pending_load.assign(data, data + len);
+  load_pending = true;
+  return true;
+}
+
+}  // namespace
+
+void register_snapshot_section(const char tag[4], snapshot_section_fn fn) {
+  section_entry s;
+  memcpy(s.tag, tag, 4);
+  s.fn = fn;
+  sections().push_back(s);
+}
+
+bool apply_pending_game_load() {
+  if (!load_pending) return false;
+  load_pending = false;
+  if (!load_game(pending_load))
+    DEBUG_MESSAGE("game_load: the save is damaged; the game state may be incomplete", MESSAGE_TYPE::M_ERROR);
+  pending_load.clear();
+  return true;
+}
+
+}  // namespace enigma
+
+namespace enigma_user {
+
+bool game_save(std::string filename) {
+  enigma::scratch.clear();
+  enigma::save_game(enigma::scratch);
+  std::ofstream file(filename.c_str(), std::ios::binary);
+  if (!file.is_open()) {
+    DEBUG_MESSAGE("Unable to open file " + filename, MESSAGE_TYPE::M_ERROR);
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(enigma::scratch.data()), enigma::scratch.size());
+  return bool(file);
+}
+
+bool game_load(std::string filename) {
+  std::ifstream file(filename.c_str(), std::ios::binary);
+  if (!file.is_open()) {
+    DEBUG_MESSAGE("Unable to open file " + filename, MESSAGE_TYPE::M_ERROR);
+    return false;
+  }
+  std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return enigma::queue_load(data.data(), data.size());
+}
+
+void game_save_buffer(int buffer) {
+  get_buffer(binbuff, buffer);
+  // A grow buffer being appended to takes the save directly.
+  if (binbuff->type == buffer_grow && binbuff->position == binbuff->data.size()) {
+    enigma::save_game(binbuff->data);
+    binbuff->position = binbuff->data.size();
+    return;
+  }
+  enigma::scratch.clear();
+  enigma::save_game(enigma::scratch);
+  const unsigned written = binbuff->Write(binbuff->position, enigma::scratch.data(), enigma::scratch.size());
+  binbuff->Seek((long long) binbuff->position + written);
+}
+
+void game_load_buffer(int buffer) {
+  get_buffer(binbuff, buffer);
+  const unsigned pos = std::min<size_t>(binbuff->position, binbuff->data.size());
+  if (enigma::queue_load(binbuff->data.data() + pos, binbuff->data.size() - pos))
+    binbuff->Seek((long long) pos + enigma::pending_load.size());
+}
+
+}  // namespace enigma_user
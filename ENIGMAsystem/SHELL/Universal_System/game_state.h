@@ -0,0 +1,38 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_GAME_STATE_H
+#define ENIGMA_GAME_STATE_H
+
+#include <string>
+
+namespace enigma_user {
+
+// Saves the running game: the current room and its variables, every active
+// instance with all of its variables, the globals, and the ds_* structures.
+// Saving happens on the spot. Loading waits for the end of the step, like a
+// room change, and replaces the room and all instances without firing any
+// events. Both return false if the file or save can't be used.
+bool game_save(std::string filename);
+bool game_load(std::string filename);
+
+// game_save_buffer/game_load_buffer are declared with the other buffer
+// functions; they write and read the same format at the buffer's position.
+
+}  // namespace enigma_user
+
+#endif  // ENIGMA_GAME_STATE_H
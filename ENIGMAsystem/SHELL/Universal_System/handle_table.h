@@ -0,0 +1,142 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_HANDLE_TABLE_H
+#define ENIGMA_HANDLE_TABLE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Widget_Systems/widgets_mandatory.h" // for DEBUG_MESSAGE
+
+namespace enigma {
+
+// Storage for objects the game creates at runtime and refers to by ID, such as
+// the ds_* data structures. Objects live in a vector of slots and destroyed
+// slots go on a free list for reuse, so a lookup is an index and a compare.
+//
+// An ID is a 32-bit number: the low 20 bits are the slot number and the high
+// 12 bits are the slot's generation, how many times it has been freed. A fresh
+// table still hands out 0, 1, 2, ..., but unlike GM a freed slot comes back
+// under a new ID: destroying 0 and creating again yields 1 << 20 = 1048576,
+// then 2 << 20, and so on. That way an ID stays dead after its slot is reused.
+// Rather than let the generation wrap and a stale ID alias a live one, a slot
+// freed for the 4095th time is retired for good. A table can hand out at most
+// max_slots slots in all, live or retired; asking for more is fatal.
+template<typename T> class handle_table {
+  static const unsigned slot_bits = 20;
+  static const unsigned slot_mask = (1u << slot_bits) - 1;
+  static const unsigned max_generation = ~0u >> slot_bits;
+  // The last index is never handed out, so an ID made of it is always dead.
+  static const unsigned max_slots = slot_mask;
+
+  struct slot {
+    T value;
+    unsigned generation;
+    bool live;
+  };
+  std::vector<slot> slots_;
+  std::vector<unsigned> free_;
+  size_t live_ = 0;
+  const char *name_;
+
+  unsigned id_of(unsigned index) const { return index | (slots_[index].generation << slot_bits); }
+
+ public:
+  explicit handle_table(const char *name): name_(name) {}
+
+  // Stores the value in a free slot and returns its ID.
+  unsigned add(T &&value) {
+    unsigned index;
+    if (free_.empty()) {
+      if (slots_.size() >= max_slots) {
+        DEBUG_MESSAGE("Out of " + std::string(name_) + " IDs: no more than " + std::to_string(max_slots) + " can be handed out.", MESSAGE_TYPE::M_FATAL_ERROR);
+        return slot_mask;
+      }
+      index = slots_.size();
+      slots_.push_back(slot{std::move(value), 0, true});
+    } else {
+      index = free_.back();
+      free_.pop_back();
+      slots_[index].value = std::move(value);
+      slots_[index].live = true;
+    }
+    ++live_;
+    return id_of(index);
+  }
+  unsigned add(const T &value) { return add(T(value)); }
+
+  bool exists(unsigned id) const {
+    const unsigned index = id & slot_mask;
+    return index < slots_.size() && slots_[index].live && id_of(index) == id;
+  }
+
+  // The object with the given ID. A dead ID gets a blank scratch object, so
+  // reads come back empty and writes go nowhere.
+  T &get(unsigned id) {
+    if (exists(id)) return slots_[id & slot_mask].value;
+    #ifdef DEBUG_MODE
+    DEBUG_MESSAGE("Requested " + std::string(name_) + " " + std::to_string(id) + " does not exist.", MESSAGE_TYPE::M_USER_ERROR);
+    #endif
+    static T sentinel;
+    sentinel = T();
+    return sentinel;
+  }
+  T &operator[](unsigned id) { return get(id); }
+
+  // Frees the object and, unless its generations are used up, its slot. Dead
+  // IDs are ignored.
+  void destroy(unsigned id) {
+    if (!exists(id)) return;
+    const unsigned index = id & slot_mask;
+    slot &s = slots_[index];
+    s.value = T();
+    s.live = false;
+    --live_;
+    if (++s.generation < max_generation) free_.push_back(index);
+  }
+
+  size_t size() const { return live_; }
+
+  // Saves or restores the table for game_save/game_load (see snapshot.h).
+  // Generations and the free list come along, so every ID the game holds
+  // means the same thing after a load, dead ones included.
+  template<typename IO> void snapshot(IO &io) {
+    unsigned long long count = slots_.size();
+    io(count);
+    if (io.loading()) {
+      if (!io.fits(count)) return;
+      slots_.clear();
+      slots_.resize(count);
+    }
+    live_ = 0;
+    for (slot &s : slots_) {
+      io(s.generation);
+      io(s.live);
+      if (s.live) {
+        io(s.value);
+        ++live_;
+      }
+    }
+    io(free_);
+  }
+};
+
+} // namespace enigma
+
+#endif // ENIGMA_HANDLE_TABLE_H
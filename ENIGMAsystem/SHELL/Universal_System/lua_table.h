@@ -129,6 +129,35 @@ template <class T> struct lua_table {
     return dense.size();
   }
 
+  /// Saves or restores the whole table through a game_save snapshot stream
+  /// (see snapshot.h); both parts keep their shape.
+  template<class IO> void snapshot(IO &io) {
+    unsigned long long dn = dense.size(), sn = sparse.size(), mx = mx_size;
+    io(dn); io(sn); io(mx);
+    if (io.loading()) {
+      if (!io.fits(dn) || !io.fits(sn)) return;
+      dense.clear();
+      dense.resize(dn);
+      sparse.clear();
+      mx_size = mx;
+    }
+    for (size_t i = 0; i < dense.size(); ++i)
+      io(dense[i]);
+    if (io.loading()) {
+      for (unsigned long long i = 0; i < sn && io.ok(); ++i) {
+        unsigned long long key = 0;
+        io(key);
+        io(sparse[key]);
+      }
+    } else {
+      for (typename sparse_type::iterator it = sparse.begin(); it != sparse.end(); ++it) {
+        unsigned long long key = it->first;
+        io(key);
+        io(it->second);
+      }
+    }
+  }
+
   lua_table<T>& operator= (const lua_table<T>& x) {
     pick_up(x);
     return *this;
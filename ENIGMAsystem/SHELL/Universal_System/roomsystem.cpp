@@ -36,6 +36,7 @@
 
 #include "roomsystem.h"
 #include "depth_draw.h"
+#include "snapshot.h"
 
 #include "Platforms/General/PFmain.h"
 
@@ -170,14 +171,10 @@ namespace enigma
     }
   }
 
-  void roomstruct::gotome(bool gamestart)
+  void roomstruct::setup(bool gamestart)
   {
     using namespace enigma_user;
 
-    this->end();
-
-    perform_callbacks_clean_up_roomend();
-
     // Set the index to self
     room.rval.d = id;
     room_caption = cap;
@@ -257,6 +254,15 @@ namespace enigma
     }
     load_tiles();
     //Tiles end
+  }
+
+  void roomstruct::gotome(bool gamestart)
+  {
+    this->end();
+
+    perform_callbacks_clean_up_roomend();
+
+    setup(gamestart);
 
     std::vector<object_basic*> created;
     created.reserve(instances.size());
@@ -872,6 +878,11 @@ namespace enigma
 
   void rooms_switch()
   {
+    if (apply_pending_game_load()) {
+      room_switching_id = -1;
+      room_switching_restartgame = false;
+      return;
+    }
     if (enigma_user::room_exists(room_switching_id)) {
       int local_room_switching_id = room_switching_id;
       bool local_room_switching_restartgame = room_switching_restartgame;
@@ -885,4 +896,21 @@ namespace enigma
     enigma::roomstruct *rit = *enigma::roomorder;
     enigma::roomdata[rit->id]->gotome(true);
   }
+
+  void snapshot_room_variables(snapshot_io &io) {
+    using namespace enigma_user;
+    io(room_caption);
+    io(room_width); io(room_height);
+    io(room_speed); io(room_persistent);
+    io(background_color); io(background_showcolor);
+    io(background_visible); io(background_foreground); io(background_index);
+    io(background_x); io(background_y); io(background_htiled); io(background_vtiled);
+    io(background_hspeed); io(background_vspeed); io(background_alpha); io(background_coloring);
+    io(background_width); io(background_height); io(background_xscale); io(background_yscale);
+    io(view_current); io(view_enabled);
+    io(view_xview); io(view_yview); io(view_wview); io(view_hview);
+    io(view_xport); io(view_yport); io(view_wport); io(view_hport);
+    io(view_object); io(view_hborder); io(view_vborder); io(view_hspeed); io(view_vspeed);
+    io(view_visible); io(view_angle);
+  }
 }
@@ -172,6 +172,10 @@ namespace enigma
     std::vector<tile> tiles;
 
     void end();
+    // Sets up everything but the instances: room variables, backgrounds,
+    // views and tiles. gotome does this between ending the old room and
+    // creating the new room's instances; game_load does it on its own.
+    void setup(bool gamestart = false);
     void gotome(bool gamestart = false);
   };
   void update_mouse_variables();
@@ -180,6 +184,11 @@ namespace enigma
   void rooms_switch();
   void rooms_load();
   void game_start();
+
+  class snapshot_io;
+  // The room variables the game can change while the room runs, for
+  // game_save/game_load.
+  void snapshot_room_variables(snapshot_io &io);
 }
 
 // room variable
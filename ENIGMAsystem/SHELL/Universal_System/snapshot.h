@@ -0,0 +1,208 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_SNAPSHOT_H
+#define ENIGMA_SNAPSHOT_H
+
+#include "var4.h"
+
+#include <cstring>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace enigma {
+
+// One stream for both directions of a game_save/game_load snapshot, so each
+// piece of state is described once: `io(x)` appends x when saving and reads it
+// back into x when loading. Values are written as raw bytes in the order they
+// are visited, with no names or per-field tags, which keeps a save to a
+// single pass of memcpys into one growing block.
+//
+// Understood field types: numbers, bools and enums; strings; variant and
+// anything derived from it (restored without running the multifunction
+// hooks); var, with its arrays; fixed arrays, std::vector and std::deque of
+// any of these; and classes with a `void snapshot(snapshot_io&)` member.
+// Anything else, including pointers, is skipped in both directions.
+class snapshot_io {
+ public:
+  // Saving appends to data; loading reads from it, starting at pos.
+  snapshot_io(std::vector<unsigned char> &data, bool loading, size_t pos = 0):
+      data_(data), pos_(loading ? pos : data.size()), loading_(loading) {}
+
+  bool loading() const { return loading_; }
+  // False once a load has run off the end of the data. Every read after that
+  // comes back zero, so callers only need to check once, at the end.
+  bool ok() const { return ok_; }
+  size_t tell() const { return pos_; }
+  size_t remaining() const { return data_.size() - pos_; }
+
+  void bytes(void *p, size_t n) {
+    if (!loading_) {
+      const unsigned char *src = (const unsigned char*) p;
+      data_.insert(data_.end(), src, src + n);
+      pos_ += n;
+    } else if (ok_ && n <= remaining()) {
+      memcpy(p, data_.data() + pos_, n);
+      pos_ += n;
+    } else {
+      ok_ = false;
+      memset(p, 0, n);
+    }
+  }
+
+  // Checks that a count read from the data could really be followed by that
+  // many elements of at least `size` bytes, so a damaged save can't make us
+  // allocate the world.
+  bool fits(unsigned long long count, size_t size = 1) {
+    if (!loading_ || (ok_ && count <= remaining() / size)) return true;
+    ok_ = false;
+    return false;
+  }
+
+  // Overwrites four bytes written earlier; used for section lengths.
+  void patch(size_t at, unsigned value) { memcpy(data_.data() + at, &value, sizeof value); }
+  void skip_to(size_t pos) {
+    if (pos > data_.size()) ok_ = false;
+    else pos_ = pos;
+  }
+
+  template<class T> void operator()(T &value);
+  template<class T> void operator()(const T&) {}  // Constants aren't state.
+
+ private:
+  template<class T, class = void> struct has_snapshot: std::false_type {};
+  template<class T> struct has_snapshot<T,
+      decltype(std::declval<T&>().snapshot(std::declval<snapshot_io&>()))>: std::true_type {};
+  template<class T> struct is_sequence: std::false_type {};
+  template<class T, class A> struct is_sequence<std::vector<T, A> >: std::true_type {};
+  template<class A> struct is_sequence<std::vector<bool, A> >: std::false_type {};
+  template<class T, class A> struct is_sequence<std::deque<T, A> >: std::true_type {};
+
+  void string(std::string &str) {
+    unsigned len = str.length();
+    bytes(&len, sizeof len);
+    if (!loading_) {
+      bytes(&str[0], len);
+    } else if (fits(len)) {
+      str.assign((const char*) data_.data() + pos_, len);
+      pos_ += len;
+    }
+  }
+
+  void value(variant &v) {
+    int type = v.type;
+    bytes(&type, sizeof type);
+    if (type == variant::ty_string) {
+      if (loading_) {
+        std::string str;
+        string(str);
+        v = std::move(str);
+      } else {
+        // Read through the const sval() so a shared string isn't copied.
+        const std::string &str = static_cast<const variant&>(v).sval();
+        unsigned len = str.length();
+        bytes(&len, sizeof len);
+        bytes(const_cast<char*>(str.data()), len);
+      }
+    } else if (type == enigma_user::ty_pointer) {
+      // Addresses mean nothing to the next run of the game.
+      if (loading_) v.rval.p = nullptr;
+    } else {
+      bytes(&v.rval.d, sizeof v.rval.d);
+      if (loading_) v.reset_sval();
+    }
+    if (loading_) v.type = type;
+  }
+
+  template<class S> void sequence(S &seq) {
+    unsigned long long n = seq.size();
+    bytes(&n, sizeof n);
+    if (loading_) {
+      if (!fits(n)) return;
+      seq.clear();
+      seq.resize(n);
+    }
+    typedef typename S::value_type T;
+    if constexpr (std::is_arithmetic<T>::value && !std::is_same<S, std::deque<T> >::value) {
+      if (!fits(n, sizeof(T))) return;
+      bytes(seq.data(), n * sizeof(T));
+    } else {
+      for (T &e : seq) (*this)(e);
+    }
+  }
+
+  std::vector<unsigned char> &data_;
+  size_t pos_;
+  bool loading_;
+  bool ok_ = true;
+};
+
+template<class T> void snapshot_io::operator()(T &v) {
+  if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value) {
+    bytes(&v, sizeof v);
+  } else if constexpr (std::is_array<T>::value) {
+    for (auto &e : v) (*this)(e);
+  } else if constexpr (std::is_same<T, std::string>::value) {
+    string(v);
+  } else if constexpr (std::is_same<T, var>::value) {
+    value(v);
+    v.array1d.snapshot(*this);
+    v.array2d.snapshot(*this);
+  } else if constexpr (std::is_base_of<variant, T>::value) {
+    value(v);
+  } else if constexpr (is_sequence<T>::value) {
+    sequence(v);
+  } else if constexpr (has_snapshot<T>::value) {
+    v.snapshot(*this);
+  }
+}
+
+// The instance-local state of an extension, for extensions that implement
+// one in a `$snapshot_fields(snapshot_io&)` member. The compiler calls this on
+// every extension an object inherits. (Instance members take the `$` so they
+// can't collide with the game's own local variables.)
+template<class T> auto snapshot_extension(snapshot_io &io, T &ext, int) -> decltype(ext.$snapshot_fields(io)) {
+  return ext.$snapshot_fields(io);
+}
+template<class T> void snapshot_extension(snapshot_io &io, T &ext, long) {}
+template<class T> void snapshot_extension(snapshot_io &io, T &ext) { snapshot_extension(io, ext, 0); }
+
+// State that lives outside instances and globals, such as the ds_* families,
+// is saved by whoever owns it. Each part registers a section under a
+// four-character tag; sections are saved in registration order and skipped
+// on load if the game no longer has them.
+typedef void (*snapshot_section_fn)(snapshot_io &io);
+void register_snapshot_section(const char tag[4], snapshot_section_fn fn);
+
+struct snapshot_section {
+  snapshot_section(const char tag[4], snapshot_section_fn fn) { register_snapshot_section(tag, fn); }
+};
+
+// Runs a game_load queued during the step, if there is one; rooms_switch
+// calls this. Returns whether it did, in which case any room change from the
+// same step is moot.
+bool apply_pending_game_load();
+
+// Generated with the game's globals: every declared global variable plus the
+// locals of the `global` instance.
+void snapshot_globals(snapshot_io &io);
+
+} // namespace enigma
+
+#endif // ENIGMA_SNAPSHOT_H
@@ -225,14 +225,82 @@ struct variant_real_union {
   variant_real_union(double x): rval(x) {}
   variant_real_union(const void *x): rval(x) {}
 };
-struct variant_string_wrapper : std::string {
-  std::string &sval() { return *this; }
-  const std::string &sval() const { return *this; }
-  variant_string_wrapper() {}
-  variant_string_wrapper(std::string const      &x): std::string(x) {}
-  variant_string_wrapper(std::string rvalue_ref  x): std::string(x) {}
-  std::string rvalue_ref release_sval() {
-    return std::move(*(std::string*) this);
+// The string half of a variant. Rather than a whole std::string in every
+// variant, real or not, this is one pointer to a reference-counted string
+// that copies of the variant share; a real-valued variant holds no string at
+// all. Writing through the mutable sval() first gives this variant its own
+// copy if the string is shared, so sharing is never visible. The count is not
+// atomic: like the rest of the game state, variants belong to the main thread.
+// Because of that, don't hold a reference from sval() or from a variant's
+// std::string cast across a copy or an assignment of the variant: the mutable
+// one may then alias a string another variant shares, and either one dangles
+// once the variant drops or replaces its string.
+struct variant_string_rep {
+  std::string str;
+  unsigned refs;
+  variant_string_rep(const std::string &x): str(x), refs(1) {}
+  variant_string_rep(std::string rvalue_ref x): str(std::move(x)), refs(1) {}
+};
+
+struct variant_string_wrapper {
+  variant_string_rep *srep;
+
+  static const std::string &empty_sval() {
+    static const std::string empty;
+    return empty;
+  }
+
+  const std::string &sval() const { return srep ? srep->str : empty_sval(); }
+  std::string &sval() {
+    if (!srep) srep = new variant_string_rep(std::string());
+    else if (srep->refs > 1) {
+      --srep->refs;
+      srep = new variant_string_rep(srep->str);
+    }
+    return srep->str;
+  }
+
+  variant_string_wrapper(): srep(nullptr) {}
+  variant_string_wrapper(const variant_string_wrapper &x): srep(x.srep) {
+    if (srep) ++srep->refs;
+  }
+  variant_string_wrapper(variant_string_wrapper rvalue_ref x): srep(x.srep) {
+    x.srep = nullptr;
+  }
+  variant_string_wrapper(std::string const      &x): srep(new variant_string_rep(x)) {}
+  variant_string_wrapper(std::string rvalue_ref  x): srep(new variant_string_rep(std::move(x))) {}
+  ~variant_string_wrapper() { reset_sval(); }
+
+  // Shares x's string; the old one is released.
+  void share_sval(const variant_string_wrapper &x) {
+    if (x.srep) ++x.srep->refs;
+    reset_sval();
+    srep = x.srep;
+  }
+  // Drops the string, as when the variant becomes a real.
+  void reset_sval() {
+    if (srep && !--srep->refs) delete srep;
+    srep = nullptr;
+  }
+  // Replaces the string, reusing this variant's buffer if nobody shares it.
+  template<typename S> void assign_sval(S rvalue_ref x) {
+    if (srep && srep->refs == 1) {
+      srep->str = std::forward<S>(x);
+    } else {
+      reset_sval();
+      srep = new variant_string_rep(std::string(std::forward<S>(x)));
+    }
+  }
+  std::string release_sval() {
+    if (!srep) return std::string();
+    std::string res = srep->refs == 1 ? std::move(srep->str) : srep->str;
+    reset_sval();
+    return res;
+  }
+
+  variant_string_wrapper &operator=(const variant_string_wrapper &x) {
+    share_sval(x);
+    return *this;
   }
 };
 
@@ -293,6 +361,11 @@ struct variant : enigma::variant_real_union, enigma::variant_string_wrapper {
     return (T) rval.d;
   }
 
+  // Variants used to be strings by inheritance; this keeps passing one where a
+  // string is expected working.
+  operator const std::string&() const { return sval(); }
+
+  const char *c_str()      const { return sval().c_str(); }
   size_t string_length()   const { return sval().length(); }
   char char_at(size_t ind) const { return sval()[ind]; }
 
@@ -323,11 +396,11 @@ struct variant : enigma::variant_real_union, enigma::variant_string_wrapper {
       enigma::variant_real_union(p), type(enigma_user::ty_pointer) {}
   variant(const variant &x):
       enigma::variant_real_union(x.rval.d),
-      enigma::variant_string_wrapper(x.sval()),
+      enigma::variant_string_wrapper(x),
       type(x.type) {}
   variant(variant rvalue_ref x):
       enigma::variant_real_union(x.rval.d),
-      enigma::variant_string_wrapper(x.release_sval()),
+      enigma::variant_string_wrapper(std::move(x)),
       type(x.type) {}
 
   // Construct a variant from numeric types
@@ -344,7 +417,7 @@ struct variant : enigma::variant_real_union, enigma::variant_string_wrapper {
       type(ty_string) {}
   variant(std::string rvalue_ref str):
       enigma::variant_real_union(0.),
-      enigma::variant_string_wrapper(str),
+      enigma::variant_string_wrapper(std::move(str)),
       type(ty_string) {}
 
   // Assignment operators
@@ -352,7 +425,14 @@ struct variant : enigma::variant_real_union, enigma::variant_string_wrapper {
 
   variant& operator=(const variant &v) {
     rval = v.rval;
-    if ((type = v.type) == ty_string) sval() = v.sval();
+    share_sval(v);
+    type = v.type;
+    return *this;
+  }
+  variant& operator=(variant rvalue_ref v) {
+    rval = v.rval;
+    std::swap(srep, v.srep);
+    type = v.type;
     return *this;
   }
 
@@ -360,24 +440,25 @@ struct variant : enigma::variant_real_union, enigma::variant_string_wrapper {
   template<typename T, REQUIRE_NON_STRING_NUMBER(T)>
   variant& operator=(T number) {
     rval.d = (double) number;
+    reset_sval();
     type = ty_real;
     return *this;
   }
 
   // Assignment to a string type
   variant& operator=(const std::string &str) {
-    sval() = str;
+    assign_sval(str);
     type = ty_string;
     return *this;
   }
   variant& operator=(std::string rvalue_ref str) {
-    sval() = std::move(str);
+    assign_sval(std::move(str));
     type = ty_string;
     return *this;
   }
 
   variant& operator=(const char *str) {
-    sval() = str;
+    assign_sval(str);
     type = ty_string;
     return *this;
   }
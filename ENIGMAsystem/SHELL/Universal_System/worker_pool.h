@@ -0,0 +1,154 @@
+/** Copyright (C) 2026 enigma-dev contributors
+***
+*** This file is a part of the ENIGMA Development Environment.
+***
+*** ENIGMA is free software: you can redistribute it and/or modify it under the
+*** terms of the GNU General Public License as published by the Free Software
+*** Foundation, version 3 of the license or any later version.
+***
+*** This application and its source code is distributed AS-IS, WITHOUT ANY
+*** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+*** FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+*** details.
+***
+*** You should have received a copy of the GNU General Public License along
+*** with this code. If not, see <http://www.gnu.org/licenses/>
+**/
+
+#ifndef ENIGMA_WORKER_POOL_H
+#define ENIGMA_WORKER_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace enigma {
+
+// A handful of persistent threads for splitting a job into numbered chunks.
+// The calling thread works on chunks too, so with no workers (single core, or
+// threads unavailable) run() is just a loop. Jobs run one at a time; a job
+// that calls run() itself, from any thread, gets its chunks run inline.
+// Between jobs the threads also take single tasks queued with post().
+class worker_pool {
+ public:
+  worker_pool() {
+    const unsigned hw = std::thread::hardware_concurrency();
+    const unsigned n = hw > 1 ? std::min(hw - 1, 7u) : 0;
+    for (unsigned i = 0; i < n; i++) {
+      try {
+        threads.emplace_back([this] { work(); });
+      } catch (const std::system_error&) {
+        break; // Make do with the threads we have.
+      }
+    }
+  }
+  ~worker_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) t.join();
+  }
+
+  // Calls fn(0) through fn(chunks - 1) and returns once they have all finished.
+  void run(size_t chunks, const std::function<void(size_t)>& fn) {
+    if (threads.empty() || chunks < 2 || in_job()) {
+      for (size_t c = 0; c < chunks; c++) fn(c);
+      return;
+    }
+    std::lock_guard<std::mutex> one_job(run_mtx);
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      job = &fn;
+      chunk_count = chunks;
+      next = 0;
+      busy = threads.size();
+      generation++;
+    }
+    wake.notify_all();
+    in_job() = true;
+    drain();
+    in_job() = false;
+    std::unique_lock<std::mutex> lock(mtx);
+    done.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+  }
+
+  // Queues task to run on one of the threads, or runs it now if there are
+  // none. Queued tasks still waiting when the pool stops never run. A job
+  // waits for each thread to finish the task it is on, so keep tasks short.
+  void post(std::function<void()> task) {
+    if (threads.empty()) {
+      task();
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+  }
+
+ private:
+  // Set on threads working on a job: the pool's own for good, and the caller's
+  // while it helps. Waiting on the pool from there would never return.
+  static bool& in_job() {
+    static thread_local bool flag = false;
+    return flag;
+  }
+  void drain() {
+    for (size_t c; (c = next++) < chunk_count; ) (*job)(c);
+  }
+  void work() {
+    in_job() = true;
+    unsigned seen = 0;
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        wake.wait(lock, [&] { return stopping || generation != seen || !tasks.empty(); });
+        if (stopping) return;
+        if (generation == seen) {
+          task = std::move(tasks.front());
+          tasks.pop_front();
+        }
+        seen = generation;
+      }
+      if (task) {
+        task();
+        continue;
+      }
+      drain();
+      std::lock_guard<std::mutex> lock(mtx);
+      if (--busy == 0) done.notify_one();
+    }
+  }
+
+  std::vector<std::thread> threads;
+  std::mutex mtx, run_mtx;
+  std::condition_variable wake, done;
+  const std::function<void(size_t)>* job = nullptr;
+  size_t chunk_count = 0;
+  std::atomic<size_t> next{0};
+  std::deque<std::function<void()>> tasks;
+  size_t busy = 0;
+  unsigned generation = 0;
+  bool stopping = false;
+};
+
+// The pool shared by the runtime, started on first use.
+inline worker_pool& shared_workers() {
+  static worker_pool pool;
+  return pool;
+}
+
+} // namespace enigma
+
+#endif // ENIGMA_WORKER_POOL_H
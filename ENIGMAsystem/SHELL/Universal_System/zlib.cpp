@@ -33,7 +33,7 @@ unsigned char* zlib_compress(unsigned char* inbuffer,int actualsize)
 
     if (res != Z_OK)
     {
-     #if DEBUG_MODE
+     #ifdef DEBUG_MODE
      if (res==Z_MEM_ERROR)
      DEBUG_MESSAGE("Zlib failed to compress the buffer. Out of memory.", MESSAGE_TYPE::M_ERROR);
      if (res==Z_BUF_ERROR)
@@ -50,17 +50,17 @@ int zlib_decompress(unsigned char* inbuffer, int insize, int uncompresssize,unsi
 	switch(uncompress(outbytef,&outused,(Bytef*)inbuffer,insize)){
 	case Z_OK:return outused;
 	case Z_MEM_ERROR:
-		#if DEBUG_MODE
+		#ifdef DEBUG_MODE
 			DEBUG_MESSAGE("Zerror: Memory out", MESSAGE_TYPE::M_ERROR);
 		#endif
 		return -1;
 	case Z_BUF_ERROR:
-		#if DEBUG_MODE
+		#ifdef DEBUG_MODE
 			DEBUG_MESSAGE("Zerror: Output of " + toString(outused) + " above allotted " + toString(uncompresssize), MESSAGE_TYPE::M_ERROR);
 		#endif
 		return -2;
 	case Z_DATA_ERROR:
-		#if DEBUG_MODE
+		#ifdef DEBUG_MODE
 			DEBUG_MESSAGE("Zerror: Invalid data", MESSAGE_TYPE::M_ERROR);
 		#endif
 		return -3;
@@ -68,4 +68,35 @@ int zlib_decompress(unsigned char* inbuffer, int insize, int uncompresssize,unsi
 	}
 }
 
+int zlib_decompress_file(FILE_t* in, size_t insize, int uncompresssize, unsigned char* outbytef)
+{
+  z_stream strm = {};
+  if (inflateInit(&strm) != Z_OK) return -1;
+  strm.next_out = outbytef;
+  strm.avail_out = uncompresssize;
+
+  unsigned char chunk[16384];
+  int res = Z_OK;
+  while (insize) {
+    const size_t want = insize < sizeof(chunk) ? insize : sizeof(chunk);
+    const size_t got = fread_wrapper(chunk, 1, want, in);
+    insize -= want;
+    if (got != want) { res = Z_DATA_ERROR; break; }
+    if (res == Z_STREAM_END) continue;  // Trailing bytes; skip them like uncompress would
+    strm.next_in = chunk;
+    strm.avail_in = got;
+    res = inflate(&strm, Z_NO_FLUSH);
+    if (res != Z_OK && res != Z_STREAM_END) break;
+  }
+  if (insize) fseek_wrapper(in, insize, SEEK_CUR);
+  const int written = uncompresssize - strm.avail_out;
+  inflateEnd(&strm);
+
+  if (res == Z_STREAM_END) return written;
+  #ifdef DEBUG_MODE
+    DEBUG_MESSAGE("Zerror: Invalid data", MESSAGE_TYPE::M_ERROR);
+  #endif
+  return res == Z_MEM_ERROR ? -1 : res == Z_BUF_ERROR || res == Z_OK ? -2 : -3;
+}
+
 }  //namespace enigma
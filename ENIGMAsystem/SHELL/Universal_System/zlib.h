@@ -18,9 +18,17 @@
 #ifndef ENIGMA_ZLIB_H
 #define ENIGMA_ZLIB_H
 
+#include "Platforms/General/fileio.h"
+
+#include <cstddef>
+
 namespace enigma {
 unsigned char* zlib_compress(unsigned char* inbuffer, int actualsize);
 int zlib_decompress(unsigned char* inbuffer, int insize, int uncompresssize, unsigned char* outbytef);
+/// Inflates the next insize bytes of a file into outbytef a chunk at a time, so
+/// the compressed data never has to be held in memory. Returns the number of
+/// bytes written, or a negative value on error. Always consumes insize bytes.
+int zlib_decompress_file(FILE_t* in, size_t insize, int uncompresssize, unsigned char* outbytef);
 }  //namespace enigma
 
 #endif  //ENIGMA_ZLIB_H
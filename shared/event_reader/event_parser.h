@@ -93,6 +93,9 @@ struct EventDescriptor {
   bool HasLocalDeclarations() const { return event->has_locals(); }
   bool HasDefaultCode() const { return event->has_default_() || HasConstantCode(); }
   bool HasConstantCode() const { return event->has_constant(); }
+  // Default code that user code replaces, as opposed to constant code, which
+  // runs ahead of it.
+  bool HasReplaceableDefaultCode() const { return event->has_default_() && !HasConstantCode(); }
   bool HasDispatcher() const { return event->has_dispatcher(); }
 
   std::string DefaultCode() const;